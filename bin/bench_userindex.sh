@@ -0,0 +1,44 @@
+#!/bin/bash
+
+# Benchmark the check of the administrator conditions in userCleaning, scanning the users against the
+# bitmap index of the initial state, on instances generated by instgen with more and more users
+
+if [ $# -ne 1 ]; then
+    echo "Usage: $0 <store_dir>"
+    exit 1
+fi
+
+# The directory to store the generated instances
+store_dir=$1
+
+# The numbers of users
+usernums="1000 5000 20000 50000"
+# The number of boolean, integer and string attributes
+boolnum=10
+intnum=10
+strnum=10
+# The size of the domain of each attribute
+domsize=20
+# The number of rules, each with a distinct administrator condition of at most maxadminatomconds atom conditions
+nrules=5000
+maxadminatomconds=3
+# The minimum and maximum number of atom conditions in a user condition
+minatomconds=1
+maxatomconds=4
+# The number of attribute-value pairs in the safety query
+nqueryav=2
+initavdefaultrate=0.2
+
+if [ ! -d $store_dir ]; then
+    mkdir -p $store_dir
+    echo "the generated instances will be stored in $store_dir"
+else
+    echo "$store_dir already exists"
+    exit 1
+fi
+
+for usernum in $usernums; do
+    instfile=$store_dir/users$usernum.acoac
+    ./instgen -u $usernum -b $boolnum -n $intnum -s $strnum -d $domsize -i $initavdefaultrate -r $nrules -l $minatomconds -h $maxatomconds -a $maxadminatomconds -q $nqueryav -o $instfile > /dev/null 2>&1
+    ./bench -b userindex -i $instfile -n 3 2>&1 | grep -v "\[INFO\]"
+done
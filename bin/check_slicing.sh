@@ -0,0 +1,64 @@
+#!/bin/bash
+
+# Check that the incremental slicer gives the same results as slice() on the demo instances
+# and on instances generated by instgen, including the sub-policies of the abstraction refinement
+
+if [ $# -ne 2 ]; then
+    echo "Usage: $0 <store_dir> <instnum>"
+    exit 1
+fi
+
+# The directory to store the generated instances
+store_dir=$1
+# The number of instances to generate
+instnum=$2
+
+if [ ! -d $store_dir ]; then
+    mkdir -p $store_dir
+    echo "the generated instances will be stored in $store_dir"
+else
+    echo "$store_dir already exists"
+    exit 1
+fi
+
+npassed=0
+nfailed=0
+
+# Compare the slicers on an instance, the output of a failed check is kept in the store directory
+check() {
+    instfile=$1
+    logfile=$store_dir/$(basename $instfile).log
+    ./bench -b slice -i $instfile -n 1 > $logfile 2>&1
+    if grep -q "same result => yes" $logfile; then
+        npassed=$((npassed + 1))
+        rm -f $logfile
+    else
+        nfailed=$((nfailed + 1))
+        echo "FAILED: $instfile, see $logfile"
+    fi
+}
+
+for instfile in ../demo/*.acoac; do
+    check $instfile
+done
+
+# The parameters of the generated instances vary with the instance number, so that instances
+# with few and many rules, small and large domains, and short and long conditions are checked
+for i in `seq $instnum`; do
+    usernum=$((1 + i % 4))
+    boolnum=$((2 + i % 5))
+    intnum=$((2 + i % 4))
+    strnum=$((2 + i % 3))
+    domsize=$((4 + i % 5 * 4))
+    nrules=$((50 + i % 6 * 150))
+    maxatomconds=$((2 + i % 5))
+    nqueryav=$((1 + i % 3))
+    initavdefaultrate=0.$((i % 10))
+    ./instgen -u $usernum -b $boolnum -s $strnum -n $intnum -d $domsize -i $initavdefaultrate -r $nrules -l 1 -h $maxatomconds -q $nqueryav -o $store_dir/test$i.acoac > /dev/null 2>&1
+    check $store_dir/test$i.acoac
+done
+
+echo "passed: $npassed, failed: $nfailed"
+if [ $nfailed -ne 0 ]; then
+    exit 1
+fi
@@ -3,25 +3,88 @@
 
 #include "acoac_inst.h"
 
+/*
+ * The strategies of refining a sub-policy that is determined to be safe:
+ *      REFINE_WIDEN: select the rules of one more step of the forward and backward rule-selection strategies;
+ *      REFINE_CEGAR: select the rules that lead from the attribute values reachable in the sub-policy, as reported by
+ *                    the model checker (see addReachableAVs), to the attribute values needed by the query, and widen
+ *                    only if there are no such rules.
+ */
+typedef enum _RefineStrategy {
+    REFINE_WIDEN,
+    REFINE_CEGAR
+} RefineStrategy;
+
+// The maximum number of widening steps per round chosen by the adaptive scheduler (see reportRound)
+#define REFINE_MAX_STEPS 64
+// The adaptive scheduler doubles the widening steps after a round model checked in less than REFINE_FAST_MC_MS
+// milliseconds, unless its sub-policy has more than REFINE_MAX_GROWTH times the rules of the previous one, and halves
+// them after a round model checked in more than REFINE_SLOW_MC_MS milliseconds
+#define REFINE_FAST_MC_MS 1000
+#define REFINE_SLOW_MC_MS 10000
+#define REFINE_MAX_GROWTH 2
+
+/*
+ * The telemetry of a round of abstraction refinement
+ */
+typedef struct _RefineTelemetry {
+    int round;
+    // The number of widening steps taken to select the rules, 0 if they are selected by the counterexample-guided strategy
+    int nSteps;
+    // The number of rules of the sub-policy, and of the rules left after pruning it, 0 if the pruning determines its safety
+    int nRules;
+    int nRulesChecked;
+    // The time spent selecting the rules, and the wall time of the model checker, in milliseconds
+    double selectCost;
+    double mcCost;
+    // The number of widening steps chosen for the next round
+    int nNextSteps;
+} RefineTelemetry;
+
 typedef struct AbsRef {
     // The current round of abstraction refinement
     int round;
 
     // The set of rules selected by the forward rule-selection strategy
     HashSet *pSetF;
-    HashMap *pMapReachableAVs;
-    HashMap *pMapReachableAVsInc;
+    IntMap *pMapReachableAVs;
+    IntMap *pMapReachableAVsInc;
 
     // The set of rules selected by the backward rule-selection strategy
     HashSet *pSetB;
-    HashMap *pMapUsefulAVs;
-    HashMap *pMapUsefulAVsInc;
+    IntMap *pMapUsefulAVs;
+    IntMap *pMapUsefulAVsInc;
 
     // The ACoAC instance before abstraction refinement
     ACoACInstance *pOriInst;
 
-    // The global rule list before abstraction refinement
+    // The global rule list before abstraction refinement. Each round prunes a fork of it (see forkRuleList),
+    // so that its conditions are not modified
     Vector *pOriVecRules;
+
+    // The rules selected so far in the order of selection, the first nSelectedPrev ones by the previous rounds
+    int *selectedRules;
+    int nSelected;
+    int nSelectedPrev;
+    // Whether each rule of the original list is selected
+    char *selected;
+
+    // The sub-policy of all the selected rules, extended with the newly selected rules every round
+    ACoACInstance *pSubInst;
+
+    // The refinement strategy, REFINE_WIDEN by default
+    RefineStrategy strategy;
+    // The attribute values reachable in the last sub-policy, recorded by addReachableAVs, or NULL if none is recorded
+    IntMap *pMapFoundAVs;
+
+    // The number of steps of the forward and backward rule-selection strategies taken to widen the sub-policy in a round,
+    // 1 by default, and whether it is adapted to the previous rounds by reportRound
+    int nSteps;
+    int adaptiveSteps;
+    // The telemetry of the rounds so far, the last one being the current round
+    RefineTelemetry *telemetry;
+    int nTelemetry;
+    int telemetryCapacity;
 } AbsRef;
 
 /**
@@ -49,4 +112,62 @@ ACoACInstance *abstract(AbsRef *pAbsRef);
  */
 ACoACInstance *refine(AbsRef *pAbsRef);
 
+/**
+ * Free a sub-policy generated by abstract or refine, which may have been pruned since. The list of users
+ * shared with the original instance is kept, and the arena of the rule indices is returned to the pool
+ * so that the next round reuses it.
+ * 
+ * @param pAbsRef[in]: The AbsRef instance
+ * @param pInst[in]: The sub-policy
+ */
+void finalizeSubPolicy(AbsRef *pAbsRef, ACoACInstance *pInst);
+
+/**
+ * Get the attribute values of a pruned sub-policy, or of a cluster of it, whose reachability the REFINE_CEGAR strategy
+ * asks the model checker, i.e., the values other than the initial ones that some rule of the instance can set.
+ * If the domain of an attribute is compressed, the values are the representatives of the classes.
+ *
+ * @param pInst[in]: The pruned sub-policy, whose domains are compressed if they are to be
+ * @param pAttrs[out]: The attributes of the attribute values, which should be freed by the caller
+ * @param pVals[out]: The values of the attribute values, which should be freed by the caller
+ * @return The number of attribute values
+ */
+int getProbeAVs(ACoACInstance *pInst, int **pAttrs, int **pVals);
+
+/**
+ * Record the attribute values of a pruned sub-policy, or of a cluster of it, that are reachable according to the model
+ * checker, for the next refinement with the REFINE_CEGAR strategy. The initial values of the query user are always
+ * reachable, and a reachable representative stands for all the values of its class.
+ *
+ * @param pAbsRef[in]: The AbsRef instance
+ * @param pInst[in]: The pruned sub-policy or cluster the attribute values are got from (see getProbeAVs)
+ * @param attrs[in]: The attributes of the attribute values
+ * @param vals[in]: The values of the attribute values
+ * @param reachable[in]: Whether each attribute value is reachable, or NULL if the model checker did not tell, in which
+ * case all of them are taken as reachable
+ * @param n[in]: The number of attribute values
+ */
+void addReachableAVs(AbsRef *pAbsRef, ACoACInstance *pInst, int *attrs, int *vals, char *reachable, int n);
+
+/**
+ * Report the verification of a sub-policy, which completes the telemetry of its round, and with adaptive steps,
+ * choose the number of widening steps of the next round from the wall time of the model checker and the growth of the
+ * sub-policies (see REFINE_FAST_MC_MS). The round is usually the last one, unless the next round is already prepared.
+ *
+ * @param pAbsRef[in]: The AbsRef instance
+ * @param round[in]: The round of the sub-policy
+ * @param nRulesChecked[in]: The number of rules of the pruned sub-policy, 0 if the pruning determines its safety
+ * @param mcCost[in]: The wall time of the model checker in milliseconds, 0 if it is not called
+ */
+void reportRound(AbsRef *pAbsRef, int round, int nRulesChecked, double mcCost);
+
+/**
+ * Write the telemetry of the rounds so far to a CSV file, one line per round.
+ *
+ * @param pAbsRef[in]: The AbsRef instance
+ * @param path[in]: The path of the file, which is overwritten
+ * @return 0 if success, -1 otherwise
+ */
+int writeRefineTelemetry(AbsRef *pAbsRef, char *path);
+
 #endif //ACoAC_ABS_REF_H
\ No newline at end of file
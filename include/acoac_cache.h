@@ -0,0 +1,54 @@
+#ifndef ACoAC_CACHE_H
+#define ACoAC_CACHE_H
+
+#include "analysis_result.h"
+
+// The length of the fingerprint of a policy in bytes
+#define FINGERPRINT_LEN 16
+
+/**
+ * Compute the 128-bit fingerprint of a parsed policy and its safety query, which is the FNV-1a hash of the compiled
+ * form of the instance (see compileInstance) and of the options that change the result of pre-checking and slicing.
+ *
+ * Note: It should be called before the instance is initialized, since the initialization discretizes the rules.
+ *
+ * @param pInst[in]: The parsed ACoAC instance
+ * @param doPrechecking[in]: Whether the instance is pre-checked before slicing
+ * @param fingerprint[out]: The fingerprint, FINGERPRINT_LEN bytes
+ * @return 0 if success, -1 otherwise
+ */
+int fingerprintPolicy(ACoACInstance *pInst, int doPrechecking, unsigned char *fingerprint);
+
+/**
+ * Get the default cache directory, $XDG_CACHE_HOME/coachecker or $HOME/.cache/coachecker.
+ *
+ * @return The path, which should be freed by the caller, or NULL if neither variable is set
+ */
+char *getDefaultCacheDir();
+
+/**
+ * Load the result of pre-checking and slicing a policy from the cache. The snapshot is either the verdict of the
+ * pre-checking or slicing, or the sliced instance, which replaces the parsed instance: its rules get the conditions
+ * discretized by the slicing, so the parsed instance should not be initialized.
+ *
+ * @param cacheDir[in]: The cache directory
+ * @param fingerprint[in]: The fingerprint of the policy
+ * @param ppInst[in,out]: The parsed instance, replaced by the sliced instance if it is cached
+ * @param pResult[out]: The verdict, or ACoAC_RESULT_UNKNOWN if the sliced instance is cached
+ * @return 1 if the snapshot is found and valid, 0 otherwise
+ */
+int loadSlicingCache(char *cacheDir, unsigned char *fingerprint, ACoACInstance **ppInst, ACoACResult *pResult);
+
+/**
+ * Save the result of pre-checking and slicing a policy to the cache. The snapshot is written to a temporary file
+ * that is renamed, so concurrent runs never read a partial snapshot.
+ *
+ * @param cacheDir[in]: The cache directory, created if it does not exist
+ * @param fingerprint[in]: The fingerprint of the policy
+ * @param pInst[in]: The sliced instance, used only if the verdict is ACoAC_RESULT_UNKNOWN
+ * @param result[in]: The verdict of the pre-checking or slicing
+ * @return 0 if success, -1 otherwise
+ */
+int saveSlicingCache(char *cacheDir, unsigned char *fingerprint, ACoACInstance *pInst, ACoACResult result);
+
+#endif // ACoAC_CACHE_H
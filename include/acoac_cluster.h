@@ -0,0 +1,42 @@
+#ifndef ACoAC_CLUSTER_H
+#define ACoAC_CLUSTER_H
+
+#include "analysis_result.h"
+
+/**
+ * Split an ACoAC instance into the clusters of its query attributes. Two attributes are in the same cluster if they
+ * are linked by a chain of rules, each rule linking its target attribute with the attributes of its conditions.
+ * The rules setting the attributes of a cluster depend only on the attributes of the cluster, so the part of the
+ * query in a cluster is reachable independently of the other clusters, and the query is reachable if and only if
+ * every part is reachable. Each cluster is returned as an instance with the rules, initial state, domains and
+ * query restricted to its attributes; the clusters without query attributes are dropped.
+ *
+ * Note: The instance should be sliced, so that its domains are complete, and it is not modified. The clusters share
+ * the list of users of the instance, and should be released with finalizeClusters before the instance.
+ *
+ * @param pInst[in]: The ACoAC instance
+ * @param pppClusters[out]: The array of the clusters, set only if there are at least two clusters
+ * @return The number of clusters, or 1 if all query attributes are in one cluster
+ */
+int splitIntoClusters(ACoACInstance *pInst, ACoACInstance ***pppClusters);
+
+/**
+ * Release the clusters returned by splitIntoClusters.
+ *
+ * @param clusters[in]: The array of the clusters
+ * @param nClusters[in]: The number of clusters
+ */
+void finalizeClusters(ACoACInstance **clusters, int nClusters);
+
+/**
+ * Combine the results of the clusters of an instance into the result of the instance: unreachable if some cluster
+ * is unreachable, reachable if all clusters are reachable, with the actions and rules of the clusters in order,
+ * otherwise the error or timeout of a cluster. The action and rule lists of the cluster results are released.
+ *
+ * @param results[in]: The results of the clusters
+ * @param nResults[in]: The number of results
+ * @return The combined result
+ */
+ACoACResult combineClusterResults(ACoACResult *results, int nResults);
+
+#endif // ACoAC_CLUSTER_H
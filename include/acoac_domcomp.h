@@ -0,0 +1,53 @@
+#ifndef ACoAC_DOMAIN_COMPRESSION_H
+#define ACoAC_DOMAIN_COMPRESSION_H
+
+#include "acoac_inst.h"
+
+/*
+ * The classes of equivalent values of the domain of an attribute. Two values are equivalent if every condition of
+ * the rules on the attribute is satisfied by both or by neither of them, and neither of them is a value of the
+ * attribute in the safety query. The representative of a class is its smallest value.
+ */
+typedef struct _ValueClasses {
+    int nValues;
+    // The values of the domain in ascending order
+    int *values;
+    // reps[i]: the representative of the class of values[i]
+    int *reps;
+} ValueClasses;
+
+/**
+ * Compress the domains of an ACoAC instance to one representative value per class of equivalent values.
+ * The domains and the value sets of the user conditions of the rules are restricted to the representatives,
+ * while the rules keep their target values, which are mapped to their representatives when the instance is
+ * translated. Replacing every value by its representative preserves the reachability of the safety query, since
+ * the conditions cannot tell the values of a class apart, so the instance needs fewer values to be model checked.
+ *
+ * Note: The value sets of the rules are modified in place (after being copied if they are shared, see getMutableRule),
+ * so it should be called on the instance to be translated, after it is pruned.
+ *
+ * @param pInst[in]: The ACoAC instance
+ */
+void compressDomains(ACoACInstance *pInst);
+
+/**
+ * Get the representative of the class of a value.
+ *
+ * @param pInst[in]: The ACoAC instance
+ * @param attrIdx[in]: The index of the attribute
+ * @param valIdx[in]: The index of the value
+ * @return The representative, or the value itself if the domain of the attribute is not compressed
+ */
+int getRepresentative(ACoACInstance *pInst, int attrIdx, int valIdx);
+
+/**
+ * Check if some rule of an ACoAC instance sets an attribute to a value of the class of a value.
+ *
+ * @param pInst[in]: The ACoAC instance
+ * @param attrIdx[in]: The index of the attribute
+ * @param valIdx[in]: The index of the value
+ * @return 1 if such a rule exists, 0 otherwise
+ */
+int isClassTarget(ACoACInstance *pInst, int attrIdx, int valIdx);
+
+#endif // ACoAC_DOMAIN_COMPRESSION_H
@@ -4,6 +4,10 @@
 #include "ccl/containers.h"
 #include "ccl/ccl_internal.h"
 #include "hashbasedtable.h"
+#include "initstate.h"
+#include "csrindex.h"
+#include "depgraph.h"
+#include "intmap.h"
 #include "acoac_rule.h"
 
 typedef struct _ACoACInstance
@@ -12,31 +16,50 @@ typedef struct _ACoACInstance
     Vector *pVecUserIndices;
     
     // A map from an attribute to its domain
-    // The attribute domain is a hashset of value indices
-    HashMap *pMapAttr2Dom;
+    // The attribute domain is a ValueSet of value indices
+    IntMap *pMapAttr2Dom;
 
     // A map from a user-attribute pair to the initial value
     // E.g., if in the initial state, the value of attribute a for user u is v, then (u, a) -> v
     HashBasedTable *pTableInitState;
+
+    // The initial state of all users in columns, built from pTableInitState by init and NULL before
+    InitState *pInitState;
     
     // List of rule indices
     HashSet *pSetRuleIdxes;
 
-    // A map from an attribute-value pair to a set of rules whose target is the pair
+    // An index from an attribute-value pair (the row is the attribute and the column is the value)
+    // to the rules whose target is the pair
     // E.g., if rule r=(cond1, cond2, a, v), then (a, v) -> {r}
-    HashBasedTable *pTableTargetAV2Rule;
+    // It is built from pSetRuleIdxes on first use and dropped by addRule, access it with getTargetAV2RuleIndex
+    CSRIndex *pIndexTargetAV2Rule;
 
-    // A map from an attribute-value pair to a set of rules for which the pair is necessary for the rule to fire
+    // An index from an attribute-value pair to the rules for which the pair is necessary for the rule to fire
     // Note: the admin condition is ignored
     // E.g., if rule r=(a'=v', a1=v1 & a2=v2, a3, v3), then (a1, v1) -> {r}, (a2, v2) -> {r}
-    HashBasedTable *pTablePrecond2Rule;
+    // It is built together with pIndexTargetAV2Rule, access it with getPrecond2RuleIndex
+    CSRIndex *pIndexPrecond2Rule;
+
+    // The dependency graph of the rules, with an edge from every pair of pIndexPrecond2Rule to the target of its rules
+    // It is built from the two indices on first use and dropped with them, access it with getDependencyGraph
+    DepGraph *pDepGraph;
+
+    // The arena that the rule indices pSetRuleIdxes, pIndexTargetAV2Rule, pIndexPrecond2Rule and pDepGraph are allocated in.
+    // The indices are rebuilt by every pruning pass and refinement round, and are released all at once by
+    // returning the arena to the pool with releaseRuleIndices
+    Arena *pArena;
     
     // The index of the target user in the safety query
     int queryUserIdx;
 
     // The attribute-value pairs in the safety query
     // E.g., if the safety query is "(u1, a1=v1 & a2=v2)", then pmapQueryAVs={(a1, v1), (a2, v2)}
-    HashMap *pmapQueryAVs;
+    IntMap *pmapQueryAVs;
+
+    // A map from an attribute to the classes of equivalent values of its domain (ValueClasses *), for the attributes
+    // whose domain is compressed by compressDomains. NULL if the domains are not compressed
+    IntMap *pMapAttr2Classes;
 } ACoACInstance;
 
 // A global string list storing all user names
@@ -58,12 +81,19 @@ extern strCollection *pscValues;
 extern Dictionary *pdictValue2Index;
 
 // A global map from attribute indices to their data types
-extern HashMap *pmapAttr2Type;
+extern IntMap *pmapAttr2Type;
 
 // A global map from attribute indices to the indices of their default values
-extern HashMap *pmapAttr2DefVal;
+extern IntMap *pmapAttr2DefVal;
+
+// A global list storing all distinct conditions (Condition), i.e., identical conditions are stored only once.
+// The condition at index TRUE_COND_IDX is the empty condition "TRUE"
+extern Vector *pVecConds;
 
-// A global list storing all rules (NOT rule pointers)
+// A global map from conditions (Condition) to their indices in the @{pVecConds} list
+extern HashMap *pmapCond2Index;
+
+// A global list storing all distinct rules (NOT rule pointers)
 extern Vector *pVecRules;
 
 /**
@@ -85,11 +115,20 @@ ACoACInstance *createACoACInstance();
 
 /**
  * Free the memory allocated for the instance and its members.
+ * The members that are shared with another instance must be set to NULL before.
  * 
  * @param pInst[in] A pointer to the ACoAC instance to be finalized
  */
 void finalizeACoACInstance(ACoACInstance *pInst);
 
+/**
+ * Release the rule indices of the instance (pSetRuleIdxes, pIndexTargetAV2Rule, pIndexPrecond2Rule and pDepGraph)
+ * by returning their arena to the pool. The indices must not be used afterwards.
+ * 
+ * @param pInst[in] A pointer to the ACoAC instance
+ */
+void releaseRuleIndices(ACoACInstance *pInst);
+
 /**
  * Get the index of a user in the global list of users @{pscUsers}.
  * 
@@ -122,6 +161,80 @@ int getAttrIndex(char *attr);
  */
 int getValueIndex(AttrType attrType, char *value, int *pValueIdx);
 
+/**
+ * Get the index of a condition in the global list of conditions @{pVecConds}.
+ * If the condition does not exist, it is added to the list. Otherwise, the given condition is finalized
+ * and the index of the existing identical condition is returned.
+ * 
+ * @param cond[in] A condition, i.e., a set of atomic conditions, owned by the global list after the call
+ * @return The index of the condition
+ */
+int getConditionIndex(HashSet *cond);
+
+/**
+ * Get a condition by its index in the global list of conditions @{pVecConds}.
+ * 
+ * @param condIdx[in] The index of the condition
+ * @return The set of atomic conditions, which should not be modified
+ */
+HashSet *getCondition(int condIdx);
+
+/**
+ * Get a condition compiled to interval tests by its index, one test per atomic condition.
+ * 
+ * @param condIdx[in] The index of the condition
+ * @param pnTests[out] The number of tests
+ * @return The tests, which should not be modified
+ */
+IntervalTest *getConditionTests(int condIdx, int *pnTests);
+
+/**
+ * Get the hash code of a condition by its index, which is computed only once when the condition is added.
+ * 
+ * @param condIdx[in] The index of the condition
+ * @return The hash code of the condition
+ */
+unsigned int getConditionHashCode(int condIdx);
+
+/**
+ * Get the index of a rule in the global list of rules @{pVecRules}.
+ * If the rule does not exist, it is added to the list, so identical rules are merged into one.
+ * 
+ * @param adminCondIdx[in] The index of the admin condition
+ * @param userCondIdx[in] The index of the user condition
+ * @param targetAttrIdx[in] The index of the target attribute
+ * @param targetValueIdx[in] The index of the target value
+ * @return The index of the rule
+ */
+int getRuleIndex(int adminCondIdx, int userCondIdx, int targetAttrIdx, int targetValueIdx);
+
+/**
+ * Fork a rule list, e.g., for a round of abstraction refinement. The fork is a copy of the rules that shares the
+ * value sets of their user conditions with @{pVecBase} until they are modified: a rule of the fork must be fetched
+ * with getMutableRule before its value sets are modified, so that @{pVecBase} is never modified through the fork.
+ * Note: only one fork of @{pVecBase} can be used at a time, and it should be made the global rule list @{pVecRules}.
+ * 
+ * @param pVecBase[in] The rule list to fork
+ * @return The fork, which should be released with releaseRuleList
+ */
+Vector *forkRuleList(Vector *pVecBase);
+
+/**
+ * Get a rule of the global rule list @{pVecRules} to modify the value sets of its user condition.
+ * If the list is a fork and the value sets of the rule are shared with the base list, they are copied first.
+ * 
+ * @param ruleIdx[in] The index of the rule
+ * @return The rule, whose user condition can be modified
+ */
+Rule *getMutableRule(int ruleIdx);
+
+/**
+ * Release a fork returned by forkRuleList, with the value sets copied by getMutableRule.
+ * 
+ * @param pVecFork[in] The fork
+ */
+void releaseRuleList(Vector *pVecFork);
+
 /**
  * Get the datatype of an attribute.
  * 
@@ -184,9 +297,20 @@ int addUAV(ACoACInstance *pInst, char *user, char *attr, char *value);
  */
 int addUAVByIdx(ACoACInstance *pInst, int userIdx, int attrIdx, int valueIdx);
 
+/**
+ * Get the domain of an attribute in @{pMapAttr2Dom} of the ACoAC instance.
+ * If the attribute has no domain yet, an empty domain is created.
+ * 
+ * @param pInst[in] The ACoAC instance
+ * @param attrIdx[in] The index of the attribute
+ * @return The domain of the attribute, owned by the instance
+ */
+ValueSet *getOrCreateDomain(ACoACInstance *pInst, int attrIdx);
+
 /**
  * Add a rule index to the list of rule indices @{pSetRuleIdxes} of the ACoAC instance.
- * The attribute domain @{pMapAttr2Dom}, tables @{pTableTargetAV2Rule} and @{pTablePrecond2Rule} are updated accordingly.
+ * The attribute domain @{pMapAttr2Dom} is updated accordingly, and the indices @{pIndexTargetAV2Rule},
+ * @{pIndexPrecond2Rule} and the graph @{pDepGraph} are dropped so that they are rebuilt on their next use.
  * 
  * @param pInst[in] The ACoAC instance
  * @param ruleIdx[in] The index of the rule
@@ -194,6 +318,16 @@ int addUAVByIdx(ACoACInstance *pInst, int userIdx, int attrIdx, int valueIdx);
  */
 int addRule(ACoACInstance *pInst, int ruleIdx);
 
+/**
+ * Add the rules of another ACoAC instance and the values of its domains, reusing the hash codes of the rules stored
+ * in its @{pSetRuleIdxes}, so the conditions of its rules must not have been modified since they were added to it.
+ * 
+ * @param pInst[in] The ACoAC instance
+ * @param pSrc[in] The instance whose rules are added
+ * @return 1 if any rule is added, 0 otherwise
+ */
+int addRulesOf(ACoACInstance *pInst, ACoACInstance *pSrc);
+
 /**
  * Initialize the ACoAC instance.
  * 
@@ -201,6 +335,34 @@ int addRule(ACoACInstance *pInst, int ruleIdx);
  */
 void init(ACoACInstance *pInst);
 
+/**
+ * Get the index from attribute-value pairs to the rules of the instance whose target is the pair.
+ * The index is built from @{pSetRuleIdxes} if the rules have changed since it was last built.
+ * Note: removing rules from @{pSetRuleIdxes} directly does not drop the index.
+ * 
+ * @param pInst[in] The ACoAC instance
+ * @return The index, in which the row is the attribute index and the column is the value index
+ */
+CSRIndex *getTargetAV2RuleIndex(ACoACInstance *pInst);
+
+/**
+ * Get the index from attribute-value pairs to the rules of the instance whose user condition needs the pair.
+ * The index is built in the same way as the one returned by getTargetAV2RuleIndex.
+ * 
+ * @param pInst[in] The ACoAC instance
+ * @return The index, in which the row is the attribute index and the column is the value index
+ */
+CSRIndex *getPrecond2RuleIndex(ACoACInstance *pInst);
+
+/**
+ * Get the dependency graph of the rules of the instance, in which the target pairs are numbered as the cells of
+ * the index returned by getTargetAV2RuleIndex. The graph is built in the same way as the index.
+ * 
+ * @param pInst[in] The ACoAC instance
+ * @return The dependency graph
+ */
+DepGraph *getDependencyGraph(ACoACInstance *pInst);
+
 /**
  * Convert a rule to a string. Used for printing the rule.
  * 
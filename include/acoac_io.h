@@ -11,6 +11,18 @@
  */
 ACoACInstance *readACoACInstance(char *filename);
 
+/**
+ * Read an ACoAC instance from a file by mapping it into memory.
+ * The sections are tokenized in place without copying lines, and the
+ * resulting instance and global variables are the same as those built by readACoACInstance.
+ * With more than one thread, the Rules section is split into chunks that are parsed in parallel.
+ * 
+ * @param filename[in]: The path of the file to read
+ * @param nThreads[in]: The number of threads for parsing the Rules section, 1 for parsing sequentially
+ * @return The ACoAC instance, or NULL if failed
+ */
+ACoACInstance *readACoACInstanceMmap(char *filename, int nThreads);
+
 /**
  * Read an ARBAC instance from a file and convert it to an ACoAC instance
  * 
@@ -28,4 +40,32 @@ ACoACInstance *readARBACInstance(char *filename);
  */
 int writeACoACInstance(ACoACInstance *pInst, char *filename);
 
+/**
+ * Compile an ACoAC instance into a versioned binary file, which holds the interned string tables,
+ * the attribute types and default values, the flattened atom conditions of all rules, the initial state and the query
+ * 
+ * @param pInst[in]: The ACoAC instance to compile
+ * @param filename[in]: The path of the file to write
+ * @return 0 if write successfully, error code if failed
+ */
+int writeCompiledInstance(ACoACInstance *pInst, char *filename);
+
+/**
+ * Compile an ACoAC instance into a buffer, in the same format as the file written by writeCompiledInstance.
+ * 
+ * @param pInst[in]: The ACoAC instance to compile
+ * @param pSize[out]: The size of the buffer
+ * @return The buffer, which should be freed by the caller, or NULL if failed
+ */
+char *compileInstance(ACoACInstance *pInst, size_t *pSize);
+
+/**
+ * Load an ACoAC instance from a binary file generated by writeCompiledInstance.
+ * The file is mapped into memory and the sections are read in place without parsing
+ * 
+ * @param filename[in]: The path of the file to read
+ * @return The ACoAC instance, or NULL if the file is invalid or of an unsupported version
+ */
+ACoACInstance *readCompiledInstance(char *filename);
+
 #endif // _ACoACIO_H
\ No newline at end of file
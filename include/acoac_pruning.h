@@ -3,8 +3,32 @@
 
 #include "analysis_result.h"
 
+/**
+ * Set the number of threads that check in parallel whether the rules can be fired, in the forward slicing of
+ * slice() and sliceIncremental(). The results do not depend on the number of threads (default 1).
+ */
+void setSlicingThreads(int nThreads);
+
 ACoACInstance *userCleaning(ACoACInstance *pInst);
 
 ACoACInstance *slice(ACoACInstance *pInst, ACoACResult *pResult);
 
+/**
+ * Slice the instance in place with a worklist instead of rebuilding it in every pass of slice().
+ * The result is the same as slice(): the same rules with the same discretized conditions, domains,
+ * initial state, query and result code.
+ * Both slicers end by removing the rules subsumed by a weaker rule with the same target attribute value.
+ */
+ACoACInstance *sliceIncremental(ACoACInstance *pInst, ACoACResult *pResult);
+
+/**
+ * Remove the rules subsumed by a weaker rule with the same target attribute value, i.e., a rule whose admin condition
+ * is true or the same, and whose user condition allows every value allowed by the other rule. Of the rules with the
+ * same conditions, the one with the lowest index is kept. It is called at the end of slice() and sliceIncremental().
+ *
+ * @param pInst[in]: The initialized instance, modified in place
+ * @return The number of rules removed
+ */
+int removeSubsumedRules(ACoACInstance *pInst);
+
 #endif // _ACoAC_PRUNING_H
@@ -3,6 +3,8 @@
 
 #include "ccl/containers.h"
 #include "hashset.h"
+#include "intmap.h"
+#include "valueset.h"
 
 /* The comparison operator. {=, !=, <, >, <=, >=} */
 typedef enum {
@@ -28,20 +30,49 @@ typedef struct {
     comparisonOperator op;
 } AtomCondition;
 
-/* A rule, consisting of an administrator condition, a user condition, a target attribute, and a target value. */
+/* An atomic condition compiled to an interval test: a value v satisfies it iff (lo <= v && v <= hi) != negated.
+   "=" and "!=" test the interval [c, c], the latter negated, and the orderings test intervals bounded on one side,
+   so a condition is evaluated without branching on its operator. The interval is empty when lo > hi. */
+typedef struct {
+    int attribute;
+    int lo;
+    int hi;
+    int negated;
+} IntervalTest;
+
+/* Evaluate the interval test @{pTest} on the value @{v} without branching, to 0 or 1 */
+#define INTERVAL_TEST(pTest, v) ((((v) >= (pTest)->lo) & ((v) <= (pTest)->hi)) ^ (pTest)->negated)
+
+/* A hash-consed condition, i.e., a conjunction of atomic conditions shared by all rules with the same condition. */
+typedef struct _Condition {
+    // The atomic conditions (AtomCondition), never modified once the condition is added to the global condition list
+    HashSet *pSetAtomConds;
+    // The cached hash code of @{pSetAtomConds}
+    unsigned int hashCode;
+    // The atomic conditions compiled to interval tests, in the iteration order of @{pSetAtomConds}
+    IntervalTest *tests;
+    int nTests;
+} Condition;
+
+/* The index of the condition "TRUE" (the empty condition) in the global condition list */
+#define TRUE_COND_IDX 0
+
+/* A rule, consisting of an administrator condition, a user condition, a target attribute, and a target value.
+   The conditions are referenced by their indices in the global condition list. */
 typedef struct _Rule {
-    HashSet *adminCond;
-    HashSet *userCond;
+    int adminCondIdx;
+    int userCondIdx;
     int targetAttrIdx;
     int targetValueIdx;
 
-    // The map from an attribute to the set of its values that can satisfy the user condition
+    // The map from an attribute to the set of its values (ValueSet *) that can satisfy the user condition
     HashMap *pmapUserCondValue;
 } Rule;
 
 typedef struct _AtomConditionInterface {
     int (*Evaluate)(AtomCondition *atomCond, int valIdx);
-    void (*FindEffectiveValues)(AtomCondition *atomdCond, HashSet *domain, HashSet *effectiveValues);
+    void (*FindEffectiveValues)(AtomCondition *atomdCond, ValueSet *domain, ValueSet *effectiveValues);
+    void (*Compile)(AtomCondition *atomCond, IntervalTest *test);
     unsigned int (*HashCode)(void *pAtomCond);
     int (*Equal)(void *pAtomCond1, void *pAtomCond2);
 } AtomConditionInterface;
@@ -49,10 +80,10 @@ typedef struct _AtomConditionInterface {
 extern AtomConditionInterface iAtomCondition;
 
 typedef struct _RuleInterface {
-    Rule *(*Create)(HashSet *adminCond, HashSet *userCond, int targetAttrIdx, int targetValueIdx);
-    int (*DiscreteCond)(Rule *r, HashMap *reachableAVs);
+    Rule *(*Create)(int adminCondIdx, int userCondIdx, int targetAttrIdx, int targetValueIdx);
+    int (*DiscreteCond)(Rule *r, IntMap *reachableAVs);
     int (*CanBeManaged)(Rule *r, HashMap *userState);
-    int (*IsEffective)(Rule *r, HashMap *reachableAVs);
+    int (*IsEffective)(Rule *r, IntMap *reachableAVs);
     unsigned int (*HashCode)(void *pRule);
     int (*Equal)(void *pRule1, void *pRule2);
 } RuleInterface;
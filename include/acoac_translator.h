@@ -8,4 +8,19 @@
 
 int translate(ACoACInstance *instance, char *nusmvFilePath, int sliced);
 
+/**
+ * Translate an ACoAC instance into a NuSMV file as translate does, followed by the probes of some attribute values,
+ * i.e., one INVARSPEC per attribute value stating that the query user never takes it. NuSMV checks the invariants
+ * in order, and an invariant is violated if and only if its attribute value is reachable (see analyzeProbeResults).
+ *
+ * @param instance[in]: The ACoAC instance
+ * @param nusmvFilePath[in]: The path of the NuSMV file
+ * @param sliced[in]: Whether the instance is sliced, otherwise the domains of the attributes are computed
+ * @param probeAttrs[in]: The attributes of the probed attribute values
+ * @param probeVals[in]: The values of the probed attribute values, which must be in the domains of the attributes
+ * @param nProbes[in]: The number of probes
+ * @return 0 if success, -1 otherwise
+ */
+int translateWithProbes(ACoACInstance *instance, char *nusmvFilePath, int sliced, int *probeAttrs, int *probeVals, int nProbes);
+
 #endif // _ACoAC_TRANSLATOR_H
\ No newline at end of file
@@ -20,12 +20,18 @@ unsigned int IntHashCode(void *pInt);
 
 int IntEqual(void *pInt1, void *pInt2);
 
+// Compare two ints for qsort, in ascending order
+int compareInts(const void *p1, const void *p2);
+
 char *IntToString(void *pInt);
 
 char *StringToString(void *pStr);
 
 void logACoAC(const char *func, int line, int logType, LogLevel logLevel, const char *format, ...);
 
+// The wall-clock time in milliseconds from an arbitrary point, for measuring the time spent waiting for other processes
+double wallClockMs();
+
 char *mapToString(HashMap *map, char *(*keyToString)(void *key), char *(*valueToString)(void *value));
 
 #endif // ACoACUTILS_H
\ No newline at end of file
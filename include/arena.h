@@ -0,0 +1,43 @@
+#ifndef _ARENA_H
+#define _ARENA_H
+
+#include <stddef.h>
+
+/*
+ * A region allocator. Memory is handed out by bumping a pointer through a list of chunks and is never freed
+ * piece by piece: all the blocks allocated in an arena are released together by Reset, which keeps the chunks
+ * for the next allocations, or by Finalize.
+ *
+ * Arenas are recycled through a global pool: Acquire takes a reset arena from the pool (or creates one) and
+ * Release resets an arena and puts it back, so the chunks of a released arena are reused by the next Acquire.
+ * The pool is thread-safe, but an arena itself must be used by one thread at a time.
+ */
+typedef struct _ArenaChunk {
+    struct _ArenaChunk *next;
+    size_t size;
+    size_t used;
+    // The memory of the chunk follows the header
+} ArenaChunk;
+
+typedef struct _Arena {
+    ArenaChunk *head;
+    // The chunk that the allocations are currently bumped in
+    ArenaChunk *current;
+    // The total size of the chunks
+    size_t capacity;
+    // The next arena in the pool
+    struct _Arena *nextFree;
+} Arena;
+
+typedef struct _ArenaInterface {
+    Arena *(*Create)();                       // 创建空的内存区域
+    void *(*Alloc)(Arena *arena, size_t size); // 分配一块内存，该内存不能单独释放
+    void (*Reset)(Arena *arena);              // 一次性释放所有已分配的内存，保留内存块供后续分配使用
+    void (*Finalize)(Arena *arena);           // 释放内存区域及其所有内存块
+    Arena *(*Acquire)();                      // 从全局池中取出一个空的内存区域，池为空时创建新的内存区域
+    void (*Release)(Arena *arena);            // 重置内存区域并放回全局池
+} ArenaInterface;
+
+extern ArenaInterface iArena;
+
+#endif // _ARENA_H
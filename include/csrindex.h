@@ -0,0 +1,45 @@
+#ifndef _CSRINDEX_H
+#define _CSRINDEX_H
+
+#include "arena.h"
+
+/*
+ * An entry of a CSRIndex: the element @{elem} belongs to the cell (@{row}, @{col})
+ */
+typedef struct _CSREntry {
+    int row;
+    int col;
+    int elem;
+} CSREntry;
+
+/*
+ * An immutable index from (row, column) pairs of ints to lists of ints, in the compressed sparse row format.
+ * The rows are dense (0, ..., nRows - 1) and the columns of a row are sparse, so an index is three flat arrays:
+ *      the non-empty cells of row r are rowStart[r], ..., rowStart[r + 1] - 1, and their columns cols[c] are ascending;
+ *      the elements of cell c are elems[cellStart[c]], ..., elems[cellStart[c + 1] - 1], in the order of their entries.
+ * It is built by sorting the entries by row and by column with counting sorts, so the build time is linear in the
+ * number of entries as long as the columns of a row are not much sparser than its entries.
+ * A lookup is a binary search among the columns of a row and returns a pointer into elems, so it allocates nothing.
+ *
+ * The cells of a row can be iterated directly:
+ *      for (c = index->rowStart[r]; c < index->rowStart[r + 1]; c++) { ... index->cols[c] ... }
+ */
+typedef struct _CSRIndex {
+    int nRows;
+    int nCells;
+    int *rowStart;
+    int *cols;
+    int *cellStart;
+    int *elems;
+} CSRIndex;
+
+typedef struct _CSRIndexInterface {
+    CSRIndex *(*Build)(Arena *arena, int nRows, CSREntry *entries, int nEntries); // 由条目构建索引，所有内存分配在arena中，条目的行号须在[0, nRows)内
+    int (*Find)(CSRIndex *index, int row, int col);                               // 获取单元格的编号，若单元格为空则返回-1
+    int (*Get)(CSRIndex *index, int row, int col, int **ppElems);                 // 获取单元格的元素，*ppElems指向第一个元素，返回元素数量，若单元格为空则返回0
+    int (*CellSize)(CSRIndex *index, int cell);                                   // 获取编号为cell的单元格的元素数量
+} CSRIndexInterface;
+
+extern CSRIndexInterface iCSRIndex;
+
+#endif // _CSRINDEX_H
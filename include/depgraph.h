@@ -0,0 +1,57 @@
+#ifndef _DEPGRAPH_H
+#define _DEPGRAPH_H
+
+#include "csrindex.h"
+
+/*
+ * The dependency graph of the rules of an instance. A node is an attribute-value pair that is the target of a rule
+ * or in the user condition of a rule, and a rule r=(cond1, cond2, a, v) adds an edge labelled r from every pair of
+ * its user condition to (a, v), i.e., an edge u -> v means that u may be necessary to reach v.
+ * The graph is built from the two indices of the instance (see getTargetAV2RuleIndex and getPrecond2RuleIndex):
+ *      the pair of the cell c of the target index is the node c, so the target pairs are the nodes 0, ..., nTargets - 1;
+ *      the other pairs of the precondition index are the nodes nTargets, ..., nNodes - 1.
+ * An edge is identified by its entry in the precondition index, i.e., the edge i is labelled with the rule
+ * pIndexPrecond->elems[i]. The edges are stored in the compressed sparse row format in both directions: the out-edges
+ * of the node u are outStart[u], ..., outStart[u + 1] - 1, going to outAdj[e] with the id outEdge[e], and the same
+ * for the in-edges.
+ *
+ * The strongly connected components (SCCs) are computed by an iterative Tarjan algorithm and are numbered in
+ * topological order, i.e., sccOf[u] <= sccOf[v] for every edge u -> v, and the nodes of the SCC k are
+ * sccNodes[sccStart[k]], ..., sccNodes[sccStart[k + 1] - 1].
+ */
+typedef struct _DepGraph {
+    int nNodes;
+    int nTargets;
+    int nEdges;
+    // The attribute-value pair of each node
+    int *nodeAttr;
+    int *nodeVal;
+    // The indices the graph is built from, used to find the node of a pair
+    CSRIndex *pIndexTarget;
+    CSRIndex *pIndexPrecond;
+    // The node of each cell of the precondition index
+    int *precondNode;
+    int *outStart;
+    int *outAdj;
+    int *outEdge;
+    int *inStart;
+    int *inAdj;
+    int *inEdge;
+    int nSCCs;
+    int *sccOf;
+    int *sccStart;
+    int *sccNodes;
+} DepGraph;
+
+typedef struct _DepGraphInterface {
+    DepGraph *(*Build)(Arena *arena, CSRIndex *pIndexTarget, CSRIndex *pIndexPrecond);                   // 由两个规则索引构建依赖图并计算强连通分量，所有内存分配在arena中
+    int (*Find)(DepGraph *g, int attrIdx, int valIdx);                                                    // 获取属性值对的节点，若不在图中则返回-1
+    int (*InCycle)(DepGraph *g, int node);                                                                // 节点是否在环上，即所在强连通分量有多个节点或有自环
+    int (*IsReachable)(DepGraph *g, int from, int to);                                                    // 是否存在从from到to的路径
+    int (*Forward)(DepGraph *g, int *seeds, int nSeeds, const char *edgeLive, char *visited);            // 标记从种子节点出发可达的节点，edgeLive非空时只经过edgeLive[边编号]非零的边，返回新标记的节点数
+    int (*Backward)(DepGraph *g, int *seeds, int nSeeds, const char *edgeLive, char *visited);           // 标记可以到达种子节点的节点，其余同Forward
+} DepGraphInterface;
+
+extern DepGraphInterface iDepGraph;
+
+#endif // _DEPGRAPH_H
@@ -11,10 +11,13 @@ typedef struct _HashBasedTable {
     KeyEqual colKeyEqual;
     DestructFn destructCol;
     DestructFn destructValue;
+    // The arena that the table and all of its row and column maps are allocated in, or NULL
+    Arena *arena;
 } HashBasedTable;
 
 typedef struct _HashBasedTableInterface {
     HashBasedTable *(*Create)(int rowKeySize, int colKeySize, int valueSize, Hashcode rowHashCode, KeyEqual rowKeyEqual, Hashcode colHashCode, KeyEqual colKeyEqual);
+    HashBasedTable *(*CreateInArena)(Arena *arena, int rowKeySize, int colKeySize, int valueSize, Hashcode rowHashCode, KeyEqual rowKeyEqual, Hashcode colHashCode, KeyEqual colKeyEqual);
     int (*Put)(HashBasedTable *hashTable, void *rowKey, void *colKey, void *value);
     void *(*Get)(HashBasedTable *hashTable, void *rowKey, void *colKey);
     HashMap *(*GetRow)(HashBasedTable *hashTable, void *rowKey);
@@ -1,6 +1,8 @@
 #ifndef _HASHMAP_H
 #define _HASHMAP_H
 
+#include "arena.h"
+
 typedef struct _HashNode {
     unsigned int hash;      // 哈希值
     void *key;              // 键
@@ -28,8 +30,19 @@ typedef struct _HashMap {
     ValueToString valueToString;
     DestructFn destructKey;
     DestructFn destructValue;
+    // The arena that the map, its table and its nodes are allocated in, or NULL if they are allocated by malloc.
+    // The memory of an arena-backed map is released by resetting the arena, so removing entries and finalizing
+    // the map only run the destructors.
+    Arena *arena;
 } HashMap;
 
+/*
+ * An iterator over a HashMap. It is either allocated by NewIterator and freed by DeleteIterator,
+ * or allocated by the caller (e.g., on the stack) and initialized by InitIterator:
+ *      HashNodeIterator it;
+ *      iHashMap.InitIterator(map, &it);
+ *      while (it.HasNext(&it)) { HashNode *node = it.GetNext(&it); ... }
+ */
 typedef struct _HashNodeIterator {
     int (*HasNext)(struct _HashNodeIterator *it);   // 是否还有下一个元素函数
     void *(*GetNext)(struct _HashNodeIterator *it); // 获取下一个元素函数
@@ -42,7 +55,9 @@ typedef struct _HashNodeIterator {
 
 typedef struct _HashMapInterface {
     HashMap *(*Create)(int keySize, int valueSize, Hashcode hashCode, KeyEqual keyEqual); // 创建哈希表函数
+    HashMap *(*CreateInArena)(Arena *arena, int keySize, int valueSize, Hashcode hashCode, KeyEqual keyEqual); // 在内存区域中创建哈希表函数，arena为NULL时等同于Create
     int (*Put)(HashMap *hashMap, void *key, void *value);                                    // 添加键值对函数
+    int (*PutAll)(HashMap *hashMap, HashMap *hashMap2);                                      // 添加另一个哈希函数相同的哈希表的所有键值对，复用其节点中的哈希值，返回是否有键被添加
     int (*ContainsKey)(HashMap *hashMap, void *key);                                         // 判断键是否存在函数
     void *(*Get)(HashMap *hashMap, void *key);                                               // 获取键值对函数
     void *(*GetOrDefault)(HashMap *hashMap, void *key, void *defaultValue);               // 获取键值对函数，若不存在则返回默认值
@@ -57,6 +72,7 @@ typedef struct _HashMapInterface {
     void (*DestructPointer)(void *pHashMap);
     HashNodeIterator *(*NewIterator)(HashMap *hashMap);                                   // 创建迭代器函数
     HashNodeIterator *(*DeleteIterator)(HashNodeIterator *it);                            // 删除迭代器函数
+    void (*InitIterator)(HashMap *hashMap, HashNodeIterator *it);                         // 初始化调用者提供的迭代器（如栈上的迭代器），无需删除
     int (*HashCode)(HashMap *hashMap);                                                    // 获取哈希值函数
     int (*Equal)(HashMap *hashMap, HashMap *hashMap2);                                    // 判断两个哈希表是否相等函数
 } HashMapInterface;
@@ -9,7 +9,9 @@ typedef HashNodeIterator HashSetIterator;
 
 typedef struct _HashSetInterface {
     HashSet *(*Create)(int valueSize, Hashcode hashCode, KeyEqual keyEqual); // 创建HashSet
+    HashSet *(*CreateInArena)(Arena *arena, int valueSize, Hashcode hashCode, KeyEqual keyEqual); // 在内存区域中创建HashSet，arena为NULL时等同于Create
     int (*Add)(HashSet *hashSet, void *newval);
+    int (*AddAll)(HashSet *hashSet1, HashSet *hashSet2); // 并集，两个集合的哈希函数须相同，复用hashSet2节点中的哈希值
     int (*Contains)(HashSet *hashSet, void *element);
     int (*containsAll)(HashSet *hashSet1, HashSet *hashSet2);
     unsigned int (*HashCode)(void *hashSet);
@@ -26,6 +28,7 @@ typedef struct _HashSetInterface {
     void (*DestructPointer)(void *pHashSet);
     HashSetIterator *(*NewIterator)(HashSet *hashSet);
     HashSetIterator *(*DeleteIterator)(HashSetIterator *it);
+    void (*InitIterator)(HashSet *hashSet, HashSetIterator *it); // 初始化调用者提供的迭代器（如栈上的迭代器），无需删除
 } HashSetInterface;
 
 extern HashSetInterface iHashSet;
@@ -0,0 +1,42 @@
+#ifndef _INITSTATE_H
+#define _INITSTATE_H
+
+#include <stdint.h>
+
+#include "acoac_rule.h"
+#include "hashbasedtable.h"
+#include "intmap.h"
+
+/*
+ * The initial state of all users in columns: one contiguous int array per attribute, indexed by user and
+ * filled with the default value of the attribute where the user does not list it. A lookup is a single array
+ * access instead of a probe of the user's row and a probe of the default values, and an atomic condition compiled
+ * to an interval test is evaluated for a range of users by a branch-free pass over a column, 8 users per
+ * instruction when compiled with AVX2.
+ *
+ * The columns have one more entry, at index nUsers, for a user whose attributes all take their default values.
+ * The columns are never modified once built.
+ */
+typedef struct _InitState {
+    int nUsers;
+    int nAttrs;
+    // columns[a][u]: the initial value of the attribute a for the user u, 0 <= u <= nUsers
+    int **columns;
+    // The number of users listing the attribute a in the initial state
+    int *nListed;
+    // The number of users listing at least one attribute
+    int nRows;
+    // The block of the columns
+    int *values;
+} InitState;
+
+typedef struct _InitStateInterface {
+    InitState *(*Create)(HashBasedTable *pTableInitState, int nUsers, int nAttrs, IntMap *pmapAttr2DefVal); // 由初始状态表构建列存储
+    int (*Get)(InitState *state, int userIdx, int attrIdx);                                             // 获取用户的属性初始值
+    void (*EvalAtom)(InitState *state, IntervalTest *test, int from, int n, uint64_t *bits);            // 对用户from, ..., from + n - 1计算原子条件的区间测试，结果按位写入bits
+    void (*Finalize)(InitState *state);                                                                 // 释放列存储
+} InitStateInterface;
+
+extern InitStateInterface iInitState;
+
+#endif // _INITSTATE_H
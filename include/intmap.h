@@ -0,0 +1,68 @@
+#ifndef _INTMAP_H
+#define _INTMAP_H
+
+#include <limits.h>
+
+#include "hashmap.h"
+
+// 两个保留的键，分别用于标记空槽位与已删除的槽位，不能作为IntMap的键
+#define INTMAP_EMPTY_KEY INT_MIN
+#define INTMAP_DELETED_KEY (INT_MIN + 1)
+
+/*
+ * An open-addressing hash map from int keys to fixed-size values.
+ * The keys and values are stored inline in two flat arrays, so no memory is allocated per entry,
+ * and the keys are hashed and compared directly instead of through function pointers.
+ * Collisions are resolved by linear probing, and a removed entry leaves a tombstone which is reclaimed on resizing.
+ *
+ * A key is hashed to itself as IntHashCode does, and the table grows like a HashMap (16 slots initially,
+ * doubled when 3/4 full), so dense small keys such as attribute indices never collide and are iterated
+ * in the same order as in a HashMap created with IntHashCode.
+ *
+ * Note: the value pointers returned by Get are invalidated by a subsequent Put.
+ */
+typedef struct _IntMap {
+    int *keys;
+    char *values;
+    int capacity;
+    int size;
+    // The number of tombstones
+    int nDeleted;
+    int valueSize;
+    DestructFn destructValue;
+} IntMap;
+
+/*
+ * An iterator over an IntMap, which can be allocated on the stack. Usage:
+ *      IntMapIterator it;
+ *      iIntMap.InitIterator(map, &it);
+ *      while (iIntMap.Next(&it)) { ... it.key ... it.value ... }
+ */
+typedef struct _IntMapIterator {
+    IntMap *map;
+    // The slot of the current entry
+    int index;
+    // The key of the current entry
+    int key;
+    // A pointer to the value of the current entry
+    void *value;
+} IntMapIterator;
+
+typedef struct _IntMapInterface {
+    IntMap *(*Create)(int valueSize);                                       // 创建哈希表
+    int (*Put)(IntMap *map, int key, void *value);                          // 添加键值对，若键已存在则覆盖其值并返回1，否则返回0
+    void *(*Get)(IntMap *map, int key);                                     // 获取键对应值的指针，若键不存在则返回NULL
+    int (*ContainsKey)(IntMap *map, int key);                               // 判断键是否存在
+    int (*Remove)(IntMap *map, int key);                                    // 删除键值对，若键存在则返回1，否则返回0
+    void (*Clear)(IntMap *map);                                             // 清空哈希表
+    int (*Size)(IntMap *map);                                               // 获取键值对数量
+    void (*Finalize)(IntMap *map);                                          // 释放哈希表
+    DestructFn (*SetDestructValue)(IntMap *map, DestructFn destructValue);  // 设置值析构函数，参数为指向值的指针
+    void (*InitIterator)(IntMap *map, IntMapIterator *it);                  // 初始化迭代器
+    int (*Next)(IntMapIterator *it);                                        // 移动到下一个键值对，若没有更多键值对则返回0
+    void (*RemoveCurrent)(IntMapIterator *it);                              // 删除迭代器当前指向的键值对
+} IntMapInterface;
+
+extern IntMapInterface iIntMap;
+
+#endif // _INTMAP_H
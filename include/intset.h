@@ -0,0 +1,27 @@
+#ifndef _INTSET_H
+#define _INTSET_H
+
+#include "intmap.h"
+
+/*
+ * An open-addressing hash set of ints, which is an IntMap without values.
+ */
+typedef IntMap IntSet;
+
+typedef IntMapIterator IntSetIterator;
+
+typedef struct _IntSetInterface {
+    IntSet *(*Create)();                                    // 创建IntSet
+    int (*Add)(IntSet *set, int element);                   // 添加元素，若元素原本不存在则返回1，否则返回0
+    int (*Contains)(IntSet *set, int element);              // 判断元素是否存在
+    int (*Remove)(IntSet *set, int element);                // 删除元素，若元素存在则返回1，否则返回0
+    void (*Clear)(IntSet *set);                             // 清空集合
+    int (*Size)(IntSet *set);                               // 获取元素数量
+    void (*Finalize)(IntSet *set);                          // 释放集合
+    void (*InitIterator)(IntSet *set, IntSetIterator *it);  // 初始化迭代器，当前元素为it->key
+    int (*Next)(IntSetIterator *it);                        // 移动到下一个元素，若没有更多元素则返回0
+} IntSetInterface;
+
+extern IntSetInterface iIntSet;
+
+#endif // _INTSET_H
@@ -6,4 +6,17 @@
 char *runModelChecker(char *modelCheckerPath, char *nusmvFilePath, char *resultFilePath, long timeout, char *bound);
 ACoACResult analyzeModelCheckerOutput(char *output, ACoACInstance *pInst, char *boundStr, int showRules);
 
+/**
+ * Analyze the results of the probes of a NuSMV file (see translateWithProbes) in the output of the model checker,
+ * i.e., the lines "-- invariant ... is true|false" in the order of the probes. A probe is reachable if its invariant
+ * is false, or if the model checker cannot tell. The output is not modified, so it should be called before
+ * analyzeModelCheckerOutput.
+ *
+ * @param output[in]: The output of the model checker
+ * @param nProbes[in]: The number of probes
+ * @param reachable[out]: Whether the attribute value of each probe is reachable
+ * @return 0 if the results of all the probes are found, -1 otherwise
+ */
+int analyzeProbeResults(char *output, int nProbes, char *reachable);
+
 #endif // NUSMV_RUNNER_H
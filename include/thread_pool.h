@@ -0,0 +1,38 @@
+#ifndef _THREAD_POOL_H
+#define _THREAD_POOL_H
+
+#include <pthread.h>
+
+typedef void (*TaskFn)(void *arg);
+
+typedef struct _Task {
+    TaskFn fn;
+    void *arg;
+    struct _Task *next;
+} Task;
+
+typedef struct _ThreadPool {
+    pthread_t *threads;
+    int nThreads;
+    // The FIFO queue of the submitted tasks that are not started yet
+    Task *head;
+    Task *tail;
+    // The number of tasks that are queued or running
+    int nUnfinished;
+    int shutdown;
+    pthread_mutex_t lock;
+    pthread_cond_t taskAvailable;
+    pthread_cond_t allFinished;
+} ThreadPool;
+
+typedef struct _ThreadPoolInterface {
+    ThreadPool *(*Create)(int nThreads);                       // 创建线程池
+    int (*Submit)(ThreadPool *pool, TaskFn fn, void *arg);     // 提交任务，任务按提交顺序开始执行
+    void (*Wait)(ThreadPool *pool);                            // 等待所有已提交的任务执行完毕
+    void (*Finalize)(ThreadPool *pool);                        // 等待所有任务执行完毕后销毁线程池
+    int (*NumCores)();                                         // 获取可用的CPU核数
+} ThreadPoolInterface;
+
+extern ThreadPoolInterface iThreadPool;
+
+#endif // _THREAD_POOL_H
@@ -0,0 +1,42 @@
+#ifndef _USERINDEX_H
+#define _USERINDEX_H
+
+#include <stdint.h>
+
+#include "arena.h"
+#include "initstate.h"
+
+/*
+ * An inverted index of the initial state in columns (InitState), from an attribute-value pair to the bitmap of the
+ * users whose initial value of the attribute is that value. Bit u of a bitmap stands for the user u, and bit nUsers
+ * for a user whose attributes all take their default values; the default values are folded into the columns, so a
+ * user that does not list an attribute is in the bitmap of its default value.
+ *
+ * A conjunctive condition is satisfied by some user if the intersection, over its atomic conditions, of the users
+ * satisfying the atomic condition is not empty. The users satisfying an atomic condition are the union of the bitmaps
+ * of the values satisfying it, or, when it is satisfied by many values, are evaluated directly on the column.
+ * The intersection is computed a word at a time and stops at the first word with a bit set.
+ *
+ * The bitmaps of an attribute are built from its column the first time a condition on the attribute is checked,
+ * and are allocated in an arena. The index refers to the columns, which must outlive it.
+ */
+typedef struct _UserIndex {
+    InitState *state;
+    // The number of bits of a bitmap, i.e. the number of users plus one, and of 64-bit words
+    int nUsers;
+    int nWords;
+    // The number of attributes, and for each attribute the map from a value to its bitmap (uint64_t *), or NULL if not built yet
+    int nAttrs;
+    IntMap **attrBitmaps;
+    Arena *arena;
+} UserIndex;
+
+typedef struct _UserIndexInterface {
+    UserIndex *(*Create)(InitState *state);                                  // 创建初始状态的索引
+    int (*IsSatisfiable)(UserIndex *index, IntervalTest *tests, int nTests); // 判断是否存在一个用户，其初始状态满足编译为区间测试的属性合取条件
+    void (*Finalize)(UserIndex *index);                                      // 释放索引
+} UserIndexInterface;
+
+extern UserIndexInterface iUserIndex;
+
+#endif // _USERINDEX_H
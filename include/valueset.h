@@ -0,0 +1,90 @@
+#ifndef _VALUESET_H
+#define _VALUESET_H
+
+#include <stdint.h>
+
+#include "hashmap.h"
+
+// The maximum number of 64-bit words of a bitset, i.e., 8MB
+#define VALUESET_MAX_WORDS (1 << 20)
+// The number of words up to which a set is always a bitset
+#define VALUESET_MIN_SPARSE_WORDS 64
+// The maximum number of words per value of a bitset of more than VALUESET_MIN_SPARSE_WORDS words
+#define VALUESET_MAX_WORDS_PER_VALUE 4
+
+/*
+ * A set of value indices stored as a dense bitset.
+ * The bitset covers the range between the smallest and the largest value ever added, rounded to whole 64-bit words,
+ * so it is sized to the domain of the attribute the values belong to. The set algebra (union, intersection,
+ * subset and equality) is computed a word at a time, and with 256-bit vectors when compiled with AVX2. Restricting
+ * a set to an interval of values masks 64 values at a time, so that an atomic condition compiled to an interval
+ * test is evaluated over a whole domain in one pass over its words.
+ *
+ * Integer values are taken from the policy as they are, so a domain may be spread over a range far larger than the
+ * number of its values, e.g., {0, 2000000000}. A set whose range would exceed VALUESET_MAX_WORDS words, or
+ * VALUESET_MAX_WORDS_PER_VALUE words per value beyond VALUESET_MIN_SPARSE_WORDS words, is stored as a sorted array
+ * of its values instead, and the operations involving it are computed value by value.
+ *
+ * Values are iterated in ascending order, one by one or as maximal runs of consecutive values, so that a set of
+ * integers is enumerated as a list of intervals.
+ */
+typedef struct _ValueSet {
+    // Bit i of words[k] represents the value base + 64 * k + i
+    uint64_t *words;
+    // A multiple of 64
+    int base;
+    int nWords;
+    // The values in ascending order if the set is sparse, NULL if it is a bitset
+    int *values;
+    int capacity;
+    // The number of values in the set
+    int size;
+    KeyToString elementToString;
+} ValueSet;
+
+/*
+ * An iterator over a ValueSet, which can be allocated on the stack. Usage:
+ *      ValueSetIterator it;
+ *      iValueSet.InitIterator(set, &it);
+ *      while (iValueSet.Next(&it)) { ... it.value ... }
+ * or, to visit the runs of consecutive values,
+ *      while (iValueSet.NextRange(&it, &lo, &hi)) { ... }
+ */
+typedef struct _ValueSetIterator {
+    ValueSet *set;
+    // The index of the current word, or of the next value if the set is sparse
+    int wordIdx;
+    // The bits of the current word that are not visited yet
+    uint64_t bits;
+    // The current value
+    int value;
+} ValueSetIterator;
+
+typedef struct _ValueSetInterface {
+    ValueSet *(*Create)();                                                         // 创建空集合
+    ValueSet *(*Clone)(ValueSet *set);                                             // 复制集合
+    int (*Add)(ValueSet *set, int value);                                          // 添加元素，若元素原本不存在则返回1，否则返回0
+    int (*Contains)(ValueSet *set, int value);                                     // 判断元素是否存在
+    int (*Remove)(ValueSet *set, int value);                                       // 删除元素，若元素存在则返回1，否则返回0
+    int (*Size)(ValueSet *set);                                                    // 获取元素数量
+    void (*Clear)(ValueSet *set);                                                  // 清空集合
+    int (*AddAll)(ValueSet *set1, ValueSet *set2);                                 // 并集，结果保存在set1中，若set1发生变化则返回1
+    int (*RetainAll)(ValueSet *set1, ValueSet *set2);                              // 交集，结果保存在set1中，若set1发生变化则返回1
+    int (*AddAllInRange)(ValueSet *set1, ValueSet *set2, int lo, int hi, int negated); // 将set2中位于区间[lo, hi]内（negated时为区间外）的元素加入set1，若set1发生变化则返回1
+    int (*RetainRange)(ValueSet *set, int lo, int hi, int negated);                 // 只保留位于区间[lo, hi]内（negated时为区间外）的元素，若集合发生变化则返回1
+    int (*ContainsAll)(ValueSet *set1, ValueSet *set2);                            // 判断set2是否为set1的子集
+    int (*Intersects)(ValueSet *set1, ValueSet *set2);                             // 判断两个集合的交集是否非空
+    int (*Equal)(ValueSet *set1, ValueSet *set2);                                  // 判断两个集合是否相等
+    unsigned int (*HashCode)(ValueSet *set);                                       // 获取哈希值，相等的集合哈希值相同
+    char *(*ToString)(void *pSet);                                                 // 转换为字符串，参数为指向集合指针的指针
+    KeyToString (*SetElementToString)(ValueSet *set, KeyToString elementToString); // 设置元素转换为字符串函数，参数为指向元素的指针
+    void (*Finalize)(ValueSet *set);                                               // 释放集合
+    void (*DestructPointer)(void *pSet);                                           // 释放集合，参数为指向集合指针的指针
+    void (*InitIterator)(ValueSet *set, ValueSetIterator *it);                     // 初始化迭代器
+    int (*Next)(ValueSetIterator *it);                                             // 移动到下一个元素，若没有更多元素则返回0
+    int (*NextRange)(ValueSetIterator *it, int *lo, int *hi);                      // 移动到下一个由连续元素lo, lo + 1, ..., hi构成的极大区间，若没有更多元素则返回0
+} ValueSetInterface;
+
+extern ValueSetInterface iValueSet;
+
+#endif // _VALUESET_H
@@ -1,4 +1,5 @@
 #include "acoac_absref.h"
+#include "acoac_domcomp.h"
 #include "acoac_utils.h"
 
 #include <time.h>
@@ -15,9 +16,48 @@ AbsRef *createAbsRef(ACoACInstance *pOriInst) {
     pAbsRef->pMapReachableAVsInc = NULL;
     pAbsRef->pMapUsefulAVs = NULL;
     pAbsRef->pMapUsefulAVsInc = NULL;
+
+    int nRules = iVector.Size(pVecRules);
+    pAbsRef->selectedRules = (int *)malloc((nRules + 1) * sizeof(int));
+    pAbsRef->selected = (char *)calloc(nRules + 1, 1);
+    pAbsRef->nSelected = 0;
+    pAbsRef->nSelectedPrev = 0;
+    pAbsRef->pSubInst = NULL;
+
+    pAbsRef->strategy = REFINE_WIDEN;
+    pAbsRef->pMapFoundAVs = NULL;
+
+    pAbsRef->nSteps = 1;
+    pAbsRef->adaptiveSteps = 0;
+    pAbsRef->telemetryCapacity = 8;
+    pAbsRef->telemetry = (RefineTelemetry *)malloc(pAbsRef->telemetryCapacity * sizeof(RefineTelemetry));
+    pAbsRef->nTelemetry = 0;
     return pAbsRef;
 }
 
+/**
+ * Get the value set of an attribute in a map from attributes to value sets, creating an empty one if there is none.
+ */
+static ValueSet *getOrCreateValues(IntMap *pMapAVs, int attrIdx) {
+    ValueSet *pSet, **ppSet = iIntMap.Get(pMapAVs, attrIdx);
+    if (ppSet != NULL) {
+        return *ppSet;
+    }
+    pSet = iValueSet.Create();
+    iIntMap.Put(pMapAVs, attrIdx, &pSet);
+    return pSet;
+}
+
+/**
+ * Add a rule to the selected rules, if it is not selected yet.
+ */
+static void selectRule(AbsRef *pAbsRef, int ruleIdx) {
+    if (!pAbsRef->selected[ruleIdx]) {
+        pAbsRef->selected[ruleIdx] = 1;
+        pAbsRef->selectedRules[pAbsRef->nSelected++] = ruleIdx;
+    }
+}
+
 /**
  * Forward rule-selection strategy.
  * 
@@ -28,103 +68,87 @@ static int forwardSearch(AbsRef *pAbsRef) {
     int ret = 0;
 
     if (pAbsRef->pMapReachableAVsInc == NULL) {
-        pAbsRef->pMapReachableAVs = iHashMap.Create(sizeof(int), sizeof(HashSet *), IntHashCode, IntEqual);
-        iHashMap.SetDestructValue(pAbsRef->pMapReachableAVs, iHashSet.DestructPointer);
-        pAbsRef->pMapReachableAVsInc = iHashMap.Create(sizeof(int), sizeof(HashSet *), IntHashCode, IntEqual);
-        iHashMap.SetDestructValue(pAbsRef->pMapReachableAVsInc, iHashSet.DestructPointer);
-
-        HashNodeIterator *itMap = iHashMap.NewIterator(
-            *(HashMap **)iHashMap.Get(pAbsRef->pOriInst->pTableInitState->pRowMap, &pAbsRef->pOriInst->queryUserIdx));
+        pAbsRef->pMapReachableAVs = iIntMap.Create(sizeof(ValueSet *));
+        iIntMap.SetDestructValue(pAbsRef->pMapReachableAVs, iValueSet.DestructPointer);
+        pAbsRef->pMapReachableAVsInc = iIntMap.Create(sizeof(ValueSet *));
+        iIntMap.SetDestructValue(pAbsRef->pMapReachableAVsInc, iValueSet.DestructPointer);
+
+        HashNodeIterator itMap;
+        iHashMap.InitIterator(*(HashMap **)iHashMap.Get(pAbsRef->pOriInst->pTableInitState->pRowMap, &pAbsRef->pOriInst->queryUserIdx),
+                              &itMap);
         HashNode *node;
-        HashSet *pSet;
-        while (itMap->HasNext(itMap)) {
-            node = itMap->GetNext(itMap);
-            pSet = iHashSet.Create(sizeof(int), IntHashCode, IntEqual);
-            iHashSet.Add(pSet, node->value);
-            iHashMap.Put(pAbsRef->pMapReachableAVs, node->key, &pSet);
-
-            pSet = iHashSet.Create(sizeof(int), IntHashCode, IntEqual);
-            iHashSet.Add(pSet, node->value);
-            iHashMap.Put(pAbsRef->pMapReachableAVsInc, node->key, &pSet);
+        ValueSet *pSet;
+        while (itMap.HasNext(&itMap)) {
+            node = itMap.GetNext(&itMap);
+            pSet = iValueSet.Create();
+            iValueSet.Add(pSet, *(int *)node->value);
+            iIntMap.Put(pAbsRef->pMapReachableAVs, *(int *)node->key, &pSet);
+
+            pSet = iValueSet.Create();
+            iValueSet.Add(pSet, *(int *)node->value);
+            iIntMap.Put(pAbsRef->pMapReachableAVsInc, *(int *)node->key, &pSet);
         }
-        iHashMap.DeleteIterator(itMap);
     }
 
-    HashBasedTable *pTablePrecond2Rule = pAbsRef->pOriInst->pTablePrecond2Rule;
-    HashMap *pMapNewReachableAVsInc = iHashMap.Create(sizeof(int), sizeof(HashSet *), IntHashCode, IntEqual);
-    iHashMap.SetDestructValue(pMapNewReachableAVsInc, iHashSet.DestructPointer);
+    CSRIndex *pIndexPrecond2Rule = getPrecond2RuleIndex(pAbsRef->pOriInst);
+    IntMap *pMapNewReachableAVsInc = iIntMap.Create(sizeof(ValueSet *));
+    iIntMap.SetDestructValue(pMapNewReachableAVsInc, iValueSet.DestructPointer);
 
     /* Traverse the newly reachable attribute values, find the rules that may become reachable
      * because of the newly reachable attribute values. If these rules are not in pf, and the 
      * current reachable attribute key-value pair can satisfy the userCond of the rule, then
      * add the rule to pf, and update the reachable attribute key-value pair */
-    HashNodeIterator *itMap = iHashMap.NewIterator(pAbsRef->pMapReachableAVsInc);
-    HashNode *node;
-    HashSet **ppSetRuleIdxes, *pSetValIdxes, **ppSetValIdxes;
-    HashSetIterator *itSetValIdx, *itSetRuleIdx;
-    int *pAttrIdx, *pValueIdx, *pRuleIdx, targetAttrIdx, targetValueIdx;
+    IntMapIterator itMap;
+    ValueSet *pSetValIdxes, **ppSetValIdxes;
+    ValueSetIterator itSetValIdx;
+    int *pAttrIdx, *pRuleIdxes, nRuleIdxes, i, targetAttrIdx, targetValueIdx;
     Rule *pRule;
-    while (itMap->HasNext(itMap)) {
-        node = itMap->GetNext(itMap);
-        pAttrIdx = (int *)node->key;
-        itSetValIdx = iHashSet.NewIterator(*(HashSet **)node->value);
-        while (itSetValIdx->HasNext(itSetValIdx)) {
-            pValueIdx = (int *)itSetValIdx->GetNext(itSetValIdx);
-            ppSetRuleIdxes = iHashBasedTable.Get(pTablePrecond2Rule, pAttrIdx, pValueIdx);
-            if (ppSetRuleIdxes == NULL) {
-                continue;
-            }
-            itSetRuleIdx = iHashSet.NewIterator(*ppSetRuleIdxes);
-            while (itSetRuleIdx->HasNext(itSetRuleIdx)) {
-                pRuleIdx = (int *)itSetRuleIdx->GetNext(itSetRuleIdx);
-                pRule = iVector.GetElement(pAbsRef->pOriVecRules, *pRuleIdx);
-                if (iHashSet.Contains(pAbsRef->pSetF, pRuleIdx)) {
+    iIntMap.InitIterator(pAbsRef->pMapReachableAVsInc, &itMap);
+    while (iIntMap.Next(&itMap)) {
+        pAttrIdx = &itMap.key;
+        iValueSet.InitIterator(*(ValueSet **)itMap.value, &itSetValIdx);
+        while (iValueSet.Next(&itSetValIdx)) {
+            nRuleIdxes = iCSRIndex.Get(pIndexPrecond2Rule, *pAttrIdx, itSetValIdx.value, &pRuleIdxes);
+            for (i = 0; i < nRuleIdxes; i++) {
+                pRule = iVector.GetElement(pAbsRef->pOriVecRules, pRuleIdxes[i]);
+                if (iHashSet.Contains(pAbsRef->pSetF, &pRuleIdxes[i])) {
                     continue;
                 }
                 if (!iRule.IsEffective(pRule, pAbsRef->pMapReachableAVs)) {
                     continue;
                 }
                 ret = 1;
-                iHashSet.Add(pAbsRef->pSetF, pRuleIdx);
+                iHashSet.Add(pAbsRef->pSetF, &pRuleIdxes[i]);
+                selectRule(pAbsRef, pRuleIdxes[i]);
                 targetAttrIdx = pRule->targetAttrIdx;
                 targetValueIdx = pRule->targetValueIdx;
-                ppSetValIdxes = iHashMap.Get(pAbsRef->pMapReachableAVs, &targetAttrIdx);
-                if (ppSetValIdxes == NULL || !iHashSet.Contains(*ppSetValIdxes, &targetValueIdx)) {
-                    ppSetValIdxes = iHashMap.Get(pMapNewReachableAVsInc, &targetAttrIdx);
+                ppSetValIdxes = iIntMap.Get(pAbsRef->pMapReachableAVs, targetAttrIdx);
+                if (ppSetValIdxes == NULL || !iValueSet.Contains(*ppSetValIdxes, targetValueIdx)) {
+                    ppSetValIdxes = iIntMap.Get(pMapNewReachableAVsInc, targetAttrIdx);
                     if (ppSetValIdxes == NULL) {
-                        pSetValIdxes = iHashSet.Create(sizeof(int), IntHashCode, IntEqual);
+                        pSetValIdxes = iValueSet.Create();
                         ppSetValIdxes = &pSetValIdxes;
-                        iHashMap.Put(pMapNewReachableAVsInc, &targetAttrIdx, ppSetValIdxes);
+                        iIntMap.Put(pMapNewReachableAVsInc, targetAttrIdx, ppSetValIdxes);
                     }
-                    iHashSet.Add(*ppSetValIdxes, &targetValueIdx);
+                    iValueSet.Add(*ppSetValIdxes, targetValueIdx);
                 }
             }
-            iHashSet.DeleteIterator(itSetRuleIdx);
         }
-        iHashSet.DeleteIterator(itSetValIdx);
     }
-    iHashMap.DeleteIterator(itMap);
 
     // Add the new reachable attribute-value pairs in pMapNewReachableAVsInc to pMapReachableAVs
-    itMap = iHashMap.NewIterator(pMapNewReachableAVsInc);
-    while (itMap->HasNext(itMap)) {
-        node = itMap->GetNext(itMap);
-        pAttrIdx = (int *)node->key;
-        ppSetValIdxes = iHashMap.Get(pAbsRef->pMapReachableAVs, pAttrIdx);
+    iIntMap.InitIterator(pMapNewReachableAVsInc, &itMap);
+    while (iIntMap.Next(&itMap)) {
+        ppSetValIdxes = iIntMap.Get(pAbsRef->pMapReachableAVs, itMap.key);
         if (ppSetValIdxes == NULL) {
-            pSetValIdxes = iHashSet.Create(sizeof(int), IntHashCode, IntEqual);
+            pSetValIdxes = iValueSet.Create();
             ppSetValIdxes = &pSetValIdxes;
-            iHashMap.Put(pAbsRef->pMapReachableAVs, pAttrIdx, ppSetValIdxes);
+            iIntMap.Put(pAbsRef->pMapReachableAVs, itMap.key, ppSetValIdxes);
         }
-        itSetValIdx = iHashSet.NewIterator(*(HashSet **)node->value);
-        while (itSetValIdx->HasNext(itSetValIdx)) {
-            iHashSet.Add(*ppSetValIdxes, itSetValIdx->GetNext(itSetValIdx));
-        }
-        iHashSet.DeleteIterator(itSetValIdx);
+        iValueSet.AddAll(*ppSetValIdxes, *(ValueSet **)itMap.value);
     }
-    iHashMap.DeleteIterator(itMap);
 
-    iHashMap.Finalize(pAbsRef->pMapReachableAVsInc);
+    iIntMap.Finalize(pAbsRef->pMapReachableAVsInc);
     pAbsRef->pMapReachableAVsInc = pMapNewReachableAVsInc;
     return ret;
 }
@@ -139,193 +163,293 @@ static int backwardSearch(AbsRef *pAbsRef) {
     int ret = 0;
     if (pAbsRef->pMapUsefulAVsInc == NULL) {
         // Initialize pMapUsefulAVs with pMapQueryAVs
-        pAbsRef->pMapUsefulAVs = iHashMap.Create(sizeof(int), sizeof(HashSet *), IntHashCode, IntEqual);
-        iHashMap.SetDestructValue(pAbsRef->pMapUsefulAVs, iHashSet.DestructPointer);
-        pAbsRef->pMapUsefulAVsInc = iHashMap.Create(sizeof(int), sizeof(HashSet *), IntHashCode, IntEqual);
-        iHashMap.SetDestructValue(pAbsRef->pMapUsefulAVsInc, iHashSet.DestructPointer);
-
-        HashNodeIterator *itMap = iHashMap.NewIterator(pAbsRef->pOriInst->pmapQueryAVs);
-        HashNode *node;
-        HashSet *pSet;
-        while (itMap->HasNext(itMap)) {
-            node = itMap->GetNext(itMap);
-            pSet = iHashSet.Create(sizeof(int), IntHashCode, IntEqual);
-            iHashSet.Add(pSet, node->value);
-            iHashMap.Put(pAbsRef->pMapUsefulAVs, node->key, &pSet);
-
-            pSet = iHashSet.Create(sizeof(int), IntHashCode, IntEqual);
-            iHashSet.Add(pSet, node->value);
-            iHashMap.Put(pAbsRef->pMapUsefulAVsInc, node->key, &pSet);
+        pAbsRef->pMapUsefulAVs = iIntMap.Create(sizeof(ValueSet *));
+        iIntMap.SetDestructValue(pAbsRef->pMapUsefulAVs, iValueSet.DestructPointer);
+        pAbsRef->pMapUsefulAVsInc = iIntMap.Create(sizeof(ValueSet *));
+        iIntMap.SetDestructValue(pAbsRef->pMapUsefulAVsInc, iValueSet.DestructPointer);
+
+        IntMapIterator itQueryAVs;
+        ValueSet *pSet;
+        iIntMap.InitIterator(pAbsRef->pOriInst->pmapQueryAVs, &itQueryAVs);
+        while (iIntMap.Next(&itQueryAVs)) {
+            pSet = iValueSet.Create();
+            iValueSet.Add(pSet, *(int *)itQueryAVs.value);
+            iIntMap.Put(pAbsRef->pMapUsefulAVs, itQueryAVs.key, &pSet);
+
+            pSet = iValueSet.Create();
+            iValueSet.Add(pSet, *(int *)itQueryAVs.value);
+            iIntMap.Put(pAbsRef->pMapUsefulAVsInc, itQueryAVs.key, &pSet);
         }
-        iHashMap.DeleteIterator(itMap);
     }
 
-    if (iHashMap.Size(pAbsRef->pMapUsefulAVsInc) == 0) {
+    if (iIntMap.Size(pAbsRef->pMapUsefulAVsInc) == 0) {
         return 0;
     }
 
-    HashMap *pMapNewUsefulAVsInc = iHashMap.Create(sizeof(int), sizeof(HashSet *), IntHashCode, IntEqual);
-    iHashMap.SetDestructValue(pMapNewUsefulAVsInc, iHashSet.DestructPointer);
+    IntMap *pMapNewUsefulAVsInc = iIntMap.Create(sizeof(ValueSet *));
+    iIntMap.SetDestructValue(pMapNewUsefulAVsInc, iValueSet.DestructPointer);
 
-    HashNodeIterator *itMap = iHashMap.NewIterator(pAbsRef->pMapUsefulAVsInc), *itMap2;
-    HashNode *node, *node2;
-    HashSet **ppSetRuleIdxes, *pSetValIdxes, **ppSetValIdxes;
-    HashSetIterator *itSetValIdx, *itSetValIdx2, *itSetRuleIdx;
-    int *pAttrIdx, *pAttrIdx2, *pValueIdx, *pValueIdx2, *pRuleIdx;
+    IntMapIterator itMap;
+    HashNodeIterator itMap2;
+    HashNode *node2;
+    ValueSet *pSetValIdxes, **ppSetValIdxes;
+    ValueSetIterator itSetValIdx, itSetValIdx2;
+    int *pAttrIdx, *pAttrIdx2, valueIdx2, *pRuleIdxes, nRuleIdxes, i;
     Rule *pRule;
-
-    while (itMap->HasNext(itMap)) {
-        node = itMap->GetNext(itMap);
-        pAttrIdx = (int *)node->key;
-        itSetValIdx = iHashSet.NewIterator(*(HashSet **)node->value);
-        while (itSetValIdx->HasNext(itSetValIdx)) {
-            pValueIdx = (int *)itSetValIdx->GetNext(itSetValIdx);
-            ppSetRuleIdxes = iHashBasedTable.Get(pAbsRef->pOriInst->pTableTargetAV2Rule, pAttrIdx, pValueIdx);
-            if (ppSetRuleIdxes == NULL) {
-                continue;
-            }
-            itSetRuleIdx = iHashSet.NewIterator(*ppSetRuleIdxes);
-            while (itSetRuleIdx->HasNext(itSetRuleIdx)) {
-                pRuleIdx = (int *)itSetRuleIdx->GetNext(itSetRuleIdx);
-                if (!iHashSet.Add(pAbsRef->pSetB, pRuleIdx)) {
+    CSRIndex *pIndexTargetAV2Rule = getTargetAV2RuleIndex(pAbsRef->pOriInst);
+
+    iIntMap.InitIterator(pAbsRef->pMapUsefulAVsInc, &itMap);
+    while (iIntMap.Next(&itMap)) {
+        pAttrIdx = &itMap.key;
+        iValueSet.InitIterator(*(ValueSet **)itMap.value, &itSetValIdx);
+        while (iValueSet.Next(&itSetValIdx)) {
+            nRuleIdxes = iCSRIndex.Get(pIndexTargetAV2Rule, *pAttrIdx, itSetValIdx.value, &pRuleIdxes);
+            for (i = 0; i < nRuleIdxes; i++) {
+                if (!iHashSet.Add(pAbsRef->pSetB, &pRuleIdxes[i])) {
                     continue;
                 }
                 ret = 1;
-                pRule = iVector.GetElement(pAbsRef->pOriVecRules, *pRuleIdx);
-                itMap2 = iHashMap.NewIterator(pRule->pmapUserCondValue);
-                while (itMap2->HasNext(itMap2)) {
-                    node2 = itMap2->GetNext(itMap2);
+                selectRule(pAbsRef, pRuleIdxes[i]);
+                pRule = iVector.GetElement(pAbsRef->pOriVecRules, pRuleIdxes[i]);
+                iHashMap.InitIterator(pRule->pmapUserCondValue, &itMap2);
+                while (itMap2.HasNext(&itMap2)) {
+                    node2 = itMap2.GetNext(&itMap2);
                     pAttrIdx2 = (int *)node2->key;
-                    itSetValIdx2 = iHashSet.NewIterator(*(HashSet **)node2->value);
-                    while (itSetValIdx2->HasNext(itSetValIdx2)) {
-                        pValueIdx2 = (int *)itSetValIdx2->GetNext(itSetValIdx2);
-                        ppSetValIdxes = iHashMap.Get(pAbsRef->pMapUsefulAVs, pAttrIdx2);
+                    iValueSet.InitIterator(*(ValueSet **)node2->value, &itSetValIdx2);
+                    while (iValueSet.Next(&itSetValIdx2)) {
+                        valueIdx2 = itSetValIdx2.value;
+                        ppSetValIdxes = iIntMap.Get(pAbsRef->pMapUsefulAVs, *pAttrIdx2);
                         if (ppSetValIdxes == NULL) {
-                            pSetValIdxes = iHashSet.Create(sizeof(int), IntHashCode, IntEqual);
+                            pSetValIdxes = iValueSet.Create();
                             ppSetValIdxes = &pSetValIdxes;
-                            iHashMap.Put(pAbsRef->pMapUsefulAVs, pAttrIdx2, ppSetValIdxes);
+                            iIntMap.Put(pAbsRef->pMapUsefulAVs, *pAttrIdx2, ppSetValIdxes);
                         }
-                        if (!iHashSet.Add(*ppSetValIdxes, pValueIdx2)) {
+                        if (!iValueSet.Add(*ppSetValIdxes, valueIdx2)) {
                             continue;
                         }
 
-                        ppSetValIdxes = iHashMap.Get(pMapNewUsefulAVsInc, pAttrIdx2);
+                        ppSetValIdxes = iIntMap.Get(pMapNewUsefulAVsInc, *pAttrIdx2);
                         if (ppSetValIdxes == NULL) {
-                            pSetValIdxes = iHashSet.Create(sizeof(int), IntHashCode, IntEqual);
+                            pSetValIdxes = iValueSet.Create();
                             ppSetValIdxes = &pSetValIdxes;
-                            iHashMap.Put(pMapNewUsefulAVsInc, pAttrIdx2, ppSetValIdxes);
+                            iIntMap.Put(pMapNewUsefulAVsInc, *pAttrIdx2, ppSetValIdxes);
                         }
-                        iHashSet.Add(*ppSetValIdxes, pValueIdx2);
+                        iValueSet.Add(*ppSetValIdxes, valueIdx2);
                     }
-                    iHashSet.DeleteIterator(itSetValIdx2);
                 }
-                iHashMap.DeleteIterator(itMap2);
             }
-            iHashSet.DeleteIterator(itSetRuleIdx);
         }
-        iHashSet.DeleteIterator(itSetValIdx);
     }
-    iHashMap.DeleteIterator(itMap);
 
-    iHashMap.Finalize(pAbsRef->pMapUsefulAVsInc);
+    iIntMap.Finalize(pAbsRef->pMapUsefulAVsInc);
     pAbsRef->pMapUsefulAVsInc = pMapNewUsefulAVsInc;
     return ret;
 }
 
 /**
- * Clone the original global rule list.
+ * Counterexample-guided rule-selection strategy, based on the attribute values found reachable in the last sub-policy.
+ * An attribute value is needed if it is in the query, or if it satisfies the user condition of a rule setting a needed
+ * value on an attribute whose reachable values do not satisfy the condition. The rules setting a needed value are
+ * selected if they are effective under the reachable values, extended with the targets of the effective rules.
+ * The reachable values of the attributes pruned from the sub-policy are not found, so the selected rules are
+ * extended as well.
  * 
  * @param pAbsRef[in]: The AbsRef instance
+ * @return 0 if no new rules are selected, 1 otherwise
  */
-static void cloneRules(AbsRef *pAbsRef) {
+static int guidedSearch(AbsRef *pAbsRef) {
     int nRules = iVector.Size(pAbsRef->pOriVecRules);
+    char *relevant = (char *)calloc(nRules + 1, 1);
+    int *candidates = (int *)malloc((nRules + 1) * sizeof(int));
+    int nCandidates = 0, nExtended = 0;
+
+    // Find the rules setting the needed values, breadth-first from the query
+    IntMap *pMapNeededAVs = iIntMap.Create(sizeof(ValueSet *));
+    iIntMap.SetDestructValue(pMapNeededAVs, iValueSet.DestructPointer);
+    Vector *pVecQueue = iVector.Create(2 * sizeof(int), 16);
+    int av[2], *pAV, head, *pRuleIdxes, nRuleIdxes, i;
+    IntMapIterator itQueryAVs;
+    iIntMap.InitIterator(pAbsRef->pOriInst->pmapQueryAVs, &itQueryAVs);
+    while (iIntMap.Next(&itQueryAVs)) {
+        av[0] = itQueryAVs.key;
+        av[1] = *(int *)itQueryAVs.value;
+        iValueSet.Add(getOrCreateValues(pMapNeededAVs, av[0]), av[1]);
+        iVector.Add(pVecQueue, av);
+    }
 
-    Vector *pVecNewRules = iVector.Create(sizeof(Rule), nRules);
-    Rule *pRule, *pNewRule;
+    CSRIndex *pIndexTargetAV2Rule = getTargetAV2RuleIndex(pAbsRef->pOriInst);
+    HashNodeIterator itCond;
     HashNode *node;
-    HashSet *pSet;
-    HashSetIterator *itSet;
-    int i;
-    for (i = 0; i < nRules; i++) {
-        pRule = iVector.GetElement(pAbsRef->pOriVecRules, i);
-        iVector.Add(pVecNewRules, pRule);
-        pNewRule = iVector.GetElement(pVecNewRules, i);
-
-        if (pRule->pmapUserCondValue != NULL) {
-            pNewRule->pmapUserCondValue = iHashMap.Create(sizeof(int), sizeof(HashSet *), IntHashCode, IntEqual);
-            HashNodeIterator *itMap = iHashMap.NewIterator(pRule->pmapUserCondValue);
-            while (itMap->HasNext(itMap)) {
-                node = itMap->GetNext(itMap);
-
-                pSet = iHashSet.Create(sizeof(int), IntHashCode, IntEqual);
-                itSet = iHashSet.NewIterator(*(HashSet **)node->value);
-                while (itSet->HasNext(itSet)) {
-                    iHashSet.Add(pSet, itSet->GetNext(itSet));
+    ValueSet *pSetCond, **ppSetFound, *pSetNeeded;
+    ValueSetIterator itVals;
+    Rule *pRule;
+    for (head = 0; head < iVector.Size(pVecQueue); head++) {
+        pAV = (int *)iVector.GetElement(pVecQueue, head);
+        nRuleIdxes = iCSRIndex.Get(pIndexTargetAV2Rule, pAV[0], pAV[1], &pRuleIdxes);
+        for (i = 0; i < nRuleIdxes; i++) {
+            if (relevant[pRuleIdxes[i]]) {
+                continue;
+            }
+            relevant[pRuleIdxes[i]] = 1;
+            candidates[nCandidates++] = pRuleIdxes[i];
+            pRule = iVector.GetElement(pAbsRef->pOriVecRules, pRuleIdxes[i]);
+            iHashMap.InitIterator(pRule->pmapUserCondValue, &itCond);
+            while (itCond.HasNext(&itCond)) {
+                node = itCond.GetNext(&itCond);
+                pSetCond = *(ValueSet **)node->value;
+                ppSetFound = iIntMap.Get(pAbsRef->pMapFoundAVs, *(int *)node->key);
+                if (ppSetFound != NULL && iValueSet.Intersects(pSetCond, *ppSetFound)) {
+                    continue;
+                }
+                av[0] = *(int *)node->key;
+                pSetNeeded = getOrCreateValues(pMapNeededAVs, av[0]);
+                iValueSet.InitIterator(pSetCond, &itVals);
+                while (iValueSet.Next(&itVals)) {
+                    if (iValueSet.Add(pSetNeeded, itVals.value)) {
+                        av[1] = itVals.value;
+                        iVector.Add(pVecQueue, av);
+                    }
                 }
-                iHashSet.DeleteIterator(itSet);
-                iHashMap.Put(pNewRule->pmapUserCondValue, node->key, &pSet);
             }
-            iHashMap.DeleteIterator(itMap);
         }
     }
-    pVecRules = pVecNewRules;
+    iVector.Finalize(pVecQueue);
+    iIntMap.Finalize(pMapNeededAVs);
+
+    // Select the candidates that become effective, until none does. The effective candidates are moved to the front
+    IntMap *pMapReachableAVs = iIntMap.Create(sizeof(ValueSet *));
+    iIntMap.SetDestructValue(pMapReachableAVs, iValueSet.DestructPointer);
+    IntMapIterator itFound;
+    ValueSet *pSet;
+    iIntMap.InitIterator(pAbsRef->pMapFoundAVs, &itFound);
+    while (iIntMap.Next(&itFound)) {
+        pSet = iValueSet.Clone(*(ValueSet **)itFound.value);
+        iIntMap.Put(pMapReachableAVs, itFound.key, &pSet);
+    }
+    int ret = 0, modified = 1, ruleIdx;
+    while (modified) {
+        modified = 0;
+        for (i = nExtended; i < nCandidates; i++) {
+            ruleIdx = candidates[i];
+            pRule = iVector.GetElement(pAbsRef->pOriVecRules, ruleIdx);
+            if (!iRule.IsEffective(pRule, pMapReachableAVs)) {
+                continue;
+            }
+            if (!pAbsRef->selected[ruleIdx]) {
+                selectRule(pAbsRef, ruleIdx);
+                ret = 1;
+            }
+            iValueSet.Add(getOrCreateValues(pMapReachableAVs, pRule->targetAttrIdx), pRule->targetValueIdx);
+            candidates[i] = candidates[nExtended];
+            candidates[nExtended++] = ruleIdx;
+            modified = 1;
+        }
+    }
+    iIntMap.Finalize(pMapReachableAVs);
+    free(relevant);
+    free(candidates);
+    return ret;
+}
+
+/**
+ * Create a sub-policy without rules, with the initial state of the query user and the query of the original
+ * instance. The sub-policy shares the list of users with the original instance.
+ */
+static ACoACInstance *createSubPolicy(AbsRef *pAbsRef) {
+    ACoACInstance *pNewInstance = createACoACInstance();
+    int queryUserIdx = pAbsRef->pOriInst->queryUserIdx;
+    iVector.Finalize(pNewInstance->pVecUserIndices);
+    pNewInstance->pVecUserIndices = pAbsRef->pOriInst->pVecUserIndices;
+
+    HashNodeIterator itMap;
+    iHashMap.InitIterator(*(HashMap **)iHashMap.Get(pAbsRef->pOriInst->pTableInitState->pRowMap, &queryUserIdx), &itMap);
+    HashNode *node;
+    while (itMap.HasNext(&itMap)) {
+        node = itMap.GetNext(&itMap);
+        addUAVByIdx(pNewInstance, queryUserIdx, *(int *)node->key, *(int *)node->value);
+    }
+
+    pNewInstance->queryUserIdx = queryUserIdx;
+
+    IntMapIterator itQueryAVs;
+    iIntMap.InitIterator(pAbsRef->pOriInst->pmapQueryAVs, &itQueryAVs);
+    while (iIntMap.Next(&itQueryAVs)) {
+        iIntMap.Put(pNewInstance->pmapQueryAVs, itQueryAVs.key, itQueryAVs.value);
+    }
+    return pNewInstance;
 }
 
 /**
  * Use the rules selected by the forward rule-selection strategy and backward rule-selection strategy
  * to generate an ACoAC instance. If the rule-selection strategies cannot select any new rules, return NULL.
+ * With the REFINE_CEGAR strategy, the rules selected by the counterexample-guided strategy are used instead, if any.
+ * Otherwise the rule-selection strategies take pAbsRef->nSteps steps, or more until some new rule is selected.
+ *
+ * The sub-policy of the selected rules (pAbsRef->pSubInst) is kept across the rounds and extended with the newly
+ * selected rules only. The returned instance, which is pruned by the caller, is a copy of it that reuses the hash
+ * codes of its rules, so only the new rules are hashed in a round.
  * 
  * @param pAbsRef[in]: The AbsRef instance
  * @return An ACoAC instance containing the rules selected by the forward-selection strategy
  * and backward-selection strategy
  */
 static ACoACInstance *getInstance(AbsRef *pAbsRef) {
-    int modified = 0;
-    modified |= forwardSearch(pAbsRef);
-    modified |= backwardSearch(pAbsRef);
-    if (!modified) {
+    clock_t startSelecting = clock();
+    int guided = 0;
+    if (pAbsRef->strategy == REFINE_CEGAR && pAbsRef->pMapFoundAVs != NULL) {
+        guided = guidedSearch(pAbsRef);
+    }
+    if (pAbsRef->pMapFoundAVs != NULL) {
+        iIntMap.Finalize(pAbsRef->pMapFoundAVs);
+        pAbsRef->pMapFoundAVs = NULL;
+    }
+
+    // Widen the sub-policy if no rule is selected yet. A round without new rules would verify the same sub-policy
+    // as the previous round, continue the selection
+    int modified = 1, nSteps = 0;
+    while (!guided && modified && (pAbsRef->nSelected == pAbsRef->nSelectedPrev || nSteps < pAbsRef->nSteps)) {
+        modified = forwardSearch(pAbsRef);
+        modified |= backwardSearch(pAbsRef);
+        nSteps++;
+    }
+    if (pAbsRef->nSelected == pAbsRef->nSelectedPrev) {
         logACoAC(__func__, __LINE__, 0, INFO, "Failed, the policy cannot be refined anymore...\n");
         return NULL;
     }
 
-    cloneRules(pAbsRef);
-
-    ACoACInstance *pNewInstance = createACoACInstance();
-    HashSetIterator *itSet = iHashSet.NewIterator(pAbsRef->pSetF);
-    int ruleIdx;
-    while (itSet->HasNext(itSet)) {
-        ruleIdx = *(int *)itSet->GetNext(itSet);
-        addRule(pNewInstance, ruleIdx);
+    // The sub-policy is pruned with a fork of the original rules, so that the conditions of the original rules are
+    // kept for the rule selection of the next rounds. The fork of the previous round is no longer used, unless the
+    // caller keeps it by resetting the global rule list to the original rules before the refinement
+    if (pVecRules != pAbsRef->pOriVecRules) {
+        releaseRuleList(pVecRules);
     }
-    iHashSet.DeleteIterator(itSet);
+    pVecRules = forkRuleList(pAbsRef->pOriVecRules);
 
-    itSet = iHashSet.NewIterator(pAbsRef->pSetB);
-    while (itSet->HasNext(itSet)) {
-        ruleIdx = *(int *)itSet->GetNext(itSet);
-        addRule(pNewInstance, ruleIdx);
+    if (pAbsRef->pSubInst == NULL) {
+        pAbsRef->pSubInst = createSubPolicy(pAbsRef);
     }
-    iHashSet.DeleteIterator(itSet);
-
-    int queryUserIdx = pAbsRef->pOriInst->queryUserIdx;
-    pNewInstance->pVecUserIndices = pAbsRef->pOriInst->pVecUserIndices;
-
-    HashNodeIterator *itMap = iHashMap.NewIterator(*(HashMap **)iHashMap.Get(pAbsRef->pOriInst->pTableInitState->pRowMap, &queryUserIdx));
-    HashNode *node;
-    while (itMap->HasNext(itMap)) {
-        node = itMap->GetNext(itMap);
-        addUAVByIdx(pNewInstance, queryUserIdx, *(int *)node->key, *(int *)node->value);
+    int i;
+    for (i = pAbsRef->nSelectedPrev; i < pAbsRef->nSelected; i++) {
+        addRule(pAbsRef->pSubInst, pAbsRef->selectedRules[i]);
     }
-    iHashMap.DeleteIterator(itMap);
+    pAbsRef->nSelectedPrev = pAbsRef->nSelected;
 
-    pNewInstance->queryUserIdx = queryUserIdx;
+    ACoACInstance *pNewInstance = createSubPolicy(pAbsRef);
+    addRulesOf(pNewInstance, pAbsRef->pSubInst);
 
-    itMap = iHashMap.NewIterator(pAbsRef->pOriInst->pmapQueryAVs);
-    while (itMap->HasNext(itMap)) {
-        node = itMap->GetNext(itMap);
-        iHashMap.Put(pNewInstance->pmapQueryAVs, node->key, node->value);
+    // Start the telemetry of the round, completed by reportRound
+    if (pAbsRef->nTelemetry == pAbsRef->telemetryCapacity) {
+        pAbsRef->telemetryCapacity *= 2;
+        pAbsRef->telemetry = (RefineTelemetry *)realloc(pAbsRef->telemetry, pAbsRef->telemetryCapacity * sizeof(RefineTelemetry));
     }
-    iHashMap.DeleteIterator(itMap);
-
+    RefineTelemetry *pTelemetry = &pAbsRef->telemetry[pAbsRef->nTelemetry++];
+    pTelemetry->round = pAbsRef->round;
+    pTelemetry->nSteps = nSteps;
+    pTelemetry->nRules = iHashSet.Size(pNewInstance->pSetRuleIdxes);
+    pTelemetry->nRulesChecked = 0;
+    pTelemetry->selectCost = (double)(clock() - startSelecting) / CLOCKS_PER_SEC * 1000;
+    pTelemetry->mcCost = 0;
+    pTelemetry->nNextSteps = pAbsRef->nSteps;
     return pNewInstance;
 }
 
@@ -343,17 +467,138 @@ ACoACInstance *abstract(AbsRef *pAbsRef) {
     return newInstance;
 }
 
+void finalizeSubPolicy(AbsRef *pAbsRef, ACoACInstance *pInst) {
+    if (pInst->pVecUserIndices == pAbsRef->pOriInst->pVecUserIndices) {
+        pInst->pVecUserIndices = NULL;
+    }
+    finalizeACoACInstance(pInst);
+}
+
 ACoACInstance *refine(AbsRef *pAbsRef) {
     logACoAC(__func__, __LINE__, 0, INFO, "[Start] %d-th policy refinement\n", pAbsRef->round);
     clock_t startRefining = clock();
 
+    // The refined sub-policy is verified in the next round
+    pAbsRef->round++;
     ACoACInstance *newInstance = getInstance(pAbsRef);
 
     if (newInstance != NULL) {
         double timeSpent = (double)(clock() - startRefining) / CLOCKS_PER_SEC * 1000;
-        logACoAC(__func__, __LINE__, 0, INFO, "[end] %d-th policy refinement, cost => %.2fms\n", pAbsRef->round, timeSpent);
+        logACoAC(__func__, __LINE__, 0, INFO, "[end] %d-th policy refinement, cost => %.2fms\n", pAbsRef->round - 1, timeSpent);
         logACoAC(__func__, __LINE__, 0, INFO, "rules => %d/%d\n", iHashSet.Size(newInstance->pSetRuleIdxes), iHashSet.Size(pAbsRef->pOriInst->pSetRuleIdxes));
     }
-    pAbsRef->round++;
     return newInstance;
 }
+
+void reportRound(AbsRef *pAbsRef, int round, int nRulesChecked, double mcCost) {
+    int i = pAbsRef->nTelemetry - 1;
+    while (i >= 0 && pAbsRef->telemetry[i].round != round) {
+        i--;
+    }
+    if (i < 0) {
+        return;
+    }
+    RefineTelemetry *pTelemetry = &pAbsRef->telemetry[i];
+    pTelemetry->nRulesChecked = nRulesChecked;
+    pTelemetry->mcCost = mcCost;
+
+    if (pAbsRef->adaptiveSteps) {
+        // A fast round takes more steps next time, unless the sub-policy is growing fast, and a slow round fewer steps
+        RefineTelemetry *pPrev = i > 0 ? pTelemetry - 1 : NULL;
+        if (mcCost > REFINE_SLOW_MC_MS) {
+            pAbsRef->nSteps = pAbsRef->nSteps > 1 ? pAbsRef->nSteps / 2 : 1;
+        } else if (mcCost < REFINE_FAST_MC_MS && (pPrev == NULL || pTelemetry->nRules <= (long)REFINE_MAX_GROWTH * pPrev->nRules)) {
+            pAbsRef->nSteps = pAbsRef->nSteps < REFINE_MAX_STEPS / 2 ? pAbsRef->nSteps * 2 : REFINE_MAX_STEPS;
+        }
+    }
+    pTelemetry->nNextSteps = pAbsRef->nSteps;
+    logACoAC(__func__, __LINE__, 0, INFO,
+             "telemetry of round %d: steps => %d, sub-policy => %d rules, pruned => %d rules, selecting => %.2fms, model checking => %.2fms, next steps => %d\n",
+             pTelemetry->round, pTelemetry->nSteps, pTelemetry->nRules, pTelemetry->nRulesChecked, pTelemetry->selectCost,
+             pTelemetry->mcCost, pTelemetry->nNextSteps);
+}
+
+int writeRefineTelemetry(AbsRef *pAbsRef, char *path) {
+    FILE *fp = fopen(path, "w");
+    if (fp == NULL) {
+        logACoAC(__func__, __LINE__, 0, ERROR, "Failed to open file: %s\n", path);
+        return -1;
+    }
+    fprintf(fp, "round,steps,rules,prunedRules,selectingMs,modelCheckingMs,nextSteps\n");
+    RefineTelemetry *pTelemetry;
+    int i;
+    for (i = 0; i < pAbsRef->nTelemetry; i++) {
+        pTelemetry = &pAbsRef->telemetry[i];
+        fprintf(fp, "%d,%d,%d,%d,%.2f,%.2f,%d\n", pTelemetry->round, pTelemetry->nSteps, pTelemetry->nRules, pTelemetry->nRulesChecked,
+                pTelemetry->selectCost, pTelemetry->mcCost, pTelemetry->nNextSteps);
+    }
+    fclose(fp);
+    return 0;
+}
+
+int getProbeAVs(ACoACInstance *pInst, int **pAttrs, int **pVals) {
+    int capacity = 16, n = 0, initRep;
+    *pAttrs = (int *)malloc(capacity * sizeof(int));
+    *pVals = (int *)malloc(capacity * sizeof(int));
+    HashMap *avsOfUser = iHashBasedTable.GetRow(pInst->pTableInitState, &pInst->queryUserIdx);
+    IntMapIterator itMap;
+    ValueSetIterator itDom;
+    iIntMap.InitIterator(pInst->pMapAttr2Dom, &itMap);
+    while (iIntMap.Next(&itMap)) {
+        if (iValueSet.Size(*(ValueSet **)itMap.value) <= 1) {
+            continue;
+        }
+        initRep = getRepresentative(pInst, itMap.key, *(int *)iHashMap.Get(avsOfUser, &itMap.key));
+        iValueSet.InitIterator(*(ValueSet **)itMap.value, &itDom);
+        while (iValueSet.Next(&itDom)) {
+            // The values no rule can set are unreachable, and the values of a class are set as the representative
+            if (itDom.value == initRep || getRepresentative(pInst, itMap.key, itDom.value) != itDom.value ||
+                !isClassTarget(pInst, itMap.key, itDom.value)) {
+                continue;
+            }
+            if (n == capacity) {
+                capacity *= 2;
+                *pAttrs = (int *)realloc(*pAttrs, capacity * sizeof(int));
+                *pVals = (int *)realloc(*pVals, capacity * sizeof(int));
+            }
+            (*pAttrs)[n] = itMap.key;
+            (*pVals)[n++] = itDom.value;
+        }
+    }
+    return n;
+}
+
+void addReachableAVs(AbsRef *pAbsRef, ACoACInstance *pInst, int *attrs, int *vals, char *reachable, int n) {
+    if (pAbsRef->pMapFoundAVs == NULL) {
+        pAbsRef->pMapFoundAVs = iIntMap.Create(sizeof(ValueSet *));
+        iIntMap.SetDestructValue(pAbsRef->pMapFoundAVs, iValueSet.DestructPointer);
+        HashNodeIterator itMap;
+        iHashMap.InitIterator(*(HashMap **)iHashMap.Get(pAbsRef->pOriInst->pTableInitState->pRowMap, &pAbsRef->pOriInst->queryUserIdx),
+                              &itMap);
+        HashNode *node;
+        while (itMap.HasNext(&itMap)) {
+            node = itMap.GetNext(&itMap);
+            iValueSet.Add(getOrCreateValues(pAbsRef->pMapFoundAVs, *(int *)node->key), *(int *)node->value);
+        }
+    }
+
+    ValueClasses **ppClasses;
+    ValueSet *pSet;
+    int i, j;
+    for (i = 0; i < n; i++) {
+        if (reachable != NULL && !reachable[i]) {
+            continue;
+        }
+        pSet = getOrCreateValues(pAbsRef->pMapFoundAVs, attrs[i]);
+        ppClasses = pInst->pMapAttr2Classes == NULL ? NULL : (ValueClasses **)iIntMap.Get(pInst->pMapAttr2Classes, attrs[i]);
+        if (ppClasses == NULL) {
+            iValueSet.Add(pSet, vals[i]);
+            continue;
+        }
+        for (j = 0; j < (*ppClasses)->nValues; j++) {
+            if ((*ppClasses)->reps[j] == vals[i]) {
+                iValueSet.Add(pSet, (*ppClasses)->values[j]);
+            }
+        }
+    }
+}
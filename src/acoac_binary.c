@@ -0,0 +1,519 @@
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "acoac_io.h"
+#include "acoac_utils.h"
+
+/*
+ * Layout of a compiled policy file. All integers are 32-bit in the byte order of the
+ * compiling machine (checked through @{byteOrderMark}), and every section starts at an
+ * 8-byte aligned offset, so the sections can be read in place from the mapped file.
+ *
+ *      header
+ *      users        : string table
+ *      attributes   : string table
+ *      values       : string table
+ *      attrTypes    : int32[nAttrs]
+ *      attrDefVals  : int32[nAttrs]
+ *      userIndices  : int32[nUserIndices]             (the users of the instance)
+ *      uavs         : CompiledUAV[nUAVs]               (the initial state)
+ *      conds        : CompiledCondition[nConds]        (all conditions in @{pVecConds})
+ *      atomConds    : CompiledAtomCond[nAtomConds]     (the atomic conditions of all conditions, flattened)
+ *      rules        : CompiledRule[nRules]             (all rules in @{pVecRules})
+ *      queryAVs     : int32[2 * nQueryAVs]             (attribute-value pairs)
+ *
+ * A string table of n strings is int32 offsets[n + 1] followed by the NUL-terminated strings,
+ * where offsets[i] is the position of the i-th string relative to the end of the offsets.
+ */
+#define COMPILED_MAGIC "ACOACBIN"
+#define COMPILED_MAGIC_LEN 8
+#define COMPILED_VERSION 2
+#define COMPILED_BYTE_ORDER_MARK 0x01020304
+#define COMPILED_ALIGNMENT 8
+
+typedef struct _CompiledHeader {
+    char magic[COMPILED_MAGIC_LEN];
+    int32_t version;
+    int32_t byteOrderMark;
+    int32_t nUsers;
+    int32_t nAttrs;
+    int32_t nValues;
+    int32_t nUserIndices;
+    int32_t nUAVs;
+    int32_t nConds;
+    int32_t nAtomConds;
+    int32_t nRules;
+    int32_t nQueryAVs;
+    int32_t queryUserIdx;
+    int64_t offUsers;
+    int64_t offAttrs;
+    int64_t offValues;
+    int64_t offAttrTypes;
+    int64_t offAttrDefVals;
+    int64_t offUserIndices;
+    int64_t offUAVs;
+    int64_t offConds;
+    int64_t offAtomConds;
+    int64_t offRules;
+    int64_t offQueryAVs;
+    int64_t fileSize;
+} CompiledHeader;
+
+typedef struct _CompiledUAV {
+    int32_t user;
+    int32_t attr;
+    int32_t value;
+} CompiledUAV;
+
+typedef struct _CompiledCondition {
+    // The atomic conditions of the condition are atomConds[atomCondStart, atomCondStart + nAtomConds)
+    int32_t atomCondStart;
+    int32_t nAtomConds;
+} CompiledCondition;
+
+typedef struct _CompiledRule {
+    int32_t targetAttrIdx;
+    int32_t targetValueIdx;
+    // The indices of the conditions in the conds section
+    int32_t adminCondIdx;
+    int32_t userCondIdx;
+} CompiledRule;
+
+typedef struct _CompiledAtomCond {
+    int32_t attribute;
+    int32_t value;
+    int32_t op;
+} CompiledAtomCond;
+
+static int64_t alignFile(FILE *fp) {
+    static const char zeros[COMPILED_ALIGNMENT] = {0};
+    long pos = ftell(fp);
+    int pad = (COMPILED_ALIGNMENT - pos % COMPILED_ALIGNMENT) % COMPILED_ALIGNMENT;
+    fwrite(zeros, 1, pad, fp);
+    return pos + pad;
+}
+
+static void writeStringTable(FILE *fp, strCollection *psc) {
+    int n = istrCollection.Size(psc);
+    int32_t *offsets = (int32_t *)malloc((n + 1) * sizeof(int32_t));
+    int i;
+    offsets[0] = 0;
+    for (i = 0; i < n; i++) {
+        offsets[i + 1] = offsets[i] + strlen(istrCollection.GetElement(psc, i)) + 1;
+    }
+    fwrite(offsets, sizeof(int32_t), n + 1, fp);
+    for (i = 0; i < n; i++) {
+        char *str = istrCollection.GetElement(psc, i);
+        fwrite(str, 1, strlen(str) + 1, fp);
+    }
+    free(offsets);
+}
+
+static int writeCondition(FILE *fp, HashSet *cond) {
+    CompiledAtomCond compiled;
+    AtomCondition *pAtomCond;
+    HashSetIterator *it = iHashSet.NewIterator(cond);
+    while (it->HasNext(it)) {
+        pAtomCond = (AtomCondition *)it->GetNext(it);
+        compiled = (CompiledAtomCond){pAtomCond->attribute, pAtomCond->value, pAtomCond->op};
+        fwrite(&compiled, sizeof(CompiledAtomCond), 1, fp);
+    }
+    iHashSet.DeleteIterator(it);
+    return iHashSet.Size(cond);
+}
+
+/**
+ * Write the compiled form of an instance to a stream, which is left positioned after the header.
+ */
+static void writeCompiled(ACoACInstance *pInst, FILE *fp) {
+    CompiledHeader header;
+    memset(&header, 0, sizeof(CompiledHeader));
+    memcpy(header.magic, COMPILED_MAGIC, COMPILED_MAGIC_LEN);
+    header.version = COMPILED_VERSION;
+    header.byteOrderMark = COMPILED_BYTE_ORDER_MARK;
+    header.nUsers = istrCollection.Size(pscUsers);
+    header.nAttrs = istrCollection.Size(pscAttrs);
+    header.nValues = istrCollection.Size(pscValues);
+    header.nUserIndices = iVector.Size(pInst->pVecUserIndices);
+    header.nConds = iVector.Size(pVecConds);
+    header.nRules = iVector.Size(pVecRules);
+    header.nQueryAVs = iIntMap.Size(pInst->pmapQueryAVs);
+    header.queryUserIdx = pInst->queryUserIdx;
+    // The header is rewritten once all the sections are written
+    fwrite(&header, sizeof(CompiledHeader), 1, fp);
+
+    header.offUsers = alignFile(fp);
+    writeStringTable(fp, pscUsers);
+    header.offAttrs = alignFile(fp);
+    writeStringTable(fp, pscAttrs);
+    header.offValues = alignFile(fp);
+    writeStringTable(fp, pscValues);
+
+    int i;
+    int32_t attrType, defVal;
+    header.offAttrTypes = alignFile(fp);
+    for (i = 0; i < header.nAttrs; i++) {
+        attrType = getAttrTypeByIdx(i);
+        fwrite(&attrType, sizeof(int32_t), 1, fp);
+    }
+    header.offAttrDefVals = alignFile(fp);
+    for (i = 0; i < header.nAttrs; i++) {
+        defVal = *(int *)iIntMap.Get(pmapAttr2DefVal, i);
+        fwrite(&defVal, sizeof(int32_t), 1, fp);
+    }
+
+    int32_t userIdx;
+    header.offUserIndices = alignFile(fp);
+    for (i = 0; i < header.nUserIndices; i++) {
+        userIdx = *(int *)iVector.GetElement(pInst->pVecUserIndices, i);
+        fwrite(&userIdx, sizeof(int32_t), 1, fp);
+    }
+
+    CompiledUAV uav;
+    HashNode *rowNode, *colNode;
+    header.offUAVs = alignFile(fp);
+    HashNodeIterator *itRow = iHashMap.NewIterator(pInst->pTableInitState->pRowMap), *itCol;
+    while (itRow->HasNext(itRow)) {
+        rowNode = itRow->GetNext(itRow);
+        uav.user = *(int *)rowNode->key;
+        itCol = iHashMap.NewIterator(*(HashMap **)rowNode->value);
+        while (itCol->HasNext(itCol)) {
+            colNode = itCol->GetNext(itCol);
+            uav.attr = *(int *)colNode->key;
+            uav.value = *(int *)colNode->value;
+            fwrite(&uav, sizeof(CompiledUAV), 1, fp);
+            header.nUAVs++;
+        }
+        iHashMap.DeleteIterator(itCol);
+    }
+    iHashMap.DeleteIterator(itRow);
+
+    CompiledCondition compiledCond;
+    header.offConds = alignFile(fp);
+    for (i = 0; i < header.nConds; i++) {
+        compiledCond.atomCondStart = header.nAtomConds;
+        compiledCond.nAtomConds = iHashSet.Size(getCondition(i));
+        header.nAtomConds += compiledCond.nAtomConds;
+        fwrite(&compiledCond, sizeof(CompiledCondition), 1, fp);
+    }
+    header.offAtomConds = alignFile(fp);
+    for (i = 0; i < header.nConds; i++) {
+        writeCondition(fp, getCondition(i));
+    }
+
+    Rule *pRule;
+    CompiledRule compiledRule;
+    header.offRules = alignFile(fp);
+    for (i = 0; i < header.nRules; i++) {
+        pRule = (Rule *)iVector.GetElement(pVecRules, i);
+        compiledRule.targetAttrIdx = pRule->targetAttrIdx;
+        compiledRule.targetValueIdx = pRule->targetValueIdx;
+        compiledRule.adminCondIdx = pRule->adminCondIdx;
+        compiledRule.userCondIdx = pRule->userCondIdx;
+        fwrite(&compiledRule, sizeof(CompiledRule), 1, fp);
+    }
+
+    int32_t av[2];
+    IntMapIterator itQuery;
+    header.offQueryAVs = alignFile(fp);
+    iIntMap.InitIterator(pInst->pmapQueryAVs, &itQuery);
+    while (iIntMap.Next(&itQuery)) {
+        av[0] = itQuery.key;
+        av[1] = *(int *)itQuery.value;
+        fwrite(av, sizeof(int32_t), 2, fp);
+    }
+
+    header.fileSize = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    fwrite(&header, sizeof(CompiledHeader), 1, fp);
+}
+
+int writeCompiledInstance(ACoACInstance *pInst, char *filename) {
+    if (pInst == NULL) {
+        logACoAC(__func__, __LINE__, 0, ERROR, "[Writing] Writing failed, the given ACoAC instance is a NULL pointer\n");
+        return -1;
+    }
+    FILE *fp = fopen(filename, "wb");
+    if (fp == NULL) {
+        logACoAC(__func__, __LINE__, 0, ERROR, "[Writing] Failed to open file %s\n", filename);
+        return -1;
+    }
+    writeCompiled(pInst, fp);
+    if (fclose(fp) != 0) {
+        logACoAC(__func__, __LINE__, 0, ERROR, "[Writing] Failed to write file %s\n", filename);
+        return -1;
+    }
+    logACoAC(__func__, __LINE__, 0, INFO, "[Writing] Successfully compiled ACoAC instance into file %s\n", filename);
+    return 0;
+}
+
+char *compileInstance(ACoACInstance *pInst, size_t *pSize) {
+    char *buffer = NULL;
+    FILE *fp = open_memstream(&buffer, pSize);
+    if (fp == NULL) {
+        logACoAC(__func__, __LINE__, 0, ERROR, "[Writing] Failed to open memory stream\n");
+        return NULL;
+    }
+    writeCompiled(pInst, fp);
+    // The size of a memory stream is its position when closed, so move past the sections written before the header
+    fseek(fp, 0, SEEK_END);
+    if (fclose(fp) != 0) {
+        free(buffer);
+        return NULL;
+    }
+    return buffer;
+}
+
+static void readStringTable(char *base, int64_t offset, int n, strCollection *psc, Dictionary *pdict) {
+    int32_t *offsets = (int32_t *)(base + offset);
+    char *strings = (char *)(offsets + n + 1);
+    int i;
+    for (i = 0; i < n; i++) {
+        istrCollection.Add(psc, strings + offsets[i]);
+        iDictionary.Insert(pdict, strings + offsets[i], &i);
+    }
+}
+
+static HashSet *readCondition(CompiledAtomCond *atomConds, int start, int n) {
+    HashSet *condition = iHashSet.Create(sizeof(AtomCondition), iAtomCondition.HashCode, iAtomCondition.Equal);
+    AtomCondition atomCond;
+    int i;
+    for (i = start; i < start + n; i++) {
+        atomCond = (AtomCondition){atomConds[i].attribute, atomConds[i].value, (comparisonOperator)atomConds[i].op};
+        iHashSet.Add(condition, &atomCond);
+    }
+    return condition;
+}
+
+/**
+ * Check that a section of @{n} items of @{itemSize} bytes starts at an aligned offset, after the end of the previous
+ * section, and lies inside the file.
+ *
+ * @param prevEnd[in]: The end of the previous section, or -1 if it is invalid
+ * @return The end of the section, or -1 if it is invalid
+ */
+static int64_t checkSection(CompiledHeader *header, int64_t prevEnd, int64_t offset, int64_t n, int64_t itemSize) {
+    if (prevEnd < 0 || offset < prevEnd || offset > header->fileSize || offset % COMPILED_ALIGNMENT != 0 ||
+        n > (header->fileSize - offset) / itemSize) {
+        return -1;
+    }
+    return offset + n * itemSize;
+}
+
+/**
+ * Check that a string table of @{n} strings lies inside the file, i.e., its offsets increase from 0 and every string
+ * is NUL-terminated before the next one starts.
+ *
+ * @return The end of the string table, or -1 if it is invalid
+ */
+static int64_t checkStringTable(char *base, CompiledHeader *header, int64_t prevEnd, int64_t offset, int n) {
+    int64_t end = checkSection(header, prevEnd, offset, (int64_t)n + 1, sizeof(int32_t));
+    if (end < 0) {
+        return -1;
+    }
+    int32_t *offsets = (int32_t *)(base + offset);
+    char *strings = base + end;
+    int i;
+    if (offsets[0] != 0) {
+        return -1;
+    }
+    for (i = 0; i < n; i++) {
+        if (offsets[i + 1] <= offsets[i] || offsets[i + 1] > header->fileSize - end || strings[offsets[i + 1] - 1] != '\0') {
+            return -1;
+        }
+    }
+    return end + offsets[n];
+}
+
+/**
+ * Check that the header of a compiled policy file is valid, i.e., it has the right magic, version, and byte order,
+ * the counts are not negative, and all sections lie inside the file in the order of the layout.
+ */
+static int checkHeader(char *base, size_t size) {
+    CompiledHeader *header = (CompiledHeader *)base;
+    if (size < sizeof(CompiledHeader) || memcmp(header->magic, COMPILED_MAGIC, COMPILED_MAGIC_LEN) != 0) {
+        logACoAC(__func__, __LINE__, 0, ERROR, "not a compiled policy file\n");
+        return -1;
+    }
+    if (header->version != COMPILED_VERSION) {
+        logACoAC(__func__, __LINE__, 0, ERROR, "unsupported compiled policy version %d (expected %d), please compile the policy again\n", header->version, COMPILED_VERSION);
+        return -1;
+    }
+    if (header->byteOrderMark != COMPILED_BYTE_ORDER_MARK) {
+        logACoAC(__func__, __LINE__, 0, ERROR, "the compiled policy was generated on a machine with a different byte order\n");
+        return -1;
+    }
+    if (header->fileSize != (int64_t)size || header->nUsers < 0 || header->nAttrs < 0 || header->nValues < 0 || header->nUserIndices < 0 ||
+        header->nUAVs < 0 || header->nConds < 0 || header->nAtomConds < 0 || header->nRules < 0 || header->nQueryAVs < 0) {
+        logACoAC(__func__, __LINE__, 0, ERROR, "the compiled policy file is truncated or corrupted\n");
+        return -1;
+    }
+    // The offsets and counts are signed, so the bounds are computed in int64_t
+    int64_t end = sizeof(CompiledHeader);
+    end = checkStringTable(base, header, end, header->offUsers, header->nUsers);
+    end = checkStringTable(base, header, end, header->offAttrs, header->nAttrs);
+    end = checkStringTable(base, header, end, header->offValues, header->nValues);
+    end = checkSection(header, end, header->offAttrTypes, header->nAttrs, sizeof(int32_t));
+    end = checkSection(header, end, header->offAttrDefVals, header->nAttrs, sizeof(int32_t));
+    end = checkSection(header, end, header->offUserIndices, header->nUserIndices, sizeof(int32_t));
+    end = checkSection(header, end, header->offUAVs, header->nUAVs, sizeof(CompiledUAV));
+    end = checkSection(header, end, header->offConds, header->nConds, sizeof(CompiledCondition));
+    end = checkSection(header, end, header->offAtomConds, header->nAtomConds, sizeof(CompiledAtomCond));
+    end = checkSection(header, end, header->offRules, header->nRules, sizeof(CompiledRule));
+    end = checkSection(header, end, header->offQueryAVs, 2 * (int64_t)header->nQueryAVs, sizeof(int32_t));
+    if (end < 0) {
+        logACoAC(__func__, __LINE__, 0, ERROR, "the compiled policy file is truncated or corrupted\n");
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * Check that a value is valid for an attribute, i.e., 0 or 1 for a boolean attribute and the index of a string for a
+ * string attribute. Any value is valid for an integer attribute.
+ */
+static int isValidValue(CompiledHeader *header, int32_t *attrTypes, int32_t attrIdx, int32_t value) {
+    switch (attrTypes[attrIdx]) {
+    case BOOLEAN:
+        return value == 0 || value == 1;
+    case STRING:
+        return value >= 0 && value < header->nValues;
+    default:
+        return 1;
+    }
+}
+
+/**
+ * Check that the indices of users, attributes, values, atomic conditions and conditions in the sections of a compiled
+ * policy file are in range, so that the instance is built from the file without further checks.
+ * The header must be checked before (see checkHeader).
+ */
+static int checkIndices(char *base, CompiledHeader *header) {
+    int32_t *attrTypes = (int32_t *)(base + header->offAttrTypes);
+    int32_t *attrDefVals = (int32_t *)(base + header->offAttrDefVals);
+    int32_t *userIndices = (int32_t *)(base + header->offUserIndices);
+    CompiledUAV *uavs = (CompiledUAV *)(base + header->offUAVs);
+    CompiledCondition *conds = (CompiledCondition *)(base + header->offConds);
+    CompiledAtomCond *atomConds = (CompiledAtomCond *)(base + header->offAtomConds);
+    CompiledRule *rules = (CompiledRule *)(base + header->offRules);
+    int32_t *queryAVs = (int32_t *)(base + header->offQueryAVs);
+    int i, valid = header->queryUserIdx >= 0 && header->queryUserIdx < header->nUsers;
+    // The attribute types are checked first, since the valid values of an attribute depend on its type
+    for (i = 0; valid && i < header->nAttrs; i++) {
+        valid = attrTypes[i] >= BOOLEAN && attrTypes[i] <= INTEGER && isValidValue(header, attrTypes, i, attrDefVals[i]);
+    }
+    for (i = 0; valid && i < header->nUserIndices; i++) {
+        valid = userIndices[i] >= 0 && userIndices[i] < header->nUsers;
+    }
+    for (i = 0; valid && i < header->nUAVs; i++) {
+        valid = uavs[i].user >= 0 && uavs[i].user < header->nUsers && uavs[i].attr >= 0 && uavs[i].attr < header->nAttrs &&
+                isValidValue(header, attrTypes, uavs[i].attr, uavs[i].value);
+    }
+    for (i = 0; valid && i < header->nConds; i++) {
+        valid = conds[i].atomCondStart >= 0 && conds[i].nAtomConds >= 0 &&
+                (int64_t)conds[i].atomCondStart + conds[i].nAtomConds <= header->nAtomConds;
+    }
+    for (i = 0; valid && i < header->nAtomConds; i++) {
+        valid = atomConds[i].attribute >= 0 && atomConds[i].attribute < header->nAttrs && atomConds[i].op >= EQUAL &&
+                atomConds[i].op <= GREATER_THAN_OR_EQUAL && isValidValue(header, attrTypes, atomConds[i].attribute, atomConds[i].value);
+    }
+    for (i = 0; valid && i < header->nRules; i++) {
+        valid = rules[i].targetAttrIdx >= 0 && rules[i].targetAttrIdx < header->nAttrs &&
+                isValidValue(header, attrTypes, rules[i].targetAttrIdx, rules[i].targetValueIdx) && rules[i].adminCondIdx >= 0 &&
+                rules[i].adminCondIdx < header->nConds && rules[i].userCondIdx >= 0 && rules[i].userCondIdx < header->nConds;
+    }
+    for (i = 0; valid && i < header->nQueryAVs; i++) {
+        valid = queryAVs[2 * i] >= 0 && queryAVs[2 * i] < header->nAttrs && isValidValue(header, attrTypes, queryAVs[2 * i], queryAVs[2 * i + 1]);
+    }
+    if (!valid) {
+        logACoAC(__func__, __LINE__, 0, ERROR, "the compiled policy file is corrupted, index out of range\n");
+        return -1;
+    }
+    return 0;
+}
+
+ACoACInstance *readCompiledInstance(char *filename) {
+    logACoAC(__func__, __LINE__, 0, INFO, "[start] loading compiled ACoAC instance from file %s\n", filename);
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        printf("Error opening file: %s\n", filename);
+        return NULL;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        printf("Error opening file: %s\n", filename);
+        close(fd);
+        return NULL;
+    }
+    size_t size = (size_t)st.st_size;
+    char *base = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        printf("Error mapping file: %s\n", filename);
+        return NULL;
+    }
+    CompiledHeader *header = (CompiledHeader *)base;
+    if (checkHeader(base, size) || checkIndices(base, header)) {
+        munmap(base, size);
+        return NULL;
+    }
+
+    initGlobalVars();
+    ACoACInstance *pInst = createACoACInstance();
+
+    readStringTable(base, header->offUsers, header->nUsers, pscUsers, pdictUser2Index);
+    readStringTable(base, header->offAttrs, header->nAttrs, pscAttrs, pdictAttr2Index);
+    readStringTable(base, header->offValues, header->nValues, pscValues, pdictValue2Index);
+
+    int32_t *attrTypes = (int32_t *)(base + header->offAttrTypes);
+    int32_t *attrDefVals = (int32_t *)(base + header->offAttrDefVals);
+    int i;
+    for (i = 0; i < header->nAttrs; i++) {
+        iIntMap.Put(pmapAttr2Type, i, &attrTypes[i]);
+        iIntMap.Put(pmapAttr2DefVal, i, &attrDefVals[i]);
+    }
+
+    int32_t *userIndices = (int32_t *)(base + header->offUserIndices);
+    for (i = 0; i < header->nUserIndices; i++) {
+        iVector.Add(pInst->pVecUserIndices, &userIndices[i]);
+    }
+
+    CompiledUAV *uavs = (CompiledUAV *)(base + header->offUAVs);
+    for (i = 0; i < header->nUAVs; i++) {
+        addUAVByIdx(pInst, uavs[i].user, uavs[i].attr, uavs[i].value);
+    }
+
+    // The conditions are distinct and the first one is "TRUE", so they get the same indices as in the compiled file
+    CompiledCondition *conds = (CompiledCondition *)(base + header->offConds);
+    CompiledAtomCond *atomConds = (CompiledAtomCond *)(base + header->offAtomConds);
+    for (i = 0; i < header->nConds; i++) {
+        if (getConditionIndex(readCondition(atomConds, conds[i].atomCondStart, conds[i].nAtomConds)) != i) {
+            logACoAC(__func__, __LINE__, 0, ERROR, "the compiled policy file contains duplicate conditions\n");
+            finalizeACoACInstance(pInst);
+            finalizeGlobalVars();
+            munmap(base, size);
+            return NULL;
+        }
+    }
+
+    CompiledRule *rules = (CompiledRule *)(base + header->offRules);
+    for (i = 0; i < header->nRules; i++) {
+        addRule(pInst, getRuleIndex(rules[i].adminCondIdx, rules[i].userCondIdx, rules[i].targetAttrIdx, rules[i].targetValueIdx));
+    }
+
+    pInst->queryUserIdx = header->queryUserIdx;
+    int32_t *queryAVs = (int32_t *)(base + header->offQueryAVs);
+    for (i = 0; i < header->nQueryAVs; i++) {
+        iIntMap.Put(pInst->pmapQueryAVs, queryAVs[2 * i], &queryAVs[2 * i + 1]);
+    }
+
+    munmap(base, size);
+    logACoAC(__func__, __LINE__, 0, INFO, "[end] loading compiled ACoAC instance from file %s\n", filename);
+    return pInst;
+}
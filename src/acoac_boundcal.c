@@ -1,4 +1,5 @@
 #include "acoac_boundcal.h"
+#include "acoac_domcomp.h"
 #include "acoac_utils.h"
 
 /**
@@ -11,21 +12,20 @@
 static BigInteger computeLooseBound(ACoACInstance *pInst) {
     BigInteger bound = iBigInteger.createFromInt(1);
     BigInteger tmp;
-    HashNodeIterator *it = iHashMap.NewIterator(pInst->pMapAttr2Dom);
+    IntMapIterator it;
     char *attr;
     int domSize;
-    while (it->HasNext(it)) {
-        HashNode *pNode = it->GetNext(it);
-        attr = istrCollection.GetElement(pscAttrs, *(int *)pNode->key);
+    iIntMap.InitIterator(pInst->pMapAttr2Dom, &it);
+    while (iIntMap.Next(&it)) {
+        attr = istrCollection.GetElement(pscAttrs, it.key);
         if (strcmp(attr, "Admin") == 0) {
             continue;
         }
-        domSize = iHashSet.Size(*(HashSet **)pNode->value);
+        domSize = iValueSet.Size(*(ValueSet **)it.value);
         tmp = iBigInteger.multiplyByInt(bound, domSize);
         iBigInteger.finalize(bound);
         bound = tmp;
     }
-    iHashMap.DeleteIterator(it);
     return bound;
 }
 
@@ -49,7 +49,7 @@ static BigInteger computeLooseBound(ACoACInstance *pInst) {
 //         if (strcmp(attr, "Admin") == 0) {
 //             continue;
 //         }
-//         domSize = iHashSet.Size(*(HashSet **)pNode->value);
+//         domSize = iValueSet.Size(*(ValueSet **)pNode->value);
 //         if (!iHashMap.ContainsKey(pInst->pmapQueryAVs, pNode->key)) {
 //             tmp = iBigInteger.multiplyByInt(boundPart1, domSize);
 //             iBigInteger.finalize(boundPart1);
@@ -103,31 +103,32 @@ void insertDesc(int *array, int len, int n) {
  * Let the attributes in A_2 be a_21,a_22,...,a_2n.
  * Then the upper bound is less than or equal to |Dom(a_21)|*|Dom(a_22)|*...|Dom(a_2n)|*P,
  * where P=1+(|Dom(a_11)|-1)+(|Dom(a_11)|-1)*(|Dom(a_12)|-1)+...+(|Dom(a_11)|-1)*...*(|Dom(a_1m)|-1).
+ * If the domains are compressed by compressDomains, a value stands for its class, i.e., a rule targets InitUAV(u_t, a)
+ * if it targets a value of the same class.
  *
  * @param pInst[in]: An ACoAC instance
  * @return The tight bound of the ACoAC instance
  */
 static BigInteger computeTightBound(ACoACInstance *pInst) {
     HashMap *pMapInitAVs = iHashBasedTable.GetRow(pInst->pTableInitState, &pInst->queryUserIdx);
-    int attrNum = iHashMap.Size(pInst->pMapAttr2Dom);
+    int attrNum = iIntMap.Size(pInst->pMapAttr2Dom);
     int attrs1[attrNum], attrs4[attrNum], attrs1MinusQueryAttrs[attrNum], attrs4MinusQueryAttrs[attrNum];
     int attrs1Len = 0, attrs4Len = 0, attrs1MinusQueryAttrsLen = 0, attrs4MinusQueryAttrsLen = 0;
 
     int *pAttrIdx, *pInitValIdx, *pQueryValIdx, domSize;
     char *attr;
-    HashNode *node;
-    HashNodeIterator *it = iHashMap.NewIterator(pInst->pMapAttr2Dom);
-    while (it->HasNext(it)) {
-        node = it->GetNext(it);
-        pAttrIdx = (int *)node->key;
+    IntMapIterator it;
+    iIntMap.InitIterator(pInst->pMapAttr2Dom, &it);
+    while (iIntMap.Next(&it)) {
+        pAttrIdx = &it.key;
         attr = istrCollection.GetElement(pscAttrs, *pAttrIdx);
         if (strcmp(attr, "Admin") == 0) {
             continue;
         }
-        domSize = iHashSet.Size(*(HashSet **)node->value);
+        domSize = iValueSet.Size(*(ValueSet **)it.value);
         pInitValIdx = (int *)iHashMap.Get(pMapInitAVs, pAttrIdx);
-        pQueryValIdx = (int *)iHashMap.Get(pInst->pmapQueryAVs, pAttrIdx);
-        if (pInitValIdx == NULL || iHashBasedTable.Get(pInst->pTableTargetAV2Rule, pAttrIdx, pInitValIdx) == NULL) {
+        pQueryValIdx = (int *)iIntMap.Get(pInst->pmapQueryAVs, *pAttrIdx);
+        if (pInitValIdx == NULL || !isClassTarget(pInst, *pAttrIdx, *pInitValIdx)) {
             // attr is non restorable, i.e., once the initial value is modified, it cannot be restored
             if (pQueryValIdx == NULL) {
                 // attr is not a target attribute of the query, so it is not already satisfied
@@ -145,7 +146,6 @@ static BigInteger computeTightBound(ACoACInstance *pInst) {
             attrs1[attrs1Len++] = domSize;
         }
     }
-    iHashMap.DeleteIterator(it);
     // Calculate P=1+(|Dom(a_11)|-1)+(|Dom(a_11)|-1)*(|Dom(a_12)|-1)+...+(|Dom(a_11)|-1)*...*(|Dom(a_1m)|-1)
     BigInteger boundPart1 = iBigInteger.createFromInt(1);
     BigInteger product = iBigInteger.createFromInt(1);
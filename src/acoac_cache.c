@@ -0,0 +1,561 @@
+#include "acoac_cache.h"
+#include "acoac_io.h"
+#include "acoac_utils.h"
+#include "intset.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define SNAPSHOT_MAGIC "ACOACSNP"
+#define SNAPSHOT_MAGIC_LEN 8
+// The version of the snapshot format and of the pre-checking and slicing, which should be increased whenever either
+// changes, so that the snapshots of older versions are never reused
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_BYTE_ORDER 0x01020304
+#define SNAPSHOT_END 0x454e4421
+#define SNAPSHOT_SUFFIX ".snap"
+
+// FNV-1a 128-bit parameters
+#define FNV128_OFFSET (((unsigned __int128)0x6c62272e07bb0142ULL << 64) | 0x62b821756295c58dULL)
+#define FNV128_PRIME (((unsigned __int128)0x0000000001000000ULL << 64) | 0x000000000000013BULL)
+
+static unsigned __int128 fnv1a128(unsigned __int128 hash, const void *data, size_t size) {
+    const unsigned char *bytes = (const unsigned char *)data;
+    size_t i;
+    for (i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= FNV128_PRIME;
+    }
+    return hash;
+}
+
+int fingerprintPolicy(ACoACInstance *pInst, int doPrechecking, unsigned char *fingerprint) {
+    size_t size;
+    char *image = compileInstance(pInst, &size);
+    if (image == NULL) {
+        return -1;
+    }
+    int32_t header[2] = {SNAPSHOT_VERSION, doPrechecking != 0};
+    unsigned __int128 hash = fnv1a128(FNV128_OFFSET, header, sizeof(header));
+    hash = fnv1a128(hash, image, size);
+    free(image);
+    int i;
+    for (i = 0; i < FINGERPRINT_LEN; i++) {
+        fingerprint[i] = (unsigned char)(hash >> (8 * (FINGERPRINT_LEN - 1 - i)));
+    }
+    return 0;
+}
+
+char *getDefaultCacheDir() {
+    char *base = getenv("XDG_CACHE_HOME"), *dir;
+    if (base != NULL && base[0] != '\0') {
+        dir = (char *)malloc(strlen(base) + 13);
+        sprintf(dir, "%s/coachecker", base);
+        return dir;
+    }
+    if ((base = getenv("HOME")) == NULL || base[0] == '\0') {
+        return NULL;
+    }
+    dir = (char *)malloc(strlen(base) + 20);
+    sprintf(dir, "%s/.cache/coachecker", base);
+    return dir;
+}
+
+/**
+ * Create a directory and its missing parents.
+ */
+static int makeDirs(char *dir) {
+    char *path = strdup(dir), *p;
+    int ret = 0;
+    for (p = path + 1; *p != '\0' && ret == 0; p++) {
+        if (*p == '/') {
+            *p = '\0';
+            if (mkdir(path, 0755) != 0 && errno != EEXIST) {
+                ret = -1;
+            }
+            *p = '/';
+        }
+    }
+    if (ret == 0 && mkdir(path, 0755) != 0 && errno != EEXIST) {
+        ret = -1;
+    }
+    free(path);
+    return ret;
+}
+
+static char *getSnapshotPath(char *cacheDir, unsigned char *fingerprint) {
+    char *path = (char *)malloc(strlen(cacheDir) + 2 * FINGERPRINT_LEN + sizeof(SNAPSHOT_SUFFIX) + 2);
+    char *p = path + sprintf(path, "%s/", cacheDir);
+    int i;
+    for (i = 0; i < FINGERPRINT_LEN; i++) {
+        p += sprintf(p, "%02x", fingerprint[i]);
+    }
+    strcpy(p, SNAPSHOT_SUFFIX);
+    return path;
+}
+
+/****************************************************************************************************
+ * Writing snapshots
+ * A snapshot is a sequence of 32-bit integers in the native byte order after its header:
+ *      the verdict code;
+ *      for a verdict, the number of actions (-1 if there is no action list) and the actions as
+ *          (admin, user, attribute, value), then the number of rules (-1 if there is no rule list) and the rules;
+ *      for a sliced instance, the query user, the number of users and the users, the number of users with initial
+ *          values and each such user with the number of its initial values and the values as (attribute, value),
+ *          the number of rules and the rules as (rule, admin condition, number of discretized attributes (-1 if the
+ *          condition is not discretized), then each attribute with the number of its values and the values), the
+ *          number of domains and the domains as (attribute, number of values, values), the number of query pairs and
+ *          the pairs as (attribute, value);
+ *      the end marker.
+ ***************************************************************************************************/
+
+static void writeInt(FILE *fp, int value) {
+    int32_t v = value;
+    fwrite(&v, sizeof(int32_t), 1, fp);
+}
+
+static void writeValueSet(FILE *fp, ValueSet *pSet) {
+    writeInt(fp, iValueSet.Size(pSet));
+    ValueSetIterator it;
+    iValueSet.InitIterator(pSet, &it);
+    while (iValueSet.Next(&it)) {
+        writeInt(fp, it.value);
+    }
+}
+
+/**
+ * Write a rule with its admin condition and discretized user condition, which are modified by the pruning.
+ */
+static void writeRule(FILE *fp, int ruleIdx) {
+    Rule *pRule = (Rule *)iVector.GetElement(pVecRules, ruleIdx);
+    writeInt(fp, ruleIdx);
+    writeInt(fp, pRule->adminCondIdx);
+    if (pRule->pmapUserCondValue == NULL) {
+        writeInt(fp, -1);
+        return;
+    }
+    writeInt(fp, iHashMap.Size(pRule->pmapUserCondValue));
+    HashNodeIterator itUserCondValue;
+    HashNode *node;
+    iHashMap.InitIterator(pRule->pmapUserCondValue, &itUserCondValue);
+    while (itUserCondValue.HasNext(&itUserCondValue)) {
+        node = itUserCondValue.GetNext(&itUserCondValue);
+        writeInt(fp, *(int *)node->key);
+        writeValueSet(fp, *(ValueSet **)node->value);
+    }
+}
+
+static void writeVerdict(FILE *fp, ACoACResult result) {
+    size_t i;
+    int valueIdx, attrIdx;
+    AdminstrativeAction *pAction;
+    writeInt(fp, result.pVecActions == NULL ? -1 : (int)iVector.Size(result.pVecActions));
+    for (i = 0; result.pVecActions != NULL && i < iVector.Size(result.pVecActions); i++) {
+        pAction = (AdminstrativeAction *)iVector.GetElement(result.pVecActions, i);
+        attrIdx = getAttrIndex(pAction->attr);
+        getValueIndex(getAttrTypeByIdx(attrIdx), pAction->val, &valueIdx);
+        writeInt(fp, pAction->adminIdx);
+        writeInt(fp, pAction->userIdx);
+        writeInt(fp, attrIdx);
+        writeInt(fp, valueIdx);
+    }
+    writeInt(fp, result.pVecRules == NULL ? -1 : (int)iVector.Size(result.pVecRules));
+    // The rules are printed with their discretized conditions, so the conditions are saved as well
+    int ruleIdx;
+    for (i = 0; result.pVecRules != NULL && i < iVector.Size(result.pVecRules); i++) {
+        ruleIdx = *(int *)iVector.GetElement(result.pVecRules, i);
+        if (ruleIdx < 0) {
+            writeInt(fp, ruleIdx);
+        } else {
+            writeRule(fp, ruleIdx);
+        }
+    }
+}
+
+static void writeSlicedInstance(FILE *fp, ACoACInstance *pInst) {
+    size_t i;
+    writeInt(fp, pInst->queryUserIdx);
+    writeInt(fp, iVector.Size(pInst->pVecUserIndices));
+    for (i = 0; i < iVector.Size(pInst->pVecUserIndices); i++) {
+        writeInt(fp, *(int *)iVector.GetElement(pInst->pVecUserIndices, i));
+    }
+
+    HashNodeIterator itRow, itCol;
+    HashNode *rowNode, *colNode;
+    writeInt(fp, iHashMap.Size(pInst->pTableInitState->pRowMap));
+    iHashMap.InitIterator(pInst->pTableInitState->pRowMap, &itRow);
+    while (itRow.HasNext(&itRow)) {
+        rowNode = itRow.GetNext(&itRow);
+        writeInt(fp, *(int *)rowNode->key);
+        writeInt(fp, iHashMap.Size(*(HashMap **)rowNode->value));
+        iHashMap.InitIterator(*(HashMap **)rowNode->value, &itCol);
+        while (itCol.HasNext(&itCol)) {
+            colNode = itCol.GetNext(&itCol);
+            writeInt(fp, *(int *)colNode->key);
+            writeInt(fp, *(int *)colNode->value);
+        }
+    }
+
+    writeInt(fp, iHashSet.Size(pInst->pSetRuleIdxes));
+    HashSetIterator itRuleIdxes;
+    iHashSet.InitIterator(pInst->pSetRuleIdxes, &itRuleIdxes);
+    while (itRuleIdxes.HasNext(&itRuleIdxes)) {
+        writeRule(fp, *(int *)itRuleIdxes.GetNext(&itRuleIdxes));
+    }
+
+    writeInt(fp, iIntMap.Size(pInst->pMapAttr2Dom));
+    IntMapIterator itAttrDom;
+    iIntMap.InitIterator(pInst->pMapAttr2Dom, &itAttrDom);
+    while (iIntMap.Next(&itAttrDom)) {
+        writeInt(fp, itAttrDom.key);
+        writeValueSet(fp, *(ValueSet **)itAttrDom.value);
+    }
+
+    writeInt(fp, iIntMap.Size(pInst->pmapQueryAVs));
+    IntMapIterator itQueryAVs;
+    iIntMap.InitIterator(pInst->pmapQueryAVs, &itQueryAVs);
+    while (iIntMap.Next(&itQueryAVs)) {
+        writeInt(fp, itQueryAVs.key);
+        writeInt(fp, *(int *)itQueryAVs.value);
+    }
+}
+
+int saveSlicingCache(char *cacheDir, unsigned char *fingerprint, ACoACInstance *pInst, ACoACResult result) {
+    if (result.code == ACoAC_RESULT_UNKNOWN ? pInst == NULL
+                                            : result.code != ACoAC_RESULT_REACHABLE && result.code != ACoAC_RESULT_UNREACHABLE) {
+        return -1;
+    }
+    if (makeDirs(cacheDir) != 0) {
+        logACoAC(__func__, __LINE__, 0, WARNING, "[Caching] Failed to create the cache directory %s\n", cacheDir);
+        return -1;
+    }
+    char *path = getSnapshotPath(cacheDir, fingerprint);
+    char *tmpPath = (char *)malloc(strlen(path) + 32);
+    sprintf(tmpPath, "%s.%d.tmp", path, (int)getpid());
+    FILE *fp = fopen(tmpPath, "wb");
+    if (fp == NULL) {
+        logACoAC(__func__, __LINE__, 0, WARNING, "[Caching] Failed to open file %s\n", tmpPath);
+        free(tmpPath);
+        free(path);
+        return -1;
+    }
+
+    fwrite(SNAPSHOT_MAGIC, 1, SNAPSHOT_MAGIC_LEN, fp);
+    writeInt(fp, SNAPSHOT_VERSION);
+    writeInt(fp, SNAPSHOT_BYTE_ORDER);
+    fwrite(fingerprint, 1, FINGERPRINT_LEN, fp);
+    writeInt(fp, result.code);
+    if (result.code == ACoAC_RESULT_UNKNOWN) {
+        writeSlicedInstance(fp, pInst);
+    } else {
+        writeVerdict(fp, result);
+    }
+    writeInt(fp, SNAPSHOT_END);
+
+    int ret = 0;
+    if (ferror(fp) | fclose(fp) || rename(tmpPath, path) != 0) {
+        logACoAC(__func__, __LINE__, 0, WARNING, "[Caching] Failed to write file %s\n", path);
+        remove(tmpPath);
+        ret = -1;
+    } else {
+        logACoAC(__func__, __LINE__, 0, INFO, "[Caching] Saved the result of slicing to %s\n", path);
+    }
+    free(tmpPath);
+    free(path);
+    return ret;
+}
+
+/****************************************************************************************************
+ * Reading snapshots
+ * Every integer is checked against the global lists of the parsed policy, and a snapshot that does not fit is
+ * treated as missing, so a corrupted or truncated file never yields a wrong instance.
+ ***************************************************************************************************/
+
+typedef struct _SnapshotReader {
+    int32_t *data;
+    size_t n;
+    size_t pos;
+    int failed;
+} SnapshotReader;
+
+static int readInt(SnapshotReader *r) {
+    if (r->pos >= r->n) {
+        r->failed = 1;
+        return 0;
+    }
+    return r->data[r->pos++];
+}
+
+/**
+ * Read an integer that should be in the range [lo, hi).
+ */
+static int readIntIn(SnapshotReader *r, int lo, int hi) {
+    int v = readInt(r);
+    if (v < lo || v >= hi) {
+        r->failed = 1;
+        return lo;
+    }
+    return v;
+}
+
+/**
+ * Read a count, which is at least @{min} and at most the number of the remaining integers.
+ */
+static int readCount(SnapshotReader *r, int min) {
+    int n = readInt(r);
+    if (n < min || (n > 0 && (size_t)n > r->n - r->pos)) {
+        r->failed = 1;
+        return 0;
+    }
+    return n;
+}
+
+static int readValue(SnapshotReader *r, int attrIdx) {
+    switch (getAttrTypeByIdx(attrIdx)) {
+    case BOOLEAN:
+        return readIntIn(r, 0, 2);
+    case STRING:
+        return readIntIn(r, 0, istrCollection.Size(pscValues));
+    default:
+        return readInt(r);
+    }
+}
+
+static void readValueSet(SnapshotReader *r, int attrIdx, ValueSet *pSet) {
+    int n = readCount(r, 0), i;
+    for (i = 0; i < n && !r->failed; i++) {
+        iValueSet.Add(pSet, readValue(r, attrIdx));
+    }
+}
+
+/**
+ * Read a rule and, if @{apply} is set, restore its admin condition and discretized user condition, which replace
+ * those of the rule since the rules are not initialized in this run.
+ *
+ * @return The index of the rule
+ */
+static int readRule(SnapshotReader *r, int apply) {
+    int ruleIdx = readIntIn(r, 0, iVector.Size(pVecRules));
+    int adminCondIdx = readIntIn(r, 0, iVector.Size(pVecConds));
+    int nCondAttrs = readCount(r, -1), i;
+    Rule *pRule = (Rule *)iVector.GetElement(pVecRules, ruleIdx);
+    ValueSet *pSetVals;
+    if (apply) {
+        pRule->adminCondIdx = adminCondIdx;
+        iHashMap.Finalize(pRule->pmapUserCondValue);
+        pRule->pmapUserCondValue = NULL;
+        if (nCondAttrs >= 0) {
+            pRule->pmapUserCondValue = iHashMap.Create(sizeof(int), sizeof(ValueSet *), IntHashCode, IntEqual);
+            iHashMap.SetDestructValue(pRule->pmapUserCondValue, iValueSet.DestructPointer);
+        }
+    }
+    for (i = 0; i < nCondAttrs && !r->failed; i++) {
+        int attrIdx = readIntIn(r, 0, istrCollection.Size(pscAttrs));
+        pSetVals = iValueSet.Create();
+        readValueSet(r, attrIdx, pSetVals);
+        if (apply) {
+            iHashMap.Put(pRule->pmapUserCondValue, &attrIdx, &pSetVals);
+        } else {
+            iValueSet.Finalize(pSetVals);
+        }
+    }
+    return ruleIdx;
+}
+
+/**
+ * Read a verdict into @{pResult}. If @{apply} is not set, the snapshot is only validated: restoring the rules
+ * modifies the global rule list, so it is done only after the whole snapshot is known to be valid.
+ */
+static void readVerdict(SnapshotReader *r, ACoACResult *pResult, int apply) {
+    int nUsers = istrCollection.Size(pscUsers), nAttrs = istrCollection.Size(pscAttrs), n, i;
+    AdminstrativeAction action;
+    if ((n = readCount(r, -1)) >= 0 && apply) {
+        pResult->pVecActions = iVector.Create(sizeof(AdminstrativeAction), 0);
+    }
+    for (i = 0; i < n && !r->failed; i++) {
+        action.adminIdx = readIntIn(r, 0, nUsers);
+        action.userIdx = readIntIn(r, 0, nUsers);
+        int attrIdx = readIntIn(r, 0, nAttrs);
+        int valueIdx = readValue(r, attrIdx);
+        if (apply) {
+            action.attr = istrCollection.GetElement(pscAttrs, attrIdx);
+            action.val = getValueByIndex(getAttrTypeByIdx(attrIdx), valueIdx);
+            iVector.Add(pResult->pVecActions, &action);
+        }
+    }
+    if ((n = readCount(r, -1)) >= 0 && apply) {
+        pResult->pVecRules = iVector.Create(sizeof(int), 0);
+    }
+    int ruleIdx;
+    for (i = 0; i < n && !r->failed; i++) {
+        // A rule index is negative if no rule authorizes the action
+        if ((ruleIdx = readInt(r)) >= 0) {
+            r->pos--;
+            ruleIdx = readRule(r, apply);
+        }
+        if (apply) {
+            iVector.Add(pResult->pVecRules, &ruleIdx);
+        }
+    }
+}
+
+/**
+ * Read a sliced instance into @{pInst}. If @{pInst} is NULL, the snapshot is only validated as by readVerdict.
+ */
+static void readSlicedInstance(SnapshotReader *r, ACoACInstance *pInst) {
+    int nUsers = istrCollection.Size(pscUsers), nAttrs = istrCollection.Size(pscAttrs), n, m, i, j;
+    int queryUserIdx = readIntIn(r, 0, nUsers);
+    if (pInst != NULL) {
+        pInst->queryUserIdx = queryUserIdx;
+    }
+    n = readCount(r, 0);
+    for (i = 0; i < n && !r->failed; i++) {
+        int userIdx = readIntIn(r, 0, nUsers);
+        if (pInst != NULL) {
+            iVector.Add(pInst->pVecUserIndices, &userIdx);
+        }
+    }
+
+    n = readCount(r, 0);
+    for (i = 0; i < n && !r->failed; i++) {
+        int userIdx = readIntIn(r, 0, nUsers);
+        m = readCount(r, 0);
+        for (j = 0; j < m && !r->failed; j++) {
+            int attrIdx = readIntIn(r, 0, nAttrs);
+            int valueIdx = readValue(r, attrIdx);
+            if (pInst != NULL) {
+                addUAVByIdx(pInst, userIdx, attrIdx, valueIdx);
+            }
+        }
+    }
+
+    n = readCount(r, 0);
+    for (i = 0; i < n && !r->failed; i++) {
+        int ruleIdx = readRule(r, pInst != NULL);
+        if (pInst != NULL) {
+            addRule(pInst, ruleIdx);
+        }
+    }
+
+    // The domains of a sliced instance may be smaller than the pairs added above, so they are replaced as a whole
+    IntSet *pSetDomAttrs = iIntSet.Create();
+    n = readCount(r, 0);
+    for (i = 0; i < n && !r->failed; i++) {
+        int attrIdx = readIntIn(r, 0, nAttrs);
+        ValueSet *pSetDom = pInst == NULL ? iValueSet.Create() : getOrCreateDomain(pInst, attrIdx);
+        iValueSet.Clear(pSetDom);
+        readValueSet(r, attrIdx, pSetDom);
+        if (pInst == NULL) {
+            iValueSet.Finalize(pSetDom);
+        }
+        iIntSet.Add(pSetDomAttrs, attrIdx);
+    }
+    if (pInst != NULL) {
+        IntMapIterator itAttrDom;
+        IntSet *pSetRemoved = iIntSet.Create();
+        iIntMap.InitIterator(pInst->pMapAttr2Dom, &itAttrDom);
+        while (iIntMap.Next(&itAttrDom)) {
+            if (!iIntSet.Contains(pSetDomAttrs, itAttrDom.key)) {
+                iIntSet.Add(pSetRemoved, itAttrDom.key);
+            }
+        }
+        IntSetIterator itRemoved;
+        iIntSet.InitIterator(pSetRemoved, &itRemoved);
+        while (iIntSet.Next(&itRemoved)) {
+            iIntMap.Remove(pInst->pMapAttr2Dom, itRemoved.key);
+        }
+        iIntSet.Finalize(pSetRemoved);
+    }
+    iIntSet.Finalize(pSetDomAttrs);
+
+    n = readCount(r, 0);
+    for (i = 0; i < n && !r->failed; i++) {
+        int attrIdx = readIntIn(r, 0, nAttrs);
+        int valueIdx = readValue(r, attrIdx);
+        if (pInst != NULL) {
+            iIntMap.Put(pInst->pmapQueryAVs, attrIdx, &valueIdx);
+        }
+    }
+}
+
+int loadSlicingCache(char *cacheDir, unsigned char *fingerprint, ACoACInstance **ppInst, ACoACResult *pResult) {
+    char *path = getSnapshotPath(cacheDir, fingerprint);
+    FILE *fp = fopen(path, "rb");
+    if (fp == NULL) {
+        logACoAC(__func__, __LINE__, 0, INFO, "[Caching] No cached result of slicing at %s\n", path);
+        free(path);
+        return 0;
+    }
+    struct stat st;
+    char *buffer = NULL;
+    size_t headerLen = SNAPSHOT_MAGIC_LEN + 2 * sizeof(int32_t) + FINGERPRINT_LEN;
+    if (fstat(fileno(fp), &st) == 0 && (size_t)st.st_size >= headerLen && (st.st_size - headerLen) % sizeof(int32_t) == 0) {
+        buffer = (char *)malloc(st.st_size);
+        if (fread(buffer, 1, st.st_size, fp) != (size_t)st.st_size) {
+            free(buffer);
+            buffer = NULL;
+        }
+    }
+    fclose(fp);
+
+    int32_t version, byteOrder;
+    if (buffer != NULL) {
+        memcpy(&version, buffer + SNAPSHOT_MAGIC_LEN, sizeof(int32_t));
+        memcpy(&byteOrder, buffer + SNAPSHOT_MAGIC_LEN + sizeof(int32_t), sizeof(int32_t));
+    }
+    if (buffer == NULL || memcmp(buffer, SNAPSHOT_MAGIC, SNAPSHOT_MAGIC_LEN) != 0 || version != SNAPSHOT_VERSION ||
+        byteOrder != SNAPSHOT_BYTE_ORDER || memcmp(buffer + headerLen - FINGERPRINT_LEN, fingerprint, FINGERPRINT_LEN) != 0) {
+        logACoAC(__func__, __LINE__, 0, WARNING, "[Caching] Ignored the invalid snapshot %s\n", path);
+        free(buffer);
+        free(path);
+        return 0;
+    }
+
+    SnapshotReader r = {.n = (st.st_size - headerLen) / sizeof(int32_t), .pos = 0, .failed = 0};
+    r.data = (int32_t *)malloc((r.n + 1) * sizeof(int32_t));
+    memcpy(r.data, buffer + headerLen, r.n * sizeof(int32_t));
+    free(buffer);
+
+    // The snapshot is validated before anything is restored
+    ACoACResult result = {.code = readInt(&r), .pVecActions = NULL, .pVecRules = NULL};
+    if (result.code == ACoAC_RESULT_UNKNOWN) {
+        readSlicedInstance(&r, NULL);
+    } else if (result.code == ACoAC_RESULT_REACHABLE || result.code == ACoAC_RESULT_UNREACHABLE) {
+        readVerdict(&r, &result, 0);
+    } else {
+        r.failed = 1;
+    }
+    if (readInt(&r) != SNAPSHOT_END || r.pos != r.n) {
+        r.failed = 1;
+    }
+    if (r.failed) {
+        logACoAC(__func__, __LINE__, 0, WARNING, "[Caching] Ignored the invalid snapshot %s\n", path);
+        free(r.data);
+        free(path);
+        return 0;
+    }
+
+    ACoACInstance *pInst = NULL;
+    r.pos = 1;
+    if (result.code == ACoAC_RESULT_UNKNOWN) {
+        pInst = createACoACInstance();
+        readSlicedInstance(&r, pInst);
+    } else {
+        readVerdict(&r, &result, 1);
+    }
+    free(r.data);
+
+    logACoAC(__func__, __LINE__, 0, INFO, "[Caching] Loaded the cached result of slicing from %s\n", path);
+    free(path);
+    if (pInst != NULL) {
+        finalizeACoACInstance(*ppInst);
+        *ppInst = pInst;
+    }
+    *pResult = result;
+    return 1;
+}
@@ -0,0 +1,194 @@
+#include "acoac_cluster.h"
+#include "acoac_utils.h"
+#include <time.h>
+
+static int findRoot(int *parent, int attrIdx) {
+    while (parent[attrIdx] != attrIdx) {
+        parent[attrIdx] = parent[parent[attrIdx]];
+        attrIdx = parent[attrIdx];
+    }
+    return attrIdx;
+}
+
+static void unionAttrs(int *parent, int attrIdx1, int attrIdx2) {
+    int root1 = findRoot(parent, attrIdx1), root2 = findRoot(parent, attrIdx2);
+    if (root1 != root2) {
+        // The smaller index is the root, so that the roots do not depend on the order of the rules
+        if (root1 < root2) {
+            parent[root2] = root1;
+        } else {
+            parent[root1] = root2;
+        }
+    }
+}
+
+int splitIntoClusters(ACoACInstance *pInst, ACoACInstance ***pppClusters) {
+    if (iIntMap.Size(pInst->pmapQueryAVs) < 2) {
+        return 1;
+    }
+    logACoAC(__func__, __LINE__, 0, INFO, "[start] splitting instance into clusters of query attributes\n");
+    clock_t startSplitting = clock();
+
+    int nAttrs = istrCollection.Size(pscAttrs), attrIdx, i, nTests;
+    int *parent = (int *)malloc((nAttrs + 1) * sizeof(int));
+    for (attrIdx = 0; attrIdx < nAttrs; attrIdx++) {
+        parent[attrIdx] = attrIdx;
+    }
+
+    // 1. Link the target attribute of every rule with the attributes its conditions depend on
+    HashSetIterator itRuleIdxes;
+    HashNodeIterator itUserCondValue;
+    HashNode *node;
+    IntervalTest *tests;
+    Rule *pRule;
+    iHashSet.InitIterator(pInst->pSetRuleIdxes, &itRuleIdxes);
+    while (itRuleIdxes.HasNext(&itRuleIdxes)) {
+        pRule = (Rule *)iVector.GetElement(pVecRules, *(int *)itRuleIdxes.GetNext(&itRuleIdxes));
+        if (pRule->adminCondIdx != TRUE_COND_IDX) {
+            tests = getConditionTests(pRule->adminCondIdx, &nTests);
+            for (i = 0; i < nTests; i++) {
+                unionAttrs(parent, pRule->targetAttrIdx, tests[i].attribute);
+            }
+        }
+        if (pRule->pmapUserCondValue == NULL) {
+            tests = getConditionTests(pRule->userCondIdx, &nTests);
+            for (i = 0; i < nTests; i++) {
+                unionAttrs(parent, pRule->targetAttrIdx, tests[i].attribute);
+            }
+            continue;
+        }
+        iHashMap.InitIterator(pRule->pmapUserCondValue, &itUserCondValue);
+        while (itUserCondValue.HasNext(&itUserCondValue)) {
+            node = itUserCondValue.GetNext(&itUserCondValue);
+            unionAttrs(parent, pRule->targetAttrIdx, *(int *)node->key);
+        }
+    }
+
+    // 2. Number the clusters of the query attributes in ascending order of their roots
+    int *clusterOf = (int *)malloc((nAttrs + 1) * sizeof(int)), nClusters = 0;
+    for (attrIdx = 0; attrIdx < nAttrs; attrIdx++) {
+        clusterOf[attrIdx] = -1;
+    }
+    for (attrIdx = 0; attrIdx < nAttrs; attrIdx++) {
+        if (iIntMap.ContainsKey(pInst->pmapQueryAVs, attrIdx) && clusterOf[findRoot(parent, attrIdx)] == -1) {
+            clusterOf[findRoot(parent, attrIdx)] = nClusters++;
+        }
+    }
+    for (attrIdx = 0; attrIdx < nAttrs; attrIdx++) {
+        clusterOf[attrIdx] = clusterOf[findRoot(parent, attrIdx)];
+    }
+    free(parent);
+    if (nClusters < 2) {
+        free(clusterOf);
+        logACoAC(__func__, __LINE__, 0, INFO, "[end] splitting instance, the query attributes are in one cluster\n");
+        return 1;
+    }
+
+    // 3. Restrict the instance to the attributes of each cluster
+    ACoACInstance **clusters = (ACoACInstance **)malloc(nClusters * sizeof(ACoACInstance *));
+    int c;
+    for (c = 0; c < nClusters; c++) {
+        clusters[c] = createACoACInstance();
+        iVector.Finalize(clusters[c]->pVecUserIndices);
+        clusters[c]->pVecUserIndices = pInst->pVecUserIndices;
+        clusters[c]->queryUserIdx = pInst->queryUserIdx;
+    }
+    int ruleIdx;
+    iHashSet.InitIterator(pInst->pSetRuleIdxes, &itRuleIdxes);
+    while (itRuleIdxes.HasNext(&itRuleIdxes)) {
+        ruleIdx = *(int *)itRuleIdxes.GetNext(&itRuleIdxes);
+        pRule = (Rule *)iVector.GetElement(pVecRules, ruleIdx);
+        if ((c = clusterOf[pRule->targetAttrIdx]) >= 0) {
+            addRule(clusters[c], ruleIdx);
+        }
+    }
+    HashMap *pmapInitState = iHashBasedTable.GetRow(pInst->pTableInitState, &pInst->queryUserIdx);
+    HashNodeIterator itInitState;
+    if (pmapInitState != NULL) {
+        iHashMap.InitIterator(pmapInitState, &itInitState);
+        while (itInitState.HasNext(&itInitState)) {
+            node = itInitState.GetNext(&itInitState);
+            if ((c = clusterOf[*(int *)node->key]) >= 0) {
+                addUAVByIdx(clusters[c], pInst->queryUserIdx, *(int *)node->key, *(int *)node->value);
+            }
+        }
+    }
+    // The domains of a sliced instance consist of the initial values and the target values of the rules, which are
+    // added above; the domains are still copied so that a cluster has the same domains as the instance
+    IntMapIterator itAttrDom;
+    ValueSet **ppSetDom, *pSetDom;
+    iIntMap.InitIterator(pInst->pMapAttr2Dom, &itAttrDom);
+    while (iIntMap.Next(&itAttrDom)) {
+        if ((c = clusterOf[itAttrDom.key]) < 0) {
+            continue;
+        }
+        if ((ppSetDom = (ValueSet **)iIntMap.Get(clusters[c]->pMapAttr2Dom, itAttrDom.key)) == NULL) {
+            pSetDom = iValueSet.Clone(*(ValueSet **)itAttrDom.value);
+            iIntMap.Put(clusters[c]->pMapAttr2Dom, itAttrDom.key, &pSetDom);
+        } else {
+            iValueSet.AddAll(*ppSetDom, *(ValueSet **)itAttrDom.value);
+        }
+    }
+    IntMapIterator itQueryAVs;
+    iIntMap.InitIterator(pInst->pmapQueryAVs, &itQueryAVs);
+    while (iIntMap.Next(&itQueryAVs)) {
+        iIntMap.Put(clusters[clusterOf[itQueryAVs.key]]->pmapQueryAVs, itQueryAVs.key, itQueryAVs.value);
+    }
+    free(clusterOf);
+
+    double timeSpent = (double)(clock() - startSplitting) / CLOCKS_PER_SEC * 1000;
+    logACoAC(__func__, __LINE__, 0, INFO, "[end] splitting instance into %d clusters, cost => %.2fms\n", nClusters, timeSpent);
+    for (c = 0; c < nClusters; c++) {
+        logACoAC(__func__, __LINE__, 0, INFO, "cluster %d => query attributes: %d, rules: %d\n", c + 1, iIntMap.Size(clusters[c]->pmapQueryAVs),
+                 iHashSet.Size(clusters[c]->pSetRuleIdxes));
+    }
+    *pppClusters = clusters;
+    return nClusters;
+}
+
+void finalizeClusters(ACoACInstance **clusters, int nClusters) {
+    int c;
+    for (c = 0; c < nClusters; c++) {
+        clusters[c]->pVecUserIndices = NULL;
+        finalizeACoACInstance(clusters[c]);
+    }
+    free(clusters);
+}
+
+ACoACResult combineClusterResults(ACoACResult *results, int nResults) {
+    ACoACResult result = {.code = ACoAC_RESULT_REACHABLE, .pVecActions = NULL, .pVecRules = NULL};
+    int i, j;
+    for (i = 0; i < nResults; i++) {
+        if (results[i].code == ACoAC_RESULT_UNREACHABLE) {
+            result.code = ACoAC_RESULT_UNREACHABLE;
+        } else if (results[i].code != ACoAC_RESULT_REACHABLE && result.code == ACoAC_RESULT_REACHABLE) {
+            result.code = results[i].code;
+        }
+    }
+    if (result.code == ACoAC_RESULT_REACHABLE) {
+        result.pVecActions = iVector.Create(sizeof(AdminstrativeAction), 0);
+        for (i = 0; i < nResults; i++) {
+            for (j = 0; results[i].pVecActions != NULL && j < iVector.Size(results[i].pVecActions); j++) {
+                iVector.Add(result.pVecActions, iVector.GetElement(results[i].pVecActions, j));
+            }
+            if (results[i].pVecRules == NULL) {
+                continue;
+            }
+            if (result.pVecRules == NULL) {
+                result.pVecRules = iVector.Create(sizeof(int), 0);
+            }
+            for (j = 0; j < iVector.Size(results[i].pVecRules); j++) {
+                iVector.Add(result.pVecRules, iVector.GetElement(results[i].pVecRules, j));
+            }
+        }
+    }
+    for (i = 0; i < nResults; i++) {
+        if (results[i].pVecActions != NULL) {
+            iVector.Finalize(results[i].pVecActions);
+        }
+        if (results[i].pVecRules != NULL) {
+            iVector.Finalize(results[i].pVecRules);
+        }
+    }
+    return result;
+}
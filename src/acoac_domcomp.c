@@ -0,0 +1,315 @@
+#include "acoac_domcomp.h"
+#include "acoac_utils.h"
+#include <time.h>
+
+/*
+ * The partition of the domain of an attribute being refined. The classes are numbered from 0 to nClasses - 1,
+ * and the arrays indexed by a class have one entry per value, which is the largest possible number of classes.
+ */
+typedef struct _Partition {
+    ValueClasses *classes;
+    // classOf[i]: the class of the value classes->values[i]
+    int *classOf;
+    int nClasses;
+    int *classSize;
+    // The number of values of each class in the splitter being applied, 0 between two splitters
+    int *hits;
+    // The class that the values of each class in the splitter are moved to
+    int *moveTo;
+    // The classes hit by the splitter being applied
+    int *touched;
+} Partition;
+
+static void destructValueClasses(void *ppClasses) {
+    ValueClasses *classes = *(ValueClasses **)ppClasses;
+    free(classes->values);
+    free(classes->reps);
+    free(classes);
+}
+
+static void destructPartition(void *ppPartition) {
+    Partition *partition = *(Partition **)ppPartition;
+    if (partition->classes != NULL) {
+        destructValueClasses(&partition->classes);
+    }
+    free(partition->classOf);
+    free(partition->classSize);
+    free(partition->hits);
+    free(partition->moveTo);
+    free(partition->touched);
+    free(partition);
+}
+
+static Partition *createPartition(ValueSet *pSetDom) {
+    Partition *partition = (Partition *)malloc(sizeof(Partition));
+    int n = iValueSet.Size(pSetDom), i = 0;
+    partition->classes = (ValueClasses *)malloc(sizeof(ValueClasses));
+    partition->classes->nValues = n;
+    partition->classes->values = (int *)malloc(n * sizeof(int));
+    partition->classes->reps = NULL;
+    ValueSetIterator it;
+    iValueSet.InitIterator(pSetDom, &it);
+    while (iValueSet.Next(&it)) {
+        partition->classes->values[i++] = it.value;
+    }
+    // All values are in the class 0 at first
+    partition->classOf = (int *)calloc(n, sizeof(int));
+    partition->nClasses = 1;
+    partition->classSize = (int *)malloc(n * sizeof(int));
+    partition->classSize[0] = n;
+    partition->hits = (int *)calloc(n, sizeof(int));
+    partition->moveTo = (int *)malloc(n * sizeof(int));
+    partition->touched = (int *)malloc(n * sizeof(int));
+    return partition;
+}
+
+/**
+ * Find the position of a value in an ascending array of values.
+ *
+ * @return The position, or -1 if the value is not in the array
+ */
+static int findValue(int *values, int n, int value) {
+    int lo = 0, hi = n - 1, mid;
+    while (lo <= hi) {
+        mid = lo + (hi - lo) / 2;
+        if (values[mid] < value) {
+            lo = mid + 1;
+        } else if (values[mid] > value) {
+            hi = mid - 1;
+        } else {
+            return mid;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Split every class of a partition into its values in a splitter and its values out of it, in time linear in the size
+ * of the splitter. The values of the splitter out of the domain are ignored.
+ *
+ * @param partition[in]: The partition
+ * @param pSetSplitter[in]: The splitter
+ */
+static void refine(Partition *partition, ValueSet *pSetSplitter) {
+    int *values = partition->classes->values, n = partition->classes->nValues;
+    int nTouched = 0, i, c, k;
+    ValueSetIterator it;
+    iValueSet.InitIterator(pSetSplitter, &it);
+    while (iValueSet.Next(&it)) {
+        if ((i = findValue(values, n, it.value)) >= 0 && partition->hits[c = partition->classOf[i]]++ == 0) {
+            partition->touched[nTouched++] = c;
+        }
+    }
+    if (nTouched == 0) {
+        return;
+    }
+    // A class is split only if some but not all of its values are in the splitter, in which case the values in
+    // the splitter are moved to a new class
+    for (k = 0; k < nTouched; k++) {
+        c = partition->touched[k];
+        if (partition->hits[c] < partition->classSize[c]) {
+            partition->moveTo[c] = partition->nClasses;
+            partition->classSize[partition->nClasses++] = partition->hits[c];
+            partition->classSize[c] -= partition->hits[c];
+        } else {
+            partition->moveTo[c] = c;
+        }
+    }
+    iValueSet.InitIterator(pSetSplitter, &it);
+    while (iValueSet.Next(&it)) {
+        if ((i = findValue(values, n, it.value)) >= 0) {
+            partition->classOf[i] = partition->moveTo[partition->classOf[i]];
+        }
+    }
+    for (k = 0; k < nTouched; k++) {
+        partition->hits[partition->touched[k]] = 0;
+    }
+}
+
+/**
+ * Refine the partitions of the attributes in a condition by its atomic conditions.
+ *
+ * @param pmapAttr2Partition[in]: The partitions of the attributes
+ * @param pMapAttr2Dom[in]: The domains of the attributes
+ * @param condIdx[in]: The index of the condition
+ * @param pSetSplitter[in]: A set used to hold the values satisfying an atomic condition
+ */
+static void refineByCondition(IntMap *pmapAttr2Partition, IntMap *pMapAttr2Dom, int condIdx, ValueSet *pSetSplitter) {
+    int nTests, i;
+    IntervalTest *tests = getConditionTests(condIdx, &nTests);
+    Partition **ppPartition;
+    for (i = 0; i < nTests; i++) {
+        ppPartition = (Partition **)iIntMap.Get(pmapAttr2Partition, tests[i].attribute);
+        if (ppPartition == NULL) {
+            continue;
+        }
+        iValueSet.Clear(pSetSplitter);
+        iValueSet.AddAllInRange(pSetSplitter, *(ValueSet **)iIntMap.Get(pMapAttr2Dom, tests[i].attribute), tests[i].lo, tests[i].hi, tests[i].negated);
+        refine(*ppPartition, pSetSplitter);
+    }
+}
+
+/**
+ * Check if the user condition of a rule is on an attribute whose domain is compressed, so that its value sets are
+ * restricted to the representatives and should be copied first if they are shared (see getMutableRule).
+ */
+static int hasCompressedCond(ACoACInstance *pInst, Rule *pRule) {
+    HashNodeIterator itCondValues;
+    HashNode *node;
+    iHashMap.InitIterator(pRule->pmapUserCondValue, &itCondValues);
+    while (itCondValues.HasNext(&itCondValues)) {
+        node = itCondValues.GetNext(&itCondValues);
+        if (iIntMap.ContainsKey(pInst->pMapAttr2Classes, *(int *)node->key)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+void compressDomains(ACoACInstance *pInst) {
+    logACoAC(__func__, __LINE__, 0, INFO, "[start] compressing attribute domains\n");
+    clock_t startCompressing = clock();
+
+    // Only the domains with more than one value can be compressed
+    IntMap *pmapAttr2Partition = iIntMap.Create(sizeof(Partition *));
+    iIntMap.SetDestructValue(pmapAttr2Partition, destructPartition);
+    IntMapIterator itAttr2Dom;
+    Partition *partition;
+    int nValues = 0, nReps = 0;
+    iIntMap.InitIterator(pInst->pMapAttr2Dom, &itAttr2Dom);
+    while (iIntMap.Next(&itAttr2Dom)) {
+        nValues += iValueSet.Size(*(ValueSet **)itAttr2Dom.value);
+        if (iValueSet.Size(*(ValueSet **)itAttr2Dom.value) > 1) {
+            partition = createPartition(*(ValueSet **)itAttr2Dom.value);
+            iIntMap.Put(pmapAttr2Partition, itAttr2Dom.key, &partition);
+        }
+    }
+
+    // The values of an attribute in the safety query are distinguished from the others
+    ValueSet *pSetSplitter = iValueSet.Create();
+    Partition **ppPartition;
+    IntMapIterator itQueryAVs;
+    iIntMap.InitIterator(pInst->pmapQueryAVs, &itQueryAVs);
+    while (iIntMap.Next(&itQueryAVs)) {
+        if ((ppPartition = (Partition **)iIntMap.Get(pmapAttr2Partition, itQueryAVs.key)) != NULL) {
+            iValueSet.Clear(pSetSplitter);
+            iValueSet.Add(pSetSplitter, *(int *)itQueryAVs.value);
+            refine(*ppPartition, pSetSplitter);
+        }
+    }
+
+    // The values are split by the value sets of the user conditions and by the atomic conditions of the administrator conditions
+    HashSetIterator itRules;
+    HashNodeIterator itCondValues;
+    HashNode *node;
+    Rule *pRule;
+    iHashSet.InitIterator(pInst->pSetRuleIdxes, &itRules);
+    while (itRules.HasNext(&itRules)) {
+        pRule = (Rule *)iVector.GetElement(pVecRules, *(int *)itRules.GetNext(&itRules));
+        if (pRule->adminCondIdx != TRUE_COND_IDX) {
+            refineByCondition(pmapAttr2Partition, pInst->pMapAttr2Dom, pRule->adminCondIdx, pSetSplitter);
+        }
+        if (pRule->pmapUserCondValue == NULL) {
+            refineByCondition(pmapAttr2Partition, pInst->pMapAttr2Dom, pRule->userCondIdx, pSetSplitter);
+            continue;
+        }
+        iHashMap.InitIterator(pRule->pmapUserCondValue, &itCondValues);
+        while (itCondValues.HasNext(&itCondValues)) {
+            node = itCondValues.GetNext(&itCondValues);
+            if ((ppPartition = (Partition **)iIntMap.Get(pmapAttr2Partition, *(int *)node->key)) != NULL) {
+                refine(*ppPartition, *(ValueSet **)node->value);
+            }
+        }
+    }
+
+    // Keep the classes of the domains with fewer classes than values, and restrict the domains to the representatives
+    ValueClasses *classes;
+    ValueSet *pSetDom;
+    IntMapIterator itPartitions;
+    int *repOfClass, i;
+    iIntMap.Finalize(pInst->pMapAttr2Classes);
+    pInst->pMapAttr2Classes = iIntMap.Create(sizeof(ValueClasses *));
+    iIntMap.SetDestructValue(pInst->pMapAttr2Classes, destructValueClasses);
+    iIntMap.InitIterator(pmapAttr2Partition, &itPartitions);
+    while (iIntMap.Next(&itPartitions)) {
+        partition = *(Partition **)itPartitions.value;
+        classes = partition->classes;
+        if (partition->nClasses == classes->nValues) {
+            continue;
+        }
+        // The values are in ascending order, so the first value met in a class is its smallest value
+        repOfClass = partition->moveTo;
+        for (i = 0; i < partition->nClasses; i++) {
+            repOfClass[i] = -1;
+        }
+        classes->reps = (int *)malloc(classes->nValues * sizeof(int));
+        pSetDom = *(ValueSet **)iIntMap.Get(pInst->pMapAttr2Dom, itPartitions.key);
+        for (i = 0; i < classes->nValues; i++) {
+            if (repOfClass[partition->classOf[i]] == -1) {
+                repOfClass[partition->classOf[i]] = i;
+            } else {
+                iValueSet.Remove(pSetDom, classes->values[i]);
+            }
+            classes->reps[i] = classes->values[repOfClass[partition->classOf[i]]];
+        }
+        iIntMap.Put(pInst->pMapAttr2Classes, itPartitions.key, &classes);
+        partition->classes = NULL;
+    }
+    iIntMap.Finalize(pmapAttr2Partition);
+    iValueSet.Finalize(pSetSplitter);
+
+    // The value sets of the rules consist of whole classes, so restricting them to the domains keeps one value per class
+    ValueSet **ppSetDom;
+    int ruleIdx;
+    iHashSet.InitIterator(pInst->pSetRuleIdxes, &itRules);
+    while (itRules.HasNext(&itRules) && iIntMap.Size(pInst->pMapAttr2Classes) > 0) {
+        ruleIdx = *(int *)itRules.GetNext(&itRules);
+        pRule = (Rule *)iVector.GetElement(pVecRules, ruleIdx);
+        if (pRule->pmapUserCondValue == NULL || !hasCompressedCond(pInst, pRule)) {
+            continue;
+        }
+        pRule = getMutableRule(ruleIdx);
+        iHashMap.InitIterator(pRule->pmapUserCondValue, &itCondValues);
+        while (itCondValues.HasNext(&itCondValues)) {
+            node = itCondValues.GetNext(&itCondValues);
+            if (iIntMap.ContainsKey(pInst->pMapAttr2Classes, *(int *)node->key)) {
+                ppSetDom = (ValueSet **)iIntMap.Get(pInst->pMapAttr2Dom, *(int *)node->key);
+                iValueSet.RetainAll(*(ValueSet **)node->value, *ppSetDom);
+            }
+        }
+    }
+
+    iIntMap.InitIterator(pInst->pMapAttr2Dom, &itAttr2Dom);
+    while (iIntMap.Next(&itAttr2Dom)) {
+        nReps += iValueSet.Size(*(ValueSet **)itAttr2Dom.value);
+    }
+    double timeSpent = (double)(clock() - startCompressing) / CLOCKS_PER_SEC * 1000;
+    logACoAC(__func__, __LINE__, 0, INFO, "[end] compressing attribute domains, values => %d/%d, cost => %.2fms\n", nReps, nValues, timeSpent);
+}
+
+int getRepresentative(ACoACInstance *pInst, int attrIdx, int valIdx) {
+    ValueClasses **ppClasses;
+    int i;
+    if (pInst->pMapAttr2Classes == NULL || (ppClasses = (ValueClasses **)iIntMap.Get(pInst->pMapAttr2Classes, attrIdx)) == NULL) {
+        return valIdx;
+    }
+    i = findValue((*ppClasses)->values, (*ppClasses)->nValues, valIdx);
+    return i < 0 ? valIdx : (*ppClasses)->reps[i];
+}
+
+int isClassTarget(ACoACInstance *pInst, int attrIdx, int valIdx) {
+    CSRIndex *pIndexTargetAV2Rule = getTargetAV2RuleIndex(pInst);
+    int repIdx = getRepresentative(pInst, attrIdx, valIdx), c;
+    if (repIdx == valIdx && (pInst->pMapAttr2Classes == NULL || !iIntMap.ContainsKey(pInst->pMapAttr2Classes, attrIdx))) {
+        return iCSRIndex.Find(pIndexTargetAV2Rule, attrIdx, valIdx) >= 0;
+    }
+    if (attrIdx >= pIndexTargetAV2Rule->nRows) {
+        return 0;
+    }
+    for (c = pIndexTargetAV2Rule->rowStart[attrIdx]; c < pIndexTargetAV2Rule->rowStart[attrIdx + 1]; c++) {
+        if (getRepresentative(pInst, attrIdx, pIndexTargetAV2Rule->cols[c]) == repIdx) {
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -16,12 +16,54 @@ strCollection *pscValues = NULL;
 
 Dictionary *pdictValue2Index = NULL;
 
-HashMap *pmapAttr2Type = NULL;
+IntMap *pmapAttr2Type = NULL;
 
-HashMap *pmapAttr2DefVal = NULL;
+IntMap *pmapAttr2DefVal = NULL;
+
+Vector *pVecConds = NULL;
+
+HashMap *pmapCond2Index = NULL;
 
 Vector *pVecRules = NULL;
 
+// The rule list that @{pVecRules} is forked from by forkRuleList, or NULL if it is not a fork
+static Vector *pVecRulesBase = NULL;
+
+// A map from the content of a rule (RuleKey) to its index in the @{pVecRules} list, used for merging identical rules.
+// The content is copied since the admin condition of a rule may be replaced during pruning
+static HashMap *pmapRuleKey2Index = NULL;
+
+typedef struct _RuleKey {
+    int adminCondIdx;
+    int userCondIdx;
+    int targetAttrIdx;
+    int targetValueIdx;
+} RuleKey;
+
+static unsigned int ConditionHashCode(void *pCond) {
+    return ((Condition *)pCond)->hashCode;
+}
+
+static int ConditionEqual(void *pCond1, void *pCond2) {
+    Condition *cond1 = (Condition *)pCond1;
+    Condition *cond2 = (Condition *)pCond2;
+    return cond1->hashCode == cond2->hashCode && iHashSet.Equal(&cond1->pSetAtomConds, &cond2->pSetAtomConds);
+}
+
+static unsigned int RuleKeyHashCode(void *pRuleKey) {
+    RuleKey *key = (RuleKey *)pRuleKey;
+    unsigned int hash = 1;
+    hash = 31 * hash + key->adminCondIdx;
+    hash = 31 * hash + key->userCondIdx;
+    hash = 31 * hash + key->targetAttrIdx;
+    hash = 31 * hash + key->targetValueIdx;
+    return hash;
+}
+
+static int RuleKeyEqual(void *pRuleKey1, void *pRuleKey2) {
+    return memcmp(pRuleKey1, pRuleKey2, sizeof(RuleKey)) == 0;
+}
+
 /**
  * Hash code for a rule index.
  * If two rule indices point to two rules with the same content, they should have the same hash code.
@@ -65,9 +107,15 @@ void initGlobalVars() {
     pdictAttr2Index = iDictionary.Create(sizeof(int), 0);
     pscValues = istrCollection.Create(0);
     pdictValue2Index = iDictionary.Create(sizeof(int), 0);
-    pmapAttr2Type = iHashMap.Create(sizeof(int), sizeof(int), IntHashCode, IntEqual);
-    pmapAttr2DefVal = iHashMap.Create(sizeof(int), sizeof(int), IntHashCode, IntEqual);
+    pmapAttr2Type = iIntMap.Create(sizeof(int));
+    pmapAttr2DefVal = iIntMap.Create(sizeof(int));
+    pVecConds = iVector.Create(sizeof(Condition), 0);
+    pmapCond2Index = iHashMap.Create(sizeof(Condition), sizeof(int), ConditionHashCode, ConditionEqual);
     pVecRules = iVector.Create(sizeof(Rule), 0);
+    pmapRuleKey2Index = iHashMap.Create(sizeof(RuleKey), sizeof(int), RuleKeyHashCode, RuleKeyEqual);
+
+    // The condition "TRUE" is always at index TRUE_COND_IDX
+    getConditionIndex(iHashSet.Create(sizeof(AtomCondition), iAtomCondition.HashCode, iAtomCondition.Equal));
 }
 
 void finalizeGlobalVars() {
@@ -77,15 +125,48 @@ void finalizeGlobalVars() {
     iDictionary.Finalize(pdictAttr2Index);
     istrCollection.Finalize(pscValues);
     iDictionary.Finalize(pdictValue2Index);
-    iHashMap.Finalize(pmapAttr2Type);
-    iHashMap.Finalize(pmapAttr2DefVal);
-    for (int i = 0; i < iVector.Size(pVecRules); i++) {
+    iIntMap.Finalize(pmapAttr2Type);
+    iIntMap.Finalize(pmapAttr2DefVal);
+    if (pVecRulesBase != NULL) {
+        releaseRuleList(pVecRules);
+        pVecRules = pVecRulesBase;
+        pVecRulesBase = NULL;
+    }
+    int i;
+    for (i = 0; i < iVector.Size(pVecRules); i++) {
         Rule *pRule = (Rule *)iVector.GetElement(pVecRules, i);
-        iHashSet.Finalize(pRule->adminCond);
-        iHashSet.Finalize(pRule->userCond);
         iHashMap.Finalize(pRule->pmapUserCondValue);
     }
     iVector.Finalize(pVecRules);
+    iHashMap.Finalize(pmapRuleKey2Index);
+    iHashMap.Finalize(pmapCond2Index);
+    Condition *pCond;
+    for (i = 0; i < iVector.Size(pVecConds); i++) {
+        pCond = (Condition *)iVector.GetElement(pVecConds, i);
+        iHashSet.Finalize(pCond->pSetAtomConds);
+        free(pCond->tests);
+    }
+    iVector.Finalize(pVecConds);
+}
+
+/**
+ * Create empty rule indices for the instance in an arena taken from the pool.
+ */
+static void createRuleIndices(ACoACInstance *pInst) {
+    pInst->pArena = iArena.Acquire();
+    pInst->pSetRuleIdxes = iHashSet.CreateInArena(pInst->pArena, sizeof(int), RuleIdxHashCode, RuleIdxEqual);
+    pInst->pIndexTargetAV2Rule = NULL;
+    pInst->pIndexPrecond2Rule = NULL;
+    pInst->pDepGraph = NULL;
+}
+
+void releaseRuleIndices(ACoACInstance *pInst) {
+    iArena.Release(pInst->pArena);
+    pInst->pArena = NULL;
+    pInst->pSetRuleIdxes = NULL;
+    pInst->pIndexTargetAV2Rule = NULL;
+    pInst->pIndexPrecond2Rule = NULL;
+    pInst->pDepGraph = NULL;
 }
 
 ACoACInstance *createACoACInstance() {
@@ -97,30 +178,29 @@ ACoACInstance *createACoACInstance() {
 
     pInst->pVecUserIndices = iVector.Create(sizeof(int), 2);
 
-    pInst->pMapAttr2Dom = iHashMap.Create(sizeof(int), sizeof(HashSet *), IntHashCode, IntEqual);
-    iHashMap.SetDestructValue(pInst->pMapAttr2Dom, iHashSet.DestructPointer); //0xc72fd0
+    pInst->pMapAttr2Dom = iIntMap.Create(sizeof(ValueSet *));
+    iIntMap.SetDestructValue(pInst->pMapAttr2Dom, iValueSet.DestructPointer);
     pInst->pTableInitState = iHashBasedTable.Create(sizeof(int), sizeof(int), sizeof(int), IntHashCode, IntEqual, IntHashCode, IntEqual);
+    pInst->pInitState = NULL;
 
-    pInst->pSetRuleIdxes = iHashSet.Create(sizeof(int), RuleIdxHashCode, RuleIdxEqual);
-
-    pInst->pTableTargetAV2Rule = iHashBasedTable.Create(sizeof(int), sizeof(int), sizeof(HashSet *), IntHashCode, IntEqual, IntHashCode, IntEqual);
-    iHashBasedTable.SetDestructValue(pInst->pTableTargetAV2Rule, iHashSet.DestructPointer);
-    pInst->pTablePrecond2Rule = iHashBasedTable.Create(sizeof(int), sizeof(int), sizeof(HashSet *), IntHashCode, IntEqual, IntHashCode, IntEqual);
-    iHashBasedTable.SetDestructValue(pInst->pTablePrecond2Rule, iHashSet.DestructPointer);
+    createRuleIndices(pInst);
 
     pInst->queryUserIdx = -1;
-    pInst->pmapQueryAVs = iHashMap.Create(sizeof(int), sizeof(int), IntHashCode, IntEqual);
+    pInst->pmapQueryAVs = iIntMap.Create(sizeof(int));
+    pInst->pMapAttr2Classes = NULL;
     return pInst;
 }
 
 void finalizeACoACInstance(ACoACInstance *pInst) {
-    iVector.Finalize(pInst->pVecUserIndices);
-    iHashMap.Finalize(pInst->pMapAttr2Dom);
+    if (pInst->pVecUserIndices != NULL) {
+        iVector.Finalize(pInst->pVecUserIndices);
+    }
+    iIntMap.Finalize(pInst->pMapAttr2Dom);
     iHashBasedTable.Finalize(pInst->pTableInitState);
-    iHashSet.Finalize(pInst->pSetRuleIdxes);
-    iHashBasedTable.Finalize(pInst->pTableTargetAV2Rule);
-    iHashBasedTable.Finalize(pInst->pTablePrecond2Rule);
-    iHashMap.Finalize(pInst->pmapQueryAVs);
+    iInitState.Finalize(pInst->pInitState);
+    releaseRuleIndices(pInst);
+    iIntMap.Finalize(pInst->pmapQueryAVs);
+    iIntMap.Finalize(pInst->pMapAttr2Classes);
     free(pInst);
 }
 
@@ -176,15 +256,20 @@ static char *stringValueIdxToString(void *pStrValIdx) {
  * @param valueIdx[in] The index of the value
  */
 static void addAV(ACoACInstance *pInst, AttrType attrType, int attrIdx, int valueIdx) {
-    HashSet *pDom, **ppDom = iHashMap.Get(pInst->pMapAttr2Dom, &attrIdx);
-    if (ppDom == NULL) {
-        pDom = iHashSet.Create(sizeof(int), IntHashCode, IntEqual);
-        ppDom = &pDom;
-        iHashSet.SetElementToString(*ppDom, attrType == BOOLEAN ? boolValueIdxToString : attrType == INTEGER ? intValueIdxToString
-                                                                                                             : stringValueIdxToString);
-        iHashMap.Put(pInst->pMapAttr2Dom, &attrIdx, ppDom);
+    iValueSet.Add(getOrCreateDomain(pInst, attrIdx), valueIdx);
+}
+
+ValueSet *getOrCreateDomain(ACoACInstance *pInst, int attrIdx) {
+    ValueSet *pDom, **ppDom = iIntMap.Get(pInst->pMapAttr2Dom, attrIdx);
+    if (ppDom != NULL) {
+        return *ppDom;
     }
-    iHashSet.Add(*ppDom, &valueIdx);
+    AttrType attrType = getAttrTypeByIdx(attrIdx);
+    pDom = iValueSet.Create();
+    iValueSet.SetElementToString(pDom, attrType == BOOLEAN ? boolValueIdxToString : attrType == INTEGER ? intValueIdxToString
+                                                                                                       : stringValueIdxToString);
+    iIntMap.Put(pInst->pMapAttr2Dom, attrIdx, &pDom);
+    return pDom;
 }
 
 int addUAV(ACoACInstance *pInst, char *user, char *attr, char *value) {
@@ -210,56 +295,118 @@ int addUAVByIdx(ACoACInstance *pInst, int userIdx, int attrIdx, int valueIdx) {
 }
 
 int addRule(ACoACInstance *pInst, int ruleIdx) {
-    if (iHashSet.Contains(pInst->pSetRuleIdxes, &ruleIdx)) {
+    // Add keeps the existing index of an identical rule, and hashes the rule only once
+    if (!iHashSet.Add(pInst->pSetRuleIdxes, &ruleIdx)) {
         logACoAC(__func__, __LINE__, 0, DEBUG, "Rule exists\n");
         return 0;
     }
-    iHashSet.Add(pInst->pSetRuleIdxes, &ruleIdx);
     Rule *r = (Rule *)iVector.GetElement(pVecRules, ruleIdx);
 
-    // 建立从TargetAttr与TargetValue到Rule的映射
-    HashSet *psetRuleIdxes, **ppsetRuleIdxes = iHashBasedTable.Get(pInst->pTableTargetAV2Rule, &r->targetAttrIdx, &r->targetValueIdx);
-    if (ppsetRuleIdxes == NULL) {
-        psetRuleIdxes = iHashSet.Create(sizeof(int), IntHashCode, IntEqual);
-        ppsetRuleIdxes = &psetRuleIdxes;
-        iHashBasedTable.Put(pInst->pTableTargetAV2Rule, &r->targetAttrIdx, &r->targetValueIdx, ppsetRuleIdxes);
-    }
-    iHashSet.Add(*ppsetRuleIdxes, &ruleIdx);
-
-    // 建立从用户条件属性到Rule的映射
-    if (r->pmapUserCondValue != NULL) {
-        int *pAttrIdx, *pValueIdx;
-        HashNode *nodeUserCondValue;
-        HashSet *psetVals;
-
-        HashSet *psetRulesOfAV, **ppsetRulesOfAV;
-        HashNodeIterator *itUserCondValue = iHashMap.NewIterator(r->pmapUserCondValue);
-        HashSetIterator *itVals;
-        while (itUserCondValue->HasNext(itUserCondValue)) {
-            nodeUserCondValue = (HashNode *)itUserCondValue->GetNext(itUserCondValue);
-            pAttrIdx = (int *)nodeUserCondValue->key;
-            psetVals = *(HashSet **)nodeUserCondValue->value;
-
-            itVals = iHashSet.NewIterator(psetVals);
-            while (itVals->HasNext(itVals)) {
-                pValueIdx = (int *)itVals->GetNext(itVals);
-                ppsetRulesOfAV = iHashBasedTable.Get(pInst->pTablePrecond2Rule, pAttrIdx, pValueIdx);
-                if (ppsetRulesOfAV == NULL) {
-                    psetRulesOfAV = iHashSet.Create(sizeof(int), IntHashCode, IntEqual);
-                    ppsetRulesOfAV = &psetRulesOfAV;
-                    iHashBasedTable.Put(pInst->pTablePrecond2Rule, pAttrIdx, pValueIdx, ppsetRulesOfAV);
-                }
-                iHashSet.Add(*ppsetRulesOfAV, &ruleIdx);
-            }
-            iHashSet.DeleteIterator(itVals);
-        }
-        iHashMap.DeleteIterator(itUserCondValue);
-    }
+    // 规则集发生变化，从属性值到规则的索引在下次使用时重新构建
+    pInst->pIndexTargetAV2Rule = NULL;
+    pInst->pIndexPrecond2Rule = NULL;
+    pInst->pDepGraph = NULL;
+
     AttrType attrType = getAttrTypeByIdx(r->targetAttrIdx);
     addAV(pInst, attrType, r->targetAttrIdx, r->targetValueIdx);
     return 1;
 }
 
+int addRulesOf(ACoACInstance *pInst, ACoACInstance *pSrc) {
+    IntMapIterator itAttrDom;
+    iIntMap.InitIterator(pSrc->pMapAttr2Dom, &itAttrDom);
+    while (iIntMap.Next(&itAttrDom)) {
+        iValueSet.AddAll(getOrCreateDomain(pInst, itAttrDom.key), *(ValueSet **)itAttrDom.value);
+    }
+    if (!iHashSet.AddAll(pInst->pSetRuleIdxes, pSrc->pSetRuleIdxes)) {
+        return 0;
+    }
+    pInst->pIndexTargetAV2Rule = NULL;
+    pInst->pIndexPrecond2Rule = NULL;
+    pInst->pDepGraph = NULL;
+    return 1;
+}
+
+/**
+ * Build the indices from attribute-value pairs to rules in one pass over the rules of the instance.
+ * The rules are visited in ascending order, so the rules of a pair are listed in ascending order.
+ * The indices and the entries they are built from are allocated in the arena of the instance.
+ */
+static void buildRuleIndices(ACoACInstance *pInst) {
+    int nRules = iHashSet.Size(pInst->pSetRuleIdxes), nPrecondEntries = 0, i, attrIdx;
+    int *ruleIdxes = (int *)iArena.Alloc(pInst->pArena, nRules * sizeof(int));
+    Rule *r;
+    HashNode *node;
+    HashSetIterator itRules;
+    HashNodeIterator itUserCondValue;
+    ValueSetIterator itVals;
+
+    i = 0;
+    iHashSet.InitIterator(pInst->pSetRuleIdxes, &itRules);
+    while (itRules.HasNext(&itRules)) {
+        ruleIdxes[i++] = *(int *)itRules.GetNext(&itRules);
+    }
+    qsort(ruleIdxes, nRules, sizeof(int), compareInts);
+
+    // 统计用户条件中的属性值对的数量
+    for (i = 0; i < nRules; i++) {
+        r = (Rule *)iVector.GetElement(pVecRules, ruleIdxes[i]);
+        if (r->pmapUserCondValue == NULL) {
+            continue;
+        }
+        iHashMap.InitIterator(r->pmapUserCondValue, &itUserCondValue);
+        while (itUserCondValue.HasNext(&itUserCondValue)) {
+            node = (HashNode *)itUserCondValue.GetNext(&itUserCondValue);
+            nPrecondEntries += iValueSet.Size(*(ValueSet **)node->value);
+        }
+    }
+
+    CSREntry *targetEntries = (CSREntry *)iArena.Alloc(pInst->pArena, nRules * sizeof(CSREntry));
+    CSREntry *precondEntries = (CSREntry *)iArena.Alloc(pInst->pArena, nPrecondEntries * sizeof(CSREntry));
+    nPrecondEntries = 0;
+    for (i = 0; i < nRules; i++) {
+        r = (Rule *)iVector.GetElement(pVecRules, ruleIdxes[i]);
+        targetEntries[i] = (CSREntry){.row = r->targetAttrIdx, .col = r->targetValueIdx, .elem = ruleIdxes[i]};
+        if (r->pmapUserCondValue == NULL) {
+            continue;
+        }
+        iHashMap.InitIterator(r->pmapUserCondValue, &itUserCondValue);
+        while (itUserCondValue.HasNext(&itUserCondValue)) {
+            node = (HashNode *)itUserCondValue.GetNext(&itUserCondValue);
+            attrIdx = *(int *)node->key;
+            iValueSet.InitIterator(*(ValueSet **)node->value, &itVals);
+            while (iValueSet.Next(&itVals)) {
+                precondEntries[nPrecondEntries++] = (CSREntry){.row = attrIdx, .col = itVals.value, .elem = ruleIdxes[i]};
+            }
+        }
+    }
+
+    int nAttrs = istrCollection.Size(pscAttrs);
+    pInst->pIndexTargetAV2Rule = iCSRIndex.Build(pInst->pArena, nAttrs, targetEntries, nRules);
+    pInst->pIndexPrecond2Rule = iCSRIndex.Build(pInst->pArena, nAttrs, precondEntries, nPrecondEntries);
+}
+
+CSRIndex *getTargetAV2RuleIndex(ACoACInstance *pInst) {
+    if (pInst->pIndexTargetAV2Rule == NULL) {
+        buildRuleIndices(pInst);
+    }
+    return pInst->pIndexTargetAV2Rule;
+}
+
+CSRIndex *getPrecond2RuleIndex(ACoACInstance *pInst) {
+    if (pInst->pIndexPrecond2Rule == NULL) {
+        buildRuleIndices(pInst);
+    }
+    return pInst->pIndexPrecond2Rule;
+}
+
+DepGraph *getDependencyGraph(ACoACInstance *pInst) {
+    if (pInst->pDepGraph == NULL) {
+        pInst->pDepGraph = iDepGraph.Build(pInst->pArena, getTargetAV2RuleIndex(pInst), getPrecond2RuleIndex(pInst));
+    }
+    return pInst->pDepGraph;
+}
+
 int getUserIndex(char *user) {
     int *i = (int *)iDictionary.GetElement(pdictUser2Index, user);
     if (i == NULL) {
@@ -310,12 +457,108 @@ int getValueIndex(AttrType attrType, char *value, int *pValueIdx) {
     }
 }
 
+int getConditionIndex(HashSet *cond) {
+    // The hash code of the set is computed only once, and then cached in the condition
+    Condition condition = {.pSetAtomConds = cond, .hashCode = iHashSet.HashCode(&cond)};
+    int *pCondIdx = (int *)iHashMap.Get(pmapCond2Index, &condition);
+    if (pCondIdx != NULL) {
+        iHashSet.Finalize(cond);
+        return *pCondIdx;
+    }
+    // A new condition is compiled once to interval tests, which are shared by all rules with the condition
+    HashSetIterator it;
+    condition.nTests = iHashSet.Size(cond);
+    condition.tests = (IntervalTest *)malloc((condition.nTests + 1) * sizeof(IntervalTest));
+    condition.nTests = 0;
+    iHashSet.InitIterator(cond, &it);
+    while (it.HasNext(&it)) {
+        iAtomCondition.Compile((AtomCondition *)it.GetNext(&it), &condition.tests[condition.nTests++]);
+    }
+    int condIdx = iVector.Size(pVecConds);
+    iVector.Add(pVecConds, &condition);
+    iHashMap.Put(pmapCond2Index, &condition, &condIdx);
+    return condIdx;
+}
+
+HashSet *getCondition(int condIdx) {
+    return ((Condition *)iVector.GetElement(pVecConds, condIdx))->pSetAtomConds;
+}
+
+IntervalTest *getConditionTests(int condIdx, int *pnTests) {
+    Condition *pCond = (Condition *)iVector.GetElement(pVecConds, condIdx);
+    *pnTests = pCond->nTests;
+    return pCond->tests;
+}
+
+unsigned int getConditionHashCode(int condIdx) {
+    return ((Condition *)iVector.GetElement(pVecConds, condIdx))->hashCode;
+}
+
+int getRuleIndex(int adminCondIdx, int userCondIdx, int targetAttrIdx, int targetValueIdx) {
+    RuleKey key = {adminCondIdx, userCondIdx, targetAttrIdx, targetValueIdx};
+    int *pRuleIdx = (int *)iHashMap.Get(pmapRuleKey2Index, &key);
+    if (pRuleIdx != NULL) {
+        return *pRuleIdx;
+    }
+    Rule *r = iRule.Create(adminCondIdx, userCondIdx, targetAttrIdx, targetValueIdx);
+    iVector.Add(pVecRules, r);
+    free(r);
+    int ruleIdx = iVector.Size(pVecRules) - 1;
+    iHashMap.Put(pmapRuleKey2Index, &key, &ruleIdx);
+    return ruleIdx;
+}
+
+Vector *forkRuleList(Vector *pVecBase) {
+    pVecRulesBase = pVecBase;
+    return iVector.Copy(pVecBase);
+}
+
+/**
+ * Check if the value sets of the user condition of a rule in a forked rule list are shared with the base list.
+ */
+static int isCondValueShared(Rule *pRule, int ruleIdx) {
+    return pVecRulesBase != NULL && ruleIdx < iVector.Size(pVecRulesBase) && pRule->pmapUserCondValue != NULL &&
+           pRule->pmapUserCondValue == ((Rule *)iVector.GetElement(pVecRulesBase, ruleIdx))->pmapUserCondValue;
+}
+
+Rule *getMutableRule(int ruleIdx) {
+    Rule *pRule = (Rule *)iVector.GetElement(pVecRules, ruleIdx);
+    if (pVecRules == pVecRulesBase || !isCondValueShared(pRule, ruleIdx)) {
+        return pRule;
+    }
+    HashMap *pmapUserCondValue = iHashMap.Create(sizeof(int), sizeof(ValueSet *), IntHashCode, IntEqual);
+    iHashMap.SetDestructValue(pmapUserCondValue, iValueSet.DestructPointer);
+    HashNodeIterator itUserCondValue;
+    HashNode *node;
+    ValueSet *pSet;
+    iHashMap.InitIterator(pRule->pmapUserCondValue, &itUserCondValue);
+    while (itUserCondValue.HasNext(&itUserCondValue)) {
+        node = itUserCondValue.GetNext(&itUserCondValue);
+        pSet = iValueSet.Clone(*(ValueSet **)node->value);
+        iHashMap.Put(pmapUserCondValue, node->key, &pSet);
+    }
+    pRule->pmapUserCondValue = pmapUserCondValue;
+    return pRule;
+}
+
+void releaseRuleList(Vector *pVecFork) {
+    int i;
+    Rule *pRule;
+    for (i = 0; i < iVector.Size(pVecFork); i++) {
+        pRule = (Rule *)iVector.GetElement(pVecFork, i);
+        if (pRule->pmapUserCondValue != NULL && !isCondValueShared(pRule, i)) {
+            iHashMap.Finalize(pRule->pmapUserCondValue);
+        }
+    }
+    iVector.Finalize(pVecFork);
+}
+
 AttrType getAttrType(char *attr) {
     return getAttrTypeByIdx(getAttrIndex(attr));
 }
 
 AttrType getAttrTypeByIdx(int attrIdx) {
-    int *pAttrTypeIdx = (int *)iHashMap.Get(pmapAttr2Type, &attrIdx);
+    int *pAttrTypeIdx = (int *)iIntMap.Get(pmapAttr2Type, attrIdx);
     if (pAttrTypeIdx == NULL) {
         fprintf(stderr, "error: cannot find attribute index %d, please check the policy again\n", attrIdx);
         exit(-1);
@@ -338,11 +581,14 @@ char *getValueByIndex(AttrType attrType, int valueIdx) {
 }
 
 int getInitValue(ACoACInstance *pInst, int userIdx, int attrIdx) {
+    if (pInst->pInitState != NULL && userIdx < pInst->pInitState->nUsers && attrIdx < pInst->pInitState->nAttrs) {
+        return iInitState.Get(pInst->pInitState, userIdx, attrIdx);
+    }
     int *pValueIdx = (int *)iHashBasedTable.Get(pInst->pTableInitState, &userIdx, &attrIdx);
     if (pValueIdx != NULL) {
         return *pValueIdx;
     }
-    int *pDefValIdx = (int *)iHashMap.Get(pmapAttr2DefVal, &attrIdx);
+    int *pDefValIdx = (int *)iIntMap.Get(pmapAttr2DefVal, attrIdx);
     if (pDefValIdx == NULL) {
         logACoAC(__func__, __LINE__, 0, ERROR, "cannot find attribute %s in the default value map\n", istrCollection.GetElement(pscAttrs, attrIdx));
         exit(-1);
@@ -363,33 +609,33 @@ static char *solution(Rule *r) {
     if (iHashMap.Size(r->pmapUserCondValue) == 0) {
         return strdup("none");
     }
-    HashNodeIterator *it = iHashMap.NewIterator(r->pmapUserCondValue);
+    HashNodeIterator it;
+    iHashMap.InitIterator(r->pmapUserCondValue, &it);
     HashNode *node;
     int *pAttrIdx;
     AttrType attrType;
-    HashSet *psetVals;
-    while (it->HasNext(it)) {
-        node = it->GetNext(it);
+    ValueSet *psetVals;
+    while (it.HasNext(&it)) {
+        node = it.GetNext(&it);
         pAttrIdx = (int *)node->key;
-        psetVals = *(HashSet **)node->value;
+        psetVals = *(ValueSet **)node->value;
         attrType = getAttrTypeByIdx(*pAttrIdx);
         switch (attrType) {
         case BOOLEAN:
-            iHashSet.SetElementToString(psetVals, boolValueIdxToString);
+            iValueSet.SetElementToString(psetVals, boolValueIdxToString);
             break;
         case INTEGER:
-            iHashSet.SetElementToString(psetVals, intValueIdxToString);
+            iValueSet.SetElementToString(psetVals, intValueIdxToString);
             break;
         case STRING:
-            iHashSet.SetElementToString(psetVals, stringValueIdxToString);
+            iValueSet.SetElementToString(psetVals, stringValueIdxToString);
             break;
         default:
             logACoAC(__func__, __LINE__, 0, ERROR, "The attribute datatype should be %d(boolean), %d(string), or %d(integer)\n", BOOLEAN, STRING, INTEGER);
             exit(-1);
         }
     }
-    iHashMap.DeleteIterator(it);
-    return mapToString(r->pmapUserCondValue, attrIdxToString, iHashSet.ToString);
+    return mapToString(r->pmapUserCondValue, attrIdxToString, iValueSet.ToString);
 }
 
 /**
@@ -428,11 +674,12 @@ static char *conditionToString(HashSet *condition) {
     if (iHashSet.Size(condition) == 0) {
         atomCondStr = strdup("TRUE");
     } else {
-        HashSetIterator *it = iHashSet.NewIterator(condition);
+        HashSetIterator it;
+        iHashSet.InitIterator(condition, &it);
         char *opStr, *attr, *value;
         int first = 1, cur = 0;
-        while (it->HasNext(it)) {
-            AtomCondition *atomCond = it->GetNext(it);
+        while (it.HasNext(&it)) {
+            AtomCondition *atomCond = it.GetNext(&it);
             attr = istrCollection.GetElement(pscAttrs, atomCond->attribute);
             value = getValueByIndex(getAttrTypeByIdx(atomCond->attribute), atomCond->value);
             opStr = getOpStr(atomCond->op);
@@ -454,7 +701,6 @@ static char *conditionToString(HashSet *condition) {
             free(value);
         }
         atomCondStr[cur++] = '\0';
-        iHashSet.DeleteIterator(it);
     }
     return atomCondStr;
 }
@@ -468,8 +714,8 @@ static char *conditionToString(HashSet *condition) {
 char *RuleToString(void *ppRule) {
     Rule *r = *(Rule **)ppRule;
 
-    char *adminCondStr = conditionToString(r->adminCond);
-    char *userCondStr = conditionToString(r->userCond);
+    char *adminCondStr = conditionToString(getCondition(r->adminCondIdx));
+    char *userCondStr = conditionToString(getCondition(r->userCondIdx));
     char *targetAttr = istrCollection.GetElement(pscAttrs, r->targetAttrIdx);
     AttrType attrType = getAttrTypeByIdx(r->targetAttrIdx);
     char *targetValue = getValueByIndex(attrType, r->targetValueIdx);
@@ -522,98 +768,69 @@ void init(ACoACInstance *pInst) {
     clock_t initStartTime = clock();
 
     /*计算值域*/
-    HashMap *map = iHashMap.Create(sizeof(int), sizeof(int), IntHashCode, IntEqual);
+    // 将初始状态转换为列存储，同时统计每个属性被多少个用户显式指定了初始值
+    iInitState.Finalize(pInst->pInitState);
+    pInst->pInitState = iInitState.Create(pInst->pTableInitState, istrCollection.Size(pscUsers), istrCollection.Size(pscAttrs), pmapAttr2DefVal);
+    InitState *pInitState = pInst->pInitState;
     int userNum = iVector.Size(pInst->pVecUserIndices);
     int *pAttrIdx;
-    int flag, *pFlag;
-    if (iHashMap.Size(pInst->pTableInitState->pRowMap) == userNum) {
-        int first = 1;
-        HashNodeIterator *itInitstate = iHashMap.NewIterator(pInst->pTableInitState->pRowMap), *itAVs;
-        HashNode *nodeInitState, *nodeAVs;
-        HashMap *pmapAVs;
-        while (itInitstate->HasNext(itInitstate)) {
-            nodeInitState = (HashNode *)itInitstate->GetNext(itInitstate);
-            pmapAVs = *(HashMap **)nodeInitState->value;
-
-            itAVs = iHashMap.NewIterator(pmapAVs);
-            while (itAVs->HasNext(itAVs)) {
-                nodeAVs = (HashNode *)itAVs->GetNext(itAVs);
-                pAttrIdx = (int *)nodeAVs->key;
-                if (first) {
-                    flag = 1;
-                    iHashMap.Put(map, pAttrIdx, &flag);
-                } else {
-                    pFlag = iHashMap.Get(map, pAttrIdx);
-                    if (pFlag != NULL) {
-                        *pFlag = *pFlag + 1;
-                    }
-                }
-            }
-            if (first) {
-                first = 0;
-            }
-            iHashMap.DeleteIterator(itAVs);
-        }
-        iHashMap.DeleteIterator(itInitstate);
-    }
 
-    HashNodeIterator *itAttr2DefVal = iHashMap.NewIterator(pmapAttr2DefVal);
-    HashNode *nodeAttr2DefVal;
+    IntMapIterator itAttr2DefVal;
     int *pDefValIdx;
-    HashSet *pDom, **ppDom;
+    ValueSet *pDom, **ppDom;
     AttrType attrType;
-    while (itAttr2DefVal->HasNext(itAttr2DefVal)) {
-        nodeAttr2DefVal = (HashNode *)itAttr2DefVal->GetNext(itAttr2DefVal);
-        pAttrIdx = (int *)nodeAttr2DefVal->key;
+    iIntMap.InitIterator(pmapAttr2DefVal, &itAttr2DefVal);
+    while (iIntMap.Next(&itAttr2DefVal)) {
+        pAttrIdx = &itAttr2DefVal.key;
         attrType = getAttrTypeByIdx(*pAttrIdx);
-        pFlag = iHashMap.Get(map, pAttrIdx);
-        if (pFlag == NULL || *pFlag != userNum) {
-            pDefValIdx = (int *)nodeAttr2DefVal->value;
-            ppDom = iHashMap.Get(pInst->pMapAttr2Dom, pAttrIdx);
+        // 只有所有用户都显式指定了该属性的初始值时，默认值才不在值域中
+        if (pInitState->nRows != userNum || pInitState->nListed[*pAttrIdx] != userNum) {
+            pDefValIdx = (int *)itAttr2DefVal.value;
+            ppDom = iIntMap.Get(pInst->pMapAttr2Dom, *pAttrIdx);
             if (ppDom == NULL) {
-                pDom = iHashSet.Create(sizeof(int), IntHashCode, IntEqual);
+                pDom = iValueSet.Create();
                 ppDom = &pDom;
-                iHashMap.Put(pInst->pMapAttr2Dom, pAttrIdx, ppDom);
-                iHashSet.SetElementToString(*ppDom, attrType == BOOLEAN ? boolValueIdxToString : attrType == INTEGER ? intValueIdxToString
+                iIntMap.Put(pInst->pMapAttr2Dom, *pAttrIdx, ppDom);
+                iValueSet.SetElementToString(*ppDom, attrType == BOOLEAN ? boolValueIdxToString : attrType == INTEGER ? intValueIdxToString
                                                                                                                      : stringValueIdxToString);
             }
-            iHashSet.Add(*ppDom, pDefValIdx);
+            iValueSet.Add(*ppDom, *pDefValIdx);
         }
     }
-    iHashMap.DeleteIterator(itAttr2DefVal);
-    iHashMap.Finalize(map);
 
-    HashSet *pSetNewRules = iHashSet.Create(sizeof(int), RuleIdxHashCode, RuleIdxEqual);
-    int ruleIdx;
+    // The rules are discretized and added back in ascending order, so that of the rules made identical by the
+    // discretization, the one with the lowest index is kept
+    int nOldRules = iHashSet.Size(pInst->pSetRuleIdxes), nRules = 0, ruleIdx, i;
+    int *ruleIdxes = (int *)malloc((nOldRules + 1) * sizeof(int));
     Rule *r;
     char *rStr;
-    HashSetIterator *itRules = iHashSet.NewIterator(pInst->pSetRuleIdxes);
-    while (itRules->HasNext(itRules)) {
-        ruleIdx = *(int *)itRules->GetNext(itRules);
+    HashSetIterator itRules;
+    iHashSet.InitIterator(pInst->pSetRuleIdxes, &itRules);
+    while (itRules.HasNext(&itRules)) {
+        ruleIdxes[nRules++] = *(int *)itRules.GetNext(&itRules);
+    }
+    qsort(ruleIdxes, nRules, sizeof(int), compareInts);
+    nRules = 0;
+    for (i = 0; i < nOldRules; i++) {
+        ruleIdx = ruleIdxes[i];
         r = (Rule *)iVector.GetElement(pVecRules, ruleIdx);
         if (iRule.DiscreteCond(r, pInst->pMapAttr2Dom) != -1) {
-            iHashSet.Add(pSetNewRules, &ruleIdx);
+            ruleIdxes[nRules++] = ruleIdx;
         } else {
             rStr = RuleToString(&r);
             logACoAC(__func__, __LINE__, 0, DEBUG, "The user condition cannot be satisfied: %s\n", rStr);
             free(rStr);
         }
     }
-    iHashSet.DeleteIterator(itRules);
-
-    int nOldRules = iHashSet.Size(pInst->pSetRuleIdxes);
 
-    iHashSet.Clear(pInst->pSetRuleIdxes);
-    iHashBasedTable.Clear(pInst->pTableTargetAV2Rule);
-    iHashBasedTable.Clear(pInst->pTablePrecond2Rule);
+    // Rebuild the rule indices in a recycled arena instead of clearing them entry by entry
+    releaseRuleIndices(pInst);
+    createRuleIndices(pInst);
 
-    itRules = iHashSet.NewIterator(pSetNewRules);
-    while (itRules->HasNext(itRules)) {
-        ruleIdx = *(int *)itRules->GetNext(itRules);
-        addRule(pInst, ruleIdx);
+    for (i = 0; i < nRules; i++) {
+        addRule(pInst, ruleIdxes[i]);
     }
-    iHashSet.DeleteIterator(itRules);
-    iHashSet.Finalize(pSetNewRules);
+    free(ruleIdxes);
 
     int nNewRules = iHashSet.Size(pInst->pSetRuleIdxes);
 
@@ -19,11 +19,13 @@ typedef struct {
     int minAtomConds;
     int maxAtomConds;
     int *nAtomConds;
+    // The maximum number of atom conditions per administrator condition, 0 for the condition Admin=true
+    int maxAdminAtomConds;
     int nQueryAV;
 } GenParam;
 
 static GenParam createGenParam(int nUsers, int nStrAttrs, int nNumAttrs, int nBoolAttrs, int maxDomSize,
-                               double initAVDefaultRate, int nRules, int minAtomConds, int maxAtomConds, int nQueryAV) {
+                               double initAVDefaultRate, int nRules, int minAtomConds, int maxAtomConds, int maxAdminAtomConds, int nQueryAV) {
     GenParam genParam;
     genParam.nUsers = nUsers;
 
@@ -46,6 +48,7 @@ static GenParam createGenParam(int nUsers, int nStrAttrs, int nNumAttrs, int nBo
         genParam.nAtomConds[i] = rand() % (maxAtomConds - minAtomConds + 1) + minAtomConds;
     }
 
+    genParam.maxAdminAtomConds = maxAdminAtomConds;
     genParam.nQueryAV = nQueryAV;
     return genParam;
 }
@@ -127,22 +130,24 @@ static void selectFrom(int m, int n, int *selected) {
     }
 }
 
-static Rule *genRule(GenParam *genParam, int nAtomConds) {
-    // 1. Generate admin condition (Admin=true)
-    HashSet *adminCond = iHashSet.Create(sizeof(AtomCondition), iAtomCondition.HashCode, iAtomCondition.Equal);
-    AtomCondition atomCond = {.attribute = 0, .value = 1, .op = EQUAL};
-    iHashSet.Add(adminCond, &atomCond);
-
-    // 2. Generate user condition
-    HashSet *userCond = iHashSet.Create(sizeof(AtomCondition), iAtomCondition.HashCode, iAtomCondition.Equal);
+/**
+ * Generate a conjunction of random atom conditions over the attributes other than Admin
+ *
+ * @param genParam[in] The parameters of the generation
+ * @param nAtomConds[in] The number of atom conditions
+ * @return The index of the condition
+ */
+static int genCondition(GenParam *genParam, int nAtomConds) {
+    HashSet *cond = iHashSet.Create(sizeof(AtomCondition), iAtomCondition.HashCode, iAtomCondition.Equal);
+    AtomCondition atomCond;
     int j, attrIdx, valIdx, ret;
     AttrType attrType;
     comparisonOperator op;
     char val[20];
     for (j = 0; j < nAtomConds; j++) {
-        // 3.1 Randomly select an attribute
+        // 1. Randomly select an attribute
         attrIdx = rand() % genParam->nAttrs + 1;
-        // 3.2 Generate a value for the attribute
+        // 2. Generate a value for the attribute
         genValForAttr(genParam, attrIdx, val);
         attrType = getAttrTypeByIdx(attrIdx);
         ret = getValueIndex(attrType, val, &valIdx);
@@ -150,18 +155,37 @@ static Rule *genRule(GenParam *genParam, int nAtomConds) {
             logACoAC(__func__, __LINE__, 0, ERROR, "Failed to generate a value for the attribute: %s, %s\n", istrCollection.GetElement(pscAttrs, attrIdx), val);
             exit(ret);
         }
-        // 3.3 If the attribute is integer, generate a random operator, otherwise set the operator to EQUAL
+        // 3. If the attribute is integer, generate a random operator, otherwise set the operator to EQUAL
         op = attrType == INTEGER ? (comparisonOperator)(rand() % 6) : EQUAL;
 
         atomCond = (AtomCondition){.attribute = attrIdx, .value = valIdx, .op = op};
-        iHashSet.Add(userCond, &atomCond);
+        iHashSet.Add(cond, &atomCond);
+    }
+    return getConditionIndex(cond);
+}
+
+static int genRule(GenParam *genParam, int nAtomConds) {
+    // 1. Generate admin condition, Admin=true by default
+    int adminCondIdx;
+    if (genParam->maxAdminAtomConds > 0) {
+        adminCondIdx = genCondition(genParam, rand() % genParam->maxAdminAtomConds + 1);
+    } else {
+        HashSet *adminCond = iHashSet.Create(sizeof(AtomCondition), iAtomCondition.HashCode, iAtomCondition.Equal);
+        AtomCondition atomCond = {.attribute = 0, .value = 1, .op = EQUAL};
+        iHashSet.Add(adminCond, &atomCond);
+        adminCondIdx = getConditionIndex(adminCond);
     }
 
-    // 4. Randomly select a target attribute
+    // 2. Generate user condition
+    int userCondIdx = genCondition(genParam, nAtomConds);
+    int attrIdx, valIdx, ret;
+    char val[20];
+
+    // 3. Randomly select a target attribute
     attrIdx = rand() % genParam->nAttrs + 1;
     char *targetAttr = istrCollection.GetElement(pscAttrs, attrIdx);
 
-    // 5. Randomly select a target attribute value
+    // 4. Randomly select a target attribute value
     genValForAttr(genParam, attrIdx, val);
     ret = getValueIndex(getAttrTypeByIdx(attrIdx), val, &valIdx);
     if (ret) {
@@ -169,7 +193,7 @@ static Rule *genRule(GenParam *genParam, int nAtomConds) {
         exit(ret);
     }
 
-    return iRule.Create(adminCond, userCond, attrIdx, valIdx);
+    return getRuleIndex(adminCondIdx, userCondIdx, attrIdx, valIdx);
 }
 
 static ACoACInstance *generate(GenParam *genParam) {
@@ -201,8 +225,8 @@ static ACoACInstance *generate(GenParam *genParam) {
     // The first attribute is Admin, a boolean attribute with default value "false"
     istrCollection.Add(pscAttrs, "Admin");
     iDictionary.Insert(pdictAttr2Index, "Admin", &attrIdx);
-    iHashMap.Put(pmapAttr2Type, &attrIdx, &attrType);
-    iHashMap.Put(pmapAttr2DefVal, &attrIdx, &defValIdx);
+    iIntMap.Put(pmapAttr2Type, attrIdx, &attrType);
+    iIntMap.Put(pmapAttr2DefVal, attrIdx, &defValIdx);
     genParam->domSize[attrIdx] = 2;
     attrIdx++;
 
@@ -220,16 +244,16 @@ static ACoACInstance *generate(GenParam *genParam) {
 
             istrCollection.Add(pscAttrs, attrName);
             iDictionary.Insert(pdictAttr2Index, attrName, &attrIdx);
-            iHashMap.Put(pmapAttr2Type, &attrIdx, &attrType);
+            iIntMap.Put(pmapAttr2Type, attrIdx, &attrType);
 
             if (attrType == STRING) {
                 sprintf(attrVal, "%s_0", attrName);
                 istrCollection.Add(pscValues, attrVal);
                 iDictionary.Insert(pdictValue2Index, attrVal, &stringValCnt);
-                iHashMap.Put(pmapAttr2DefVal, &attrIdx, &stringValCnt);
+                iIntMap.Put(pmapAttr2DefVal, attrIdx, &stringValCnt);
                 stringValCnt++;
             } else {
-                iHashMap.Put(pmapAttr2DefVal, &attrIdx, &defValIdx);
+                iIntMap.Put(pmapAttr2DefVal, attrIdx, &defValIdx);
             }
 
             genParam->domSize[attrIdx] = attrType == BOOLEAN ? 2 : rand() % genParam->maxDomSize + 1;
@@ -255,12 +279,8 @@ static ACoACInstance *generate(GenParam *genParam) {
     addUAV(pInst, "u0", "Admin", "true");
 
     // Generate rules
-    Rule *r;
     for (i = 0; i < genParam->nRules; i++) {
-        r = genRule(genParam, genParam->nAtomConds[i]);
-        iVector.Add(pVecRules, r);
-        free(r);
-        addRule(pInst, i);
+        addRule(pInst, genRule(genParam, genParam->nAtomConds[i]));
     }
 
     // Set the last user as the query user
@@ -281,7 +301,7 @@ static ACoACInstance *generate(GenParam *genParam) {
             logACoAC(__func__, __LINE__, 0, ERROR, "Failed to handle query av: %s, %s\n", istrCollection.GetElement(pscAttrs, attrIdx), attrVal);
             exit(ret);
         }
-        iHashMap.Put(pInst->pmapQueryAVs, &attrIdx, &valIdx);
+        iIntMap.Put(pInst->pmapQueryAVs, attrIdx, &valIdx);
     }
 
     return pInst;
@@ -298,14 +318,16 @@ int main(int argc, char **argv) {
                   "  -r <number of rules>\n"
                   "  -l <minimum number of atom conditions per rule>\n"
                   "  -h <maximum number of atom conditions per rule>\n"
+                  "  -a <maximum number of atom conditions per administrator condition (default 0: Admin=true)>\n"
                   "  -q <number of query attributes>\n"
                   "  -o <output file>\n";
 
     int nUsers, nBoolAttrs, nIntAttrs, nStrAttrs, maxDomSize, initAVDefaultRate, nRules, minAtomConds, maxAtomConds, nQueryAV;
+    int maxAdminAtomConds = 0;
     char *outputFilePath;
 
     int opt;
-    while ((opt = getopt(argc, argv, "u:b:n:s:d:i:r:l:h:q:o:")) != -1) {
+    while ((opt = getopt(argc, argv, "u:b:n:s:d:i:r:l:h:a:q:o:")) != -1) {
         switch (opt) {
         case 'u':
             nUsers = atoi(optarg);
@@ -334,11 +356,14 @@ int main(int argc, char **argv) {
         case 'h':
             maxAtomConds = atoi(optarg);
             break;
+        case 'a':
+            maxAdminAtomConds = atoi(optarg);
+            break;
         case 'q':
             nQueryAV = atoi(optarg);
             break;
         case 'o':
-            outputFilePath = (char *)malloc(sizeof(char) * strlen(optarg));
+            outputFilePath = (char *)malloc(sizeof(char) * (strlen(optarg) + 1));
             strcpy(outputFilePath, optarg);
             break;
         default:
@@ -350,7 +375,7 @@ int main(int argc, char **argv) {
     unsigned int seed = (unsigned int)time(NULL);
     seed += StringHashCode(&outputFilePath);
     srand(seed);
-    GenParam genParam = createGenParam(nUsers, nStrAttrs, nIntAttrs, nBoolAttrs, maxDomSize, initAVDefaultRate, nRules, minAtomConds, maxAtomConds, nQueryAV);
+    GenParam genParam = createGenParam(nUsers, nStrAttrs, nIntAttrs, nBoolAttrs, maxDomSize, initAVDefaultRate, nRules, minAtomConds, maxAtomConds, maxAdminAtomConds, nQueryAV);
     ACoACInstance *pInst = generate(&genParam);
     writeACoACInstance(pInst, outputFilePath);
     return 0;
@@ -0,0 +1,833 @@
+#include <ctype.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "acoac_io.h"
+#include "acoac_utils.h"
+#include "thread_pool.h"
+
+#define USERS "Users"
+#define ATTRIBUTES "Attributes"
+#define DEFAULT_VALUE "Default Value"
+#define UAV "UAV"
+#define RULES "Rules"
+#define SPEC "Spec"
+
+// The Rules section is split into about RULE_CHUNKS_PER_THREAD chunks per thread for load balancing,
+// but no chunk is smaller than MIN_RULE_CHUNK_SIZE bytes
+#define RULE_CHUNKS_PER_THREAD 4
+#define MIN_RULE_CHUNK_SIZE (64 * 1024)
+
+/**
+ * A view of a string inside the mapped file, i.e., a pointer and a length.
+ * The characters are never copied. A view is NUL-terminated in place (the mapping is private and writable)
+ * only when it has to be handed to an API expecting a C string, and only after the delimiters around it
+ * have been scanned.
+ */
+typedef struct _StrView {
+    char *ptr;
+    int len;
+} StrView;
+
+static inline StrView svMake(char *begin, char *end) {
+    return (StrView){begin, (int)(end - begin)};
+}
+
+static inline StrView svTrim(StrView sv) {
+    while (sv.len > 0 && isspace((unsigned char)*sv.ptr)) {
+        sv.ptr++;
+        sv.len--;
+    }
+    while (sv.len > 0 && isspace((unsigned char)sv.ptr[sv.len - 1])) {
+        sv.len--;
+    }
+    return sv;
+}
+
+static inline int svEqual(StrView sv, const char *str) {
+    return strlen(str) == (size_t)sv.len && memcmp(sv.ptr, str, sv.len) == 0;
+}
+
+static inline char *svTerminate(StrView sv) {
+    sv.ptr[sv.len] = '\0';
+    return sv.ptr;
+}
+
+/**
+ * Get the next whitespace-separated token in [*pCur, end), and move *pCur past the delimiter following it
+ *
+ * @param pCur[in, out]: The scanning position
+ * @param end[in]: The end of the scanned range
+ * @param pToken[out]: The token
+ * @return 1 if a token is found, 0 otherwise
+ */
+static int svNextToken(char **pCur, char *end, StrView *pToken) {
+    char *p = *pCur;
+    while (p < end && isspace((unsigned char)*p)) {
+        p++;
+    }
+    if (p == end) {
+        *pCur = p;
+        return 0;
+    }
+    pToken->ptr = p;
+    while (p < end && !isspace((unsigned char)*p)) {
+        p++;
+    }
+    pToken->len = p - pToken->ptr;
+    *pCur = p < end ? p + 1 : p;
+    return 1;
+}
+
+static void handleUsersView(ACoACInstance *pInst, StrView line) {
+    char *p = line.ptr, *end = line.ptr + line.len;
+    StrView user;
+    int userNum;
+    while (svNextToken(&p, end, &user)) {
+        if (p == end && user.len > 0 && user.ptr[user.len - 1] == ';') {
+            // Remove trailing semicolon
+            user.len--;
+        }
+        if (user.len == 0) {
+            continue;
+        }
+        userNum = istrCollection.Size(pscUsers);
+        if (iDictionary.Insert(pdictUser2Index, svTerminate(user), &userNum)) {
+            istrCollection.Add(pscUsers, user.ptr);
+            iVector.Add(pInst->pVecUserIndices, &userNum);
+            logACoAC(__func__, __LINE__, 0, DEBUG, "Add %d user: %s\n", userNum + 1, user.ptr);
+        }
+    }
+}
+
+static int handleAttributesView(StrView line) {
+    if (svEqual(line, ";")) {
+        return 0;
+    }
+
+    char *end = line.ptr + line.len;
+    char *colon = memchr(line.ptr, ':', line.len);
+    if (colon == NULL) {
+        return 0;
+    }
+    if (memchr(colon + 1, ':', end - colon - 1) != NULL) {
+        logACoAC(__func__, __LINE__, 0, ERROR, "type already set, line: %.*s\n", line.len, line.ptr);
+        return -1;
+    }
+
+    AttrType attrType;
+    int defValIdx = 0, attrNum;
+    StrView type = svTrim(svMake(line.ptr, colon));
+    if (svEqual(type, "boolean")) {
+        attrType = BOOLEAN;
+    } else if (svEqual(type, "string")) {
+        attrType = STRING;
+        iDictionary.Insert(pdictValue2Index, "", &defValIdx);
+        istrCollection.Add(pscValues, "");
+    } else if (svEqual(type, "int")) {
+        attrType = INTEGER;
+    } else {
+        logACoAC(__func__, __LINE__, 0, ERROR, "unknown attribute type %.*s\n", type.len, type.ptr);
+        return -1;
+    }
+
+    char *p = colon + 1;
+    StrView attr;
+    while (svNextToken(&p, end, &attr)) {
+        if (p == end && attr.len > 0 && attr.ptr[attr.len - 1] == ';') {
+            attr.len--;
+        }
+        if (attr.len == 0) {
+            continue;
+        }
+        svTerminate(attr);
+        if (!iDictionary.Contains(pdictAttr2Index, attr.ptr)) {
+            attrNum = istrCollection.Size(pscAttrs);
+            iDictionary.Insert(pdictAttr2Index, attr.ptr, &attrNum);
+            istrCollection.Add(pscAttrs, attr.ptr);
+            iIntMap.Put(pmapAttr2Type, attrNum, &attrType);
+            iIntMap.Put(pmapAttr2DefVal, attrNum, &defValIdx);
+        }
+    }
+    return 0;
+}
+
+static int handleDefaultValuesView(StrView line) {
+    if (svEqual(line, ";")) {
+        return 0;
+    }
+
+    char *end = line.ptr + line.len;
+    char *colon = memchr(line.ptr, ':', line.len);
+    if (colon == NULL || memchr(colon + 1, ':', end - colon - 1) != NULL) {
+        fprintf(stderr, "Error: default value should be in the form of [attr] : [value]\n");
+        exit(-1);
+    }
+    StrView attr = svTrim(svMake(line.ptr, colon));
+    StrView value = svTrim(svMake(colon + 1, end));
+    if (value.len > 0 && value.ptr[value.len - 1] == ';') {
+        value = svTrim((StrView){value.ptr, value.len - 1});
+    }
+
+    int attrIdx = getAttrIndex(svTerminate(attr));
+    int valueIdx;
+    int ret = getValueIndex(getAttrTypeByIdx(attrIdx), svTerminate(value), &valueIdx);
+    if (ret) {
+        logACoAC(__func__, __LINE__, 0, ERROR, "Failed to add default value: %s, %s\n", attr.ptr, value.ptr);
+        exit(ret);
+    }
+    iIntMap.Put(pmapAttr2DefVal, attrIdx, &valueIdx);
+    return 0;
+}
+
+/**
+ * Split a bracketed tuple "(part0, part1, ..., partN)" into its comma-separated parts.
+ * Characters following the right bracket (e.g., a trailing semicolon or comment) are ignored.
+ *
+ * @param line[in]: The line to split, starting with the left bracket
+ * @param parts[out]: The trimmed parts
+ * @param nParts[in]: The expected number of parts
+ * @return 0 if the line has exactly @{nParts} parts, -1 if the right bracket is missing, -2 if the number of parts is wrong
+ */
+static int splitTuple(StrView line, StrView *parts, int nParts) {
+    char *p = line.ptr + 1, *end = line.ptr + line.len;
+    char *start = p;
+    int partCount = 0;
+    while (1) {
+        if (p == end) {
+            return -1;
+        }
+        if (*p == ',' || *p == ')') {
+            if (partCount == nParts) {
+                return -2;
+            }
+            parts[partCount++] = svTrim(svMake(start, p));
+            if (*p == ')') {
+                break;
+            }
+            start = p + 1;
+        }
+        p++;
+    }
+    return partCount == nParts ? 0 : -2;
+}
+
+static int handleUAVView(ACoACInstance *pInst, StrView line) {
+    if (svEqual(line, ";")) {
+        return 0;
+    }
+
+    if (*line.ptr != '(') {
+        logACoAC(__func__, __LINE__, 0, ERROR, "UAV should be in the form of ([user], [attr], [value]), missing left bracket\n");
+        abort();
+    }
+    StrView parts[3];
+    int ret = splitTuple(line, parts, 3);
+    if (ret == -1) {
+        logACoAC(__func__, __LINE__, 0, ERROR, "UAV should be in the form of ([user], [attr], [value]), missing right bracket\n");
+        abort();
+    } else if (ret) {
+        logACoAC(__func__, __LINE__, 0, ERROR, "UAV should be in the form of ([user], [attr], [value]), there should be extact two commas\n");
+        abort();
+    }
+
+    ret = addUAV(pInst, svTerminate(parts[0]), svTerminate(parts[1]), svTerminate(parts[2]));
+    if (ret) {
+        logACoAC(__func__, __LINE__, 0, ERROR, "Failed to handle UAV: %s, %s, %s)\n", parts[0].ptr, parts[1].ptr, parts[2].ptr);
+        exit(ret);
+    }
+    return 0;
+}
+
+/**
+ * The rules parsed from a chunk of the Rules section by a worker thread.
+ * The global value table is read-only while the chunks are parsed, so a string value that is not interned yet
+ * is interned into the chunk-local table, and the atom conditions and rule targets referring to it are recorded.
+ * They are patched when the chunks are merged in file order, which yields the same value indices as a sequential parse.
+ */
+typedef struct _RuleChunk {
+    // The lines of the chunk
+    char *begin;
+    char *end;
+    // Parsed rules (ParsedRule)
+    Vector *pVecParsedRules;
+    // The atom conditions of all parsed rules (AtomCondition)
+    Vector *pVecAtomConds;
+    // The chunk-local string values, in the order of first appearance
+    strCollection *pscLocalValues;
+    Dictionary *pdictLocalValue2Index;
+    // The references to local values: i >= 0 refers to the i-th atom condition, and -(i + 1) to the target value of the i-th rule
+    Vector *pVecLocalRefs;
+    // The admin and user conditions built from the parsed rules once the local values are resolved,
+    // two per rule (HashSet *)
+    Vector *pVecConds;
+} RuleChunk;
+
+typedef struct _ParsedRule {
+    int targetAttrIdx;
+    int targetValueIdx;
+    // The admin condition is pVecAtomConds[atomCondStart, atomCondStart + nAdminAtomConds),
+    // and the user condition follows it
+    int atomCondStart;
+    int nAdminAtomConds;
+    int nUserAtomConds;
+} ParsedRule;
+
+/**
+ * Get the index of a value.
+ * With a chunk, a string value that is not in the global table @{pscValues} is interned into the chunk, and its local index is returned.
+ *
+ * @param attrType[in]: The datatype of the attribute
+ * @param value[in]: The value
+ * @param pChunk[in]: The chunk being parsed, or NULL if the rules are parsed sequentially
+ * @param pValueIdx[out]: The index of the value
+ * @return 1 if @{pValueIdx} is a local index of @{pChunk}, 0 if it is a global index, -1 if the value is invalid
+ */
+static int resolveValueView(AttrType attrType, StrView value, RuleChunk *pChunk, int *pValueIdx) {
+    char *str = svTerminate(value);
+    if (pChunk == NULL || attrType != STRING) {
+        return getValueIndex(attrType, str, pValueIdx) ? -1 : 0;
+    }
+    int *pIdx = (int *)iDictionary.GetElement(pdictValue2Index, str);
+    if (pIdx != NULL) {
+        *pValueIdx = *pIdx;
+        return 0;
+    }
+    pIdx = (int *)iDictionary.GetElement(pChunk->pdictLocalValue2Index, str);
+    if (pIdx != NULL) {
+        *pValueIdx = *pIdx;
+    } else {
+        *pValueIdx = istrCollection.Size(pChunk->pscLocalValues);
+        iDictionary.Insert(pChunk->pdictLocalValue2Index, str, pValueIdx);
+        istrCollection.Add(pChunk->pscLocalValues, str);
+    }
+    return 1;
+}
+
+/**
+ * Parse an atom condition "attr op value"
+ *
+ * @return 1 if the value of the atom condition is a local index of @{pChunk}, 0 otherwise
+ */
+static int parseAtomConditionView(StrView atomCondStr, RuleChunk *pChunk, AtomCondition *pAtomCond) {
+    char *p = atomCondStr.ptr, *end = atomCondStr.ptr + atomCondStr.len;
+    char *opPos = NULL, *valuePos = NULL;
+    comparisonOperator op;
+    int opNum = 0;
+    while (p < end && opNum <= 1) {
+        if (*p == '!' && p + 1 < end && *(p + 1) == '=') {
+            op = NOT_EQUAL;
+            opPos = p;
+            p += 2;
+        } else if (*p == '<' || *p == '>') {
+            opPos = p;
+            if (p + 1 < end && *(p + 1) == '=') {
+                op = *p == '<' ? LESS_THAN_OR_EQUAL : GREATER_THAN_OR_EQUAL;
+                p += 2;
+            } else {
+                op = *p == '<' ? LESS_THAN : GREATER_THAN;
+                p++;
+            }
+        } else if (*p == '=') {
+            op = EQUAL;
+            opPos = p;
+            p++;
+        } else {
+            p++;
+            continue;
+        }
+        valuePos = p;
+        opNum++;
+    }
+
+    if (opNum == 0) {
+        logACoAC(__func__, __LINE__, 0, ERROR, "atom cond should be form of attr op value, but missing operation in %.*s\n", atomCondStr.len, atomCondStr.ptr);
+        exit(-1);
+    } else if (opNum > 1) {
+        logACoAC(__func__, __LINE__, 0, ERROR, "found multiple operation in %.*s\n", atomCondStr.len, atomCondStr.ptr);
+        exit(-1);
+    }
+
+    StrView attr = svTrim(svMake(atomCondStr.ptr, opPos));
+    StrView value = svTrim(svMake(valuePos, end));
+    pAtomCond->attribute = getAttrIndex(svTerminate(attr));
+    pAtomCond->op = op;
+    int ret = resolveValueView(getAttrTypeByIdx(pAtomCond->attribute), value, pChunk, &pAtomCond->value);
+    if (ret < 0) {
+        logACoAC(__func__, __LINE__, 0, ERROR, "Failed to handle atom condition: %s %s\n", attr.ptr, value.ptr);
+        exit(-1);
+    }
+    return ret;
+}
+
+/**
+ * Get the next atom condition of a condition "atom & atom & ... & atom", and move *pCur past it
+ *
+ * @return 1 if an atom condition is found, 0 otherwise
+ */
+static int nextAtomConditionView(char **pCur, char *end, StrView *pAtomCondStr) {
+    char *atomEnd;
+    while (*pCur < end) {
+        atomEnd = memchr(*pCur, '&', end - *pCur);
+        if (atomEnd == NULL) {
+            atomEnd = end;
+        }
+        *pAtomCondStr = svTrim(svMake(*pCur, atomEnd));
+        *pCur = atomEnd + 1;
+        if (pAtomCondStr->len > 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static HashSet *handleConditionView(StrView condStr) {
+    HashSet *condition = iHashSet.Create(sizeof(AtomCondition), iAtomCondition.HashCode, iAtomCondition.Equal);
+    if (svEqual(condStr, "TRUE")) {
+        return condition;
+    }
+
+    char *p = condStr.ptr, *end = condStr.ptr + condStr.len;
+    StrView atomCondStr;
+    AtomCondition atomCond;
+    while (nextAtomConditionView(&p, end, &atomCondStr)) {
+        parseAtomConditionView(atomCondStr, NULL, &atomCond);
+        iHashSet.Add(condition, &atomCond);
+    }
+    return condition;
+}
+
+/**
+ * Parse a condition into the atom conditions of a chunk
+ *
+ * @return The number of atom conditions
+ */
+static int parseConditionView(StrView condStr, RuleChunk *pChunk) {
+    if (svEqual(condStr, "TRUE")) {
+        return 0;
+    }
+
+    char *p = condStr.ptr, *end = condStr.ptr + condStr.len;
+    StrView atomCondStr;
+    AtomCondition atomCond;
+    int atomCondIdx, nAtomConds = 0;
+    while (nextAtomConditionView(&p, end, &atomCondStr)) {
+        atomCondIdx = iVector.Size(pChunk->pVecAtomConds);
+        if (parseAtomConditionView(atomCondStr, pChunk, &atomCond)) {
+            iVector.Add(pChunk->pVecLocalRefs, &atomCondIdx);
+        }
+        iVector.Add(pChunk->pVecAtomConds, &atomCond);
+        nAtomConds++;
+    }
+    return nAtomConds;
+}
+
+/**
+ * Split a rule "(admincond, usercond, attr, val)" into its four parts, and resolve the target attribute and value
+ *
+ * @return 1 if the target value is a local index of @{pChunk}, 0 otherwise
+ */
+static int splitRuleView(StrView line, StrView *parts, RuleChunk *pChunk, int *pAttrIdx, int *pValueIdx) {
+    if (*line.ptr != '(') {
+        logACoAC(__func__, __LINE__, 0, ERROR, "a rule should be form of (admincond, usercond, attr, val), missing left bracket\n");
+        abort();
+    }
+    int ret = splitTuple(line, parts, 4);
+    if (ret == -1) {
+        logACoAC(__func__, __LINE__, 0, ERROR, "a rule should be form of (admincond, usercond, attr, val), missing right bracket\n");
+        abort();
+    } else if (ret) {
+        logACoAC(__func__, __LINE__, 0, ERROR, "a rule should be form of (admincond, usercond, attr, val), there should be extact three commas\n");
+        abort();
+    }
+
+    *pAttrIdx = getAttrIndex(svTerminate(parts[2]));
+    ret = resolveValueView(getAttrTypeByIdx(*pAttrIdx), parts[3], pChunk, pValueIdx);
+    if (ret < 0) {
+        logACoAC(__func__, __LINE__, 0, ERROR, "Failed to handle rule: (%.*s, %.*s, %s, %s)\n", parts[0].len, parts[0].ptr, parts[1].len, parts[1].ptr, parts[2].ptr, parts[3].ptr);
+        exit(-1);
+    }
+    return ret;
+}
+
+static int handleRuleView(ACoACInstance *pInst, StrView line) {
+    if (svEqual(line, ";")) {
+        return 0;
+    }
+
+    // parts: admin condition, user condition, target attribute, target value
+    StrView parts[4];
+    int attrIdx, valueIdx;
+    splitRuleView(line, parts, NULL, &attrIdx, &valueIdx);
+    int adminCondIdx = getConditionIndex(handleConditionView(parts[0]));
+    int userCondIdx = getConditionIndex(handleConditionView(parts[1]));
+    int ruleIdx = getRuleIndex(adminCondIdx, userCondIdx, attrIdx, valueIdx);
+    addRule(pInst, ruleIdx);
+    return 0;
+}
+
+static void parseRuleView(RuleChunk *pChunk, StrView line) {
+    if (svEqual(line, ";")) {
+        return;
+    }
+
+    StrView parts[4];
+    ParsedRule parsedRule;
+    int ruleRef = -(iVector.Size(pChunk->pVecParsedRules) + 1);
+    if (splitRuleView(line, parts, pChunk, &parsedRule.targetAttrIdx, &parsedRule.targetValueIdx)) {
+        iVector.Add(pChunk->pVecLocalRefs, &ruleRef);
+    }
+    parsedRule.atomCondStart = iVector.Size(pChunk->pVecAtomConds);
+    parsedRule.nAdminAtomConds = parseConditionView(parts[0], pChunk);
+    parsedRule.nUserAtomConds = parseConditionView(parts[1], pChunk);
+    iVector.Add(pChunk->pVecParsedRules, &parsedRule);
+}
+
+/**
+ * Task: parse the lines of a chunk
+ */
+static void parseRuleChunk(void *arg) {
+    RuleChunk *pChunk = (RuleChunk *)arg;
+    char *p = pChunk->begin, *lineEnd;
+    StrView line;
+    while (p < pChunk->end) {
+        lineEnd = memchr(p, '\n', pChunk->end - p);
+        if (lineEnd == NULL) {
+            lineEnd = pChunk->end;
+        }
+        line = svTrim(svMake(p, lineEnd));
+        p = lineEnd + 1;
+        if (line.len > 0) {
+            parseRuleView(pChunk, line);
+        }
+    }
+}
+
+/**
+ * Replace the local value indices of a chunk with global ones, interning the local values in their order of first appearance
+ */
+static void resolveLocalValues(RuleChunk *pChunk) {
+    int nLocalValues = istrCollection.Size(pChunk->pscLocalValues);
+    if (nLocalValues == 0) {
+        return;
+    }
+    int *globalIdxes = (int *)malloc(nLocalValues * sizeof(int));
+    int i, ref;
+    for (i = 0; i < nLocalValues; i++) {
+        getValueIndex(STRING, istrCollection.GetElement(pChunk->pscLocalValues, i), &globalIdxes[i]);
+    }
+    AtomCondition *pAtomCond;
+    ParsedRule *pParsedRule;
+    for (i = 0; i < iVector.Size(pChunk->pVecLocalRefs); i++) {
+        ref = *(int *)iVector.GetElement(pChunk->pVecLocalRefs, i);
+        if (ref >= 0) {
+            pAtomCond = (AtomCondition *)iVector.GetElement(pChunk->pVecAtomConds, ref);
+            pAtomCond->value = globalIdxes[pAtomCond->value];
+        } else {
+            pParsedRule = (ParsedRule *)iVector.GetElement(pChunk->pVecParsedRules, -ref - 1);
+            pParsedRule->targetValueIdx = globalIdxes[pParsedRule->targetValueIdx];
+        }
+    }
+    free(globalIdxes);
+}
+
+static HashSet *buildCondition(Vector *pVecAtomConds, int start, int n) {
+    HashSet *condition = iHashSet.Create(sizeof(AtomCondition), iAtomCondition.HashCode, iAtomCondition.Equal);
+    for (int i = start; i < start + n; i++) {
+        iHashSet.Add(condition, iVector.GetElement(pVecAtomConds, i));
+    }
+    return condition;
+}
+
+/**
+ * Task: build the conditions of a chunk from its parsed rules
+ */
+static void buildRuleChunk(void *arg) {
+    RuleChunk *pChunk = (RuleChunk *)arg;
+    int nRules = iVector.Size(pChunk->pVecParsedRules);
+    pChunk->pVecConds = iVector.Create(sizeof(HashSet *), 2 * nRules);
+    ParsedRule *pParsedRule;
+    HashSet *adminCond, *userCond;
+    for (int i = 0; i < nRules; i++) {
+        pParsedRule = (ParsedRule *)iVector.GetElement(pChunk->pVecParsedRules, i);
+        adminCond = buildCondition(pChunk->pVecAtomConds, pParsedRule->atomCondStart, pParsedRule->nAdminAtomConds);
+        userCond = buildCondition(pChunk->pVecAtomConds, pParsedRule->atomCondStart + pParsedRule->nAdminAtomConds, pParsedRule->nUserAtomConds);
+        iVector.Add(pChunk->pVecConds, &adminCond);
+        iVector.Add(pChunk->pVecConds, &userCond);
+    }
+}
+
+/**
+ * Parse the lines [begin, end) of the Rules section on @{nThreads} threads.
+ * The section is split into chunks at line boundaries, which are parsed in parallel and merged in file order,
+ * so the indices of the values, conditions and rules are the same as those of a sequential parse.
+ */
+static void handleRulesParallel(ACoACInstance *pInst, char *begin, char *end, int nThreads) {
+    long sectionLen = end - begin;
+    int nChunks = nThreads * RULE_CHUNKS_PER_THREAD;
+    if (sectionLen / nChunks < MIN_RULE_CHUNK_SIZE) {
+        nChunks = sectionLen / MIN_RULE_CHUNK_SIZE + 1;
+    }
+    RuleChunk *chunks = (RuleChunk *)calloc(nChunks, sizeof(RuleChunk));
+    char *p = begin, *chunkEnd;
+    int i, j, nonEmpty = 0;
+    for (i = 0; i < nChunks && p < end; i++) {
+        chunkEnd = i == nChunks - 1 ? end : begin + sectionLen * (i + 1) / nChunks;
+        if (chunkEnd < p) {
+            chunkEnd = p;
+        }
+        // Move the boundary to the start of the next line
+        chunkEnd = chunkEnd < end ? memchr(chunkEnd, '\n', end - chunkEnd) : end;
+        chunkEnd = chunkEnd == NULL ? end : chunkEnd + 1;
+        chunks[i].begin = p;
+        chunks[i].end = chunkEnd > end ? end : chunkEnd;
+        chunks[i].pVecParsedRules = iVector.Create(sizeof(ParsedRule), 0);
+        chunks[i].pVecAtomConds = iVector.Create(sizeof(AtomCondition), 0);
+        chunks[i].pscLocalValues = istrCollection.Create(0);
+        chunks[i].pdictLocalValue2Index = iDictionary.Create(sizeof(int), 0);
+        chunks[i].pVecLocalRefs = iVector.Create(sizeof(int), 0);
+        p = chunks[i].end;
+        nonEmpty++;
+    }
+    nChunks = nonEmpty;
+
+    ThreadPool *pool = iThreadPool.Create(nThreads < nChunks ? nThreads : nChunks);
+    for (i = 0; i < nChunks; i++) {
+        iThreadPool.Submit(pool, parseRuleChunk, &chunks[i]);
+    }
+    iThreadPool.Wait(pool);
+    for (i = 0; i < nChunks; i++) {
+        resolveLocalValues(&chunks[i]);
+    }
+    for (i = 0; i < nChunks; i++) {
+        iThreadPool.Submit(pool, buildRuleChunk, &chunks[i]);
+    }
+    iThreadPool.Finalize(pool);
+
+    // Hash-cons the conditions and rules in file order
+    ParsedRule *pParsedRule;
+    int adminCondIdx, userCondIdx;
+    for (i = 0; i < nChunks; i++) {
+        for (j = 0; j < iVector.Size(chunks[i].pVecParsedRules); j++) {
+            pParsedRule = (ParsedRule *)iVector.GetElement(chunks[i].pVecParsedRules, j);
+            adminCondIdx = getConditionIndex(*(HashSet **)iVector.GetElement(chunks[i].pVecConds, 2 * j));
+            userCondIdx = getConditionIndex(*(HashSet **)iVector.GetElement(chunks[i].pVecConds, 2 * j + 1));
+            addRule(pInst, getRuleIndex(adminCondIdx, userCondIdx, pParsedRule->targetAttrIdx, pParsedRule->targetValueIdx));
+        }
+        iVector.Finalize(chunks[i].pVecConds);
+        iVector.Finalize(chunks[i].pVecParsedRules);
+        iVector.Finalize(chunks[i].pVecAtomConds);
+        istrCollection.Finalize(chunks[i].pscLocalValues);
+        iDictionary.Finalize(chunks[i].pdictLocalValue2Index);
+        iVector.Finalize(chunks[i].pVecLocalRefs);
+    }
+    free(chunks);
+}
+
+static int handleSpecView(ACoACInstance *pInst, StrView line) {
+    if (*line.ptr != '(') {
+        logACoAC(__func__, __LINE__, 0, ERROR, "spec should starts with (, but it is %.*s\n", line.len, line.ptr);
+        abort();
+    }
+
+    char *p = line.ptr + 1, *end = line.ptr + line.len;
+    char *start = p, *eq;
+    StrView queryUser, queryAV, attr, value;
+    int attrIdx, valueIdx, partCount = 0;
+    while (1) {
+        if (p == end) {
+            logACoAC(__func__, __LINE__, 0, ERROR, "spec should be form of (user, attr=value, attr=value, ...);, missing right bracket\n");
+            abort();
+        }
+        if (*p == ',' || *p == ')') {
+            if (partCount == 0) {
+                queryUser = svTrim(svMake(start, p));
+            } else {
+                queryAV = svTrim(svMake(start, p));
+                eq = memchr(queryAV.ptr, '=', queryAV.len);
+                if (eq == NULL || memchr(eq + 1, '=', queryAV.ptr + queryAV.len - eq - 1) != NULL) {
+                    logACoAC(__func__, __LINE__, 0, ERROR, "query av should be form of <attr> = <value>, but it is %.*s\n", queryAV.len, queryAV.ptr);
+                    abort();
+                }
+                attr = svTrim(svMake(queryAV.ptr, eq));
+                value = svTrim(svMake(eq + 1, queryAV.ptr + queryAV.len));
+                if (*p == ')') {
+                    // the terminator of the value may overwrite the right bracket
+                    end = p;
+                }
+                attrIdx = getAttrIndex(svTerminate(attr));
+                int ret = getValueIndex(getAttrTypeByIdx(attrIdx), svTerminate(value), &valueIdx);
+                if (ret) {
+                    logACoAC(__func__, __LINE__, 0, ERROR, "Failed to handle query av: %s, %s\n", attr.ptr, value.ptr);
+                    exit(ret);
+                }
+                iIntMap.Put(pInst->pmapQueryAVs, attrIdx, &valueIdx);
+                logACoAC(__func__, __LINE__, 0, INFO, "add query attribute: %s, value: %s\n", attr.ptr, value.ptr);
+            }
+            if (p == end || *p == ')') {
+                break;
+            }
+            start = p + 1;
+            partCount++;
+        }
+        p++;
+    }
+
+    pInst->queryUserIdx = getUserIndex(svTerminate(queryUser));
+    logACoAC(__func__, __LINE__, 0, INFO, "query user: %s\n", queryUser.ptr);
+    return 0;
+}
+
+/**
+ * Map a file into a private writable region followed by at least one zero byte,
+ * so that every view (including the last one) can be NUL-terminated in place.
+ *
+ * @param filename[in]: The path of the file to map
+ * @param pSize[out]: The size of the file
+ * @param pMapLen[out]: The length of the mapped region
+ * @return The start of the mapped region, or NULL if failed
+ */
+static char *mapFile(char *filename, size_t *pSize, size_t *pMapLen) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return NULL;
+    }
+    size_t size = (size_t)st.st_size;
+    size_t mapLen = size + 1;
+
+    // Reserve an anonymous (zero-filled) region, and then map the file over its beginning.
+    // If the file size is a multiple of the page size, the guard byte lies in the anonymous part.
+    char *base = mmap(NULL, mapLen, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        close(fd);
+        return NULL;
+    }
+    if (size > 0) {
+        if (mmap(base, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+            munmap(base, mapLen);
+            close(fd);
+            return NULL;
+        }
+        madvise(base, size, MADV_SEQUENTIAL);
+    }
+    close(fd);
+    base[size] = '\0';
+    *pSize = size;
+    *pMapLen = mapLen;
+    return base;
+}
+
+static int isSectionHeader(StrView line) {
+    return svEqual(line, USERS) || svEqual(line, ATTRIBUTES) || svEqual(line, DEFAULT_VALUE) || svEqual(line, UAV) ||
+           svEqual(line, RULES) || svEqual(line, SPEC);
+}
+
+/**
+ * Find the end of the section starting at @{p}, i.e., the start of the next section header line or @{end}
+ */
+static char *findSectionEnd(char *p, char *end) {
+    char *lineEnd;
+    while (p < end) {
+        lineEnd = memchr(p, '\n', end - p);
+        if (lineEnd == NULL) {
+            lineEnd = end;
+        }
+        if (isSectionHeader(svTrim(svMake(p, lineEnd)))) {
+            return p;
+        }
+        p = lineEnd + 1;
+    }
+    return end;
+}
+
+ACoACInstance *readACoACInstanceMmap(char *acoacFilePath, int nThreads) {
+    logACoAC(__func__, __LINE__, 0, INFO, "[start] reading ACoAC instance from file %s\n", acoacFilePath);
+
+    size_t size, mapLen;
+    char *base = mapFile(acoacFilePath, &size, &mapLen);
+    if (base == NULL) {
+        printf("Error opening file: %s\n", acoacFilePath);
+        return NULL;
+    }
+
+    initGlobalVars();
+    ACoACInstance *pInst = createACoACInstance();
+
+    // 0: initial, 1: users, 2: attributes, 3: default value, 4: UAV, 5: rules, 6: spec
+    int stage = 0;
+    int ret = 0;
+    char *p = base, *end = base + size, *lineEnd;
+    StrView line;
+    while (p < end && ret == 0) {
+        lineEnd = memchr(p, '\n', end - p);
+        if (lineEnd == NULL) {
+            lineEnd = end;
+        }
+        line = svTrim(svMake(p, lineEnd));
+        p = lineEnd + 1;
+        if (line.len == 0) {
+            continue;
+        }
+
+        if (svEqual(line, USERS)) {
+            stage = 1;
+        } else if (svEqual(line, ATTRIBUTES)) {
+            stage = 2;
+        } else if (svEqual(line, DEFAULT_VALUE)) {
+            stage = 3;
+        } else if (svEqual(line, UAV)) {
+            stage = 4;
+        } else if (svEqual(line, RULES)) {
+            stage = 5;
+            if (nThreads > 1) {
+                lineEnd = findSectionEnd(p, end);
+                handleRulesParallel(pInst, p, lineEnd, nThreads);
+                p = lineEnd;
+            }
+        } else if (svEqual(line, SPEC)) {
+            stage = 6;
+        } else {
+            switch (stage) {
+            case 1:
+                handleUsersView(pInst, line);
+                break;
+            case 2:
+                ret = handleAttributesView(line);
+                break;
+            case 3:
+                ret = handleDefaultValuesView(line);
+                break;
+            case 4:
+                ret = handleUAVView(pInst, line);
+                break;
+            case 5:
+                ret = handleRuleView(pInst, line);
+                break;
+            case 6:
+                ret = handleSpecView(pInst, line);
+                break;
+            default:
+                logACoAC(__func__, __LINE__, 0, ERROR, "Unexpected line: %.*s\n", line.len, line.ptr);
+                ret = -1;
+            }
+        }
+    }
+    munmap(base, mapLen);
+
+    if (ret) {
+        finalizeACoACInstance(pInst);
+        return NULL;
+    }
+    logACoAC(__func__, __LINE__, 0, INFO, "[end] reading ACoAC instance from file %s\n", acoacFilePath);
+    return pInst;
+}
@@ -1,79 +1,108 @@
 #include "acoac_pruning.h"
 #include "acoac_utils.h"
 #include "analysis_result.h"
+#include "intset.h"
+#include "thread_pool.h"
+#include "userindex.h"
 #include <time.h>
 
+// 前向剪枝的一层候选规则数量不少于该值时，才在线程池中并行检查规则是否可触发
+#define PARALLEL_MIN_CANDIDATES 4096
+
+// 前向剪枝使用的线程数
+static int nSlicingThreads = 1;
+
+void setSlicingThreads(int nThreads) {
+    nSlicingThreads = nThreads > 0 ? nThreads : 1;
+}
+
+/*
+ * 并行检查的一段候选规则，effective[i]记录ruleIdxes[i]是否可触发
+ */
+typedef struct _EffectiveCheckChunk {
+    int *ruleIdxes;
+    char *effective;
+    int nRules;
+    IntMap *pmapReachableAVs;
+} EffectiveCheckChunk;
+
+typedef struct _AVP {
+    int attrIdx;
+    int valIdx;
+} AVP;
+
+static void checkEffectiveChunk(void *arg) {
+    EffectiveCheckChunk *pChunk = (EffectiveCheckChunk *)arg;
+    int i;
+    for (i = 0; i < pChunk->nRules; i++) {
+        pChunk->effective[i] = iRule.IsEffective((Rule *)iVector.GetElement(pVecRules, pChunk->ruleIdxes[i]), pChunk->pmapReachableAVs);
+    }
+}
+
 /****************************************************************************************************
- * 功能：给定一个ACoAC-safety analysis实例与一个属性合取条件，判断是否存在一个用户，其初始状态下的属性能够
- *      满足给定的条件。例如，假设给定的条件为 n0>1 & s1=s1_2，在实例的初始状态，某个用户的属性n0为2，属性
- *      s1为默认值s1_2，那么该条件可以被该用户满足，该函数应该返回1。
+ * 功能：检查前向剪枝中一层候选规则是否可触发。检查期间可达属性值不变，各规则的检查互不影响，因此候选规则
+ *      较多时被分段在线程池中并行检查，结果与顺序检查相同
+ * 参数：
+ *      @ruleIdxes[in]: 候选规则的编号
+ *      @nRules[in]: 候选规则的数量
+ *      @effective[out]: effective[i]记录ruleIdxes[i]是否可触发
+ *      @pmapReachableAVs[in]: 可达属性值
+ *      @ppPool[in,out]: 线程池，第一次并行检查时创建，由调用者销毁
+ ***************************************************************************************************/
+static void checkEffective(int *ruleIdxes, int nRules, char *effective, IntMap *pmapReachableAVs, ThreadPool **ppPool) {
+    EffectiveCheckChunk chunks[nSlicingThreads];
+    int i, nChunks = nRules < PARALLEL_MIN_CANDIDATES ? 1 : nSlicingThreads;
+    for (i = 0; i < nChunks; i++) {
+        chunks[i].ruleIdxes = ruleIdxes + (long)nRules * i / nChunks;
+        chunks[i].effective = effective + (long)nRules * i / nChunks;
+        chunks[i].nRules = (long)nRules * (i + 1) / nChunks - (long)nRules * i / nChunks;
+        chunks[i].pmapReachableAVs = pmapReachableAVs;
+    }
+    if (nChunks == 1) {
+        checkEffectiveChunk(&chunks[0]);
+        return;
+    }
+    if (*ppPool == NULL) {
+        *ppPool = iThreadPool.Create(nSlicingThreads);
+    }
+    for (i = 0; i < nChunks; i++) {
+        iThreadPool.Submit(*ppPool, checkEffectiveChunk, &chunks[i]);
+    }
+    iThreadPool.Wait(*ppPool);
+}
+
+/****************************************************************************************************
+ * 功能：释放ruleCleaning提前结束处理的旧实例，其用户列表移交给随验证结果一起返回的新实例
+ * 参数：
+ *      @pInst[in]: 旧实例
+ *      @pNewInst[in]: 新实例
+ ***************************************************************************************************/
+static void discardInstance(ACoACInstance *pInst, ACoACInstance *pNewInst) {
+    iVector.Finalize(pNewInst->pVecUserIndices);
+    pNewInst->pVecUserIndices = pInst->pVecUserIndices;
+    pInst->pVecUserIndices = NULL;
+    finalizeACoACInstance(pInst);
+}
+
+/****************************************************************************************************
+ * 功能：按编号升序获取实例中的规则编号。规则按此顺序加入新实例，使重复规则中保留哪一条不依赖于哈希表的布局
  * 参数：
  *      @pInst[in]: ACoAC实例
- *      @pCond[in]: 属性合取条件
+ *      @pnRules[out]: 规则数量
  * 返回值：
- *      1：存在满足条件的用户，0：不存在满足条件的用户
+ *      规则编号数组，由调用者释放
  ***************************************************************************************************/
-static int isEffective(ACoACInstance *pInst, HashSet *pCond) {
-    int attrIdx, *pValueIdx;
-    HashMap *pmapAVs;
-    HashSetIterator *itCond;
-    AtomCondition *pAtomCond;
-    int effective = 0;
-
-    // 遍历所有显式指定了部分属性初始值的用户
-    HashNodeIterator *it = iHashMap.NewIterator(pInst->pTableInitState->pRowMap);
-    while (it->HasNext(it)) {
-        // 获得用户初始状态下的属性键值对
-        pmapAVs = *(HashMap **)((HashNode *)it->GetNext(it))->value;
-
-        effective = 1;
-        // 遍历pCond中的每个原子条件
-        itCond = iHashSet.NewIterator(pCond);
-        while (itCond->HasNext(itCond)) {
-            pAtomCond = (AtomCondition *)itCond->GetNext(itCond);
-            attrIdx = pAtomCond->attribute;
-            // 获取用户初始状态下的属性值
-            pValueIdx = (int *)iHashMap.Get(pmapAVs, &attrIdx);
-            if (pValueIdx == NULL) {
-                // 没有显式给出属性初始值，使用默认值
-                pValueIdx = (int *)iHashMap.Get(pmapAttr2DefVal, &attrIdx);
-            }
-            // 判断原子条件是否成立
-            if (!iAtomCondition.Evaluate(pAtomCond, *pValueIdx)) {
-                // 该用户的初始状态下的属性值无法满足该原子条件，终止当前循环并继续判断下一个用户
-                effective = 0;
-                break;
-            }
-        }
-        iHashSet.DeleteIterator(itCond);
-
-        if (effective) {
-            // 找到了一个满足条件的用户，返回1
-            iHashMap.DeleteIterator(it);
-            return 1;
-        }
+static int *getSortedRuleIdxes(ACoACInstance *pInst, int *pnRules) {
+    int nRules = iHashSet.Size(pInst->pSetRuleIdxes), i = 0;
+    int *ruleIdxes = (int *)malloc((nRules + 1) * sizeof(int));
+    HashSetIterator itRuleIdxes;
+    iHashSet.InitIterator(pInst->pSetRuleIdxes, &itRuleIdxes);
+    while (itRuleIdxes.HasNext(&itRuleIdxes)) {
+        ruleIdxes[i++] = *(int *)itRuleIdxes.GetNext(&itRuleIdxes);
     }
-    iHashMap.DeleteIterator(it);
-
-    // 所有显式指定了部分属性初始值的用户都无法满足条件
-    // 继续判断未显式指定初始值的用户，这些用户在初始状态下的的所有属性值都为默认值
-    effective = 1;
-    // 遍历pCond中的每个原子条件
-    itCond = iHashSet.NewIterator(pCond);
-    while (itCond->HasNext(itCond)) {
-        pAtomCond = (AtomCondition *)itCond->GetNext(itCond);
-        attrIdx = pAtomCond->attribute;
-        // 获取属性的属性值
-        pValueIdx = (int *)iHashMap.Get(pmapAttr2DefVal, &attrIdx);
-        // 判断原子条件是否成立
-        if (!iAtomCondition.Evaluate(pAtomCond, *pValueIdx)) {
-            // 存在无法被满足的原子条件，终止循环
-            effective = 0;
-            break;
-        }
-    }
-    iHashSet.DeleteIterator(itCond);
-    return effective;
+    qsort(ruleIdxes, nRules, sizeof(int), compareInts);
+    *pnRules = nRules;
+    return ruleIdxes;
 }
 
 /****************************************************************************************************
@@ -90,65 +119,58 @@ ACoACInstance *userCleaning(ACoACInstance *pInst) {
     ACoACInstance *pNewInst = createACoACInstance();
 
     // 1.删除所有管理条件无法满足的规则，并将剩余规则的管理条件修改为true
-    // 为了提高效率，用一个Map存储已经判断过的AdminCond，避免重复判断
-    HashMap *pmapAdminCond2Bool = iHashMap.Create(sizeof(HashSet *), sizeof(int), iHashSet.HashCode, iHashSet.Equal);
-    iHashMap.SetDestructKey(pmapAdminCond2Bool, iHashSet.DestructPointer);
-    HashSetIterator *itRuleIdxes = iHashSet.NewIterator(pInst->pSetRuleIdxes);
-    int effective, *pEffective, ruleIdx;
-    HashSet *psetAdminCond;
-    while (itRuleIdxes->HasNext(itRuleIdxes)) {
-        ruleIdx = *(int *)itRuleIdxes->GetNext(itRuleIdxes);
+    // 管理条件能否被满足，即是否存在一个用户，其初始状态下的属性满足该条件，通过初始状态的倒排索引判断
+    // 相同的AdminCond共享同一个条件编号，用一个以条件编号为下标的数组存储已经判断过的AdminCond，避免重复判断
+    // 数组元素：-1表示未判断，0表示无法满足，1表示可以满足
+    if (pInst->pInitState == NULL) {
+        pInst->pInitState = iInitState.Create(pInst->pTableInitState, istrCollection.Size(pscUsers), istrCollection.Size(pscAttrs), pmapAttr2DefVal);
+    }
+    UserIndex *pUserIndex = iUserIndex.Create(pInst->pInitState);
+    int nConds = iVector.Size(pVecConds);
+    signed char *adminCondEffective = (signed char *)malloc(nConds);
+    memset(adminCondEffective, -1, nConds);
+    // 按编号升序处理规则，管理条件改为true后内容相同的规则中保留编号最小的一条
+    int nRules, *ruleIdxes = getSortedRuleIdxes(pInst, &nRules), i;
+    int ruleIdx, adminCondIdx, nTests;
+    IntervalTest *tests;
+    for (i = 0; i < nRules; i++) {
+        ruleIdx = ruleIdxes[i];
         Rule *pRule = (Rule *)iVector.GetElement(pVecRules, ruleIdx);
-        psetAdminCond = pRule->adminCond;
-        pEffective = iHashMap.Get(pmapAdminCond2Bool, &psetAdminCond);
-        if (pEffective != NULL && *pEffective) {
-            // pRule->adminCond = iHashSet.Create(sizeof(AtomCondition), iAtomCondition.HashCode, iAtomCondition.Equal);
-            iHashSet.Clear(pRule->adminCond);
+        adminCondIdx = pRule->adminCondIdx;
+        if (adminCondEffective[adminCondIdx] == -1) {
+            tests = getConditionTests(adminCondIdx, &nTests);
+            adminCondEffective[adminCondIdx] = iUserIndex.IsSatisfiable(pUserIndex, tests, nTests);
+        }
+        if (adminCondEffective[adminCondIdx]) {
+            pRule->adminCondIdx = TRUE_COND_IDX;
             addRule(pNewInst, ruleIdx);
-        } else {
-            effective = isEffective(pInst, psetAdminCond);
-            iHashMap.Put(pmapAdminCond2Bool, &psetAdminCond, &effective);
-            if (effective) {
-                pRule->adminCond = iHashSet.Create(sizeof(AtomCondition), iAtomCondition.HashCode, iAtomCondition.Equal);
-                addRule(pNewInst, ruleIdx);
-            }
         }
     }
-    iHashSet.DeleteIterator(itRuleIdxes);
-    iHashMap.Finalize(pmapAdminCond2Bool);
+    free(adminCondEffective);
+    free(ruleIdxes);
+    iUserIndex.Finalize(pUserIndex);
 
-    iHashMap.Finalize(pInst->pMapAttr2Dom);
-    iHashSet.Finalize(pInst->pSetRuleIdxes);
-    iHashBasedTable.Finalize(pInst->pTableTargetAV2Rule);
-    iHashBasedTable.Finalize(pInst->pTablePrecond2Rule);
+    iIntMap.Finalize(pInst->pMapAttr2Dom);
+    releaseRuleIndices(pInst);
 
     // 2.只保留目标用户
     int queryUserIdx = pInst->queryUserIdx;
     iVector.Add(pNewInst->pVecUserIndices, &queryUserIdx);
     iVector.Finalize(pInst->pVecUserIndices);
 
-    // 3. 只保留目标用户的初始状态，并将状态中未列举的属性值用默认值替代
-    HashMap **ppmapInitStateOfQueryUser = iHashMap.Get(pInst->pTableInitState->pRowMap, &queryUserIdx);
-    HashNodeIterator *itAttr2DefVal = iHashMap.NewIterator(pmapAttr2DefVal);
-    HashNode *node;
-    int *pAttrIdx, *pDefValIdx;
-    while (itAttr2DefVal->HasNext(itAttr2DefVal)) {
-        node = itAttr2DefVal->GetNext(itAttr2DefVal);
-        pAttrIdx = (int *)node->key;
-        pDefValIdx = (int *)node->value;
-        if (ppmapInitStateOfQueryUser == NULL || (pDefValIdx = (int *)iHashMap.Get(*ppmapInitStateOfQueryUser, pAttrIdx)) == NULL) {
-            // 该属性在目标用户的初始状态中没有列举，使用默认值
-            pDefValIdx = (int *)node->value;
-        }
-        addUAVByIdx(pNewInst, queryUserIdx, *pAttrIdx, *pDefValIdx);
+    // 3. 只保留目标用户的初始状态，列存储中未列举的属性值已用默认值替代
+    IntMapIterator itAttr2DefVal;
+    iIntMap.InitIterator(pmapAttr2DefVal, &itAttr2DefVal);
+    while (iIntMap.Next(&itAttr2DefVal)) {
+        addUAVByIdx(pNewInst, queryUserIdx, itAttr2DefVal.key, iInitState.Get(pInst->pInitState, queryUserIdx, itAttr2DefVal.key));
     }
-    iHashMap.DeleteIterator(itAttr2DefVal);
     iHashBasedTable.Finalize(pInst->pTableInitState);
+    iInitState.Finalize(pInst->pInitState);
 
     // 4. 查询不变
     pNewInst->queryUserIdx = queryUserIdx;
 
-    iHashMap.Finalize(pNewInst->pmapQueryAVs);
+    iIntMap.Finalize(pNewInst->pmapQueryAVs);
     pNewInst->pmapQueryAVs = pInst->pmapQueryAVs;
 
     // 释放pInst
@@ -178,81 +200,78 @@ ACoACInstance *ruleCleaning(ACoACInstance *pInst, int *ruleCleaningCnt, int *pMo
     clock_t startRuleCleaning = clock();
     ACoACInstance *pNewInst = createACoACInstance();
     *pModification = 0;
-    HashMap *pmapAttrDom = pInst->pMapAttr2Dom;
+    IntMap *pmapAttrDom = pInst->pMapAttr2Dom;
 
     /*1.根据值域清理查询内容*/
     // 查询用户不变
     int queryUserIdx = pInst->queryUserIdx;
     pNewInst->queryUserIdx = queryUserIdx;
-    HashNodeIterator *itQueryAVs = iHashMap.NewIterator(pInst->pmapQueryAVs);
+    IntMapIterator itQueryAVs;
     HashNode *node;
     int *pQueryAttrIdx, *pQueryValueIdx;
-    while (itQueryAVs->HasNext(itQueryAVs)) {
-        node = itQueryAVs->GetNext(itQueryAVs);
-        pQueryAttrIdx = (int *)node->key;
-        pQueryValueIdx = (int *)node->value;
-        HashSet **ppSetDom = iHashMap.Get(pmapAttrDom, pQueryAttrIdx);
+    iIntMap.InitIterator(pInst->pmapQueryAVs, &itQueryAVs);
+    while (iIntMap.Next(&itQueryAVs)) {
+        pQueryAttrIdx = &itQueryAVs.key;
+        pQueryValueIdx = (int *)itQueryAVs.value;
+        ValueSet **ppSetDom = iIntMap.Get(pmapAttrDom, *pQueryAttrIdx);
 
         // 查询属性的值域为空，或者值域中不包含被查询值时，查询不可能成立
-        if (ppSetDom == NULL || !iHashSet.Contains(*ppSetDom, pQueryValueIdx)) {
+        if (ppSetDom == NULL || !iValueSet.Contains(*ppSetDom, *pQueryValueIdx)) {
             char *queryAttr = istrCollection.GetElement(pscAttrs, *pQueryAttrIdx);
             char *queryVal = getValueByIndex(getAttrTypeByIdx(*pQueryAttrIdx), *pQueryValueIdx);
             logACoAC(__func__, __LINE__, 0, INFO, "unreachable, because: the query value %s is not in the domain of the query attribute %s\n", queryAttr, queryAttr);
             free(queryVal);
-            iHashMap.DeleteIterator(itQueryAVs);
             result->code = ACoAC_RESULT_UNREACHABLE;
+            discardInstance(pInst, pNewInst);
             return pNewInst;
         }
 
         // 当查询属性的值域包含被查询值且大小为1时，该属性项将永远成立，不用参与最终查询
-        if (iHashSet.Size(*ppSetDom) == 1) {
+        if (iValueSet.Size(*ppSetDom) == 1) {
             *pModification = 1;
         } else {
-            iHashMap.Put(pNewInst->pmapQueryAVs, pQueryAttrIdx, pQueryValueIdx);
+            iIntMap.Put(pNewInst->pmapQueryAVs, *pQueryAttrIdx, pQueryValueIdx);
         }
     }
-    iHashMap.DeleteIterator(itQueryAVs);
-    iHashMap.Finalize(pInst->pmapQueryAVs);
+    iIntMap.Finalize(pInst->pmapQueryAVs);
+    pInst->pmapQueryAVs = NULL;
     // 如果查询属性值域为空，表示查询条件永远成立
-    if (iHashMap.Size(pNewInst->pmapQueryAVs) == 0) {
+    if (iIntMap.Size(pNewInst->pmapQueryAVs) == 0) {
         logACoAC(__func__, __LINE__, 0, INFO, "reachable, because: the query is always satisfied\n");
         result->code = ACoAC_RESULT_REACHABLE;
         result->pVecActions = iVector.Create(sizeof(AdminstrativeAction), 0);
+        discardInstance(pInst, pNewInst);
         return pNewInst;
     }
 
-    HashSet *pSetToBeRemoved = iHashSet.Create(sizeof(int), IntHashCode, IntEqual);
-    HashNodeIterator *itAttrDom = iHashMap.NewIterator(pmapAttrDom);
-    HashSet *pSetDom;
+    IntSet *pSetToBeRemoved = iIntSet.Create();
+    IntMapIterator itAttrDom;
     int *pAttrIdx;
-    while (itAttrDom->HasNext(itAttrDom)) {
-        node = itAttrDom->GetNext(itAttrDom);
-        pAttrIdx = (int *)node->key;
-        pSetDom = *(HashSet **)node->value;
-        if (iHashSet.Size(pSetDom) == 1) {
-            iHashSet.Add(pSetToBeRemoved, pAttrIdx);
+    iIntMap.InitIterator(pmapAttrDom, &itAttrDom);
+    while (iIntMap.Next(&itAttrDom)) {
+        if (iValueSet.Size(*(ValueSet **)itAttrDom.value) == 1) {
+            iIntSet.Add(pSetToBeRemoved, itAttrDom.key);
         }
     }
-    iHashMap.DeleteIterator(itAttrDom);
 
-    /*2.根据值域清洗规则，同时根据Set的无重复性删除重复规则*/
-    int discreteResult, nOldRules = iHashSet.Size(pInst->pSetRuleIdxes);
+    /*2.根据值域清洗规则，同时根据Set的无重复性删除重复规则，重复规则中保留编号最小的一条*/
+    int discreteResult, nOldRules;
+    int *ruleIdxes = getSortedRuleIdxes(pInst, &nOldRules);
     Rule *pRule;
-    HashSetIterator *itRuleIdxes = iHashSet.NewIterator(pInst->pSetRuleIdxes);
-    int ruleIdx;
+    int ruleIdx, i;
     char *ruleStr;
-    while (itRuleIdxes->HasNext(itRuleIdxes)) {
-        ruleIdx = *(int *)itRuleIdxes->GetNext(itRuleIdxes);
+    for (i = 0; i < nOldRules; i++) {
+        ruleIdx = ruleIdxes[i];
         pRule = (Rule *)iVector.GetElement(pVecRules, ruleIdx);
         // 目标属性值域大小为1时，表示它永远不会变化，此时规则没有意义，不应当保留
-        if (iHashSet.Contains(pSetToBeRemoved, &pRule->targetAttrIdx)) {
+        if (iIntSet.Contains(pSetToBeRemoved, pRule->targetAttrIdx)) {
             *pModification = 1;
             ruleStr = RuleToString(&pRule);
             logACoAC(__func__, __LINE__, 0, DEBUG, "because the size of domain of the target attribute is 1, the rule can be removed: %s\n", ruleStr);
             free(ruleStr);
             continue;
         }
-        discreteResult = iRule.DiscreteCond(pRule, pmapAttrDom);
+        discreteResult = iRule.DiscreteCond(getMutableRule(ruleIdx), pmapAttrDom);
         if (discreteResult == 1) {
             *pModification = 1;
         } else if (discreteResult == -1) {
@@ -265,32 +284,30 @@ ACoACInstance *ruleCleaning(ACoACInstance *pInst, int *ruleCleaningCnt, int *pMo
         }
         addRule(pNewInst, ruleIdx);
     }
-    iHashSet.DeleteIterator(itRuleIdxes);
+    free(ruleIdxes);
 
     /*3.用户不需要清理*/
     iVector.Finalize(pNewInst->pVecUserIndices);
     pNewInst->pVecUserIndices = pInst->pVecUserIndices;
 
     /*4.清理初始属性值*/
-    HashNodeIterator *itInitState = iHashMap.NewIterator(iHashBasedTable.GetRow(pInst->pTableInitState, &queryUserIdx));
-    while (itInitState->HasNext(itInitState)) {
-        node = itInitState->GetNext(itInitState);
+    HashNodeIterator itInitState;
+    iHashMap.InitIterator(iHashBasedTable.GetRow(pInst->pTableInitState, &queryUserIdx), &itInitState);
+    while (itInitState.HasNext(&itInitState)) {
+        node = itInitState.GetNext(&itInitState);
         pAttrIdx = (int *)node->key;
-        if (iHashSet.Contains(pSetToBeRemoved, pAttrIdx)) {
+        if (iIntSet.Contains(pSetToBeRemoved, *pAttrIdx)) {
             *pModification = 1;
             continue;
         }
         addUAVByIdx(pNewInst, queryUserIdx, *pAttrIdx, *(int *)node->value);
     }
-    iHashSet.Finalize(pSetToBeRemoved);
+    iIntSet.Finalize(pSetToBeRemoved);
 
-    iHashMap.DeleteIterator(itInitState);
     iHashBasedTable.Finalize(pInst->pTableInitState);
 
-    iHashMap.Finalize(pInst->pMapAttr2Dom);
-    iHashSet.Finalize(pInst->pSetRuleIdxes);
-    iHashBasedTable.Finalize(pInst->pTableTargetAV2Rule);
-    iHashBasedTable.Finalize(pInst->pTablePrecond2Rule);
+    iIntMap.Finalize(pInst->pMapAttr2Dom);
+    releaseRuleIndices(pInst);
     free(pInst);
 
     int nNewRules = iHashSet.Size(pNewInst->pSetRuleIdxes);
@@ -330,147 +347,112 @@ static ACoACInstance *forwardSlice(ACoACInstance *pInst, int *forwardSlicingCnt,
     // 创建新实例
     ACoACInstance *pNewInst = createACoACInstance();
 
+    // 在从剩余规则集中移除规则之前构建索引
+    CSRIndex *pIndexPrecond2Rule = getPrecond2RuleIndex(pInst);
+
     // 1.根据queryUser的初始属性值， 初始化可达属性值
     int queryUserIdx = pInst->queryUserIdx;
-    HashMap *pmapReachableAVs = iHashMap.Create(sizeof(int), sizeof(HashSet *), IntHashCode, IntEqual);
-    iHashMap.SetDestructValue(pmapReachableAVs, iHashSet.DestructPointer);
+    IntMap *pmapReachableAVs = iIntMap.Create(sizeof(ValueSet *));
+    iIntMap.SetDestructValue(pmapReachableAVs, iValueSet.DestructPointer);
 
-    HashNodeIterator *itInitState = iHashMap.NewIterator(iHashBasedTable.GetRow(pInst->pTableInitState, &queryUserIdx));
+    HashNodeIterator itInitState;
+    iHashMap.InitIterator(iHashBasedTable.GetRow(pInst->pTableInitState, &queryUserIdx), &itInitState);
     HashNode *node;
     int *pAttrIdx, *pValIdx;
-    HashSet *pSetVals;
-    while (itInitState->HasNext(itInitState)) {
-        node = itInitState->GetNext(itInitState);
+    ValueSet *pSetVals;
+    while (itInitState.HasNext(&itInitState)) {
+        node = itInitState.GetNext(&itInitState);
         pAttrIdx = (int *)node->key;
         pValIdx = (int *)node->value;
-        pSetVals = iHashSet.Create(sizeof(int), IntHashCode, IntEqual);
-        iHashSet.Add(pSetVals, pValIdx);
-        iHashMap.Put(pmapReachableAVs, pAttrIdx, &pSetVals);
+        pSetVals = iValueSet.Create();
+        iValueSet.Add(pSetVals, *pValIdx);
+        iIntMap.Put(pmapReachableAVs, *pAttrIdx, &pSetVals);
     }
-    iHashMap.DeleteIterator(itInitState);
 
-    // 用于存储增量可达属性值
-    HashMap *pmapReachableAVsIncs = iHashMap.Create(sizeof(int), sizeof(HashSet *), IntHashCode, IntEqual);
-    iHashMap.SetDestructValue(pmapReachableAVsIncs, iHashSet.DestructPointer);
+    // 逐层扩展可达属性值：每层的候选规则根据该层开始时的可达属性值检查是否可触发，检查可以并行执行，
+    // 然后按候选规则的顺序依次触发，新增的可达属性值组成下一层的前沿，以其为前置条件的规则为下一层的候选规则。
+    // 可达属性值只增不减，规则只要在某一层可触发就会被触发，因此结果与逐条检查规则相同
+    int *candidates = (int *)malloc((nOldRules + 1) * sizeof(int));
+    char *effective = (char *)malloc(nOldRules + 1);
+    AVP *frontier = (AVP *)malloc((nOldRules + 1) * sizeof(AVP));
+    int *candidateLevel = (int *)malloc((iVector.Size(pVecRules) + 1) * sizeof(int));
+    int nCandidates = 0, nFrontier, level = 0, i, j;
+    ThreadPool *pPool = NULL;
+
+    // 第一层的候选规则为所有剩余规则
+    HashSetIterator itRuleIdxes;
+    iHashSet.InitIterator(pInst->pSetRuleIdxes, &itRuleIdxes);
+    while (itRuleIdxes.HasNext(&itRuleIdxes)) {
+        candidates[nCandidates++] = *(int *)itRuleIdxes.GetNext(&itRuleIdxes);
+    }
+    for (i = 0; i < iVector.Size(pVecRules); i++) {
+        candidateLevel[i] = -1;
+    }
 
-    // 第一轮检查规则是否可达
-    HashSetIterator *itRuleIdxes = iHashSet.NewIterator(pInst->pSetRuleIdxes);
     Rule *pRule;
-    HashSet **ppSetVals;
-    int targetAttrIdx, targetValIdx, ruleIdx;
-    while (itRuleIdxes->HasNext(itRuleIdxes)) {
-        ruleIdx = *(int *)itRuleIdxes->GetNext(itRuleIdxes);
-        pRule = (Rule *)iVector.GetElement(pVecRules, ruleIdx);
-        if (iRule.IsEffective(pRule, pmapReachableAVs)) {
-            targetAttrIdx = pRule->targetAttrIdx;
-            targetValIdx = pRule->targetValueIdx;
+    ValueSet **ppSetVals;
+    int targetAttrIdx, targetValIdx, ruleIdx, *pRuleIdxes, nRuleIdxes;
+    while (nCandidates > 0) {
+        checkEffective(candidates, nCandidates, effective, pmapReachableAVs, &pPool);
+
+        // 触发可触发的规则，更新可达属性值和前沿
+        nFrontier = 0;
+        for (i = 0; i < nCandidates; i++) {
+            if (!effective[i]) {
+                continue;
+            }
+            ruleIdx = candidates[i];
+            pRule = (Rule *)iVector.GetElement(pVecRules, ruleIdx);
             addRule(pNewInst, ruleIdx);
+            // 从剩余规则集中移除
+            iHashSet.Remove(pInst->pSetRuleIdxes, &ruleIdx);
 
-            // 更新可达属性值
-            ppSetVals = (HashSet **)iHashMap.Get(pmapReachableAVs, &targetAttrIdx);
+            targetAttrIdx = pRule->targetAttrIdx;
+            targetValIdx = pRule->targetValueIdx;
+            ppSetVals = (ValueSet **)iIntMap.Get(pmapReachableAVs, targetAttrIdx);
             if (ppSetVals == NULL) {
-                pSetVals = iHashSet.Create(sizeof(int), IntHashCode, IntEqual);
+                pSetVals = iValueSet.Create();
                 ppSetVals = &pSetVals;
-                iHashMap.Put(pmapReachableAVs, &targetAttrIdx, ppSetVals);
+                iIntMap.Put(pmapReachableAVs, targetAttrIdx, ppSetVals);
             }
-            iHashSet.Add(*ppSetVals, &targetValIdx);
-
-            // 更新增量可达属性值
-            ppSetVals = (HashSet **)iHashMap.Get(pmapReachableAVsIncs, &targetAttrIdx);
-            if (ppSetVals == NULL) {
-                pSetVals = iHashSet.Create(sizeof(int), IntHashCode, IntEqual);
-                ppSetVals = &pSetVals;
-                iHashMap.Put(pmapReachableAVsIncs, &targetAttrIdx, ppSetVals);
+            if (iValueSet.Add(*ppSetVals, targetValIdx)) {
+                frontier[nFrontier++] = (AVP){.attrIdx = targetAttrIdx, .valIdx = targetValIdx};
             }
-            iHashSet.Add(*ppSetVals, &targetValIdx);
+        }
 
-            // 从剩余规则集中移除
-            itRuleIdxes->Remove(itRuleIdxes);
-        }
-    }
-    iHashSet.DeleteIterator(itRuleIdxes);
-
-    // 迭代处理增量可达属性值
-    HashMap *pmapNewIncrement;
-    HashNodeIterator *itReachableAVsIncs;
-    HashSetIterator *itVals;
-    HashSet **ppSetRuleIdxes;
-    int *pRuleIdx;
-    while (iHashMap.Size(pmapReachableAVsIncs) > 0) {
-        pmapNewIncrement = iHashMap.Create(sizeof(int), sizeof(HashSet *), IntHashCode, IntEqual);
-        iHashMap.SetDestructValue(pmapNewIncrement, iHashSet.DestructPointer);
-
-        itReachableAVsIncs = iHashMap.NewIterator(pmapReachableAVsIncs);
-        while (itReachableAVsIncs->HasNext(itReachableAVsIncs)) {
-            node = itReachableAVsIncs->GetNext(itReachableAVsIncs);
-            pAttrIdx = (int *)node->key;
-            itVals = iHashSet.NewIterator(*(HashSet **)node->value);
-            while (itVals->HasNext(itVals)) {
-                pValIdx = (int *)itVals->GetNext(itVals);
-                // 找出所有可能因增量可达属性值而可达的规则，即以该属性值为前置条件的规则
-                ppSetRuleIdxes = (HashSet **)iHashBasedTable.Get(pInst->pTablePrecond2Rule, pAttrIdx, pValIdx);
-                if (ppSetRuleIdxes == NULL) {
-                    continue;
-                }
-                itRuleIdxes = iHashSet.NewIterator(*ppSetRuleIdxes);
-                while (itRuleIdxes->HasNext(itRuleIdxes)) {
-                    pRuleIdx = (int *)itRuleIdxes->GetNext(itRuleIdxes);
-                    pRule = (Rule *)iVector.GetElement(pVecRules, *pRuleIdx);
-                    // 检查规则是否在剩余规则集中且可达
-                    if (!iHashSet.Contains(pInst->pSetRuleIdxes, pRuleIdx) || !iRule.IsEffective(pRule, pmapReachableAVs)) {
-                        continue;
-                    }
-                    // 将该规则添加到新实例中
-                    addRule(pNewInst, *pRuleIdx);
-                    targetAttrIdx = pRule->targetAttrIdx;
-                    targetValIdx = pRule->targetValueIdx;
-                    ppSetVals = (HashSet **)iHashMap.Get(pmapReachableAVs, &targetAttrIdx);
-                    if (ppSetVals != NULL && iHashSet.Contains(*ppSetVals, &targetValIdx)) {
-                        continue;
-                    }
-                    // 更新可达属性值
-                    if (ppSetVals == NULL) {
-                        pSetVals = iHashSet.Create(sizeof(int), IntHashCode, IntEqual);
-                        ppSetVals = &pSetVals;
-                        iHashMap.Put(pmapReachableAVs, &targetAttrIdx, ppSetVals);
-                    }
-                    iHashSet.Add(*ppSetVals, &targetValIdx);
-                    // 更新新增量
-                    ppSetVals = (HashSet **)iHashMap.Get(pmapNewIncrement, &targetAttrIdx);
-                    if (ppSetVals == NULL) {
-                        pSetVals = iHashSet.Create(sizeof(int), IntHashCode, IntEqual);
-                        ppSetVals = &pSetVals;
-                        iHashMap.Put(pmapNewIncrement, &targetAttrIdx, ppSetVals);
-                    }
-                    iHashSet.Add(*ppSetVals, &targetValIdx);
-                    // 从剩余规则集中移除
-                    iHashSet.Remove(pInst->pSetRuleIdxes, pRuleIdx);
+        // 找出所有可能因前沿而可触发的规则，即在剩余规则集中且以前沿的属性值为前置条件的规则
+        level++;
+        nCandidates = 0;
+        for (i = 0; i < nFrontier; i++) {
+            nRuleIdxes = iCSRIndex.Get(pIndexPrecond2Rule, frontier[i].attrIdx, frontier[i].valIdx, &pRuleIdxes);
+            for (j = 0; j < nRuleIdxes; j++) {
+                ruleIdx = pRuleIdxes[j];
+                if (candidateLevel[ruleIdx] != level && iHashSet.Contains(pInst->pSetRuleIdxes, &ruleIdx)) {
+                    candidateLevel[ruleIdx] = level;
+                    candidates[nCandidates++] = ruleIdx;
                 }
-                iHashSet.DeleteIterator(itRuleIdxes);
             }
-            iHashSet.DeleteIterator(itVals);
         }
-        iHashMap.DeleteIterator(itReachableAVsIncs);
-        // 清理旧的增量集
-        iHashMap.Finalize(pmapReachableAVsIncs);
-        pmapReachableAVsIncs = pmapNewIncrement;
     }
-    iHashMap.Finalize(pmapReachableAVsIncs);
+    iThreadPool.Finalize(pPool);
+    free(candidates);
+    free(effective);
+    free(frontier);
+    free(candidateLevel);
 
     // 检查是否发生修改
     if (iHashSet.Size(pNewInst->pSetRuleIdxes) != nOldRules) {
         *pModification = 1;
-        itRuleIdxes = iHashSet.NewIterator(pInst->pSetRuleIdxes);
-        while (itRuleIdxes->HasNext(itRuleIdxes)) {
-            ruleIdx = *(int *)itRuleIdxes->GetNext(itRuleIdxes);
+        iHashSet.InitIterator(pInst->pSetRuleIdxes, &itRuleIdxes);
+        while (itRuleIdxes.HasNext(&itRuleIdxes)) {
+            ruleIdx = *(int *)itRuleIdxes.GetNext(&itRuleIdxes);
             pRule = (Rule *)iVector.GetElement(pVecRules, ruleIdx);
             logACoAC(__func__, __LINE__, 0, DEBUG, "user condition can never be satisfied: %s", RuleToString(&pRule));
         }
-        iHashMap.DeleteIterator(itRuleIdxes);
     }
 
     // 设置新实例的其他属性
-    iHashMap.Finalize(pNewInst->pMapAttr2Dom);
+    iIntMap.Finalize(pNewInst->pMapAttr2Dom);
     pNewInst->pMapAttr2Dom = pmapReachableAVs;
 
     iVector.Finalize(pNewInst->pVecUserIndices);
@@ -481,13 +463,11 @@ static ACoACInstance *forwardSlice(ACoACInstance *pInst, int *forwardSlicingCnt,
 
     pNewInst->queryUserIdx = pInst->queryUserIdx;
 
-    iHashMap.Finalize(pNewInst->pmapQueryAVs);
+    iIntMap.Finalize(pNewInst->pmapQueryAVs);
     pNewInst->pmapQueryAVs = pInst->pmapQueryAVs;
 
-    iHashMap.Finalize(pInst->pMapAttr2Dom);
-    iHashSet.Finalize(pInst->pSetRuleIdxes);
-    iHashBasedTable.Finalize(pInst->pTablePrecond2Rule);
-    iHashBasedTable.Finalize(pInst->pTableTargetAV2Rule);
+    iIntMap.Finalize(pInst->pMapAttr2Dom);
+    releaseRuleIndices(pInst);
     free(pInst);
 
     int nNewRules = iHashSet.Size(pNewInst->pSetRuleIdxes);
@@ -499,11 +479,6 @@ static ACoACInstance *forwardSlice(ACoACInstance *pInst, int *forwardSlicingCnt,
     return pNewInst;
 }
 
-typedef struct _AVP {
-    int attrIdx;
-    int valIdx;
-} AVP;
-
 static unsigned int AVPHashCode(void *pKey) {
     AVP *pAVP = (AVP *)pKey;
     unsigned int hash = 1;
@@ -526,47 +501,43 @@ ACoACInstance *backwardSlice(ACoACInstance *pInst, int *backwardSlicingCnt, int
 
     List *pListStack = iList.Create(sizeof(AVP));
     HashSet *pSetVisited = iHashSet.Create(sizeof(AVP), AVPHashCode, AVPEqual);
-    HashNodeIterator *itQueryAVs = iHashMap.NewIterator(pInst->pmapQueryAVs);
+    IntMapIterator itQueryAVs;
     HashNode *node;
-    int queryAttrIdx, queryValueIdx;
-    while (itQueryAVs->HasNext(itQueryAVs)) {
-        node = itQueryAVs->GetNext(itQueryAVs);
-        queryAttrIdx = *(int *)node->key;
-        queryValueIdx = *(int *)node->value;
-        AVP avp = {.attrIdx = queryAttrIdx, .valIdx = queryValueIdx};
+    iIntMap.InitIterator(pInst->pmapQueryAVs, &itQueryAVs);
+    while (iIntMap.Next(&itQueryAVs)) {
+        AVP avp = {.attrIdx = itQueryAVs.key, .valIdx = *(int *)itQueryAVs.value};
         iList.PushFront(pListStack, &avp);
         iHashSet.Add(pSetVisited, &avp);
     }
-    iHashMap.DeleteIterator(itQueryAVs);
 
-    HashMap *pmapReachableAVs = iHashMap.Create(sizeof(int), sizeof(HashSet *), IntHashCode, IntEqual);
-    iHashMap.SetDestructValue(pmapReachableAVs, iHashSet.DestructPointer);
+    IntMap *pmapReachableAVs = iIntMap.Create(sizeof(ValueSet *));
+    iIntMap.SetDestructValue(pmapReachableAVs, iValueSet.DestructPointer);
 
     AVP avp, avp2;
     Rule *pRule;
-    int ruleIdx;
+    int ruleIdx, *pRuleIdxes, nRuleIdxes, i;
     char *ruleStr, *val;
-    HashNodeIterator *itUserCondValue;
-    HashSet **ppSetRuleIdxes, *pSetVals, **ppSetVals;
-    HashSetIterator *itRuleIdxes, *itVals;
+    HashNodeIterator itUserCondValue;
+    ValueSet *pSetVals, **ppSetVals;
+    ValueSetIterator itVals;
+    CSRIndex *pIndexTargetAV2Rule = getTargetAV2RuleIndex(pInst);
     while (iList.Size(pListStack) > 0) {
         iList.PopFront(pListStack, &avp);
-        ppSetRuleIdxes = iHashBasedTable.Get(pInst->pTableTargetAV2Rule, &avp.attrIdx, &avp.valIdx);
-        if (ppSetRuleIdxes == NULL) {
+        nRuleIdxes = iCSRIndex.Get(pIndexTargetAV2Rule, avp.attrIdx, avp.valIdx, &pRuleIdxes);
+        if (nRuleIdxes == 0) {
             continue;
         }
 
-        ppSetVals = (HashSet **)iHashMap.Get(pmapReachableAVs, &avp.attrIdx);
+        ppSetVals = (ValueSet **)iIntMap.Get(pmapReachableAVs, avp.attrIdx);
         if (ppSetVals == NULL) {
-            pSetVals = iHashSet.Create(sizeof(int), IntHashCode, IntEqual);
+            pSetVals = iValueSet.Create();
             ppSetVals = &pSetVals;
-            iHashMap.Put(pmapReachableAVs, &avp.attrIdx, ppSetVals);
+            iIntMap.Put(pmapReachableAVs, avp.attrIdx, ppSetVals);
         }
-        iHashSet.Add(*ppSetVals, &avp.valIdx);
+        iValueSet.Add(*ppSetVals, avp.valIdx);
 
-        itRuleIdxes = iHashSet.NewIterator(*ppSetRuleIdxes);
-        while (itRuleIdxes->HasNext(itRuleIdxes)) {
-            ruleIdx = *(int *)itRuleIdxes->GetNext(itRuleIdxes);
+        for (i = 0; i < nRuleIdxes; i++) {
+            ruleIdx = pRuleIdxes[i];
             pRule = (Rule *)iVector.GetElement(pVecRules, ruleIdx);
             addRule(pNewInst, ruleIdx);
             ruleStr = RuleToString(&pRule);
@@ -574,21 +545,18 @@ ACoACInstance *backwardSlice(ACoACInstance *pInst, int *backwardSlicingCnt, int
             logACoAC(__func__, __LINE__, 0, DEBUG, "rule %s is associated with (%s, %s)", ruleStr, istrCollection.GetElement(pscAttrs, avp.attrIdx), val);
             free(ruleStr);
             free(val);
-            itUserCondValue = iHashMap.NewIterator(pRule->pmapUserCondValue);
-            while (itUserCondValue->HasNext(itUserCondValue)) {
-                node = itUserCondValue->GetNext(itUserCondValue);
-                itVals = iHashSet.NewIterator(*(HashSet **)node->value);
-                while (itVals->HasNext(itVals)) {
-                    avp2 = (AVP){.attrIdx = *(int *)node->key, .valIdx = *(int *)itVals->GetNext(itVals)};
+            iHashMap.InitIterator(pRule->pmapUserCondValue, &itUserCondValue);
+            while (itUserCondValue.HasNext(&itUserCondValue)) {
+                node = itUserCondValue.GetNext(&itUserCondValue);
+                iValueSet.InitIterator(*(ValueSet **)node->value, &itVals);
+                while (iValueSet.Next(&itVals)) {
+                    avp2 = (AVP){.attrIdx = *(int *)node->key, .valIdx = itVals.value};
                     if (iHashSet.Add(pSetVisited, &avp2)) {
                         iList.PushFront(pListStack, &avp2);
                     }
                 }
-                iHashSet.DeleteIterator(itVals);
             }
-            iHashMap.DeleteIterator(itUserCondValue);
         }
-        iHashSet.DeleteIterator(itRuleIdxes);
     }
     iList.Finalize(pListStack);
     iHashSet.Finalize(pSetVisited);
@@ -598,23 +566,23 @@ ACoACInstance *backwardSlice(ACoACInstance *pInst, int *backwardSlicingCnt, int
     }
 
     int *pAttrIdx;
-    HashNodeIterator *itInitState = iHashMap.NewIterator(iHashBasedTable.GetRow(pInst->pTableInitState, &pInst->queryUserIdx));
-    while (itInitState->HasNext(itInitState)) {
-        node = itInitState->GetNext(itInitState);
+    HashNodeIterator itInitState;
+    iHashMap.InitIterator(iHashBasedTable.GetRow(pInst->pTableInitState, &pInst->queryUserIdx), &itInitState);
+    while (itInitState.HasNext(&itInitState)) {
+        node = itInitState.GetNext(&itInitState);
         pAttrIdx = (int *)node->key;
-        ppSetVals = (HashSet **)iHashMap.Get(pmapReachableAVs, pAttrIdx);
+        ppSetVals = (ValueSet **)iIntMap.Get(pmapReachableAVs, *pAttrIdx);
         if (ppSetVals == NULL) {
-            pSetVals = iHashSet.Create(sizeof(int), IntHashCode, IntEqual);
+            pSetVals = iValueSet.Create();
             ppSetVals = &pSetVals;
-            iHashMap.Put(pmapReachableAVs, pAttrIdx, ppSetVals);
+            iIntMap.Put(pmapReachableAVs, *pAttrIdx, ppSetVals);
         }
-        iHashSet.Add(*ppSetVals, node->value);
+        iValueSet.Add(*ppSetVals, *(int *)node->value);
     }
-    iHashMap.DeleteIterator(itInitState);
 
     int nOldRules = iHashSet.Size(pInst->pSetRuleIdxes);
 
-    iHashMap.Finalize(pNewInst->pMapAttr2Dom);
+    iIntMap.Finalize(pNewInst->pMapAttr2Dom);
     pNewInst->pMapAttr2Dom = pmapReachableAVs;
 
     iVector.Finalize(pNewInst->pVecUserIndices);
@@ -625,13 +593,11 @@ ACoACInstance *backwardSlice(ACoACInstance *pInst, int *backwardSlicingCnt, int
 
     pNewInst->queryUserIdx = pInst->queryUserIdx;
 
-    iHashMap.Finalize(pNewInst->pmapQueryAVs);
+    iIntMap.Finalize(pNewInst->pmapQueryAVs);
     pNewInst->pmapQueryAVs = pInst->pmapQueryAVs;
 
-    iHashMap.Finalize(pInst->pMapAttr2Dom);
-    iHashSet.Finalize(pInst->pSetRuleIdxes);
-    iHashBasedTable.Finalize(pInst->pTablePrecond2Rule);
-    iHashBasedTable.Finalize(pInst->pTableTargetAV2Rule);
+    iIntMap.Finalize(pInst->pMapAttr2Dom);
+    releaseRuleIndices(pInst);
     free(pInst);
 
     int nNewRules = iHashSet.Size(pNewInst->pSetRuleIdxes);
@@ -643,6 +609,187 @@ ACoACInstance *backwardSlice(ACoACInstance *pInst, int *backwardSlicingCnt, int
     return pNewInst;
 }
 
+/*
+ * 规则归并中被排序的规则，约束越少的规则越靠前
+ */
+typedef struct _SubsumptionRule {
+    int ruleIdx;
+    // 用户条件约束的属性数量，以及各属性可取值的总数
+    int nAttrs;
+    int nValues;
+} SubsumptionRule;
+
+static int compareSubsumptionRules(const void *p1, const void *p2) {
+    const SubsumptionRule *r1 = (const SubsumptionRule *)p1, *r2 = (const SubsumptionRule *)p2;
+    if (r1->nAttrs != r2->nAttrs) {
+        return r1->nAttrs < r2->nAttrs ? -1 : 1;
+    }
+    if (r1->nValues != r2->nValues) {
+        return r1->nValues > r2->nValues ? -1 : 1;
+    }
+    return compareInts(&r1->ruleIdx, &r2->ruleIdx);
+}
+
+static void destructBucket(void *ppBucket) {
+    iVector.Finalize(*(Vector **)ppBucket);
+}
+
+/****************************************************************************************************
+ * 功能：判断规则pRule2是否比pRule1更弱，即pRule1能够被触发时pRule2一定也能被触发
+ *      pRule2的管理条件为true或与pRule1的相同，且pRule2的用户条件约束的每个属性也被pRule1约束，
+ *      pRule1在该属性上的可取值是pRule2的可取值的子集
+ ***************************************************************************************************/
+static int isWeakerRule(Rule *pRule2, Rule *pRule1) {
+    if (pRule2->adminCondIdx != TRUE_COND_IDX && pRule2->adminCondIdx != pRule1->adminCondIdx) {
+        return 0;
+    }
+    HashNodeIterator itUserCondValue;
+    HashNode *node;
+    ValueSet **ppSetVals1;
+    iHashMap.InitIterator(pRule2->pmapUserCondValue, &itUserCondValue);
+    while (itUserCondValue.HasNext(&itUserCondValue)) {
+        node = itUserCondValue.GetNext(&itUserCondValue);
+        ppSetVals1 = (ValueSet **)iHashMap.Get(pRule1->pmapUserCondValue, node->key);
+        if (ppSetVals1 == NULL || !iValueSet.ContainsAll(*(ValueSet **)node->value, *ppSetVals1)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static int isSubsumedInBucket(HashMap *pmapBuckets, AVP *pAVP, Rule *pRule) {
+    Vector **ppBucket = (Vector **)iHashMap.Get(pmapBuckets, pAVP);
+    int i;
+    for (i = 0; ppBucket != NULL && i < iVector.Size(*ppBucket); i++) {
+        if (isWeakerRule((Rule *)iVector.GetElement(pVecRules, *(int *)iVector.GetElement(*ppBucket, i)), pRule)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void addToBucket(HashMap *pmapBuckets, AVP avp, int ruleIdx) {
+    Vector **ppBucket = (Vector **)iHashMap.Get(pmapBuckets, &avp), *pBucket;
+    if (ppBucket == NULL) {
+        pBucket = iVector.Create(sizeof(int), 4);
+        iHashMap.Put(pmapBuckets, &avp, &pBucket);
+    } else {
+        pBucket = *ppBucket;
+    }
+    iVector.Add(pBucket, &ruleIdx);
+}
+
+/****************************************************************************************************
+ * 功能：删除被归并的规则。目标属性值相同的两条规则中，若r2比r1更弱，则任何使用r1的管理操作序列都可以改用r2，
+ *      删除r1不影响查询的可达性。约束相同的规则中保留编号最小的一条
+ *      每组目标属性值相同的规则按约束从少到多处理，更弱的规则总是先被处理，因此只需与已保留的规则比较。
+ *      r2比r1更弱时，r2约束的属性都被r1约束，设a为r2约束的编号最小的属性，则r1约束a，且r1在a上的最小可取值v
+ *      属于r2在a上的可取值。已保留的规则按其编号最小的约束属性a及a上的每个可取值v放入桶(a, v)中，
+ *      r1只需与桶(a, min(r1[a]))中的规则比较，a取遍r1约束的属性，而不是与组内所有规则比较
+ * 参数：
+ *      @pInst[in]: ACoAC实例，被原地修改
+ * 返回值：
+ *      被删除的规则数量
+ ***************************************************************************************************/
+int removeSubsumedRules(ACoACInstance *pInst) {
+    logACoAC(__func__, __LINE__, 0, INFO, "[start] removing subsumed rules\n");
+    clock_t startRemoving = clock();
+
+    CSRIndex *pIndex = getTargetAV2RuleIndex(pInst);
+    int nRules = pIndex->cellStart[pIndex->nCells];
+    int *keptRuleIdxes = (int *)malloc((nRules + 1) * sizeof(int)), nKeptRules = 0;
+    SubsumptionRule *group = (SubsumptionRule *)malloc((nRules + 1) * sizeof(SubsumptionRule));
+    HashMap *pmapBuckets = iHashMap.Create(sizeof(AVP), sizeof(Vector *), AVPHashCode, AVPEqual);
+    iHashMap.SetDestructValue(pmapBuckets, destructBucket);
+    HashNodeIterator itUserCondValue;
+    HashNode *node;
+    ValueSetIterator itVals;
+    Rule *pRule;
+    AVP avp;
+    int cell, nGroup, i, minAttrIdx, subsumed;
+    char *ruleStr;
+    for (cell = 0; cell < pIndex->nCells; cell++) {
+        nGroup = 0;
+        for (i = pIndex->cellStart[cell]; i < pIndex->cellStart[cell + 1]; i++) {
+            pRule = (Rule *)iVector.GetElement(pVecRules, pIndex->elems[i]);
+            if (pRule->pmapUserCondValue == NULL) {
+                keptRuleIdxes[nKeptRules++] = pIndex->elems[i];
+                continue;
+            }
+            group[nGroup] = (SubsumptionRule){.ruleIdx = pIndex->elems[i], .nAttrs = iHashMap.Size(pRule->pmapUserCondValue), .nValues = 0};
+            iHashMap.InitIterator(pRule->pmapUserCondValue, &itUserCondValue);
+            while (itUserCondValue.HasNext(&itUserCondValue)) {
+                node = itUserCondValue.GetNext(&itUserCondValue);
+                group[nGroup].nValues += iValueSet.Size(*(ValueSet **)node->value);
+            }
+            nGroup++;
+        }
+        if (nGroup == 0) {
+            continue;
+        }
+        qsort(group, nGroup, sizeof(SubsumptionRule), compareSubsumptionRules);
+
+        iHashMap.Clear(pmapBuckets);
+        for (i = 0; i < nGroup; i++) {
+            pRule = (Rule *)iVector.GetElement(pVecRules, group[i].ruleIdx);
+            // 没有约束的已保留规则在桶(-1, -1)中，它们比组内的任何规则都弱
+            avp = (AVP){.attrIdx = -1, .valIdx = -1};
+            subsumed = isSubsumedInBucket(pmapBuckets, &avp, pRule);
+            iHashMap.InitIterator(pRule->pmapUserCondValue, &itUserCondValue);
+            while (!subsumed && itUserCondValue.HasNext(&itUserCondValue)) {
+                node = itUserCondValue.GetNext(&itUserCondValue);
+                iValueSet.InitIterator(*(ValueSet **)node->value, &itVals);
+                if (iValueSet.Next(&itVals)) {
+                    avp = (AVP){.attrIdx = *(int *)node->key, .valIdx = itVals.value};
+                    subsumed = isSubsumedInBucket(pmapBuckets, &avp, pRule);
+                }
+            }
+            if (subsumed) {
+                ruleStr = RuleToString(&pRule);
+                logACoAC(__func__, __LINE__, 0, DEBUG, "the rule is subsumed by a weaker rule with the same target: %s\n", ruleStr);
+                free(ruleStr);
+                continue;
+            }
+
+            keptRuleIdxes[nKeptRules++] = group[i].ruleIdx;
+            minAttrIdx = -1;
+            iHashMap.InitIterator(pRule->pmapUserCondValue, &itUserCondValue);
+            while (itUserCondValue.HasNext(&itUserCondValue)) {
+                node = itUserCondValue.GetNext(&itUserCondValue);
+                if (minAttrIdx == -1 || *(int *)node->key < minAttrIdx) {
+                    minAttrIdx = *(int *)node->key;
+                }
+            }
+            if (minAttrIdx == -1) {
+                addToBucket(pmapBuckets, (AVP){.attrIdx = -1, .valIdx = -1}, group[i].ruleIdx);
+                continue;
+            }
+            iValueSet.InitIterator(*(ValueSet **)iHashMap.Get(pRule->pmapUserCondValue, &minAttrIdx), &itVals);
+            while (iValueSet.Next(&itVals)) {
+                addToBucket(pmapBuckets, (AVP){.attrIdx = minAttrIdx, .valIdx = itVals.value}, group[i].ruleIdx);
+            }
+        }
+    }
+    iHashMap.Finalize(pmapBuckets);
+    free(group);
+
+    int nRemoved = nRules - nKeptRules;
+    if (nRemoved > 0) {
+        // 与sliceIncremental相同，按编号升序重建规则集
+        qsort(keptRuleIdxes, nKeptRules, sizeof(int), compareInts);
+        iHashSet.Clear(pInst->pSetRuleIdxes);
+        for (i = 0; i < nKeptRules; i++) {
+            addRule(pInst, keptRuleIdxes[i]);
+        }
+    }
+    free(keptRuleIdxes);
+
+    double timeSpent = (double)(clock() - startRemoving) / CLOCKS_PER_SEC * 1000;
+    logACoAC(__func__, __LINE__, 0, INFO, "[end] removing subsumed rules, cost => %.2fms\n", timeSpent);
+    logACoAC(__func__, __LINE__, 0, INFO, "rules: %d==>%d, difference: %d\n", nRules, nKeptRules, nRemoved);
+    return nRemoved;
+}
+
 ACoACInstance *slice(ACoACInstance *pInst, ACoACResult *pResult) {
     logACoAC(__func__, __LINE__, 0, INFO, "[start] slicing instance\n");
     clock_t startSlicing = clock();
@@ -672,9 +819,441 @@ ACoACInstance *slice(ACoACInstance *pInst, ACoACResult *pResult) {
             break;
         }
     }
+    // 剪枝结束后删除被归并的规则，它们的目标属性值仍被更弱的规则覆盖，值域不变
+    removeSubsumedRules(pInst);
     int nNewRules = iHashSet.Size(pInst->pSetRuleIdxes);
     double timeSpent = (double)(clock() - startSlicing) / CLOCKS_PER_SEC * 1000;
     logACoAC(__func__, __LINE__, 0, INFO, "[end] slicing instance, cost => %.2fms\n", timeSpent);
     logACoAC(__func__, __LINE__, 0, INFO, "rules: %d==>%d, difference: %d\n", nOldRules, nNewRules, nOldRules - nNewRules);
     return pInst;
 }
+
+/*
+ * 增量剪枝的状态。实例被原地剪枝：属性的值域pMapAttr2Dom只包含被存活规则作为目标的属性值以及目标用户的
+ * 初始属性值，每个目标属性值被存活规则引用的次数记录在targetRefCnt中。
+ * 值域发生变化的属性被放入工作表，处理时只重新清理条件中包含该属性的规则，因此每次删除只影响与之相关的规则。
+ * 规则的哈希值依赖于被离散化的条件，条件变化后无法从pSetRuleIdxes中删除，因此存活的规则记录在ruleLive中，
+ * 剪枝结束后再重建pSetRuleIdxes
+ */
+typedef struct _SliceState {
+    ACoACInstance *pInst;
+    // 在剪枝开始时构建的索引，被删除的规则仍在索引中，使用时需检查规则是否存活
+    CSRIndex *pIndexTargetAV2Rule;
+    CSRIndex *pIndexPrecond2Rule;
+    DepGraph *pDepGraph;
+    // pIndexTargetAV2Rule的每个单元格中存活规则的数量，即该属性值被存活规则引用的次数
+    int *targetRefCnt;
+    // 以规则编号为下标：规则是否存活、规则在pIndexTargetAV2Rule中的单元格、各轮处理使用的标记
+    char *ruleLive;
+    int *ruleCell;
+    int *ruleMark;
+    int mark;
+    // 前向剪枝中规则最近一次成为候选规则时的层号
+    int *ruleLevel;
+    int level;
+    int nLiveRules;
+    // 以属性编号为下标：目标用户是否有该属性的初始值、初始值
+    char *hasInit;
+    int *initVal;
+    HashMap *pmapInitState;
+    // 值域发生变化、等待处理的属性
+    int *attrWorklist;
+    int nWorklist;
+    char *attrQueued;
+} SliceState;
+
+static void finalizeSliceState(SliceState *s) {
+    free(s->targetRefCnt);
+    free(s->ruleLive);
+    free(s->ruleCell);
+    free(s->ruleMark);
+    free(s->ruleLevel);
+    free(s->hasInit);
+    free(s->initVal);
+    free(s->attrWorklist);
+    free(s->attrQueued);
+}
+
+static void enqueueAttr(SliceState *s, int attrIdx) {
+    if (!s->attrQueued[attrIdx]) {
+        s->attrQueued[attrIdx] = 1;
+        s->attrWorklist[s->nWorklist++] = attrIdx;
+    }
+}
+
+/****************************************************************************************************
+ * 功能：属性值不再被任何存活规则或初始状态引用时，将其从属性值域中删除，并将属性放入工作表
+ ***************************************************************************************************/
+static void releaseAV(SliceState *s, int attrIdx, int valIdx) {
+    ValueSet **ppSetDom = (ValueSet **)iIntMap.Get(s->pInst->pMapAttr2Dom, attrIdx);
+    if (ppSetDom != NULL && iValueSet.Remove(*ppSetDom, valIdx)) {
+        enqueueAttr(s, attrIdx);
+    }
+}
+
+static void killRule(SliceState *s, int ruleIdx) {
+    Rule *pRule = (Rule *)iVector.GetElement(pVecRules, ruleIdx);
+    s->ruleLive[ruleIdx] = 0;
+    s->nLiveRules--;
+    if (--s->targetRefCnt[s->ruleCell[ruleIdx]] == 0 &&
+        !(s->hasInit[pRule->targetAttrIdx] && s->initVal[pRule->targetAttrIdx] == pRule->targetValueIdx)) {
+        releaseAV(s, pRule->targetAttrIdx, pRule->targetValueIdx);
+    }
+}
+
+static void removeInitValue(SliceState *s, int attrIdx) {
+    int valIdx = s->initVal[attrIdx];
+    s->hasInit[attrIdx] = 0;
+    iHashMap.Remove(s->pmapInitState, &attrIdx);
+    int cell = iCSRIndex.Find(s->pIndexTargetAV2Rule, attrIdx, valIdx);
+    if (cell < 0 || s->targetRefCnt[cell] == 0) {
+        releaseAV(s, attrIdx, valIdx);
+    }
+}
+
+/****************************************************************************************************
+ * 功能：处理一个值域发生变化的属性，与ruleCleaning对该属性的处理相同
+ *      1.根据值域检查查询中的该属性，值域大小为1时从查询中删除
+ *      2.根据值域重新清理条件中包含该属性的存活规则，条件无法满足时删除规则
+ *      3.值域大小为1时，删除以该属性为目标的规则以及该属性的初始值
+ * 参数：
+ *      @s[in]: 增量剪枝的状态
+ *      @attrIdx[in]: 属性编号
+ *      @result[out]: 处理过程中对策略安全性的验证结果
+ * 返回值：
+ *      1：继续剪枝，0：验证结果已确定
+ ***************************************************************************************************/
+static int propagateAttr(SliceState *s, int attrIdx, ACoACResult *result) {
+    ACoACInstance *pInst = s->pInst;
+    ValueSet **ppSetDom = (ValueSet **)iIntMap.Get(pInst->pMapAttr2Dom, attrIdx);
+    int domSize = ppSetDom == NULL ? 0 : iValueSet.Size(*ppSetDom);
+
+    int *pQueryValIdx = (int *)iIntMap.Get(pInst->pmapQueryAVs, attrIdx);
+    if (pQueryValIdx != NULL) {
+        if (domSize == 0 || !iValueSet.Contains(*ppSetDom, *pQueryValIdx)) {
+            char *queryAttr = istrCollection.GetElement(pscAttrs, attrIdx);
+            logACoAC(__func__, __LINE__, 0, INFO, "unreachable, because: the query value is not in the domain of the query attribute %s\n", queryAttr);
+            result->code = ACoAC_RESULT_UNREACHABLE;
+            return 0;
+        }
+        if (domSize == 1) {
+            iIntMap.Remove(pInst->pmapQueryAVs, attrIdx);
+            if (iIntMap.Size(pInst->pmapQueryAVs) == 0) {
+                logACoAC(__func__, __LINE__, 0, INFO, "reachable, because: the query is always satisfied\n");
+                result->code = ACoAC_RESULT_REACHABLE;
+                result->pVecActions = iVector.Create(sizeof(AdminstrativeAction), 0);
+                return 0;
+            }
+        }
+    }
+
+    // 一条规则可能出现在该属性的多个单元格中，用标记保证每条规则只被清理一次
+    CSRIndex *pIndex = s->pIndexPrecond2Rule;
+    int cell, i, ruleIdx, mark = ++s->mark;
+    if (attrIdx < pIndex->nRows) {
+        for (cell = pIndex->rowStart[attrIdx]; cell < pIndex->rowStart[attrIdx + 1]; cell++) {
+            for (i = pIndex->cellStart[cell]; i < pIndex->cellStart[cell + 1]; i++) {
+                ruleIdx = pIndex->elems[i];
+                if (!s->ruleLive[ruleIdx] || s->ruleMark[ruleIdx] == mark) {
+                    continue;
+                }
+                s->ruleMark[ruleIdx] = mark;
+                if (iRule.DiscreteCond(getMutableRule(ruleIdx), pInst->pMapAttr2Dom) == -1) {
+                    killRule(s, ruleIdx);
+                }
+            }
+        }
+    }
+
+    if (domSize == 1) {
+        // 属性永远不会变化，以其为目标的规则没有意义，其初始值也不再需要
+        pIndex = s->pIndexTargetAV2Rule;
+        if (attrIdx < pIndex->nRows) {
+            for (i = pIndex->cellStart[pIndex->rowStart[attrIdx]]; i < pIndex->cellStart[pIndex->rowStart[attrIdx + 1]]; i++) {
+                if (s->ruleLive[pIndex->elems[i]]) {
+                    killRule(s, pIndex->elems[i]);
+                }
+            }
+        }
+        if (s->hasInit[attrIdx]) {
+            removeInitValue(s, attrIdx);
+        }
+    }
+    return 1;
+}
+
+static int drainWorklist(SliceState *s, ACoACResult *result) {
+    int attrIdx;
+    while (s->nWorklist > 0) {
+        attrIdx = s->attrWorklist[--s->nWorklist];
+        s->attrQueued[attrIdx] = 0;
+        if (!propagateAttr(s, attrIdx, result)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/****************************************************************************************************
+ * 功能：删除从目标用户的初始状态出发无法触发的存活规则，与forwardSlice的结果相同。与forwardSlice一样逐层扩展
+ *      可达属性值，每层的候选规则可以并行检查
+ * 返回值：
+ *      被删除的规则数量
+ ***************************************************************************************************/
+static int forwardPrune(SliceState *s) {
+    int nAttrs = s->pIndexTargetAV2Rule->nRows;
+    IntMap *pmapReachableAVs = iIntMap.Create(sizeof(ValueSet *));
+    iIntMap.SetDestructValue(pmapReachableAVs, iValueSet.DestructPointer);
+    ValueSet *pSetVals, **ppSetVals;
+    int attrIdx;
+    for (attrIdx = 0; attrIdx < nAttrs; attrIdx++) {
+        if (s->hasInit[attrIdx]) {
+            pSetVals = iValueSet.Create();
+            iValueSet.Add(pSetVals, s->initVal[attrIdx]);
+            iIntMap.Put(pmapReachableAVs, attrIdx, &pSetVals);
+        }
+    }
+
+    // 第一层的候选规则为所有存活规则，之后每层的候选规则为以上一层新增的可达属性值为前置条件的未触发的存活规则
+    CSRIndex *pIndex = s->pIndexTargetAV2Rule;
+    int nRules = pIndex->cellStart[pIndex->nCells], mark = ++s->mark;
+    int *candidates = (int *)malloc((nRules + 1) * sizeof(int));
+    char *effective = (char *)malloc(nRules + 1);
+    AVP *frontier = (AVP *)malloc((pIndex->nCells + 1) * sizeof(AVP));
+    int nCandidates = 0, nFrontier, i, j, ruleIdx, *pRuleIdxes, nRuleIdxes;
+    Rule *pRule;
+    ThreadPool *pPool = NULL;
+    for (i = 0; i < nRules; i++) {
+        ruleIdx = pIndex->elems[i];
+        if (s->ruleLive[ruleIdx]) {
+            candidates[nCandidates++] = ruleIdx;
+        }
+    }
+    while (nCandidates > 0) {
+        checkEffective(candidates, nCandidates, effective, pmapReachableAVs, &pPool);
+        nFrontier = 0;
+        for (i = 0; i < nCandidates; i++) {
+            if (!effective[i]) {
+                continue;
+            }
+            ruleIdx = candidates[i];
+            s->ruleMark[ruleIdx] = mark;
+            pRule = (Rule *)iVector.GetElement(pVecRules, ruleIdx);
+            ppSetVals = (ValueSet **)iIntMap.Get(pmapReachableAVs, pRule->targetAttrIdx);
+            if (ppSetVals == NULL) {
+                pSetVals = iValueSet.Create();
+                ppSetVals = &pSetVals;
+                iIntMap.Put(pmapReachableAVs, pRule->targetAttrIdx, ppSetVals);
+            }
+            if (iValueSet.Add(*ppSetVals, pRule->targetValueIdx)) {
+                frontier[nFrontier++] = (AVP){.attrIdx = pRule->targetAttrIdx, .valIdx = pRule->targetValueIdx};
+            }
+        }
+        s->level++;
+        nCandidates = 0;
+        for (i = 0; i < nFrontier; i++) {
+            nRuleIdxes = iCSRIndex.Get(s->pIndexPrecond2Rule, frontier[i].attrIdx, frontier[i].valIdx, &pRuleIdxes);
+            for (j = 0; j < nRuleIdxes; j++) {
+                ruleIdx = pRuleIdxes[j];
+                if (s->ruleLive[ruleIdx] && s->ruleMark[ruleIdx] != mark && s->ruleLevel[ruleIdx] != s->level) {
+                    s->ruleLevel[ruleIdx] = s->level;
+                    candidates[nCandidates++] = ruleIdx;
+                }
+            }
+        }
+    }
+    iThreadPool.Finalize(pPool);
+    iIntMap.Finalize(pmapReachableAVs);
+    free(candidates);
+    free(effective);
+    free(frontier);
+
+    int nKilled = 0;
+    for (i = 0; i < nRules; i++) {
+        ruleIdx = pIndex->elems[i];
+        if (s->ruleLive[ruleIdx] && s->ruleMark[ruleIdx] != mark) {
+            killRule(s, ruleIdx);
+            nKilled++;
+        }
+    }
+    return nKilled;
+}
+
+/****************************************************************************************************
+ * 功能：删除与查询无关的存活规则，即从查询的属性值出发反向遍历时不会经过的规则，与backwardSlice的结果相同。
+ *      在依赖图上反向遍历，目标属性值未被访问的存活规则被删除。依赖图在剪枝开始时构建，而规则条件在剪枝中被
+ *      不断离散化，因此只经过存活规则的、其属性值仍在当前条件中的边
+ * 返回值：
+ *      被删除的规则数量
+ ***************************************************************************************************/
+static int backwardPrune(SliceState *s) {
+    DepGraph *pGraph = s->pDepGraph;
+    CSRIndex *pIndex = s->pIndexPrecond2Rule;
+    char *edgeLive = (char *)malloc(pIndex->cellStart[pIndex->nCells] + 1);
+    int attrIdx, cell, i, ruleIdx;
+    ValueSet **ppSetVals;
+    for (attrIdx = 0; attrIdx < pIndex->nRows; attrIdx++) {
+        for (cell = pIndex->rowStart[attrIdx]; cell < pIndex->rowStart[attrIdx + 1]; cell++) {
+            for (i = pIndex->cellStart[cell]; i < pIndex->cellStart[cell + 1]; i++) {
+                ruleIdx = pIndex->elems[i];
+                edgeLive[i] = 0;
+                if (s->ruleLive[ruleIdx]) {
+                    ppSetVals = (ValueSet **)iHashMap.Get(((Rule *)iVector.GetElement(pVecRules, ruleIdx))->pmapUserCondValue, &attrIdx);
+                    edgeLive[i] = ppSetVals != NULL && iValueSet.Contains(*ppSetVals, pIndex->cols[cell]);
+                }
+            }
+        }
+    }
+
+    int *seeds = (int *)malloc((iIntMap.Size(s->pInst->pmapQueryAVs) + 1) * sizeof(int));
+    int nSeeds = 0;
+    IntMapIterator itQueryAVs;
+    iIntMap.InitIterator(s->pInst->pmapQueryAVs, &itQueryAVs);
+    while (iIntMap.Next(&itQueryAVs)) {
+        seeds[nSeeds++] = iDepGraph.Find(pGraph, itQueryAVs.key, *(int *)itQueryAVs.value);
+    }
+    char *visited = (char *)calloc(pGraph->nNodes + 1, 1);
+    iDepGraph.Backward(pGraph, seeds, nSeeds, edgeLive, visited);
+    free(seeds);
+    free(edgeLive);
+
+    // 目标属性值的节点编号即其在pIndexTargetAV2Rule中的单元格编号
+    pIndex = s->pIndexTargetAV2Rule;
+    int nRules = pIndex->cellStart[pIndex->nCells], nKilled = 0;
+    for (i = 0; i < nRules; i++) {
+        ruleIdx = pIndex->elems[i];
+        if (s->ruleLive[ruleIdx] && !visited[s->ruleCell[ruleIdx]]) {
+            killRule(s, ruleIdx);
+            nKilled++;
+        }
+    }
+    free(visited);
+    return nKilled;
+}
+
+ACoACInstance *sliceIncremental(ACoACInstance *pInst, ACoACResult *pResult) {
+    logACoAC(__func__, __LINE__, 0, INFO, "[start] incremental slicing instance\n");
+    clock_t startSlicing = clock();
+    int nOldRules = iHashSet.Size(pInst->pSetRuleIdxes);
+
+    // 第一次规则清理根据原始值域离散化规则条件，并将值域缩小为初始属性值与规则目标属性值，记录原始值域以便找出变化的值域
+    int nRules = iVector.Size(pVecRules), nAttrs = istrCollection.Size(pscAttrs);
+    int attrIdx, cell, i, nKilled;
+    ValueSet **oldDoms = (ValueSet **)calloc(nAttrs + 1, sizeof(ValueSet *));
+    IntMapIterator itAttrDom;
+    iIntMap.InitIterator(pInst->pMapAttr2Dom, &itAttrDom);
+    while (iIntMap.Next(&itAttrDom)) {
+        oldDoms[itAttrDom.key] = iValueSet.Clone(*(ValueSet **)itAttrDom.value);
+    }
+    pResult->code = ACoAC_RESULT_UNKNOWN;
+    int rcMod, rcCnt = 1;
+    pInst = ruleCleaning(pInst, &rcCnt, &rcMod, pResult);
+    if (pResult->code != ACoAC_RESULT_UNKNOWN) {
+        for (attrIdx = 0; attrIdx < nAttrs; attrIdx++) {
+            iValueSet.Finalize(oldDoms[attrIdx]);
+        }
+        free(oldDoms);
+        return pInst;
+    }
+
+    SliceState s;
+    s.pInst = pInst;
+    s.pIndexTargetAV2Rule = getTargetAV2RuleIndex(pInst);
+    s.pIndexPrecond2Rule = getPrecond2RuleIndex(pInst);
+    s.pDepGraph = getDependencyGraph(pInst);
+    int nIndexedRules = s.pIndexTargetAV2Rule->cellStart[s.pIndexTargetAV2Rule->nCells];
+    s.targetRefCnt = (int *)malloc((s.pIndexTargetAV2Rule->nCells + 1) * sizeof(int));
+    s.ruleLive = (char *)calloc(nRules + 1, 1);
+    s.ruleCell = (int *)malloc((nRules + 1) * sizeof(int));
+    s.ruleMark = (int *)calloc(nRules + 1, sizeof(int));
+    s.mark = 0;
+    s.ruleLevel = (int *)calloc(nRules + 1, sizeof(int));
+    s.level = 0;
+    s.nLiveRules = iHashSet.Size(pInst->pSetRuleIdxes);
+    s.hasInit = (char *)calloc(nAttrs + 1, 1);
+    s.initVal = (int *)malloc((nAttrs + 1) * sizeof(int));
+    s.pmapInitState = iHashBasedTable.GetRow(pInst->pTableInitState, &pInst->queryUserIdx);
+    s.attrWorklist = (int *)malloc((nAttrs + 1) * sizeof(int));
+    s.nWorklist = 0;
+    s.attrQueued = (char *)calloc(nAttrs + 1, 1);
+
+    for (cell = 0; cell < s.pIndexTargetAV2Rule->nCells; cell++) {
+        s.targetRefCnt[cell] = iCSRIndex.CellSize(s.pIndexTargetAV2Rule, cell);
+        for (i = s.pIndexTargetAV2Rule->cellStart[cell]; i < s.pIndexTargetAV2Rule->cellStart[cell + 1]; i++) {
+            s.ruleLive[s.pIndexTargetAV2Rule->elems[i]] = 1;
+            s.ruleCell[s.pIndexTargetAV2Rule->elems[i]] = cell;
+        }
+    }
+    if (s.pmapInitState != NULL) {
+        HashNodeIterator itInitState;
+        HashNode *node;
+        iHashMap.InitIterator(s.pmapInitState, &itInitState);
+        while (itInitState.HasNext(&itInitState)) {
+            node = itInitState.GetNext(&itInitState);
+            s.hasInit[*(int *)node->key] = 1;
+            s.initVal[*(int *)node->key] = *(int *)node->value;
+        }
+    }
+    // 规则清理已经根据原始值域处理了所有属性，只有值域被缩小的属性需要再处理一次
+    ValueSet **ppSetDom;
+    for (attrIdx = nAttrs - 1; attrIdx >= 0; attrIdx--) {
+        ppSetDom = (ValueSet **)iIntMap.Get(pInst->pMapAttr2Dom, attrIdx);
+        if (oldDoms[attrIdx] == NULL ? ppSetDom != NULL : ppSetDom == NULL || !iValueSet.Equal(*ppSetDom, oldDoms[attrIdx])) {
+            enqueueAttr(&s, attrIdx);
+        }
+        iValueSet.Finalize(oldDoms[attrIdx]);
+    }
+    free(oldDoms);
+
+    // 工作表为空时，分别做一次前向与后向剪枝，直到没有规则被删除
+    int round = 0;
+    while (drainWorklist(&s, pResult)) {
+        nKilled = forwardPrune(&s);
+        if (!drainWorklist(&s, pResult)) {
+            break;
+        }
+        nKilled += backwardPrune(&s);
+        logACoAC(__func__, __LINE__, 0, INFO, "round %d, live rules: %d\n", ++round, s.nLiveRules);
+        if (nKilled == 0 && s.nWorklist == 0) {
+            break;
+        }
+    }
+
+    if (pResult->code != ACoAC_RESULT_UNKNOWN) {
+        finalizeSliceState(&s);
+        ACoACInstance *pNewInst = createACoACInstance();
+        pNewInst->queryUserIdx = pInst->queryUserIdx;
+        discardInstance(pInst, pNewInst);
+        return pNewInst;
+    }
+
+    // 删除已经为空的值域
+    iIntMap.InitIterator(pInst->pMapAttr2Dom, &itAttrDom);
+    while (iIntMap.Next(&itAttrDom)) {
+        if (iValueSet.Size(*(ValueSet **)itAttrDom.value) == 0) {
+            iIntMap.RemoveCurrent(&itAttrDom);
+        }
+    }
+
+    // 与ruleCleaning相同，按编号升序加入存活的规则，重复规则中保留编号最小的一条
+    int *ruleIdxes = (int *)malloc((s.nLiveRules + 1) * sizeof(int)), nLiveRules = 0;
+    for (i = 0; i < nIndexedRules; i++) {
+        if (s.ruleLive[s.pIndexTargetAV2Rule->elems[i]]) {
+            ruleIdxes[nLiveRules++] = s.pIndexTargetAV2Rule->elems[i];
+        }
+    }
+    qsort(ruleIdxes, nLiveRules, sizeof(int), compareInts);
+    iHashSet.Clear(pInst->pSetRuleIdxes);
+    for (i = 0; i < nLiveRules; i++) {
+        addRule(pInst, ruleIdxes[i]);
+    }
+    free(ruleIdxes);
+    finalizeSliceState(&s);
+    removeSubsumedRules(pInst);
+
+    int nNewRules = iHashSet.Size(pInst->pSetRuleIdxes);
+    double timeSpent = (double)(clock() - startSlicing) / CLOCKS_PER_SEC * 1000;
+    logACoAC(__func__, __LINE__, 0, INFO, "[end] incremental slicing instance, cost => %.2fms\n", timeSpent);
+    logACoAC(__func__, __LINE__, 0, INFO, "rules: %d==>%d, difference: %d\n", nOldRules, nNewRules, nOldRules - nNewRules);
+    return pInst;
+}
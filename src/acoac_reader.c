@@ -110,8 +110,8 @@ static int handleAttributes(char *line) {
                 iDictionary.Insert(pdictAttr2Index, line + start, &attrNum);
                 istrCollection.Add(pscAttrs, line + start);
                 // iVector.Add(pInst->pVecAttrIdxes, &attrNum);
-                iHashMap.Put(pmapAttr2Type, &attrNum, &attrType);
-                iHashMap.Put(pmapAttr2DefVal, &attrNum, &defValIdx);
+                iIntMap.Put(pmapAttr2Type, attrNum, &attrType);
+                iIntMap.Put(pmapAttr2DefVal, attrNum, &defValIdx);
                 attrNum++;
             }
             start = cur + 1;
@@ -152,7 +152,7 @@ static int handleDefaultValues(char *line) {
         logACoAC(__func__, __LINE__, 0, ERROR, "Failed to add default value: %s, %s\n", attr, value);
         exit(ret);
     }
-    iHashMap.Put(pmapAttr2DefVal, &attrIdx, &valueIdx);
+    iIntMap.Put(pmapAttr2DefVal, attrIdx, &valueIdx);
     return 0;
 }
 
@@ -370,12 +370,9 @@ static int handleRule(ACoACInstance *pInst, char *line) {
         logACoAC(__func__, __LINE__, 0, ERROR, "Failed to handle rule: (%s, %s, %s, %s)\n", adminCondStr, userCondStr, attr, value);
         exit(ret);
     }
-    HashSet *adminCond = handleCondition(adminCondStr);
-    HashSet *userCond = handleCondition(userCondStr);
-    Rule *r = iRule.Create(adminCond, userCond, attrIdx, valueIdx);
-    iVector.Add(pVecRules, r);
-    free(r);
-    int ruleIdx = iVector.Size(pVecRules) - 1;
+    int adminCondIdx = getConditionIndex(handleCondition(adminCondStr));
+    int userCondIdx = getConditionIndex(handleCondition(userCondStr));
+    int ruleIdx = getRuleIndex(adminCondIdx, userCondIdx, attrIdx, valueIdx);
     addRule(pInst, ruleIdx);
     return 0;
 }
@@ -420,7 +417,7 @@ static int handleSpec(ACoACInstance *pInst, char *line) {
                     logACoAC(__func__, __LINE__, 0, ERROR, "Failed to handle query av: %s, %s\n", attr, value);
                     exit(ret);
                 }
-                iHashMap.Put(pInst->pmapQueryAVs, &attrIdx, &valueIdx);
+                iIntMap.Put(pInst->pmapQueryAVs, attrIdx, &valueIdx);
                 logACoAC(__func__, __LINE__, 0, INFO, "add query attribute: %s, value: %s\n", attr, value);
                 free(value);
             }
@@ -1,5 +1,7 @@
+#include <limits.h>
 #include <string.h>
 
+#include "acoac_inst.h"
 #include "acoac_rule.h"
 #include "acoac_utils.h"
 #include "hashset.h"
@@ -33,32 +35,60 @@ static int Evaluate(AtomCondition *atomCond, int valIdx) {
 }
 
 /**
- * 在值域domain中寻找所有满足该条件的值effectiveValues
- * @param domain 查找范围
- * @return domain中满足该条件的值构成的集合
+ * Lower an atomic condition to an interval test. The bounds of the strict orderings are moved inwards by one,
+ * and a strict ordering with nothing beyond the bound, e.g., "< INT_MIN", becomes the empty interval.
  */
-static void FindEffectiveValues(AtomCondition *atomdCond, HashSet *domain, HashSet *effectiveValues) {
-    HashSetIterator *it = iHashSet.NewIterator(domain);
-    int valIdx;
-    while (it->HasNext(it)) {
-        valIdx = *(int *)it->GetNext(it);
-        if (Evaluate(atomdCond, valIdx)) {
-            iHashSet.Add(effectiveValues, &valIdx);
+static void Compile(AtomCondition *atomCond, IntervalTest *test) {
+    int c = atomCond->value;
+    test->attribute = atomCond->attribute;
+    test->lo = INT_MIN;
+    test->hi = INT_MAX;
+    test->negated = 0;
+    switch (atomCond->op) {
+    case EQUAL:
+        test->lo = test->hi = c;
+        break;
+    case NOT_EQUAL:
+        test->lo = test->hi = c;
+        test->negated = 1;
+        break;
+    case LESS_THAN:
+        if (c == INT_MIN) {
+            test->lo = INT_MAX;
+            test->hi = INT_MIN;
+        } else {
+            test->hi = c - 1;
         }
+        break;
+    case GREATER_THAN:
+        if (c == INT_MAX) {
+            test->lo = INT_MAX;
+            test->hi = INT_MIN;
+        } else {
+            test->lo = c + 1;
+        }
+        break;
+    case LESS_THAN_OR_EQUAL:
+        test->hi = c;
+        break;
+    case GREATER_THAN_OR_EQUAL:
+        test->lo = c;
+        break;
+    default:
+        logACoAC(__func__, __LINE__, 0, ERROR, "Invalid comparison operator\n");
+        exit(-1);
     }
-    iHashSet.DeleteIterator(it);
 }
 
-static void RetainEffectiveValues(AtomCondition *atomdCond, HashSet *effectiveValues) {
-    HashSetIterator *it = iHashSet.NewIterator(effectiveValues);
-    int valIdx;
-    while (it->HasNext(it)) {
-        valIdx = *(int *)it->GetNext(it);
-        if (!Evaluate(atomdCond, valIdx)) {
-            it->Remove(it);
-        }
-    }
-    iHashSet.DeleteIterator(it);
+/**
+ * 在值域domain中寻找所有满足该条件的值effectiveValues
+ * @param domain 查找范围
+ * @return domain中满足该条件的值构成的集合
+ */
+static void FindEffectiveValues(AtomCondition *atomdCond, ValueSet *domain, ValueSet *effectiveValues) {
+    IntervalTest test;
+    Compile(atomdCond, &test);
+    iValueSet.AddAllInRange(effectiveValues, domain, test.lo, test.hi, test.negated);
 }
 
 static unsigned int AtomCondHashCode(void *obj) {
@@ -93,20 +123,20 @@ static unsigned int RuleHashCode(void *pRule) {
     int hash = 1;
     Rule *r = (Rule *)pRule;
 
-    hash = 31 * hash + iHashSet.HashCode(&r->adminCond);
+    hash = 31 * hash + getConditionHashCode(r->adminCondIdx);
 
     if (r->pmapUserCondValue == NULL) {
-        hash = 31 * hash + iHashSet.HashCode(&r->userCond);
+        hash = 31 * hash + getConditionHashCode(r->userCondIdx);
     } else {
         int hash2 = 1;
-        HashNodeIterator *it = iHashMap.NewIterator(r->pmapUserCondValue);
+        HashNodeIterator it;
+        iHashMap.InitIterator(r->pmapUserCondValue, &it);
         HashNode *node;
-        while (it->HasNext(it)) {
-            node = (HashNode *)it->GetNext(it);
+        while (it.HasNext(&it)) {
+            node = (HashNode *)it.GetNext(&it);
             hash2 = 31 * hash2 + IntHashCode(node->key);
-            hash2 = 31 * hash2 + iHashSet.HashCode(node->value);
+            hash2 = 31 * hash2 + iValueSet.HashCode(*(ValueSet **)node->value);
         }
-        iHashMap.DeleteIterator(it);
         hash = 31 * hash + hash2;
     }
 
@@ -128,38 +158,39 @@ static int RuleEqual(void *pRule1, void *pRule2) {
     if (r1->targetValueIdx != r2->targetValueIdx) {
         return 0;
     }
-    if (iHashSet.Equal(&r1->adminCond, &r2->adminCond) == 0) {
+    // Identical conditions share the same index
+    if (r1->adminCondIdx != r2->adminCondIdx) {
         return 0;
     }
     if (r1->pmapUserCondValue == NULL || r2->pmapUserCondValue == NULL) {
-        return iHashSet.Equal(&r1->userCond, &r2->userCond);
+        return r1->userCondIdx == r2->userCondIdx;
     } else {
         int ret = 1;
-        HashNodeIterator *it = iHashMap.NewIterator(r1->pmapUserCondValue);
+        HashNodeIterator it;
+        iHashMap.InitIterator(r1->pmapUserCondValue, &it);
         HashNode *node;
-        HashSet **psetCondValues1, **psetCondValues2;
-        while (it->HasNext(it)) {
-            node = (HashNode *)it->GetNext(it);
-            psetCondValues1 = (HashSet **)node->value;
+        ValueSet **psetCondValues1, **psetCondValues2;
+        while (it.HasNext(&it)) {
+            node = (HashNode *)it.GetNext(&it);
+            psetCondValues1 = (ValueSet **)node->value;
             psetCondValues2 = iHashMap.Get(r2->pmapUserCondValue, node->key);
-            if (psetCondValues2 == NULL || iHashSet.Equal(psetCondValues1, psetCondValues2) == 0) {
+            if (psetCondValues2 == NULL || iValueSet.Equal(*psetCondValues1, *psetCondValues2) == 0) {
                 ret = 0;
                 break;
             }
         }
-        iHashMap.DeleteIterator(it);
         return ret;
     }
 }
 
-static Rule *Create(HashSet *adminCond, HashSet *userCond, int targetAttrIdx, int targetValueIdx) {
+static Rule *Create(int adminCondIdx, int userCondIdx, int targetAttrIdx, int targetValueIdx) {
     Rule *r = (Rule *)malloc(sizeof(Rule));
     if (r == NULL) {
         logACoAC(__func__, __LINE__, 0, ERROR, "Failed to allocate memory for rule\n");
         return NULL;
     }
-    r->adminCond = adminCond;
-    r->userCond = userCond;
+    r->adminCondIdx = adminCondIdx;
+    r->userCondIdx = userCondIdx;
     r->targetAttrIdx = targetAttrIdx;
     r->targetValueIdx = targetValueIdx;
     r->pmapUserCondValue = NULL;
@@ -177,145 +208,133 @@ static Rule *Create(HashSet *adminCond, HashSet *userCond, int targetAttrIdx, in
  *       0：条件未更新
  *       -1：规则不可被满足
  ***************************************************************************************************/
-static int DiscreteCond(Rule *r, HashMap *reachableAVs) {
+static int DiscreteCond(Rule *r, IntMap *reachableAVs) {
     int ret = 0;
     int *pAttrIdx;
-    HashSet *effectiveVals, **pEffectiveVals, *reachableValues, **pReachableVals;
+    ValueSet *effectiveVals, **pEffectiveVals, *reachableValues, **pReachableVals;
     HashNode *node;
     HashMap *pmapUserCondValue = r->pmapUserCondValue;
     if (pmapUserCondValue == NULL) {
-        pmapUserCondValue = iHashMap.Create(sizeof(int), sizeof(HashSet *), IntHashCode, IntEqual);
-        iHashMap.SetDestructValue(pmapUserCondValue, iHashSet.DestructPointer);
+        pmapUserCondValue = iHashMap.Create(sizeof(int), sizeof(ValueSet *), IntHashCode, IntEqual);
+        iHashMap.SetDestructValue(pmapUserCondValue, iValueSet.DestructPointer);
         
         r->pmapUserCondValue = pmapUserCondValue;
-        HashSetIterator *it = iHashSet.NewIterator(r->userCond);
-        AtomCondition *atomCond;
-        int attrIdx;
-        while (it->HasNext(it)) {
-            atomCond = it->GetNext(it); //*(atomCondition **)it->GetNext(it);
-            attrIdx = atomCond->attribute;
-
-            pEffectiveVals = iHashMap.Get(pmapUserCondValue, &attrIdx);
+        // The values of an attribute satisfying the condition are its domain masked by the intervals of its atomic conditions
+        int nTests, i;
+        IntervalTest *tests = getConditionTests(r->userCondIdx, &nTests), *test;
+        for (i = 0; i < nTests; i++) {
+            test = &tests[i];
+            pEffectiveVals = iHashMap.Get(pmapUserCondValue, &test->attribute);
             if (pEffectiveVals == NULL) {
-                effectiveVals = iHashSet.Create(sizeof(int), IntHashCode, IntEqual);
-                pReachableVals = iHashMap.Get(reachableAVs, &attrIdx);
+                effectiveVals = iValueSet.Create();
+                pReachableVals = iIntMap.Get(reachableAVs, test->attribute);
                 if (pReachableVals != NULL) {
-                    FindEffectiveValues(atomCond, *pReachableVals, effectiveVals);
+                    iValueSet.AddAllInRange(effectiveVals, *pReachableVals, test->lo, test->hi, test->negated);
                 }
-                iHashMap.Put(pmapUserCondValue, &attrIdx, &effectiveVals);
+                iHashMap.Put(pmapUserCondValue, &test->attribute, &effectiveVals);
             } else {
-                RetainEffectiveValues(atomCond, *pEffectiveVals);
+                iValueSet.RetainRange(*pEffectiveVals, test->lo, test->hi, test->negated);
             }
         }
-        iHashSet.DeleteIterator(it);
         ret = 1;
     } else {
         int before;
-        HashNodeIterator *it = iHashMap.NewIterator(pmapUserCondValue);
-        while (it->HasNext(it)) {
-            node = it->GetNext(it);
+        HashNodeIterator it;
+        iHashMap.InitIterator(pmapUserCondValue, &it);
+        while (it.HasNext(&it)) {
+            node = it.GetNext(&it);
             pAttrIdx = (int *)node->key;
-            reachableValues = *(HashSet **)node->value;
-            before = iHashSet.Size(reachableValues);
-            pReachableVals = iHashMap.Get(reachableAVs, pAttrIdx);
+            reachableValues = *(ValueSet **)node->value;
+            before = iValueSet.Size(reachableValues);
+            pReachableVals = iIntMap.Get(reachableAVs, *pAttrIdx);
             if (pReachableVals == NULL) {
-                iHashSet.Clear(reachableValues);
+                iValueSet.Clear(reachableValues);
             } else {
-                iHashSet.RetainAll(reachableValues, *pReachableVals);
+                iValueSet.RetainAll(reachableValues, *pReachableVals);
             }
-            ret = (iHashSet.Size(reachableValues) != before);
+            ret = (iValueSet.Size(reachableValues) != before);
         }
-        iHashMap.DeleteIterator(it);
     }
 
-    HashSet **pSet, **pTargetAttrDom = iHashMap.Get(pmapUserCondValue, &r->targetAttrIdx);
+    ValueSet **pSet, **pTargetAttrDom = iHashMap.Get(pmapUserCondValue, &r->targetAttrIdx);
     if (pTargetAttrDom != NULL) {
-        iHashSet.Add(*pTargetAttrDom, &r->targetValueIdx);
-        pSet = iHashMap.Get(reachableAVs, &r->targetAttrIdx);
-        if (pSet != NULL && iHashSet.Equal(pTargetAttrDom, pSet)) {
+        iValueSet.Add(*pTargetAttrDom, r->targetValueIdx);
+        pSet = iIntMap.Get(reachableAVs, r->targetAttrIdx);
+        if (pSet != NULL && iValueSet.Equal(*pTargetAttrDom, *pSet)) {
             iHashMap.Remove(pmapUserCondValue, &r->targetAttrIdx);
         } else {
-            iHashSet.Remove(*pTargetAttrDom, &r->targetValueIdx);
+            iValueSet.Remove(*pTargetAttrDom, r->targetValueIdx);
         }
     }
 
-    HashNodeIterator *it = iHashMap.NewIterator(pmapUserCondValue);
-    while (it->HasNext(it)) {
-        node = it->GetNext(it);
+    HashNodeIterator it;
+    iHashMap.InitIterator(pmapUserCondValue, &it);
+    while (it.HasNext(&it)) {
+        node = it.GetNext(&it);
         pAttrIdx = (int *)node->key;
-        reachableValues = *(HashSet **)node->value;
-        if (iHashSet.Size(reachableValues) == 0) {
+        reachableValues = *(ValueSet **)node->value;
+        if (iValueSet.Size(reachableValues) == 0) {
             ret = -1;
             break;
         }
-        pSet = iHashMap.Get(reachableAVs, pAttrIdx);
-        if (pSet != NULL && iHashSet.Equal(&reachableValues, pSet)) {
-            it->Remove(it);
+        pSet = iIntMap.Get(reachableAVs, *pAttrIdx);
+        if (pSet != NULL && iValueSet.Equal(reachableValues, *pSet)) {
+            it.Remove(&it);
             // free(node->key);
-            // iHashSet.Finalize(reachableValues);
+            // iValueSet.Finalize(reachableValues);
             // free(node->value);
             // free(node);
             // iHashMap.Remove(pmapUserCondValue, pAttrIdx);
         }
     }
-    iHashMap.DeleteIterator(it);
     return ret;
 }
 
 static int CanBeManaged(Rule *r, HashMap *userState) {
     int ret = 1;
-    HashNodeIterator *it = iHashMap.NewIterator(r->pmapUserCondValue);
+    HashNodeIterator it;
+    iHashMap.InitIterator(r->pmapUserCondValue, &it);
     int *pAttrIdx, *pUserAttrVal;
     HashNode *node;
-    HashSet *condValues;
-    while (it->HasNext(it)) {
-        node = it->GetNext(it);
+    ValueSet *condValues;
+    while (it.HasNext(&it)) {
+        node = it.GetNext(&it);
         pAttrIdx = (int *)node->key;
-        condValues = *(HashSet **)node->value;
+        condValues = *(ValueSet **)node->value;
         pUserAttrVal = iHashMap.Get(userState, pAttrIdx);
-        if (pUserAttrVal == NULL || !iHashSet.Contains(condValues, pUserAttrVal)) {
+        if (pUserAttrVal == NULL || !iValueSet.Contains(condValues, *pUserAttrVal)) {
             ret = 0;
             break;
         }
     }
-    iHashMap.DeleteIterator(it);
     return ret;
 }
 
-static int IsEffective(Rule *r, HashMap *reachableAVs) {
+static int IsEffective(Rule *r, IntMap *reachableAVs) {
     int ret = 1;
-    HashNodeIterator *it = iHashMap.NewIterator(r->pmapUserCondValue);
-    int flag, *pAttrIdx, *pVal;
+    HashNodeIterator it;
+    iHashMap.InitIterator(r->pmapUserCondValue, &it);
+    int *pAttrIdx;
     HashNode *node;
-    HashSet *condValues, **pReachableValues;
-    HashSetIterator *itCondValues;
-    while (it->HasNext(it)) {
-        node = it->GetNext(it);
+    ValueSet *condValues, **pReachableValues;
+    while (it.HasNext(&it)) {
+        node = it.GetNext(&it);
         pAttrIdx = (int *)node->key;
-        condValues = *(HashSet **)node->value;
-        flag = 0;
-        itCondValues = iHashSet.NewIterator(condValues);
-        while (itCondValues->HasNext(itCondValues)) {
-            pVal = (int *)itCondValues->GetNext(itCondValues);
-            pReachableValues = iHashMap.Get(reachableAVs, pAttrIdx);
-            if (pReachableValues != NULL && iHashSet.Contains(*pReachableValues, pVal)) {
-                flag = 1;
-                break;
-            }
-        }
-        iHashSet.DeleteIterator(itCondValues);
-        if (!flag) {
+        condValues = *(ValueSet **)node->value;
+        pReachableValues = iIntMap.Get(reachableAVs, *pAttrIdx);
+        // The rule is effective only if, for each attribute, some value satisfying the condition is reachable
+        if (pReachableValues == NULL || !iValueSet.Intersects(condValues, *pReachableValues)) {
             ret = 0;
             break;
         }
     }
-    iHashMap.DeleteIterator(it);
     return ret;
 }
 
 AtomConditionInterface iAtomCondition = {
     .Evaluate = Evaluate,
     .FindEffectiveValues = FindEffectiveValues,
+    .Compile = Compile,
     .HashCode = AtomCondHashCode,
     .Equal = AtomCondEqual,
 };
@@ -1,48 +1,71 @@
 #include "acoac_translator.h"
+#include "acoac_domcomp.h"
 #include "acoac_utils.h"
 #include <assert.h>
 #include <time.h>
 
+// An integer attribute is declared as a range if its domain fills at least 1 / INT_RANGE_MAX_SPARSITY of the range
+#define INT_RANGE_MAX_SPARSITY 2
+
 static void computeAttrDom(ACoACInstance *pInst) {
-    HashSetIterator *itSet1 = iHashSet.NewIterator(pInst->pSetRuleIdxes), *itSet2;
+    HashSetIterator itSet1;
+    iHashSet.InitIterator(pInst->pSetRuleIdxes, &itSet1);
     int ruleIdx, *pAttrIdx;
     Rule *pRule;
-    HashNodeIterator *itMap;
+    HashNodeIterator itMap;
     HashNode *node;
-    HashSet **ppSetValIdxes;
-    while (itSet1->HasNext(itSet1)) {
-        ruleIdx = *(int *)itSet1->GetNext(itSet1);
+    ValueSet **ppSetValIdxes;
+    while (itSet1.HasNext(&itSet1)) {
+        ruleIdx = *(int *)itSet1.GetNext(&itSet1);
         pRule = iVector.GetElement(pVecRules, ruleIdx);
-        itMap = iHashMap.NewIterator(pRule->pmapUserCondValue);
-        while (itMap->HasNext(itMap)) {
-            node = itMap->GetNext(itMap);
+        iHashMap.InitIterator(pRule->pmapUserCondValue, &itMap);
+        while (itMap.HasNext(&itMap)) {
+            node = itMap.GetNext(&itMap);
             pAttrIdx = (int *)node->key;
-            ppSetValIdxes = iHashMap.Get(pInst->pMapAttr2Dom, pAttrIdx);
+            ppSetValIdxes = iIntMap.Get(pInst->pMapAttr2Dom, *pAttrIdx);
             assert(ppSetValIdxes != NULL);
-            itSet2 = iHashSet.NewIterator(*(HashSet **)node->value);
-            while (itSet2->HasNext(itSet2)) {
-                iHashSet.Add(*ppSetValIdxes, itSet2->GetNext(itSet2));
-            }
-            iHashSet.DeleteIterator(itSet2);
+            iValueSet.AddAll(*ppSetValIdxes, *(ValueSet **)node->value);
         }
-        iHashMap.DeleteIterator(itMap);
     }
-    iHashMap.DeleteIterator(itSet1);
 
-    itMap = iHashMap.NewIterator(pInst->pmapQueryAVs);
-    while (itMap->HasNext(itMap)) {
-        node = itMap->GetNext(itMap);
-        pAttrIdx = (int *)node->key;
-        ppSetValIdxes = iHashMap.Get(pInst->pMapAttr2Dom, pAttrIdx);
+    IntMapIterator itQueryAVs;
+    iIntMap.InitIterator(pInst->pmapQueryAVs, &itQueryAVs);
+    while (iIntMap.Next(&itQueryAVs)) {
+        ppSetValIdxes = iIntMap.Get(pInst->pMapAttr2Dom, itQueryAVs.key);
         assert(ppSetValIdxes != NULL);
         // if (ppSetValIdxes == NULL) {
-        //     pSetValIdxes = iHashSet.Create(sizeof(int), IntHashCode, IntEqual);
+        //     pSetValIdxes = iValueSet.Create();
         //     ppSetValIdxes = &pSetValIdxes;
         //     iHashMap.Put(pInst->pmapAttr2Dom, pAttrIdx, ppSetValIdxes);
         // }
-        iHashSet.Add(*ppSetValIdxes, node->value);
+        iValueSet.Add(*ppSetValIdxes, *(int *)itQueryAVs.value);
+    }
+}
+
+/**
+ * 判断整数属性的值域是否以区间lo..hi的形式声明
+ * 值域的值至少占区间的1/INT_RANGE_MAX_SPARSITY时以区间声明，区间中不属于值域的值是不可达的，因为属性只会取其初始值或规则的目标值
+ * @param pSetDom[in]: 属性的值域
+ * @param lo[out]: 值域的最小值，值域少于2个值时为0
+ * @param hi[out]: 值域的最大值，值域少于2个值时为0
+ * @return 1：以区间声明，0：逐个列出值域中的值
+ */
+static int getIntRange(ValueSet *pSetDom, int *lo, int *hi) {
+    int runLo, runHi, first = 1;
+    ValueSetIterator it;
+    *lo = *hi = 0;
+    if (iValueSet.Size(pSetDom) < 2) {
+        return 0;
+    }
+    iValueSet.InitIterator(pSetDom, &it);
+    while (iValueSet.NextRange(&it, &runLo, &runHi)) {
+        if (first) {
+            *lo = runLo;
+            first = 0;
+        }
+        *hi = runHi;
     }
-    iHashMap.DeleteIterator(itMap);
+    return (long)*hi - *lo + 1 <= (long)INT_RANGE_MAX_SPARSITY * iValueSet.Size(pSetDom);
 }
 
 /**
@@ -56,21 +79,35 @@ static void translateVars(ACoACInstance *pInst, FILE *fp) {
     // 定义变量
     HashSet *pSetVals = iHashSet.Create(sizeof(char *), StringHashCode, StringEqual);
 
-    HashNodeIterator *itMap = iHashMap.NewIterator(pInst->pMapAttr2Dom);
-    int *pAttrIdx;
+    IntMapIterator itMap;
     char *attr, *val;
     AttrType attrType;
-    HashNode *node;
-    HashSetIterator *itSet;
-    int first;
-    while (itMap->HasNext(itMap)) {
-        node = itMap->GetNext(itMap);
-        pAttrIdx = (int *)node->key;
-        attr = istrCollection.GetElement(pscAttrs, *pAttrIdx);
-        attrType = *(AttrType *)iHashMap.Get(pmapAttr2Type, pAttrIdx);
+    HashSetIterator itSet;
+    ValueSetIterator itDom;
+    int first, lo, hi, c;
+    CSRIndex *pIndexTargetAV2Rule = getTargetAV2RuleIndex(pInst);
+    iIntMap.InitIterator(pInst->pMapAttr2Dom, &itMap);
+    while (iIntMap.Next(&itMap)) {
+        attr = istrCollection.GetElement(pscAttrs, itMap.key);
+        attrType = *(AttrType *)iIntMap.Get(pmapAttr2Type, itMap.key);
+
+        if (attrType == INTEGER && getIntRange(*(ValueSet **)itMap.value, &lo, &hi)) {
+            fprintf(fp, "%s : %d..%d;\n", attr, lo, hi);
+            // val只需包含规则可以赋予该属性的值，而不是整个区间
+            if (itMap.key < pIndexTargetAV2Rule->nRows) {
+                for (c = pIndexTargetAV2Rule->rowStart[itMap.key]; c < pIndexTargetAV2Rule->rowStart[itMap.key + 1]; c++) {
+                    val = getValueByIndex(attrType, getRepresentative(pInst, itMap.key, pIndexTargetAV2Rule->cols[c]));
+                    if (!iHashSet.Add(pSetVals, &val)) {
+                        free(val);
+                    }
+                }
+            }
+            continue;
+        }
+
         fprintf(fp, "%s : {", attr);
 
-        if (attrType == BOOLEAN && iHashSet.Size(*(HashSet **)node->value) == 2) {
+        if (attrType == BOOLEAN && iValueSet.Size(*(ValueSet **)itMap.value) == 2) {
             fprintf(fp, "true,false};\n");
             val = "true";
             iHashSet.Add(pSetVals, &val);
@@ -80,38 +117,33 @@ static void translateVars(ACoACInstance *pInst, FILE *fp) {
         }
 
         first = 1;
-        itSet = iHashSet.NewIterator(*(HashSet **)node->value);
-        while (itSet->HasNext(itSet)) {
-            val = getValueByIndex(attrType, *(int *)itSet->GetNext(itSet));
+        iValueSet.InitIterator(*(ValueSet **)itMap.value, &itDom);
+        while (iValueSet.Next(&itDom)) {
+            val = getValueByIndex(attrType, itDom.value);
             fprintf(fp, "%s%s", first ? "" : ",", val);
             first = 0;
             iHashSet.Add(pSetVals, &val);
         }
-        iHashSet.DeleteIterator(itSet);
         fprintf(fp, "};\n");
     }
-    iHashMap.DeleteIterator(itMap);
 
     fprintf(fp, "attr : {");
-    itMap = iHashMap.NewIterator(pInst->pMapAttr2Dom);
+    iIntMap.InitIterator(pInst->pMapAttr2Dom, &itMap);
     first = 1;
-    while (itMap->HasNext(itMap)) {
-        node = itMap->GetNext(itMap);
-        attr = istrCollection.GetElement(pscAttrs, *(int *)node->key);
+    while (iIntMap.Next(&itMap)) {
+        attr = istrCollection.GetElement(pscAttrs, itMap.key);
         fprintf(fp, "%s%s%s", first ? "" : ",", attr, ALIAS_SUFFIX);
         first = 0;
     }
-    iHashMap.DeleteIterator(itMap);
     fprintf(fp, "};\n");
 
     fprintf(fp, "val : {");
-    itSet = iHashSet.NewIterator(pSetVals);
+    iHashSet.InitIterator(pSetVals, &itSet);
     first = 1;
-    while (itSet->HasNext(itSet)) {
-        fprintf(fp, "%s%s", first ? "" : ",", *(char **)itSet->GetNext(itSet));
+    while (itSet.HasNext(&itSet)) {
+        fprintf(fp, "%s%s", first ? "" : ",", *(char **)itSet.GetNext(&itSet));
         first = 0;
     }
-    iHashSet.DeleteIterator(itSet);
     fprintf(fp, "};\n\n");
 }
 
@@ -126,97 +158,158 @@ static void translateInitState(ACoACInstance *pInst, FILE *fp) {
     HashMap *avsOfUser = iHashBasedTable.GetRow(pInst->pTableInitState, &pInst->queryUserIdx);
     int *pAttrIdx, valIdx;
     AttrType attrType;
-    HashNode *node;
-    HashNodeIterator *itMap = iHashMap.NewIterator(pInst->pMapAttr2Dom);
-    while (itMap->HasNext(itMap)) {
-        node = itMap->GetNext(itMap);
-        if (iHashSet.Size(*(HashSet **)node->value) <= 1) {
+    IntMapIterator itMap;
+    iIntMap.InitIterator(pInst->pMapAttr2Dom, &itMap);
+    while (iIntMap.Next(&itMap)) {
+        if (iValueSet.Size(*(ValueSet **)itMap.value) <= 1) {
             continue;
         }
-        pAttrIdx = (int *)node->key;
+        pAttrIdx = &itMap.key;
         valIdx = *(int *)iHashMap.Get(avsOfUser, pAttrIdx);
-        attrType = *(AttrType *)iHashMap.Get(pmapAttr2Type, pAttrIdx);
-        fprintf(fp, "init(%s) := %s;\n", istrCollection.GetElement(pscAttrs, *pAttrIdx), getValueByIndex(attrType, valIdx));
+        attrType = *(AttrType *)iIntMap.Get(pmapAttr2Type, *pAttrIdx);
+        fprintf(fp, "init(%s) := %s;\n", istrCollection.GetElement(pscAttrs, *pAttrIdx), getValueByIndex(attrType, getRepresentative(pInst, *pAttrIdx, valIdx)));
     }
-    iHashMap.DeleteIterator(itMap);
 
     fprintf(fp, "\n");
 }
 
+/**
+ * 写入属性attr的取值属于集合pSetValues的条件
+ * 整数属性的取值合并为区间条件，例如(level=1 | level>=3 & level<=7)。区间只需覆盖值域中的值：不在值域中的值是不可达的，
+ * 所以例如值域为{1,3,5,7}时，取值{3,5,7}写作level>=3 & level<=7
+ * @param fp[in]: 输出文件
+ * @param attr[in]: 属性
+ * @param attrType[in]: 属性的类型
+ * @param pSetValues[in]: 满足条件的取值
+ * @param pSetDom[in]: 属性的值域
+ */
+static void translateCondValues(FILE *fp, char *attr, AttrType attrType, ValueSet *pSetValues, ValueSet *pSetDom) {
+    ValueSetIterator it, itDom;
+    int first = 1, hasNext, hasDom, lo, hi;
+    char *val;
+    iValueSet.InitIterator(pSetValues, &it);
+    if (iValueSet.Size(pSetValues) == 1) {
+        iValueSet.Next(&it);
+        val = getValueByIndex(attrType, it.value);
+        fprintf(fp, " & %s=%s", attr, val);
+        free(val);
+        return;
+    }
+    if (attrType != INTEGER) {
+        while (iValueSet.Next(&it)) {
+            val = getValueByIndex(attrType, it.value);
+            fprintf(fp, first ? " & (%s=%s" : " | %s=%s", attr, val);
+            free(val);
+            first = 0;
+        }
+        fprintf(fp, ")");
+        return;
+    }
+
+    // A run of values is broken by a value of the domain that is not in the set, so the values are iterated along
+    // with the domain, whose iterator is kept at the smallest value of the domain above the run
+    iValueSet.InitIterator(pSetDom, &itDom);
+    hasDom = iValueSet.Next(&itDom);
+    hasNext = iValueSet.Next(&it);
+    while (hasNext) {
+        lo = hi = it.value;
+        while (hasDom && itDom.value <= hi) {
+            hasDom = iValueSet.Next(&itDom);
+        }
+        while ((hasNext = iValueSet.Next(&it)) && (!hasDom || itDom.value >= it.value)) {
+            hi = it.value;
+            while (hasDom && itDom.value <= hi) {
+                hasDom = iValueSet.Next(&itDom);
+            }
+        }
+        fprintf(fp, first ? " & (" : " | ");
+        if (lo == hi) {
+            fprintf(fp, "%s=%d", attr, lo);
+        } else {
+            fprintf(fp, "%s>=%d & %s<=%d", attr, lo, attr, hi);
+        }
+        first = 0;
+    }
+    fprintf(fp, ")");
+}
+
 static void translateCanSetRules(ACoACInstance *pInst, FILE *fp) {
-    int *pTargetAttrIdx, condAttrIdx, valIdx1 = 0, valIdx2 = 1;
+    int *pTargetAttrIdx, condAttrIdx, c, cFirst, cLast, cStep, k, nRuleIdxes, *pRuleIdxes;
     char *targetAttr, *targetVal, *condAttr;
     AttrType attrType, condAttrType;
     Rule *pRule;
     char *ruleStr;
-    int isEffectiveRule, first, isAtLeastOneEffectiveRule;
-    HashSet *pSetAttrDom, *pSetEffectiveValues;
-    HashSetIterator *itSetRules, *itSetAtomConds, *itSetEffectiveValues;
+    int isEffectiveRule, isAtLeastOneEffectiveRule;
+    ValueSet *pSetAttrDom, *pSetEffectiveValues;
+    HashSetIterator itSetAtomConds;
     AtomCondition *pAtomCond;
-    HashMap *pMapValToRules, *pMapAdminCondValue, *pMaptmp = NULL;
+    HashMap *pMapAdminCondValue;
     HashNode *node;
-    HashNodeIterator *itMapAttr2Dom = iHashMap.NewIterator(pInst->pMapAttr2Dom), *itMapValToRules, *itMapCondValue;
-    while (itMapAttr2Dom->HasNext(itMapAttr2Dom)) {
-        node = itMapAttr2Dom->GetNext(itMapAttr2Dom);
-        pTargetAttrIdx = (int *)node->key;
-        pSetAttrDom = *(HashSet **)node->value;
-        if (iHashSet.Size(pSetAttrDom) <= 1) {
+    IntMapIterator itMapAttr2Dom;
+    HashNodeIterator itMapCondValue;
+    CSRIndex *pIndexTargetAV2Rule = getTargetAV2RuleIndex(pInst);
+    iIntMap.InitIterator(pInst->pMapAttr2Dom, &itMapAttr2Dom);
+    while (iIntMap.Next(&itMapAttr2Dom)) {
+        pTargetAttrIdx = &itMapAttr2Dom.key;
+        pSetAttrDom = *(ValueSet **)itMapAttr2Dom.value;
+        if (iValueSet.Size(pSetAttrDom) <= 1) {
             continue;
         }
         targetAttr = istrCollection.GetElement(pscAttrs, *pTargetAttrIdx);
 
-        pMapValToRules = iHashBasedTable.GetRow(pInst->pTableTargetAV2Rule, pTargetAttrIdx);
-        if (pMapValToRules == NULL) {
+        if (*pTargetAttrIdx >= pIndexTargetAV2Rule->nRows || pIndexTargetAV2Rule->rowStart[*pTargetAttrIdx] == pIndexTargetAV2Rule->rowStart[*pTargetAttrIdx + 1]) {
             // 如果没有以attr为目标属性的规则，那么该属性的值将永远不会变化
             // 即next(attr) := attr
             fprintf(fp, "next(%s) := %s;\n\n", targetAttr, targetAttr);
             continue;
         }
 
-        attrType = *(AttrType *)iHashMap.Get(pmapAttr2Type, pTargetAttrIdx);
+        attrType = *(AttrType *)iIntMap.Get(pmapAttr2Type, *pTargetAttrIdx);
         isAtLeastOneEffectiveRule = 0;
 
-        if (attrType == BOOLEAN && iHashMap.Size(pMapValToRules) == 2) {
-            pMaptmp = iHashMap.Create(sizeof(int), sizeof(HashSet *), IntHashCode, IntEqual);
-            iHashMap.Put(pMaptmp, &valIdx1, iHashMap.Get(pMapValToRules, &valIdx2));
-            iHashMap.Put(pMaptmp, &valIdx2, iHashMap.Get(pMapValToRules, &valIdx1));
-            pMapValToRules = pMaptmp;
+        // 按目标值升序遍历以attr为目标属性的规则，布尔属性的两个目标值都存在时，先列出目标值为true的规则
+        cFirst = pIndexTargetAV2Rule->rowStart[*pTargetAttrIdx];
+        cLast = pIndexTargetAV2Rule->rowStart[*pTargetAttrIdx + 1] - 1;
+        cStep = 1;
+        if (attrType == BOOLEAN && cLast - cFirst == 1) {
+            c = cFirst;
+            cFirst = cLast;
+            cLast = c;
+            cStep = -1;
         }
 
         // 遍历规则，列出next(attr[i])的所有可能变化
-        itMapValToRules = iHashMap.NewIterator(pMapValToRules);
-        while (itMapValToRules->HasNext(itMapValToRules)) {
-            node = itMapValToRules->GetNext(itMapValToRules);
-            itSetRules = iHashSet.NewIterator(*(HashSet **)node->value);
-
-            while (itSetRules->HasNext(itSetRules)) {
-                pRule = (Rule *)iVector.GetElement(pVecRules, *(int *)itSetRules->GetNext(itSetRules));
+        for (c = cFirst; c != cLast + cStep; c += cStep) {
+            nRuleIdxes = iCSRIndex.CellSize(pIndexTargetAV2Rule, c);
+            pRuleIdxes = pIndexTargetAV2Rule->elems + pIndexTargetAV2Rule->cellStart[c];
+            for (k = 0; k < nRuleIdxes; k++) {
+                pRule = (Rule *)iVector.GetElement(pVecRules, pRuleIdxes[k]);
 
                 // 检查该规则是否有效
                 isEffectiveRule = 1;
-                pMapAdminCondValue = iHashMap.Create(sizeof(int), sizeof(HashSet *), IntHashCode, IntEqual);
-                iHashMap.SetDestructValue(pMapAdminCondValue, iHashSet.DestructPointer);
+                pMapAdminCondValue = iHashMap.Create(sizeof(int), sizeof(ValueSet *), IntHashCode, IntEqual);
+                iHashMap.SetDestructValue(pMapAdminCondValue, iValueSet.DestructPointer);
 
-                itSetAtomConds = iHashSet.NewIterator(pRule->adminCond);
-                while (itSetAtomConds->HasNext(itSetAtomConds)) {
-                    pAtomCond = (AtomCondition *)itSetAtomConds->GetNext(itSetAtomConds);
+                iHashSet.InitIterator(getCondition(pRule->adminCondIdx), &itSetAtomConds);
+                while (itSetAtomConds.HasNext(&itSetAtomConds)) {
+                    pAtomCond = (AtomCondition *)itSetAtomConds.GetNext(&itSetAtomConds);
                     condAttrIdx = pAtomCond->attribute;
 
                     // 在condAttr的值域中寻找所有满足条件adminAtomCond的值effectiveValues
-                    pSetAttrDom = iHashMap.Get(pInst->pMapAttr2Dom, &condAttrIdx);
-                    pSetEffectiveValues = iHashSet.Create(sizeof(int), IntHashCode, IntEqual);
+                    pSetAttrDom = *(ValueSet **)iIntMap.Get(pInst->pMapAttr2Dom, condAttrIdx);
+                    pSetEffectiveValues = iValueSet.Create();
                     iAtomCondition.FindEffectiveValues(pAtomCond, pSetAttrDom, pSetEffectiveValues);
 
                     // 如果effectiveValues为空集，则设置标志位isEffectiveRule = false，然后break
-                    if (iHashSet.Size(pSetEffectiveValues) == 0) {
+                    if (iValueSet.Size(pSetEffectiveValues) == 0) {
                         isEffectiveRule = 0;
-                        iHashSet.Finalize(pSetEffectiveValues);
+                        iValueSet.Finalize(pSetEffectiveValues);
                         break;
                     }
 
                     // 如果effectiveValues等于condAttr的值域，则不用添加后续条件，直接continue就行
-                    if (iHashSet.Equal(&pSetAttrDom, &pSetEffectiveValues)) {
-                        iHashSet.Finalize(pSetEffectiveValues);
+                    if (iValueSet.Equal(pSetAttrDom, pSetEffectiveValues)) {
+                        iValueSet.Finalize(pSetEffectiveValues);
                         continue;
                     }
                     iHashMap.Put(pMapAdminCondValue, &condAttrIdx, &pSetEffectiveValues);
@@ -239,7 +332,7 @@ static void translateCanSetRules(ACoACInstance *pInst, FILE *fp) {
                 // 2.管理值为规则的目标值，即val = targetVal
                 // 3.被管理为i，即user = i
                 // 4.管理员与被管理者分别满足adminCondition与userCondition
-                targetVal = getValueByIndex(attrType, pRule->targetValueIdx);
+                targetVal = getValueByIndex(attrType, getRepresentative(pInst, *pTargetAttrIdx, pRule->targetValueIdx));
                 ruleStr = RuleToString(&pRule);
                 fprintf(fp, "-- %s\nattr=%s%s & val=%s", ruleStr, targetAttr, ALIAS_SUFFIX, targetVal);
                 free(ruleStr);
@@ -247,41 +340,20 @@ static void translateCanSetRules(ACoACInstance *pInst, FILE *fp) {
                 HashMap *condValues[2] = {pMapAdminCondValue, pRule->pmapUserCondValue};
                 int i;
                 for (i = 0; i < 2; i++) {
-                    itMapCondValue = iHashMap.NewIterator(condValues[i]);
-                    while (itMapCondValue->HasNext(itMapCondValue)) {
-                        node = itMapCondValue->GetNext(itMapCondValue);
+                    iHashMap.InitIterator(condValues[i], &itMapCondValue);
+                    while (itMapCondValue.HasNext(&itMapCondValue)) {
+                        node = itMapCondValue.GetNext(&itMapCondValue);
                         condAttrIdx = *(int *)node->key;
                         condAttr = istrCollection.GetElement(pscAttrs, condAttrIdx);
-                        condAttrType = *(AttrType *)iHashMap.Get(pmapAttr2Type, &condAttrIdx);
-                        pSetEffectiveValues = *(HashSet **)node->value;
-                        itSetEffectiveValues = iHashSet.NewIterator(pSetEffectiveValues);
-                        if (iHashSet.Size(pSetEffectiveValues) == 1) {
-                            while (itSetEffectiveValues->HasNext(itSetEffectiveValues)) {
-                                fprintf(fp, " & %s=%s", condAttr, getValueByIndex(condAttrType, *(int *)itSetEffectiveValues->GetNext(itSetEffectiveValues)));
-                            }
-                        } else {
-                            first = 1;
-                            while (itSetEffectiveValues->HasNext(itSetEffectiveValues)) {
-                                fprintf(fp, first ? " & (%s=%s" : " | %s=%s", condAttr, getValueByIndex(condAttrType, *(int *)itSetEffectiveValues->GetNext(itSetEffectiveValues)));
-                                first = 0;
-                            }
-                            fprintf(fp, ")");
-                        }
-                        iHashSet.DeleteIterator(itSetEffectiveValues);
+                        condAttrType = *(AttrType *)iIntMap.Get(pmapAttr2Type, condAttrIdx);
+                        pSetAttrDom = *(ValueSet **)iIntMap.Get(pInst->pMapAttr2Dom, condAttrIdx);
+                        translateCondValues(fp, condAttr, condAttrType, *(ValueSet **)node->value, pSetAttrDom);
                     }
-                    iHashMap.DeleteIterator(itMapCondValue);
                 }
                 fprintf(fp, " : %s;\n", targetVal);
 
                 iHashMap.Finalize(pMapAdminCondValue);
             }
-            iHashSet.DeleteIterator(itSetRules);
-        }
-        iHashMap.DeleteIterator(itMapValToRules);
-
-        if (pMaptmp != NULL) {
-            iHashMap.Finalize(pMaptmp);
-            pMaptmp = NULL;
         }
 
         if (!isAtLeastOneEffectiveRule) {
@@ -291,7 +363,6 @@ static void translateCanSetRules(ACoACInstance *pInst, FILE *fp) {
 
         fprintf(fp, "-- default\nTRUE : %s;\nesac;\n\n", targetAttr);
     }
-    iHashMap.DeleteIterator(itMapAttr2Dom);
 }
 
 /**
@@ -302,24 +373,43 @@ static void translateCanSetRules(ACoACInstance *pInst, FILE *fp) {
 static void translateQuery(ACoACInstance *pInst, FILE *fp) {
     fprintf(fp, "LTLSPEC\n");
 
-    int *pAttrIdx, first = 1;
+    int first = 1;
     char *attr, *val;
     AttrType attrType;
-    HashNode *node;
-    HashNodeIterator *itMap = iHashMap.NewIterator(pInst->pmapQueryAVs);
-    while (itMap->HasNext(itMap)) {
-        node = itMap->GetNext(itMap);
-        pAttrIdx = (int *)node->key;
-        attr = istrCollection.GetElement(pscAttrs, *pAttrIdx);
-        attrType = *(AttrType *)iHashMap.Get(pmapAttr2Type, pAttrIdx);
-        val = getValueByIndex(attrType, *(int *)node->value);
+    IntMapIterator itMap;
+    iIntMap.InitIterator(pInst->pmapQueryAVs, &itMap);
+    while (iIntMap.Next(&itMap)) {
+        attr = istrCollection.GetElement(pscAttrs, itMap.key);
+        attrType = *(AttrType *)iIntMap.Get(pmapAttr2Type, itMap.key);
+        val = getValueByIndex(attrType, *(int *)itMap.value);
         fprintf(fp, first ? "G (%s!=%s" : " | %s!=%s", attr, val);
         first = 0;
     }
     fprintf(fp, ")");
 }
 
+/**
+ * 写入属性值的探针，每个探针是一个不变式，断言查询用户的属性不取该值
+ * @param fp[in]: 输出文件
+ * @param probeAttrs[in]: 探针的属性
+ * @param probeVals[in]: 探针的值
+ * @param nProbes[in]: 探针的数量
+ */
+static void translateProbes(FILE *fp, int *probeAttrs, int *probeVals, int nProbes) {
+    int i;
+    char *val;
+    for (i = 0; i < nProbes; i++) {
+        val = getValueByIndex(*(AttrType *)iIntMap.Get(pmapAttr2Type, probeAttrs[i]), probeVals[i]);
+        fprintf(fp, "\n\nINVARSPEC\n%s!=%s", istrCollection.GetElement(pscAttrs, probeAttrs[i]), val);
+        free(val);
+    }
+}
+
 int translate(ACoACInstance *instance, char *nusmvFilePath, int sliced) {
+    return translateWithProbes(instance, nusmvFilePath, sliced, NULL, NULL, 0);
+}
+
+int translateWithProbes(ACoACInstance *instance, char *nusmvFilePath, int sliced, int *probeAttrs, int *probeVals, int nProbes) {
     logACoAC(__func__, __LINE__, 0, INFO, "[begin] translating ACoAC instance into nusmv file %s\n", nusmvFilePath);
     clock_t startTranslating = clock();
 
@@ -340,6 +430,7 @@ int translate(ACoACInstance *instance, char *nusmvFilePath, int sliced) {
     translateInitState(instance, fp);
     translateCanSetRules(instance, fp);
     translateQuery(instance, fp);
+    translateProbes(fp, probeAttrs, probeVals, nProbes);
 
     fclose(fp);
 
@@ -7,6 +7,12 @@
 
 #include "acoac_utils.h"
 
+double wallClockMs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
 void logACoAC(const char *func, int line, int logType, LogLevel logLevel, const char *format, ...) {
     char *logLevelStr = NULL;
     switch (logLevel) {
@@ -35,12 +41,16 @@ void logACoAC(const char *func, int line, int logType, LogLevel logLevel, const
     time_t time_log;
     if (logType == 0) {
         time_log = time(NULL);
-        struct tm *tm_log = localtime(&time_log);
+        struct tm tm_buf, *tm_log = localtime_r(&time_log, &tm_buf);
+        // Keep the lines of concurrent threads apart
+        flockfile(stdout);
         /*printf("%04d-%02d-%02d %02d:%02d:%02d INFO [%s](%d):  ", tm_log->tm_year + 1900, tm_log->tm_mon + 1, tm_log->tm_mday,
             tm_log->tm_hour, tm_log->tm_min, tm_log->tm_sec, func, line);*/
         printf("\033[47;31m%02d/%02d/%02d %02d:%02d:%02d [%s][%s(%d)]: \033[0m", tm_log->tm_year - 100, tm_log->tm_mon + 1, tm_log->tm_mday,
                tm_log->tm_hour, tm_log->tm_min, tm_log->tm_sec, logLevelStr, func, line);
         vprintf(format, arg);
+        funlockfile(stdout);
+        va_end(arg);
         return;
     }
     FILE *p = fopen("log.txt", "a+");
@@ -48,7 +58,7 @@ void logACoAC(const char *func, int line, int logType, LogLevel logLevel, const
         return;
     }
     time_log = time(NULL);
-    struct tm *tm_log = localtime(&time_log);
+    struct tm tm_buf, *tm_log = localtime_r(&time_log, &tm_buf);
     fprintf(p, "%04d-%02d-%02d %02d:%02d:%02d %s [%s](%d):", tm_log->tm_year + 1900, tm_log->tm_mon + 1, tm_log->tm_mday,
             tm_log->tm_hour, tm_log->tm_min, tm_log->tm_sec, func, line);
     vfprintf(p, format, arg);
@@ -162,6 +172,11 @@ int IntEqual(void *pInt1, void *pInt2) {
     return *(int *)pInt1 == *(int *)pInt2;
 }
 
+int compareInts(const void *p1, const void *p2) {
+    int i1 = *(const int *)p1, i2 = *(const int *)p2;
+    return i1 < i2 ? -1 : i1 > i2;
+}
+
 char *IntToString(void *pInt) {
     int i = *(int *)pInt;
     char *str = (char *)malloc(32);
@@ -178,7 +193,8 @@ char *StringToString(void *pStr) {
 }
 
 char *mapToString(HashMap *map, char *(*keyToString)(void *key), char *(*valueToString)(void *value)) {
-    HashNodeIterator *it = iHashMap.NewIterator(map);
+    HashNodeIterator it;
+    iHashMap.InitIterator(map, &it);
     HashNode *node;
     char *key, *value;
     char *ret = (char *)malloc(3);
@@ -186,8 +202,8 @@ char *mapToString(HashMap *map, char *(*keyToString)(void *key), char *(*valueTo
     ret[cur++] = '{';
     int first = 1;
     int keyLen, valueLen;
-    while (it->HasNext(it)) {
-        node = it->GetNext(it);
+    while (it.HasNext(&it)) {
+        node = it.GetNext(&it);
         key = keyToString(node->key);
         value = valueToString(node->value);
         keyLen = strlen(key);
@@ -209,7 +225,6 @@ char *mapToString(HashMap *map, char *(*keyToString)(void *key), char *(*valueTo
     }
     ret[cur++] = '}';
     ret[cur++] = '\0';
-    iHashMap.DeleteIterator(it);
     return ret;
 }
 
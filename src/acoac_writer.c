@@ -64,7 +64,7 @@ static int writeUsers(FILE *fp, ACoACInstance *pInst) {
  * @return 0 if write successfully, -1 if failed
  */
 static int writeAttrsAndDefaultValues(FILE *fp, ACoACInstance *pInst) {
-    if (iHashMap.Size(pInst->pMapAttr2Dom) == 0) {
+    if (iIntMap.Size(pInst->pMapAttr2Dom) == 0) {
         logACoAC(__func__, __LINE__, 0, ERROR, "[Writing] The set of attributes is empty\n");
         return -1;
     }
@@ -75,17 +75,14 @@ static int writeAttrsAndDefaultValues(FILE *fp, ACoACInstance *pInst) {
         attrs[i] = iHashSet.Create(sizeof(int), IntHashCode, IntEqual);
     }
 
-    HashNodeIterator *itmapAttr2Dom = iHashMap.NewIterator(pInst->pMapAttr2Dom);
-    HashNode *node;
+    IntMapIterator itmapAttr2Dom;
     int *pAttrIdx;
     AttrType attrType;
-    while (itmapAttr2Dom->HasNext(itmapAttr2Dom)) {
-        node = itmapAttr2Dom->GetNext(itmapAttr2Dom);
-        pAttrIdx = (int *)node->key;
-        attrType = getAttrTypeByIdx(*pAttrIdx);
-        iHashSet.Add(attrs[attrType], pAttrIdx);
+    iIntMap.InitIterator(pInst->pMapAttr2Dom, &itmapAttr2Dom);
+    while (iIntMap.Next(&itmapAttr2Dom)) {
+        attrType = getAttrTypeByIdx(itmapAttr2Dom.key);
+        iHashSet.Add(attrs[attrType], &itmapAttr2Dom.key);
     }
-    iHashMap.DeleteIterator(itmapAttr2Dom);
 
     // Write the attributes and their data types
     fprintf(fp, ATTRIBUTES);
@@ -116,7 +113,7 @@ static int writeAttrsAndDefaultValues(FILE *fp, ACoACInstance *pInst) {
         itHashSet = iHashSet.NewIterator(attrs[i]);
         while (itHashSet->HasNext(itHashSet)) {
             pAttrIdx = (int *)itHashSet->GetNext(itHashSet);
-            defaultValueIdx = *(int *)iHashMap.Get(pmapAttr2DefVal, pAttrIdx);
+            defaultValueIdx = *(int *)iIntMap.Get(pmapAttr2DefVal, *pAttrIdx);
             if (defaultValueIdx) {
                 fprintf(fp, "\n%s: %s", istrCollection.GetElement(pscAttrs, *pAttrIdx), getValueByIndex(getAttrTypeByIdx(*pAttrIdx), defaultValueIdx));
                 f = 1;
@@ -257,7 +254,7 @@ static int writeSpec(FILE *fp, ACoACInstance *pInst) {
         logACoAC(__func__, __LINE__, 0, ERROR, "[Writing] The query is a NULL pointer\n");
         return -1;
     }
-    if (iHashMap.Size(pInst->pmapQueryAVs) == 0) {
+    if (iIntMap.Size(pInst->pmapQueryAVs) == 0) {
         logACoAC(__func__, __LINE__, 0, ERROR, "[Writing] The set of query attribute-value pairs is empty\n");
         return -1;
     }
@@ -266,18 +263,16 @@ static int writeSpec(FILE *fp, ACoACInstance *pInst) {
     fprintf(fp, "\n(%s", istrCollection.GetElement(pscUsers, pInst->queryUserIdx));
 
     // 遍历查询属性值集合，写入文件
-    HashNodeIterator *itAttrs = iHashMap.NewIterator(pInst->pmapQueryAVs);
+    IntMapIterator itAttrs;
     int attrIdx;
     char *attr, *value;
-    HashNode *node;
-    while (itAttrs->HasNext(itAttrs)) {
-        node = itAttrs->GetNext(itAttrs);
-        attrIdx = *(int *)node->key;
+    iIntMap.InitIterator(pInst->pmapQueryAVs, &itAttrs);
+    while (iIntMap.Next(&itAttrs)) {
+        attrIdx = itAttrs.key;
         attr = istrCollection.GetElement(pscAttrs, attrIdx);
-        value = getValueByIndex(getAttrTypeByIdx(attrIdx), *(int *)node->value);
+        value = getValueByIndex(getAttrTypeByIdx(attrIdx), *(int *)itAttrs.value);
         fprintf(fp, ", %s = %s", attr, value);
     }
-    iHashMap.DeleteIterator(itAttrs);
     fprintf(fp, ");\n");
     return 0;
 }
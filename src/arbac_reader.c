@@ -55,8 +55,8 @@ static void handleRoles(ACoACInstance *pInst, char *line) {
             roleNum = istrCollection.Size(pscAttrs);
             iDictionary.Insert(pdictAttr2Index, role, &roleNum);
             istrCollection.Add(pscAttrs, role);
-            iHashMap.Put(pmapAttr2Type, &roleNum, &attrType);
-            iHashMap.Put(pmapAttr2DefVal, &roleNum, &defValIdx);
+            iIntMap.Put(pmapAttr2Type, roleNum, &attrType);
+            iIntMap.Put(pmapAttr2DefVal, roleNum, &defValIdx);
             logACoAC(__func__, __LINE__, 0, DEBUG, "Add attribute: %s, index: %d\n", role, roleNum);
             roleNum++;
         }
@@ -204,8 +204,7 @@ static void handleCA(ACoACInstance *pInst, char *line) {
     int rc;
     char *caStr, *adminCondStr, *userCondStr, *targetRole;
     int roleIdx;
-    HashSet *adminCond, *userCond;
-    Rule *r;
+    int adminCondIdx, userCondIdx, ruleIdx;
     while (line != NULL) {
         rc = regexec(&pattern, line, 2, pmatch, 0);
         if (rc != 0) {
@@ -230,12 +229,9 @@ static void handleCA(ACoACInstance *pInst, char *line) {
 
         roleIdx = getAttrIndex(strtrim(targetRole));
 
-        adminCond = handleCondition(strtrim(adminCondStr));
-        userCond = handleCondition(strtrim(userCondStr));
-        r = iRule.Create(adminCond, userCond, roleIdx, 1);
-        iVector.Add(pVecRules, r);
-        free(r);
-        int ruleIdx = iVector.Size(pVecRules) - 1;
+        adminCondIdx = getConditionIndex(handleCondition(strtrim(adminCondStr)));
+        userCondIdx = getConditionIndex(handleCondition(strtrim(userCondStr)));
+        ruleIdx = getRuleIndex(adminCondIdx, userCondIdx, roleIdx, 1);
         addRule(pInst, ruleIdx);
     }
 }
@@ -255,8 +251,7 @@ static void handleCR(ACoACInstance *pInst, char *line) {
     int rc;
     char *crStr, *adminCondStr, *targetRole;
     int roleIdx;
-    HashSet *adminCond, *userCond;
-    Rule *r;
+    int adminCondIdx, ruleIdx;
     while (line != NULL) {
         rc = regexec(&pattern, line, 2, pmatch, 0);
         if (rc != 0) {
@@ -280,12 +275,8 @@ static void handleCR(ACoACInstance *pInst, char *line) {
 
         roleIdx = getAttrIndex(strtrim(targetRole));
 
-        adminCond = handleCondition(strtrim(adminCondStr));
-        userCond = iHashSet.Create(sizeof(AtomCondition), iAtomCondition.HashCode, iAtomCondition.Equal);
-        r = iRule.Create(adminCond, userCond, roleIdx, 0);
-        iVector.Add(pVecRules, r);
-        free(r);
-        int ruleIdx = iVector.Size(pVecRules) - 1;
+        adminCondIdx = getConditionIndex(handleCondition(strtrim(adminCondStr)));
+        ruleIdx = getRuleIndex(adminCondIdx, TRUE_COND_IDX, roleIdx, 0);
         addRule(pInst, ruleIdx);
     }
 }
@@ -316,7 +307,7 @@ static void handleSpec(ACoACInstance *pInst, char *line) {
     int roleIdx = getAttrIndex(role);
     int valueIdx = 1;
 
-    iHashMap.Put(pInst->pmapQueryAVs, &roleIdx, &valueIdx);
+    iIntMap.Put(pInst->pmapQueryAVs, roleIdx, &valueIdx);
     logACoAC(__func__, __LINE__, 0, INFO, "query user: %s\n", queryUser);
 }
 
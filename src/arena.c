@@ -0,0 +1,142 @@
+#include "arena.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// The first chunk of an arena, the later chunks double in size up to ARENA_MAX_CHUNK_SIZE
+#define ARENA_MIN_CHUNK_SIZE (16 * 1024)
+#define ARENA_MAX_CHUNK_SIZE (1024 * 1024)
+#define ARENA_ALIGNMENT 16
+// The number of released arenas kept in the pool, the others are finalized
+#define ARENA_POOL_CAPACITY 16
+
+#define ALIGN_UP(n) (((n) + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1))
+// The header of a chunk is padded so that the memory behind it is aligned
+#define CHUNK_HEADER_SIZE ALIGN_UP(sizeof(ArenaChunk))
+#define CHUNK_DATA(chunk) ((char *)(chunk) + CHUNK_HEADER_SIZE)
+
+static Arena *pool = NULL;
+static int poolSize = 0;
+static pthread_mutex_t poolLock = PTHREAD_MUTEX_INITIALIZER;
+
+static Arena *Create() {
+    Arena *arena = (Arena *)malloc(sizeof(Arena));
+    if (arena == NULL) {
+        printf("[Error] Arena Create: failed to allocate memory\n");
+        abort();
+    }
+    arena->head = NULL;
+    arena->current = NULL;
+    arena->capacity = 0;
+    arena->nextFree = NULL;
+    return arena;
+}
+
+/**
+ * Allocate a chunk which can hold at least @{size} bytes and link it after the current chunk.
+ */
+static ArenaChunk *addChunk(Arena *arena, size_t size) {
+    size_t chunkSize = arena->capacity < ARENA_MIN_CHUNK_SIZE ? ARENA_MIN_CHUNK_SIZE : arena->capacity;
+    if (chunkSize > ARENA_MAX_CHUNK_SIZE) {
+        chunkSize = ARENA_MAX_CHUNK_SIZE;
+    }
+    if (chunkSize < size) {
+        chunkSize = size;
+    }
+    ArenaChunk *chunk = (ArenaChunk *)malloc(CHUNK_HEADER_SIZE + chunkSize);
+    if (chunk == NULL) {
+        printf("[Error] Arena Alloc: failed to allocate memory\n");
+        abort();
+    }
+    chunk->size = chunkSize;
+    chunk->used = 0;
+    if (arena->current == NULL) {
+        chunk->next = arena->head;
+        arena->head = chunk;
+    } else {
+        chunk->next = arena->current->next;
+        arena->current->next = chunk;
+    }
+    arena->capacity += chunkSize;
+    return chunk;
+}
+
+static void *Alloc(Arena *arena, size_t size) {
+    size = ALIGN_UP(size);
+    ArenaChunk *chunk = arena->current;
+    if (chunk == NULL) {
+        chunk = arena->head;
+    }
+    // The chunks after the current one are empty, they are left over from before the last Reset
+    while (chunk != NULL && chunk->size - chunk->used < size) {
+        chunk = chunk->next;
+    }
+    if (chunk == NULL) {
+        chunk = addChunk(arena, size);
+    }
+    arena->current = chunk;
+    void *block = CHUNK_DATA(chunk) + chunk->used;
+    chunk->used += size;
+    return block;
+}
+
+static void Reset(Arena *arena) {
+    ArenaChunk *chunk;
+    for (chunk = arena->head; chunk != NULL; chunk = chunk->next) {
+        chunk->used = 0;
+    }
+    arena->current = NULL;
+}
+
+static void Finalize(Arena *arena) {
+    if (arena == NULL) {
+        return;
+    }
+    ArenaChunk *chunk = arena->head, *next;
+    while (chunk != NULL) {
+        next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    free(arena);
+}
+
+static Arena *Acquire() {
+    pthread_mutex_lock(&poolLock);
+    Arena *arena = pool;
+    if (arena != NULL) {
+        pool = arena->nextFree;
+        poolSize--;
+    }
+    pthread_mutex_unlock(&poolLock);
+    if (arena == NULL) {
+        return Create();
+    }
+    arena->nextFree = NULL;
+    return arena;
+}
+
+static void Release(Arena *arena) {
+    if (arena == NULL) {
+        return;
+    }
+    Reset(arena);
+    pthread_mutex_lock(&poolLock);
+    if (poolSize < ARENA_POOL_CAPACITY) {
+        arena->nextFree = pool;
+        pool = arena;
+        poolSize++;
+        arena = NULL;
+    }
+    pthread_mutex_unlock(&poolLock);
+    Finalize(arena);
+}
+
+ArenaInterface iArena = {
+    .Create = Create,
+    .Alloc = Alloc,
+    .Reset = Reset,
+    .Finalize = Finalize,
+    .Acquire = Acquire,
+    .Release = Release,
+};
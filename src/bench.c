@@ -0,0 +1,1419 @@
+#include "acoac_absref.h"
+#include "acoac_domcomp.h"
+#include "acoac_io.h"
+#include "acoac_pruning.h"
+#include "acoac_translator.h"
+#include "acoac_utils.h"
+#include "intset.h"
+#include "mc_runner.h"
+#include "valueset.h"
+#include "thread_pool.h"
+#include "userindex.h"
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define DEFAULT_REPEAT 5
+
+// The number of keys inserted by the map benchmarks
+#define MAP_BENCH_KEYS (1 << 18)
+
+// The number of value sets, and the domain sizes, used by the value-set benchmark
+#define SET_BENCH_SETS 4096
+static int setBenchDomains[] = {8, 64, 512};
+
+// The timeout of a call to the model checker in the refinement benchmark, in seconds
+#define REFINE_BENCH_TIMEOUT 3600
+
+// The number of threads used by readMmap
+static int nReaderThreads = 1;
+
+/**
+ * Check whether two files have exactly the same content
+ *
+ * @param path1[in]: The path of the first file
+ * @param path2[in]: The path of the second file
+ * @return 1 if the contents are the same, 0 otherwise
+ */
+static int sameContent(char *path1, char *path2) {
+    FILE *fp1 = fopen(path1, "r");
+    FILE *fp2 = fopen(path2, "r");
+    int same = fp1 != NULL && fp2 != NULL;
+    int c1, c2;
+    while (same) {
+        c1 = fgetc(fp1);
+        c2 = fgetc(fp2);
+        if (c1 != c2) {
+            same = 0;
+        } else if (c1 == EOF) {
+            break;
+        }
+    }
+    if (fp1 != NULL) {
+        fclose(fp1);
+    }
+    if (fp2 != NULL) {
+        fclose(fp2);
+    }
+    return same;
+}
+
+static ACoACInstance *readMmap(char *filename) {
+    return readACoACInstanceMmap(filename, nReaderThreads);
+}
+
+/**
+ * Read an instance file repeatedly with a reader, and report the cost of reading.
+ * The instance read in the last round is written to @{dumpPath} for comparison.
+ *
+ * @param name[in]: The name of the reader
+ * @param reader[in]: The reader
+ * @param instFile[in]: The path of the instance file
+ * @param repeat[in]: The number of rounds
+ * @param dumpPath[in]: The path of the file to dump the instance
+ * @return The average cost in milliseconds, or -1 if failed
+ */
+static double benchReader(char *name, ACoACInstance *(*reader)(char *), char *instFile, int repeat, char *dumpPath) {
+    double start, cost, total = 0, min = -1;
+    ACoACInstance *pInst;
+    int i;
+    for (i = 0; i < repeat; i++) {
+        start = wallClockMs();
+        pInst = reader(instFile);
+        cost = wallClockMs() - start;
+        if (pInst == NULL) {
+            printf("%s reader failed to read %s\n", name, instFile);
+            return -1;
+        }
+        total += cost;
+        if (min < 0 || cost < min) {
+            min = cost;
+        }
+        if (i == repeat - 1) {
+            writeACoACInstance(pInst, dumpPath);
+            printf("%-8s reader: %d users, %d attributes, %d values, %d rules\n", name, (int)istrCollection.Size(pscUsers),
+                   (int)istrCollection.Size(pscAttrs), (int)istrCollection.Size(pscValues), (int)iVector.Size(pVecRules));
+        }
+        finalizeACoACInstance(pInst);
+        finalizeGlobalVars();
+    }
+    printf("%-8s reader: avg => %.2fms, min => %.2fms (%d rounds)\n", name, total / repeat, min, repeat);
+    return total / repeat;
+}
+
+/**
+ * Compare the stdio-based reader readACoACInstance, the memory-mapped reader readACoACInstanceMmap,
+ * and the loader of compiled policies readCompiledInstance
+ */
+static int benchReaders(char *instFile, int repeat) {
+    char stdioDump[] = "/tmp/coachecker_bench_stdio_XXXXXX";
+    char mmapDump[] = "/tmp/coachecker_bench_mmap_XXXXXX";
+    char binaryDump[] = "/tmp/coachecker_bench_binary_XXXXXX";
+    char compiledFile[] = "/tmp/coachecker_bench_compiled_XXXXXX";
+    int fds[4] = {mkstemp(stdioDump), mkstemp(mmapDump), mkstemp(binaryDump), mkstemp(compiledFile)};
+    int i;
+    for (i = 0; i < 4; i++) {
+        if (fds[i] < 0) {
+            printf("Failed to create temporary files!\n");
+            return 1;
+        }
+        close(fds[i]);
+    }
+
+    double stdioCost = benchReader("stdio", readACoACInstance, instFile, repeat, stdioDump);
+    double mmapCost = benchReader("mmap", readMmap, instFile, repeat, mmapDump);
+
+    double binaryCost = -1;
+    ACoACInstance *pInst = readMmap(instFile);
+    if (pInst != NULL && writeCompiledInstance(pInst, compiledFile) == 0) {
+        finalizeACoACInstance(pInst);
+        finalizeGlobalVars();
+        binaryCost = benchReader("binary", readCompiledInstance, compiledFile, repeat, binaryDump);
+    }
+
+    int same = sameContent(stdioDump, mmapDump);
+    int sameBinary = sameContent(stdioDump, binaryDump);
+    remove(stdioDump);
+    remove(mmapDump);
+    remove(binaryDump);
+    remove(compiledFile);
+    if (stdioCost < 0 || mmapCost < 0 || binaryCost < 0) {
+        return 1;
+    }
+    printf("mmap speedup => %.2fx, same instance => %s\n", stdioCost / mmapCost, same ? "yes" : "NO");
+    printf("binary speedup => %.2fx, same instance => %s\n", stdioCost / binaryCost, sameBinary ? "yes" : "NO");
+    return same && sameBinary ? 0 : 1;
+}
+
+/**
+ * Read an instance file with the memory-mapped reader on 1, 2, 4, ..., @{maxThreads} threads,
+ * and report the speedups over the sequential parse
+ */
+static int benchParallelReader(char *instFile, int repeat, int maxThreads) {
+    char seqDump[] = "/tmp/coachecker_bench_seq_XXXXXX";
+    char parDump[] = "/tmp/coachecker_bench_par_XXXXXX";
+    int fds[2] = {mkstemp(seqDump), mkstemp(parDump)};
+    if (fds[0] < 0 || fds[1] < 0) {
+        printf("Failed to create temporary files!\n");
+        return 1;
+    }
+    close(fds[0]);
+    close(fds[1]);
+
+    char name[32];
+    nReaderThreads = 1;
+    double seqCost = benchReader("1-thread", readMmap, instFile, repeat, seqDump), parCost;
+    int allSame = seqCost >= 0, same;
+    for (nReaderThreads = 2; seqCost >= 0 && nReaderThreads < maxThreads * 2; nReaderThreads *= 2) {
+        if (nReaderThreads > maxThreads) {
+            nReaderThreads = maxThreads;
+        }
+        sprintf(name, "%d-thread", nReaderThreads);
+        parCost = benchReader(name, readMmap, instFile, repeat, parDump);
+        if (parCost < 0) {
+            allSame = 0;
+            break;
+        }
+        same = sameContent(seqDump, parDump);
+        allSame = allSame && same;
+        printf("%s speedup => %.2fx, same instance => %s\n", name, seqCost / parCost, same ? "yes" : "NO");
+    }
+    remove(seqDump);
+    remove(parDump);
+    return allSame ? 0 : 1;
+}
+
+/* The cost of each phase of a map benchmark, and a checksum of the values that are read */
+typedef struct _MapBenchCost {
+    double insert;
+    double lookup;
+    double iterate;
+    double remove;
+    long checksum;
+} MapBenchCost;
+
+typedef void (*MapBenchFn)(int *keys, int n, MapBenchCost *cost);
+
+static void benchHashMapOnce(int *keys, int n, MapBenchCost *cost) {
+    HashMap *map = iHashMap.Create(sizeof(int), sizeof(int), IntHashCode, IntEqual);
+    HashNodeIterator *it;
+    int i;
+    double start = wallClockMs();
+    for (i = 0; i < n; i++) {
+        iHashMap.Put(map, &keys[i], &i);
+    }
+    cost->insert = wallClockMs() - start;
+
+    start = wallClockMs();
+    for (i = 0; i < n; i++) {
+        cost->checksum += *(int *)iHashMap.Get(map, &keys[i]);
+    }
+    cost->lookup = wallClockMs() - start;
+
+    start = wallClockMs();
+    it = iHashMap.NewIterator(map);
+    while (it->HasNext(it)) {
+        cost->checksum += *(int *)((HashNode *)it->GetNext(it))->value;
+    }
+    iHashMap.DeleteIterator(it);
+    cost->iterate = wallClockMs() - start;
+
+    start = wallClockMs();
+    for (i = 0; i < n; i++) {
+        iHashMap.Remove(map, &keys[i]);
+    }
+    cost->remove = wallClockMs() - start;
+    iHashMap.Finalize(map);
+}
+
+static void benchIntMapOnce(int *keys, int n, MapBenchCost *cost) {
+    IntMap *map = iIntMap.Create(sizeof(int));
+    IntMapIterator it;
+    int i;
+    double start = wallClockMs();
+    for (i = 0; i < n; i++) {
+        iIntMap.Put(map, keys[i], &i);
+    }
+    cost->insert = wallClockMs() - start;
+
+    start = wallClockMs();
+    for (i = 0; i < n; i++) {
+        cost->checksum += *(int *)iIntMap.Get(map, keys[i]);
+    }
+    cost->lookup = wallClockMs() - start;
+
+    start = wallClockMs();
+    iIntMap.InitIterator(map, &it);
+    while (iIntMap.Next(&it)) {
+        cost->checksum += *(int *)it.value;
+    }
+    cost->iterate = wallClockMs() - start;
+
+    start = wallClockMs();
+    for (i = 0; i < n; i++) {
+        iIntMap.Remove(map, keys[i]);
+    }
+    cost->remove = wallClockMs() - start;
+    iIntMap.Finalize(map);
+}
+
+static void benchHashSetOnce(int *keys, int n, MapBenchCost *cost) {
+    HashSet *set = iHashSet.Create(sizeof(int), IntHashCode, IntEqual);
+    HashSetIterator *it;
+    int i;
+    double start = wallClockMs();
+    for (i = 0; i < n; i++) {
+        iHashSet.Add(set, &keys[i]);
+    }
+    cost->insert = wallClockMs() - start;
+
+    start = wallClockMs();
+    for (i = 0; i < n; i++) {
+        cost->checksum += iHashSet.Contains(set, &keys[i]);
+    }
+    cost->lookup = wallClockMs() - start;
+
+    start = wallClockMs();
+    it = iHashSet.NewIterator(set);
+    while (it->HasNext(it)) {
+        cost->checksum += *(int *)it->GetNext(it);
+    }
+    iHashSet.DeleteIterator(it);
+    cost->iterate = wallClockMs() - start;
+
+    start = wallClockMs();
+    for (i = 0; i < n; i++) {
+        iHashSet.Remove(set, &keys[i]);
+    }
+    cost->remove = wallClockMs() - start;
+    iHashSet.Finalize(set);
+}
+
+static void benchIntSetOnce(int *keys, int n, MapBenchCost *cost) {
+    IntSet *set = iIntSet.Create();
+    IntSetIterator it;
+    int i;
+    double start = wallClockMs();
+    for (i = 0; i < n; i++) {
+        iIntSet.Add(set, keys[i]);
+    }
+    cost->insert = wallClockMs() - start;
+
+    start = wallClockMs();
+    for (i = 0; i < n; i++) {
+        cost->checksum += iIntSet.Contains(set, keys[i]);
+    }
+    cost->lookup = wallClockMs() - start;
+
+    start = wallClockMs();
+    iIntSet.InitIterator(set, &it);
+    while (iIntSet.Next(&it)) {
+        cost->checksum += it.key;
+    }
+    cost->iterate = wallClockMs() - start;
+
+    start = wallClockMs();
+    for (i = 0; i < n; i++) {
+        iIntSet.Remove(set, keys[i]);
+    }
+    cost->remove = wallClockMs() - start;
+    iIntSet.Finalize(set);
+}
+
+/**
+ * Run a map benchmark @{repeat} times, and keep the minimum cost of each phase
+ */
+static MapBenchCost benchMap(char *name, MapBenchFn fn, int *keys, int n, int repeat) {
+    MapBenchCost best = {-1, -1, -1, -1, 0}, cost;
+    int i;
+    for (i = 0; i < repeat; i++) {
+        cost.checksum = 0;
+        fn(keys, n, &cost);
+        if (best.insert < 0 || cost.insert < best.insert) {
+            best.insert = cost.insert;
+        }
+        if (best.lookup < 0 || cost.lookup < best.lookup) {
+            best.lookup = cost.lookup;
+        }
+        if (best.iterate < 0 || cost.iterate < best.iterate) {
+            best.iterate = cost.iterate;
+        }
+        if (best.remove < 0 || cost.remove < best.remove) {
+            best.remove = cost.remove;
+        }
+        best.checksum = cost.checksum;
+    }
+    printf("%-14s insert => %8.2fms, lookup => %8.2fms, iterate => %8.2fms, remove => %8.2fms\n",
+           name, best.insert, best.lookup, best.iterate, best.remove);
+    return best;
+}
+
+static int compareMaps(char *name, MapBenchCost base, MapBenchCost cost) {
+    printf("%-14s speedup => insert %.2fx, lookup %.2fx, iterate %.2fx, remove %.2fx, same result => %s\n", name,
+           base.insert / cost.insert, base.lookup / cost.lookup, base.iterate / cost.iterate, base.remove / cost.remove,
+           base.checksum == cost.checksum ? "yes" : "NO");
+    return base.checksum == cost.checksum;
+}
+
+/**
+ * Compare the chained HashMap/HashSet with the open-addressing IntMap/IntSet on int keys.
+ * Dense keys 0..n-1 resemble attribute and value indices; sparse keys are spread over the non-negative ints.
+ */
+static int benchIntMaps(int repeat) {
+    int *keys = (int *)malloc(MAP_BENCH_KEYS * sizeof(int));
+    int i, dense, same = 1;
+    MapBenchCost hashCost, intCost;
+    for (dense = 1; dense >= 0; dense--) {
+        for (i = 0; i < MAP_BENCH_KEYS; i++) {
+            // An odd multiplier is a bijection modulo 2^31, so the sparse keys are distinct
+            keys[i] = dense ? i : (int)((i * 2654435761u) & 0x7fffffff);
+        }
+        printf("%s keys (%d):\n", dense ? "dense" : "sparse", MAP_BENCH_KEYS);
+        hashCost = benchMap("HashMap", benchHashMapOnce, keys, MAP_BENCH_KEYS, repeat);
+        intCost = benchMap("IntMap", benchIntMapOnce, keys, MAP_BENCH_KEYS, repeat);
+        same = compareMaps("IntMap", hashCost, intCost) && same;
+        hashCost = benchMap("HashSet", benchHashSetOnce, keys, MAP_BENCH_KEYS, repeat);
+        intCost = benchMap("IntSet", benchIntSetOnce, keys, MAP_BENCH_KEYS, repeat);
+        same = compareMaps("IntSet", hashCost, intCost) && same;
+    }
+    free(keys);
+    return same ? 0 : 1;
+}
+
+/* The cost of each operation of a value-set benchmark, and a checksum of the results */
+typedef struct _SetBenchCost {
+    double unionAll;
+    double intersects;
+    double subset;
+    double equal;
+    long checksum;
+} SetBenchCost;
+
+/* The values of the sets used by a value-set benchmark */
+typedef struct _SetBenchInput {
+    int nSets;
+    int **values;
+    int *nValues;
+} SetBenchInput;
+
+typedef void (*SetBenchFn)(SetBenchInput *input, SetBenchCost *cost);
+
+static void benchHashSetOpsOnce(SetBenchInput *input, SetBenchCost *cost) {
+    int n = input->nSets, i, j, found;
+    HashSet **sets = (HashSet **)malloc(n * sizeof(HashSet *));
+    HashSet **copies = (HashSet **)malloc(n * sizeof(HashSet *));
+    HashSetIterator *it;
+    for (i = 0; i < n; i++) {
+        sets[i] = iHashSet.Create(sizeof(int), IntHashCode, IntEqual);
+        copies[i] = iHashSet.Create(sizeof(int), IntHashCode, IntEqual);
+        for (j = 0; j < input->nValues[i]; j++) {
+            iHashSet.Add(sets[i], &input->values[i][j]);
+            iHashSet.Add(copies[i], &input->values[i][input->nValues[i] - 1 - j]);
+        }
+    }
+
+    // Union of all sets, as in computing the attribute domains
+    double start = wallClockMs();
+    HashSet *all = iHashSet.Create(sizeof(int), IntHashCode, IntEqual);
+    for (i = 0; i < n; i++) {
+        it = iHashSet.NewIterator(sets[i]);
+        while (it->HasNext(it)) {
+            iHashSet.Add(all, it->GetNext(it));
+        }
+        iHashSet.DeleteIterator(it);
+    }
+    cost->checksum += iHashSet.Size(all);
+    cost->unionAll = wallClockMs() - start;
+
+    // Whether two sets share a value, as in checking whether a rule is effective
+    start = wallClockMs();
+    for (i = 0; i < n; i++) {
+        found = 0;
+        it = iHashSet.NewIterator(sets[i]);
+        while (!found && it->HasNext(it)) {
+            found = iHashSet.Contains(sets[(i + 1) % n], it->GetNext(it));
+        }
+        iHashSet.DeleteIterator(it);
+        cost->checksum += found;
+    }
+    cost->intersects = wallClockMs() - start;
+
+    start = wallClockMs();
+    for (i = 0; i < n; i++) {
+        found = 1;
+        it = iHashSet.NewIterator(sets[i]);
+        while (found && it->HasNext(it)) {
+            found = iHashSet.Contains(all, it->GetNext(it));
+        }
+        iHashSet.DeleteIterator(it);
+        cost->checksum += found;
+    }
+    cost->subset = wallClockMs() - start;
+
+    start = wallClockMs();
+    for (i = 0; i < n; i++) {
+        cost->checksum += iHashSet.Equal(&sets[i], &copies[i]);
+        cost->checksum += iHashSet.Equal(&sets[i], &sets[(i + 1) % n]);
+    }
+    cost->equal = wallClockMs() - start;
+
+    for (i = 0; i < n; i++) {
+        iHashSet.Finalize(sets[i]);
+        iHashSet.Finalize(copies[i]);
+    }
+    iHashSet.Finalize(all);
+    free(sets);
+    free(copies);
+}
+
+static void benchValueSetOpsOnce(SetBenchInput *input, SetBenchCost *cost) {
+    int n = input->nSets, i, j;
+    ValueSet **sets = (ValueSet **)malloc(n * sizeof(ValueSet *));
+    ValueSet **copies = (ValueSet **)malloc(n * sizeof(ValueSet *));
+    for (i = 0; i < n; i++) {
+        sets[i] = iValueSet.Create();
+        copies[i] = iValueSet.Create();
+        for (j = 0; j < input->nValues[i]; j++) {
+            iValueSet.Add(sets[i], input->values[i][j]);
+            iValueSet.Add(copies[i], input->values[i][input->nValues[i] - 1 - j]);
+        }
+    }
+
+    double start = wallClockMs();
+    ValueSet *all = iValueSet.Create();
+    for (i = 0; i < n; i++) {
+        iValueSet.AddAll(all, sets[i]);
+    }
+    cost->checksum += iValueSet.Size(all);
+    cost->unionAll = wallClockMs() - start;
+
+    start = wallClockMs();
+    for (i = 0; i < n; i++) {
+        cost->checksum += iValueSet.Intersects(sets[i], sets[(i + 1) % n]);
+    }
+    cost->intersects = wallClockMs() - start;
+
+    start = wallClockMs();
+    for (i = 0; i < n; i++) {
+        cost->checksum += iValueSet.ContainsAll(all, sets[i]);
+    }
+    cost->subset = wallClockMs() - start;
+
+    start = wallClockMs();
+    for (i = 0; i < n; i++) {
+        cost->checksum += iValueSet.Equal(sets[i], copies[i]);
+        cost->checksum += iValueSet.Equal(sets[i], sets[(i + 1) % n]);
+    }
+    cost->equal = wallClockMs() - start;
+
+    for (i = 0; i < n; i++) {
+        iValueSet.Finalize(sets[i]);
+        iValueSet.Finalize(copies[i]);
+    }
+    iValueSet.Finalize(all);
+    free(sets);
+    free(copies);
+}
+
+/**
+ * Run a value-set benchmark @{repeat} times, and keep the minimum cost of each operation
+ */
+static SetBenchCost benchSetOps(char *name, SetBenchFn fn, SetBenchInput *input, int repeat) {
+    SetBenchCost best = {-1, -1, -1, -1, 0}, cost;
+    int i;
+    for (i = 0; i < repeat; i++) {
+        cost.checksum = 0;
+        fn(input, &cost);
+        if (best.unionAll < 0 || cost.unionAll < best.unionAll) {
+            best.unionAll = cost.unionAll;
+        }
+        if (best.intersects < 0 || cost.intersects < best.intersects) {
+            best.intersects = cost.intersects;
+        }
+        if (best.subset < 0 || cost.subset < best.subset) {
+            best.subset = cost.subset;
+        }
+        if (best.equal < 0 || cost.equal < best.equal) {
+            best.equal = cost.equal;
+        }
+        best.checksum = cost.checksum;
+    }
+    printf("%-14s union => %8.3fms, intersects => %8.3fms, subset => %8.3fms, equal => %8.3fms\n",
+           name, best.unionAll, best.intersects, best.subset, best.equal);
+    return best;
+}
+
+/**
+ * Compare HashSet with the bitset ValueSet on the set algebra used by the slicing and the translation.
+ * Each set holds a random subset of a domain 0..d-1, either sparse like the values allowed by a condition
+ * or dense like a reachable domain.
+ */
+static int benchValueSets(int repeat) {
+    SetBenchInput input;
+    SetBenchCost hashCost, valueCost;
+    int i, j, k, d, same = 1;
+    input.nSets = SET_BENCH_SETS;
+    input.values = (int **)malloc(SET_BENCH_SETS * sizeof(int *));
+    input.nValues = (int *)malloc(SET_BENCH_SETS * sizeof(int));
+    srand(1);
+    for (k = 0; k < (int)(sizeof(setBenchDomains) / sizeof(int)); k++) {
+        d = setBenchDomains[k];
+        for (i = 0; i < SET_BENCH_SETS; i++) {
+            input.values[i] = (int *)malloc(d * sizeof(int));
+            input.nValues[i] = 0;
+            for (j = 0; j < d; j++) {
+                // Every other set is sparse
+                if (rand() % (i % 2 ? 8 : 2) == 0) {
+                    input.values[i][input.nValues[i]++] = j;
+                }
+            }
+        }
+        printf("domain size %d (%d sets):\n", d, SET_BENCH_SETS);
+        hashCost = benchSetOps("HashSet", benchHashSetOpsOnce, &input, repeat);
+        valueCost = benchSetOps("ValueSet", benchValueSetOpsOnce, &input, repeat);
+        printf("%-14s speedup => union %.2fx, intersects %.2fx, subset %.2fx, equal %.2fx, same result => %s\n", "ValueSet",
+               hashCost.unionAll / valueCost.unionAll, hashCost.intersects / valueCost.intersects,
+               hashCost.subset / valueCost.subset, hashCost.equal / valueCost.equal,
+               hashCost.checksum == valueCost.checksum ? "yes" : "NO");
+        same = same && hashCost.checksum == valueCost.checksum;
+        for (i = 0; i < SET_BENCH_SETS; i++) {
+            free(input.values[i]);
+        }
+    }
+    free(input.values);
+    free(input.nValues);
+    return same ? 0 : 1;
+}
+
+/*
+ * The numbers of calls to the allocation functions. The bench executable is linked with
+ * -Wl,--wrap=malloc,... so that the calls made by the analysis are routed through the wrappers below.
+ */
+static long nAllocs, nFrees;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t n, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+void __real_free(void *ptr);
+
+void *__wrap_malloc(size_t size) {
+    nAllocs++;
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t n, size_t size) {
+    nAllocs++;
+    return __real_calloc(n, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size) {
+    if (ptr == NULL) {
+        nAllocs++;
+    }
+    return __real_realloc(ptr, size);
+}
+
+void __wrap_free(void *ptr) {
+    if (ptr != NULL) {
+        nFrees++;
+    }
+    __real_free(ptr);
+}
+
+/* The allocations and the cost of a phase of the analysis */
+typedef struct _AllocBenchPhase {
+    char *name;
+    long allocs;
+    long frees;
+    double cost;
+} AllocBenchPhase;
+
+static void startPhase(AllocBenchPhase *phase, char *name) {
+    phase->name = name;
+    phase->allocs = nAllocs;
+    phase->frees = nFrees;
+    phase->cost = wallClockMs();
+}
+
+static void endPhase(AllocBenchPhase *phase) {
+    phase->allocs = nAllocs - phase->allocs;
+    phase->frees = nFrees - phase->frees;
+    phase->cost = wallClockMs() - phase->cost;
+}
+
+/**
+ * Count the heap allocations made by each phase of the analysis of an instance: pruning, translation,
+ * and the abstraction refinement, where every sub-policy is sliced and translated and then refined
+ * as if the model checker reported it safe.
+ */
+static int benchAllocations(char *instFile) {
+    ACoACInstance *pInst = readACoACInstanceMmap(instFile, 1);
+    if (pInst == NULL) {
+        printf("Failed to read %s\n", instFile);
+        return 1;
+    }
+    char smvPath[] = "/tmp/coachecker_bench_XXXXXX";
+    int fd = mkstemp(smvPath);
+    if (fd < 0) {
+        printf("Failed to create a temporary file\n");
+        return 1;
+    }
+    close(fd);
+
+    AllocBenchPhase phases[3];
+    int nPhases = 0, rounds = 0;
+    ACoACResult result = {.code = ACoAC_RESULT_UNKNOWN};
+    startPhase(&phases[nPhases], "pruning");
+    init(pInst);
+    pInst = userCleaning(pInst);
+    pInst = sliceIncremental(pInst, &result);
+    endPhase(&phases[nPhases++]);
+
+    if (result.code == ACoAC_RESULT_UNKNOWN) {
+        startPhase(&phases[nPhases], "translation");
+        translate(pInst, smvPath, 1);
+        endPhase(&phases[nPhases++]);
+
+        startPhase(&phases[nPhases], "refinement");
+        AbsRef *pAbsRef = createAbsRef(pInst);
+        ACoACInstance *next = abstract(pAbsRef);
+        while (next != NULL) {
+            rounds++;
+            result.code = ACoAC_RESULT_UNKNOWN;
+            next = sliceIncremental(next, &result);
+            if (result.code == ACoAC_RESULT_REACHABLE) {
+                break;
+            }
+            if (result.code == ACoAC_RESULT_UNKNOWN) {
+                translate(next, smvPath, 1);
+            }
+            finalizeSubPolicy(pAbsRef, next);
+            next = refine(pAbsRef);
+        }
+        endPhase(&phases[nPhases++]);
+    }
+    remove(smvPath);
+
+    printf("\n%s:\n", instFile);
+    int i;
+    for (i = 0; i < nPhases; i++) {
+        printf("%-12s allocations => %10ld, frees => %10ld, cost => %8.2fms\n", phases[i].name, phases[i].allocs, phases[i].frees, phases[i].cost);
+    }
+    printf("refinement rounds => %d\n", rounds);
+    return 0;
+}
+
+/**
+ * Write the result of slicing an instance in a canonical form: the result code, and if it is unknown,
+ * the query, the domains and the initial state by attribute, and the rules with their discretized conditions by index.
+ *
+ * @param fp[in]: The file to write
+ * @param pInst[in]: The sliced instance
+ * @param pResult[in]: The result of slicing
+ */
+static void dumpSliceResult(FILE *fp, ACoACInstance *pInst, ACoACResult *pResult) {
+    fprintf(fp, "result: %d\n", pResult->code);
+    if (pResult->code != ACoAC_RESULT_UNKNOWN) {
+        return;
+    }
+    int nAttrs = istrCollection.Size(pscAttrs), attrIdx, *pValIdx, i;
+    HashMap *pmapInitState = iHashBasedTable.GetRow(pInst->pTableInitState, &pInst->queryUserIdx);
+    ValueSet **ppSetDom;
+    ValueSetIterator itVals;
+    char *str;
+    for (attrIdx = 0; attrIdx < nAttrs; attrIdx++) {
+        if ((pValIdx = (int *)iIntMap.Get(pInst->pmapQueryAVs, attrIdx)) != NULL) {
+            fprintf(fp, "query %d: %d\n", attrIdx, *pValIdx);
+        }
+        if ((ppSetDom = (ValueSet **)iIntMap.Get(pInst->pMapAttr2Dom, attrIdx)) != NULL) {
+            fprintf(fp, "domain %d:", attrIdx);
+            iValueSet.InitIterator(*ppSetDom, &itVals);
+            while (iValueSet.Next(&itVals)) {
+                fprintf(fp, " %d", itVals.value);
+            }
+            fprintf(fp, "\n");
+        }
+        if (pmapInitState != NULL && (pValIdx = (int *)iHashMap.Get(pmapInitState, &attrIdx)) != NULL) {
+            fprintf(fp, "init %d: %d\n", attrIdx, *pValIdx);
+        }
+    }
+
+    int nRules = iHashSet.Size(pInst->pSetRuleIdxes);
+    int *ruleIdxes = (int *)malloc((nRules + 1) * sizeof(int));
+    HashSetIterator itRuleIdxes;
+    iHashSet.InitIterator(pInst->pSetRuleIdxes, &itRuleIdxes);
+    for (i = 0; itRuleIdxes.HasNext(&itRuleIdxes); i++) {
+        ruleIdxes[i] = *(int *)itRuleIdxes.GetNext(&itRuleIdxes);
+    }
+    qsort(ruleIdxes, nRules, sizeof(int), compareInts);
+    Rule *pRule;
+    for (i = 0; i < nRules; i++) {
+        pRule = (Rule *)iVector.GetElement(pVecRules, ruleIdxes[i]);
+        str = RuleToString(&pRule);
+        fprintf(fp, "rule %d: %s\n", ruleIdxes[i], str);
+        free(str);
+    }
+    free(ruleIdxes);
+}
+
+typedef ACoACInstance *(*Slicer)(ACoACInstance *pInst, ACoACResult *pResult);
+
+/**
+ * Read an instance and slice it with a slicer. If @{fpDump} is not NULL, the sub-policies of the abstraction
+ * refinement are sliced as well, every sub-policy being refined as if the model checker reported it safe,
+ * and all the results are written to @{fpDump}.
+ *
+ * @return The cost of slicing the instance in milliseconds, or -1 if failed
+ */
+static double runSlicer(Slicer slicer, char *instFile, FILE *fpDump) {
+    ACoACInstance *pInst = readACoACInstanceMmap(instFile, 1);
+    if (pInst == NULL) {
+        printf("Failed to read %s\n", instFile);
+        return -1;
+    }
+    ACoACResult result = {.code = ACoAC_RESULT_UNKNOWN};
+    init(pInst);
+    pInst = userCleaning(pInst);
+    double start = wallClockMs();
+    pInst = slicer(pInst, &result);
+    double cost = wallClockMs() - start;
+
+    if (fpDump != NULL) {
+        dumpSliceResult(fpDump, pInst, &result);
+    }
+    if (fpDump == NULL || result.code != ACoAC_RESULT_UNKNOWN) {
+        finalizeACoACInstance(pInst);
+        finalizeGlobalVars();
+        return cost;
+    }
+
+    AbsRef *pAbsRef = createAbsRef(pInst);
+    ACoACInstance *next = abstract(pAbsRef);
+    int round = 0;
+    while (next != NULL) {
+        result.code = ACoAC_RESULT_UNKNOWN;
+        next = slicer(next, &result);
+        fprintf(fpDump, "round %d\n", ++round);
+        dumpSliceResult(fpDump, next, &result);
+        if (result.code == ACoAC_RESULT_REACHABLE) {
+            finalizeSubPolicy(pAbsRef, next);
+            break;
+        }
+        finalizeSubPolicy(pAbsRef, next);
+        next = refine(pAbsRef);
+    }
+
+    // The sub-policies are pruned with a fork of the global rules, which finalizeGlobalVars releases
+    finalizeACoACInstance(pInst);
+    finalizeGlobalVars();
+    return cost;
+}
+
+/**
+ * Compare the incremental slicer sliceIncremental with slice, each on one thread and on @{nThreads} threads:
+ * the cost of slicing the instance, and whether they give the same results as the serial slice on the instance
+ * and on the sub-policies of the abstraction refinement.
+ */
+static int benchSlicers(char *instFile, int repeat, int nThreads) {
+    char dumps[4][64];
+    char names[4][32];
+    Slicer slicers[4] = {slice, sliceIncremental, slice, sliceIncremental};
+    int threads[4] = {1, 1, nThreads, nThreads};
+    FILE *fp;
+    double cost, total, min;
+    int i, k, fd, same = 1;
+    for (k = 0; k < 4; k++) {
+        sprintf(dumps[k], "/tmp/coachecker_bench_slice_XXXXXX");
+        if ((fd = mkstemp(dumps[k])) < 0) {
+            printf("Failed to create temporary files!\n");
+            return 1;
+        }
+        close(fd);
+        sprintf(names[k], "%s/%d-thread", k % 2 == 0 ? "slice" : "incremental", threads[k]);
+        setSlicingThreads(threads[k]);
+        total = 0;
+        min = -1;
+        for (i = 0; i < repeat; i++) {
+            fp = i == repeat - 1 ? fopen(dumps[k], "w") : NULL;
+            cost = runSlicer(slicers[k], instFile, fp);
+            if (fp != NULL) {
+                fclose(fp);
+            }
+            if (cost < 0) {
+                return 1;
+            }
+            total += cost;
+            if (min < 0 || cost < min) {
+                min = cost;
+            }
+        }
+        printf("%-20s slicing: avg => %.2fms, min => %.2fms (%d rounds)\n", names[k], total / repeat, min, repeat);
+    }
+    setSlicingThreads(1);
+    for (k = 1; k < 4; k++) {
+        if (!sameContent(dumps[0], dumps[k])) {
+            printf("%s: %s differs from %s\n", instFile, names[k], names[0]);
+            same = 0;
+        }
+    }
+    printf("%s: same result => %s\n", instFile, same ? "yes" : "NO");
+    for (k = 0; k < 4; k++) {
+        remove(dumps[k]);
+    }
+    return same ? 0 : 1;
+}
+
+/**
+ * The reference check of userCleaning: scan the initial state of every user, and then a user with the default
+ * values only, for one satisfying the conjunctive condition @{pCond}
+ */
+static int scanUsers(ACoACInstance *pInst, HashSet *pCond) {
+    HashNodeIterator it;
+    HashSetIterator itCond;
+    AtomCondition *pAtomCond;
+    HashMap *pmapAVs;
+    int *pValIdx, effective, defaultUser = 0;
+    iHashMap.InitIterator(pInst->pTableInitState->pRowMap, &it);
+    while (!defaultUser) {
+        defaultUser = !it.HasNext(&it);
+        pmapAVs = defaultUser ? NULL : *(HashMap **)((HashNode *)it.GetNext(&it))->value;
+        effective = 1;
+        iHashSet.InitIterator(pCond, &itCond);
+        while (effective && itCond.HasNext(&itCond)) {
+            pAtomCond = (AtomCondition *)itCond.GetNext(&itCond);
+            if (pmapAVs == NULL || (pValIdx = (int *)iHashMap.Get(pmapAVs, &pAtomCond->attribute)) == NULL) {
+                pValIdx = (int *)iIntMap.Get(pmapAttr2DefVal, pAtomCond->attribute);
+            }
+            effective = iAtomCondition.Evaluate(pAtomCond, *pValIdx);
+        }
+        if (effective) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Compare the bitmap index of the initial state with scanning the users, on the distinct administrator
+ * conditions of the rules of an instance, which is the check of userCleaning
+ */
+static int benchUserIndex(char *instFile, int repeat) {
+    ACoACInstance *pInst = readACoACInstanceMmap(instFile, 1);
+    if (pInst == NULL) {
+        printf("Failed to read %s\n", instFile);
+        return 1;
+    }
+    init(pInst);
+
+    // The distinct administrator conditions of the rules
+    int nConds = iVector.Size(pVecConds), nAdminConds = 0, i, k, ruleIdx;
+    int *adminConds = (int *)malloc((nConds + 1) * sizeof(int));
+    char *seen = (char *)calloc(nConds + 1, 1);
+    HashSetIterator itRuleIdxes;
+    iHashSet.InitIterator(pInst->pSetRuleIdxes, &itRuleIdxes);
+    while (itRuleIdxes.HasNext(&itRuleIdxes)) {
+        ruleIdx = *(int *)itRuleIdxes.GetNext(&itRuleIdxes);
+        k = ((Rule *)iVector.GetElement(pVecRules, ruleIdx))->adminCondIdx;
+        if (!seen[k]) {
+            seen[k] = 1;
+            adminConds[nAdminConds++] = k;
+        }
+    }
+    printf("%d users, %d rows of initial state, %d distinct administrator conditions\n", (int)iVector.Size(pInst->pVecUserIndices),
+           (int)iHashMap.Size(pInst->pTableInitState->pRowMap), nAdminConds);
+
+    char *scanResult = (char *)malloc(nAdminConds + 1), *indexResult = (char *)malloc(nAdminConds + 1);
+    double start, cost, totals[3] = {0, 0, 0}, mins[3] = {-1, -1, -1};
+    UserIndex *pUserIndex;
+    InitState *pInitState;
+    IntervalTest *tests;
+    int nTests;
+    for (i = 0; i < repeat; i++) {
+        // The columns are built by init, they are rebuilt here only to be timed
+        start = wallClockMs();
+        pInitState = iInitState.Create(pInst->pTableInitState, istrCollection.Size(pscUsers), istrCollection.Size(pscAttrs), pmapAttr2DefVal);
+        cost = wallClockMs() - start;
+        iInitState.Finalize(pInitState);
+        totals[2] += cost;
+        mins[2] = mins[2] < 0 || cost < mins[2] ? cost : mins[2];
+
+        start = wallClockMs();
+        for (k = 0; k < nAdminConds; k++) {
+            scanResult[k] = scanUsers(pInst, getCondition(adminConds[k]));
+        }
+        cost = wallClockMs() - start;
+        totals[0] += cost;
+        mins[0] = mins[0] < 0 || cost < mins[0] ? cost : mins[0];
+
+        start = wallClockMs();
+        pUserIndex = iUserIndex.Create(pInst->pInitState);
+        for (k = 0; k < nAdminConds; k++) {
+            tests = getConditionTests(adminConds[k], &nTests);
+            indexResult[k] = iUserIndex.IsSatisfiable(pUserIndex, tests, nTests);
+        }
+        iUserIndex.Finalize(pUserIndex);
+        cost = wallClockMs() - start;
+        totals[1] += cost;
+        mins[1] = mins[1] < 0 || cost < mins[1] ? cost : mins[1];
+    }
+    int nSatisfiable = 0, same = 1;
+    for (k = 0; k < nAdminConds; k++) {
+        nSatisfiable += indexResult[k];
+        same = same && scanResult[k] == indexResult[k];
+    }
+    printf("scan   : avg => %.2fms, min => %.2fms (%d rounds)\n", totals[0] / repeat, mins[0], repeat);
+    printf("bitmap : avg => %.2fms, min => %.2fms (%d rounds), speedup => %.2fx\n", totals[1] / repeat, mins[1], repeat,
+           mins[1] > 0 ? mins[0] / mins[1] : 0);
+    printf("columns: avg => %.2fms, min => %.2fms (%d rounds), built once by init\n", totals[2] / repeat, mins[2], repeat);
+    printf("%d of %d administrator conditions are satisfiable\n", nSatisfiable, nAdminConds);
+    printf("%s: same result => %s\n", instFile, same ? "yes" : "NO");
+
+    free(adminConds);
+    free(seen);
+    free(scanResult);
+    free(indexResult);
+    finalizeACoACInstance(pInst);
+    finalizeGlobalVars();
+    return same ? 0 : 1;
+}
+
+/**
+ * Compare evaluating the atomic conditions of all conditions of an instance over the domains of their attributes
+ * value by value with the interval tests they are compiled to, which is the first step of DiscreteCond
+ */
+static int benchAtomEval(char *instFile, int repeat) {
+    ACoACInstance *pInst = readACoACInstanceMmap(instFile, 1);
+    if (pInst == NULL) {
+        printf("Failed to read %s\n", instFile);
+        return 1;
+    }
+    init(pInst);
+
+    int nConds = iVector.Size(pVecConds), nAtoms = 0, nTests, condIdx, i, j, k, same = 1;
+    for (condIdx = 0; condIdx < nConds; condIdx++) {
+        getConditionTests(condIdx, &nTests);
+        nAtoms += nTests;
+    }
+    printf("%d conditions, %d atomic conditions\n", nConds, nAtoms);
+
+    // The effective values of the k-th atomic condition, by the reference evaluation and by the interval test
+    ValueSet **refSets = (ValueSet **)malloc((nAtoms + 1) * sizeof(ValueSet *));
+    ValueSet **testSets = (ValueSet **)malloc((nAtoms + 1) * sizeof(ValueSet *));
+    for (k = 0; k < nAtoms; k++) {
+        refSets[k] = iValueSet.Create();
+        testSets[k] = iValueSet.Create();
+    }
+    HashSetIterator itCond;
+    ValueSetIterator itDom;
+    AtomCondition *pAtomCond;
+    IntervalTest *tests;
+    ValueSet **pDom;
+    double start, cost, totals[2] = {0, 0}, mins[2] = {-1, -1};
+    for (i = 0; i < repeat; i++) {
+        start = wallClockMs();
+        for (condIdx = 0, k = 0; condIdx < nConds; condIdx++) {
+            iHashSet.InitIterator(getCondition(condIdx), &itCond);
+            while (itCond.HasNext(&itCond)) {
+                pAtomCond = (AtomCondition *)itCond.GetNext(&itCond);
+                iValueSet.Clear(refSets[k]);
+                if ((pDom = (ValueSet **)iIntMap.Get(pInst->pMapAttr2Dom, pAtomCond->attribute)) != NULL) {
+                    iValueSet.InitIterator(*pDom, &itDom);
+                    while (iValueSet.Next(&itDom)) {
+                        if (iAtomCondition.Evaluate(pAtomCond, itDom.value)) {
+                            iValueSet.Add(refSets[k], itDom.value);
+                        }
+                    }
+                }
+                k++;
+            }
+        }
+        cost = wallClockMs() - start;
+        totals[0] += cost;
+        mins[0] = mins[0] < 0 || cost < mins[0] ? cost : mins[0];
+
+        start = wallClockMs();
+        for (condIdx = 0, k = 0; condIdx < nConds; condIdx++) {
+            tests = getConditionTests(condIdx, &nTests);
+            for (j = 0; j < nTests; j++, k++) {
+                iValueSet.Clear(testSets[k]);
+                if ((pDom = (ValueSet **)iIntMap.Get(pInst->pMapAttr2Dom, tests[j].attribute)) != NULL) {
+                    iValueSet.AddAllInRange(testSets[k], *pDom, tests[j].lo, tests[j].hi, tests[j].negated);
+                }
+            }
+        }
+        cost = wallClockMs() - start;
+        totals[1] += cost;
+        mins[1] = mins[1] < 0 || cost < mins[1] ? cost : mins[1];
+    }
+    for (k = 0; k < nAtoms; k++) {
+        same = same && iValueSet.Equal(refSets[k], testSets[k]);
+        iValueSet.Finalize(refSets[k]);
+        iValueSet.Finalize(testSets[k]);
+    }
+    printf("evaluate: avg => %.2fms, min => %.2fms (%d rounds)\n", totals[0] / repeat, mins[0], repeat);
+    printf("interval: avg => %.2fms, min => %.2fms (%d rounds), speedup => %.2fx\n", totals[1] / repeat, mins[1], repeat,
+           mins[1] > 0 ? mins[0] / mins[1] : 0);
+    printf("%s: same result => %s\n", instFile, same ? "yes" : "NO");
+
+    free(refSets);
+    free(testSets);
+    finalizeACoACInstance(pInst);
+    finalizeGlobalVars();
+    return same ? 0 : 1;
+}
+
+/**
+ * Mark the nodes reachable from @{from} along the edges of one direction by a plain depth-first search, the
+ * reference of the SCCs and the reachability queries of the dependency graph
+ */
+static void searchDepGraph(DepGraph *g, int *start, int *adj, int from, char *visited, int *stack) {
+    int top = 0, u, e;
+    memset(visited, 0, g->nNodes + 1);
+    visited[from] = 1;
+    stack[top++] = from;
+    while (top > 0) {
+        u = stack[--top];
+        for (e = start[u]; e < start[u + 1]; e++) {
+            if (!visited[adj[e]]) {
+                visited[adj[e]] = 1;
+                stack[top++] = adj[e];
+            }
+        }
+    }
+}
+
+/**
+ * Measure building the dependency graph of the rules of an instance after their conditions are discretized over
+ * the domains, and check its SCCs, their topological order and the reachability queries against depth-first search
+ * from a sample of the nodes
+ */
+static int benchDepGraph(char *instFile, int repeat) {
+    ACoACInstance *pInst = readACoACInstanceMmap(instFile, 1);
+    if (pInst == NULL) {
+        printf("Failed to read %s\n", instFile);
+        return 1;
+    }
+    init(pInst);
+    pInst = userCleaning(pInst);
+    HashSetIterator itRules;
+    iHashSet.InitIterator(pInst->pSetRuleIdxes, &itRules);
+    while (itRules.HasNext(&itRules)) {
+        iRule.DiscreteCond((Rule *)iVector.GetElement(pVecRules, *(int *)itRules.GetNext(&itRules)), pInst->pMapAttr2Dom);
+    }
+    CSRIndex *pIndexTarget = getTargetAV2RuleIndex(pInst), *pIndexPrecond = getPrecond2RuleIndex(pInst);
+
+    Arena *arena = iArena.Acquire();
+    DepGraph *g = NULL;
+    double start, cost, total = 0, min = -1;
+    int i;
+    for (i = 0; i < repeat; i++) {
+        iArena.Reset(arena);
+        start = wallClockMs();
+        g = iDepGraph.Build(arena, pIndexTarget, pIndexPrecond);
+        cost = wallClockMs() - start;
+        total += cost;
+        min = min < 0 || cost < min ? cost : min;
+    }
+    int nCyclic = 0, maxSCC = 0, u, v, e, k, same = 1;
+    for (u = 0; u < g->nNodes; u++) {
+        nCyclic += iDepGraph.InCycle(g, u);
+    }
+    for (k = 0; k < g->nSCCs; k++) {
+        maxSCC = g->sccStart[k + 1] - g->sccStart[k] > maxSCC ? g->sccStart[k + 1] - g->sccStart[k] : maxSCC;
+    }
+    printf("%d nodes, %d edges, %d SCCs, largest SCC => %d nodes, nodes on cycles => %d\n", g->nNodes, g->nEdges, g->nSCCs,
+           maxSCC, nCyclic);
+    printf("build: avg => %.2fms, min => %.2fms (%d rounds)\n", total / repeat, min, repeat);
+
+    // Every edge goes forward in the topological order of the SCCs
+    for (u = 0; u < g->nNodes; u++) {
+        for (e = g->outStart[u]; e < g->outStart[u + 1]; e++) {
+            same = same && g->sccOf[u] <= g->sccOf[g->outAdj[e]];
+        }
+    }
+    // The SCC of a node is the set of nodes both reachable from it and reaching it
+    char *fwd = (char *)malloc(g->nNodes + 1), *bwd = (char *)malloc(g->nNodes + 1);
+    int *stack = (int *)malloc((g->nNodes + 1) * sizeof(int));
+    int nSamples = g->nNodes < 100 ? g->nNodes : 100, nQueries = 0;
+    srand(1);
+    start = wallClockMs();
+    for (i = 0; i < nSamples; i++) {
+        u = nSamples == g->nNodes ? i : rand() % g->nNodes;
+        searchDepGraph(g, g->outStart, g->outAdj, u, fwd, stack);
+        searchDepGraph(g, g->inStart, g->inAdj, u, bwd, stack);
+        for (v = 0; v < g->nNodes; v++) {
+            same = same && (fwd[v] && bwd[v]) == (g->sccOf[v] == g->sccOf[u]);
+        }
+        for (k = 0; k < 20; k++) {
+            v = rand() % g->nNodes;
+            same = same && iDepGraph.IsReachable(g, u, v) == fwd[v];
+            nQueries++;
+        }
+    }
+    printf("checked %d nodes and %d reachability queries, cost => %.2fms\n", nSamples, nQueries, wallClockMs() - start);
+    printf("%s: same result => %s\n", instFile, same ? "yes" : "NO");
+
+    free(fwd);
+    free(bwd);
+    free(stack);
+    iArena.Release(arena);
+    finalizeACoACInstance(pInst);
+    finalizeGlobalVars();
+    return same ? 0 : 1;
+}
+
+typedef struct _RefineBenchCost {
+    ACoACResult result;
+    int rounds;
+    int nCalls;
+    // The number of rules of the last sub-policy model checked
+    int nRules;
+    double mcCost;
+    double cost;
+} RefineBenchCost;
+
+/**
+ * Verify an instance by abstraction refinement with a refinement strategy, calling the model checker in SMC mode on
+ * every pruned sub-policy as a single cluster, and count the rounds and the calls to the model checker. With
+ * adaptiveSteps, the steps of the rule-selection strategies are adapted to the rounds reported so far.
+ *
+ * @return 0 if success, 1 otherwise
+ */
+static int runRefinement(RefineStrategy strategy, int adaptiveSteps, char *instFile, char *modelCheckerPath, char *smvPath, char *outputPath,
+                         RefineBenchCost *cost) {
+    ACoACInstance *pInst = readACoACInstanceMmap(instFile, 1);
+    if (pInst == NULL) {
+        printf("Failed to read %s\n", instFile);
+        return 1;
+    }
+    memset(cost, 0, sizeof(RefineBenchCost));
+    ACoACResult result = {.code = ACoAC_RESULT_UNKNOWN};
+    double start = wallClockMs(), startCall;
+    init(pInst);
+    pInst = userCleaning(pInst);
+    pInst = sliceIncremental(pInst, &result);
+
+    int *probeAttrs = NULL, *probeVals = NULL, nProbes = 0;
+    char *output, *reachable;
+    double mcCost;
+    if (result.code == ACoAC_RESULT_UNKNOWN) {
+        AbsRef *pAbsRef = createAbsRef(pInst);
+        pAbsRef->strategy = strategy;
+        pAbsRef->adaptiveSteps = adaptiveSteps;
+        ACoACInstance *next = abstract(pAbsRef);
+        while (next != NULL) {
+            cost->rounds++;
+            result.code = ACoAC_RESULT_UNKNOWN;
+            mcCost = 0;
+            next = sliceIncremental(next, &result);
+            if (result.code == ACoAC_RESULT_UNKNOWN) {
+                compressDomains(next);
+                if (strategy == REFINE_CEGAR) {
+                    nProbes = getProbeAVs(next, &probeAttrs, &probeVals);
+                }
+                translateWithProbes(next, smvPath, 1, probeAttrs, probeVals, nProbes);
+                cost->nRules = iHashSet.Size(next->pSetRuleIdxes);
+                startCall = wallClockMs();
+                output = runModelChecker(modelCheckerPath, smvPath, outputPath, REFINE_BENCH_TIMEOUT, NULL);
+                mcCost = wallClockMs() - startCall;
+                cost->mcCost += mcCost;
+                cost->nCalls++;
+                reachable = NULL;
+                if (probeAttrs != NULL) {
+                    reachable = (char *)malloc(nProbes + 1);
+                    if (analyzeProbeResults(output, nProbes, reachable) != 0) {
+                        free(reachable);
+                        reachable = NULL;
+                    }
+                }
+                result = analyzeModelCheckerOutput(output, next, NULL, 0);
+                free(output);
+                if (probeAttrs != NULL) {
+                    addReachableAVs(pAbsRef, next, probeAttrs, probeVals, reachable, nProbes);
+                    free(reachable);
+                    free(probeAttrs);
+                    free(probeVals);
+                    probeAttrs = probeVals = NULL;
+                }
+            }
+            reportRound(pAbsRef, pAbsRef->round, mcCost > 0 ? iHashSet.Size(next->pSetRuleIdxes) : 0, mcCost);
+            finalizeSubPolicy(pAbsRef, next);
+            if (result.code != ACoAC_RESULT_UNREACHABLE) {
+                break;
+            }
+            next = refine(pAbsRef);
+        }
+    }
+    cost->cost = wallClockMs() - start;
+    cost->result = result;
+
+    finalizeACoACInstance(pInst);
+    finalizeGlobalVars();
+    return 0;
+}
+
+/**
+ * Compare the refinement strategies: the rounds of abstraction refinement and the calls to the model checker needed
+ * to verify the instance with widening, with widening by adaptive steps and with the counterexample-guided refinement,
+ * and whether the verdicts are the same.
+ */
+static int benchRefineStrategies(char *instFile, char *modelCheckerPath) {
+    char smvPath[] = "/tmp/coachecker_bench_XXXXXX";
+    char outputPath[] = "/tmp/coachecker_bench_out_XXXXXX";
+    int fd1 = mkstemp(smvPath), fd2 = mkstemp(outputPath);
+    if (fd1 < 0 || fd2 < 0) {
+        printf("Failed to create a temporary file\n");
+        return 1;
+    }
+    close(fd1);
+    close(fd2);
+
+    RefineStrategy strategies[3] = {REFINE_WIDEN, REFINE_WIDEN, REFINE_CEGAR};
+    int adaptiveSteps[3] = {0, 1, 0};
+    char *names[3] = {"widen", "adapt", "cegar"};
+    RefineBenchCost costs[3];
+    int k, failed = 0;
+    for (k = 0; k < 3 && !failed; k++) {
+        failed = runRefinement(strategies[k], adaptiveSteps[k], instFile, modelCheckerPath, smvPath, outputPath, &costs[k]);
+    }
+    remove(smvPath);
+    remove(outputPath);
+    if (failed) {
+        return 1;
+    }
+
+    printf("\n%s:\n", instFile);
+    for (k = 0; k < 3; k++) {
+        printf("%-6s result => %2d, rounds => %3d, model checker calls => %3d, rules checked last => %6d, model checking => %9.2fms, total => %9.2fms\n",
+               names[k], costs[k].result.code, costs[k].rounds, costs[k].nCalls, costs[k].nRules, costs[k].mcCost, costs[k].cost);
+        if (costs[k].result.pVecActions != NULL) {
+            iVector.Finalize(costs[k].result.pVecActions);
+        }
+    }
+    int same = costs[0].result.code == costs[1].result.code && costs[0].result.code == costs[2].result.code;
+    printf("same result => %s\n", same ? "yes" : "NO");
+    return same ? 0 : 1;
+}
+
+int main(int argc, char *argv[]) {
+    char *helpMessage = "Usage: %s <option> <argument>\n"
+                        "Options:\n"
+                        "  -b, --bench <arg>            The component to benchmark\n"
+                        "  -i, --instance-file <arg>    The file of ACoAC-safety instance\n"
+                        "  -n, --repeat <arg>           The number of rounds (default 5)\n"
+                        "  -j, --threads <arg>          The (maximum) number of threads (default: number of cores)\n"
+                        "  -m, --model-checker <arg>    The path of the model checker, for the refine benchmark\n"
+                        "Benchmarks:\n"
+                        "  reader                       Compare the stdio, mmap and compiled readers\n"
+                        "  parallel_reader              Scaling of the mmap reader with the number of threads\n"
+                        "  intmap                       Compare HashMap/HashSet with IntMap/IntSet on int keys\n"
+                        "  valueset                     Compare HashSet with the bitset ValueSet on set operations\n"
+                        "  alloc                        Count the heap allocations of each phase of the analysis\n"
+                        "  slice                        Compare the incremental slicer with slice, serial and parallel, on the instance and its sub-policies\n"
+                        "  userindex                    Compare the bitmap index of the initial state with scanning the users in userCleaning\n"
+                        "  atomeval                     Compare evaluating atomic conditions over the attribute domains value by value and as interval tests\n"
+                        "  depgraph                     Build the dependency graph of the rules and check its SCCs and reachability queries\n"
+                        "  refine                       Compare the rounds and the model checker calls of the widening, adaptive and counterexample-guided refinements\n";
+
+    static struct option long_options[] = {
+        {"bench", required_argument, 0, 'b'},
+        {"instance-file", required_argument, 0, 'i'},
+        {"repeat", required_argument, 0, 'n'},
+        {"threads", required_argument, 0, 'j'},
+        {"model-checker", required_argument, 0, 'm'},
+        {0, 0, 0, 0}};
+
+    char *benchType = NULL;
+    char *instFilePath = NULL;
+    char *modelCheckerPath = NULL;
+    int repeat = DEFAULT_REPEAT;
+    int nThreads = iThreadPool.NumCores();
+    int unrecognized = 0;
+
+    int c;
+    while (1) {
+        int option_index = 0;
+
+        c = getopt_long_only(argc, argv, "b:i:n:j:m:", long_options, &option_index);
+        if (c == -1)
+            break;
+        switch (c) {
+        case 'b':
+            benchType = optarg;
+            break;
+        case 'i':
+            instFilePath = optarg;
+            break;
+        case 'n':
+            repeat = atoi(optarg);
+            break;
+        case 'j':
+            nThreads = atoi(optarg);
+            break;
+        case 'm':
+            modelCheckerPath = optarg;
+            break;
+        default:
+            unrecognized = 1;
+            break;
+        }
+    }
+
+    if (unrecognized || benchType == NULL || repeat <= 0 || nThreads <= 0) {
+        printf("Unrecognized option or benchmark is not set!\n");
+        printf(helpMessage, argv[0]);
+        return 1;
+    }
+
+    if (strcmp(benchType, "reader") == 0 || strcmp(benchType, "parallel_reader") == 0 || strcmp(benchType, "alloc") == 0 ||
+        strcmp(benchType, "slice") == 0 || strcmp(benchType, "userindex") == 0 || strcmp(benchType, "atomeval") == 0 ||
+        strcmp(benchType, "depgraph") == 0 || strcmp(benchType, "refine") == 0) {
+        if (instFilePath == NULL) {
+            printf("Instance file is not specified!\n");
+            printf(helpMessage, argv[0]);
+            return 1;
+        }
+        if (strcmp(benchType, "reader") == 0) {
+            return benchReaders(instFilePath, repeat);
+        }
+        if (strcmp(benchType, "alloc") == 0) {
+            return benchAllocations(instFilePath);
+        }
+        if (strcmp(benchType, "slice") == 0) {
+            return benchSlicers(instFilePath, repeat, nThreads);
+        }
+        if (strcmp(benchType, "userindex") == 0) {
+            return benchUserIndex(instFilePath, repeat);
+        }
+        if (strcmp(benchType, "atomeval") == 0) {
+            return benchAtomEval(instFilePath, repeat);
+        }
+        if (strcmp(benchType, "depgraph") == 0) {
+            return benchDepGraph(instFilePath, repeat);
+        }
+        if (strcmp(benchType, "refine") == 0) {
+            if (modelCheckerPath == NULL) {
+                printf("Model checker is not specified!\n");
+                printf(helpMessage, argv[0]);
+                return 1;
+            }
+            return benchRefineStrategies(instFilePath, modelCheckerPath);
+        }
+        return benchParallelReader(instFilePath, repeat, nThreads);
+    }
+
+    if (strcmp(benchType, "intmap") == 0) {
+        return benchIntMaps(repeat);
+    }
+
+    if (strcmp(benchType, "valueset") == 0) {
+        return benchValueSets(repeat);
+    }
+
+    printf("Unknown benchmark: %s\n", benchType);
+    printf(helpMessage, argv[0]);
+    return 1;
+}
@@ -7,6 +7,9 @@
 
 #include "acoac_absref.h"
 #include "acoac_boundcal.h"
+#include "acoac_cache.h"
+#include "acoac_cluster.h"
+#include "acoac_domcomp.h"
 #include "acoac_io.h"
 #include "acoac_pruning.h"
 #include "acoac_translator.h"
@@ -16,6 +19,7 @@
 #include "hashset.h"
 #include "mc_runner.h"
 #include "precheck.h"
+#include "thread_pool.h"
 
 #define ACoAC_SUFFIX ".aabac"
 #define ACoAC_SUFFIX_LEN 6
@@ -23,6 +27,8 @@
 #define ARBAC_SUFFIX_LEN 6
 #define MOHAWK_SUFFIX ".mohawk"
 #define MOHAWK_SUFFIX_LEN 7
+#define COMPILED_SUFFIX ".aabin"
+#define COMPILED_SUFFIX_LEN 6
 #define SMV_SUFFIX ".smv"
 #define SMV_SUFFIX_LEN 4
 
@@ -41,32 +47,437 @@
 #define RESULT_SUFFIX ".txt"
 #define RESULT_SUFFIX_LEN 4
 
-static ACoACResult verify(char *modelCheckerPath, char *instFilePath, char *logDir, int doPrechecking,
-                          int doSlicing, int enableAbstractRefine, int useBMC, int tl, int showRules, long timeout) {
-    ACoACInstance *pInst = NULL;
+#define REFINE_TELEMETRY_FILE_NAME "refinementTelemetry.csv"
+#define REFINE_TELEMETRY_FILE_NAME_LEN 23
 
-    // read the instance file
+/**
+ * Read an instance file according to its suffix, i.e.,
+ * .aabac for ACoAC policies, .arbac/.mohawk for ARBAC policies, and .aabin for compiled policies
+ *
+ * @param instFilePath[in]: The path of the instance file
+ * @param nThreads[in]: The number of threads for parsing .aabac files, which are read with the stdio reader if it is 1
+ * @return The ACoAC instance, or NULL if failed
+ */
+static ACoACInstance *readInstanceFile(char *instFilePath, int nThreads) {
     int instFilePathLen = strlen(instFilePath);
     if (instFilePathLen >= ACoAC_SUFFIX_LEN && strcmp(instFilePath + instFilePathLen - ACoAC_SUFFIX_LEN, ACoAC_SUFFIX) == 0) {
         logACoAC(__func__, __LINE__, 0, INFO, "[start] parsing ACoAC instance file\n");
-        pInst = readACoACInstance(instFilePath);
+        // The memory-mapped reader is not faster on a single thread (see bench -b reader), since most of the time
+        // goes to interning the conditions, so it is only used to parse the rules in parallel
+        if (nThreads > 1) {
+            return readACoACInstanceMmap(instFilePath, nThreads);
+        }
+        return readACoACInstance(instFilePath);
     } else if ((instFilePathLen >= ARBAC_SUFFIX_LEN && strcmp(instFilePath + instFilePathLen - ARBAC_SUFFIX_LEN, ARBAC_SUFFIX) == 0) ||
                (instFilePathLen >= MOHAWK_SUFFIX_LEN && strcmp(instFilePath + instFilePathLen - MOHAWK_SUFFIX_LEN, MOHAWK_SUFFIX) == 0)) {
         logACoAC(__func__, __LINE__, 0, INFO, "[start] translating arbac instance file\n");
-        pInst = readARBACInstance(instFilePath);
-    } else {
-        logACoAC(__func__, __LINE__, 0, ERROR, "illegal file type\n");
-        return (ACoACResult){.code = ACoAC_RESULT_ERROR};
+        return readARBACInstance(instFilePath);
+    } else if (instFilePathLen >= COMPILED_SUFFIX_LEN && strcmp(instFilePath + instFilePathLen - COMPILED_SUFFIX_LEN, COMPILED_SUFFIX) == 0) {
+        logACoAC(__func__, __LINE__, 0, INFO, "[start] loading compiled instance file\n");
+        return readCompiledInstance(instFilePath);
+    }
+    logACoAC(__func__, __LINE__, 0, ERROR, "illegal file type\n");
+    return NULL;
+}
+
+/**
+ * Compile an instance file into the binary policy format, so that it can be loaded without parsing
+ *
+ * @param instFilePath[in]: The path of the instance file
+ * @param outputPath[in]: The path of the compiled file, or NULL to replace the suffix of @{instFilePath} with .aabin
+ * @param nThreads[in]: The number of threads for parsing the instance file
+ * @return 0 if success, 1 otherwise
+ */
+static int compile(char *instFilePath, char *outputPath, int nThreads) {
+    ACoACInstance *pInst = readInstanceFile(instFilePath, nThreads);
+    if (pInst == NULL) {
+        return 1;
+    }
+    char *compiledPath = outputPath;
+    if (compiledPath == NULL) {
+        char *dot = strrchr(instFilePath, '.');
+        int stemLen = dot != NULL ? dot - instFilePath : strlen(instFilePath);
+        compiledPath = (char *)malloc(stemLen + COMPILED_SUFFIX_LEN + 1);
+        sprintf(compiledPath, "%.*s%s", stemLen, instFilePath, COMPILED_SUFFIX);
+    }
+    int ret = writeCompiledInstance(pInst, compiledPath);
+    if (compiledPath != outputPath) {
+        free(compiledPath);
+    }
+    finalizeACoACInstance(pInst);
+    finalizeGlobalVars();
+    return ret ? 1 : 0;
+}
+
+/*
+ * The model checking of an instance: the NuSMV file it is translated to, the bound and the output of the model checker
+ */
+typedef struct _ModelCheckTask {
+    ACoACInstance *pInst;
+    char *modelCheckerPath;
+    char *nusmvFilePath;
+    char *resultFilePath;
+    long timeout;
+    int useBMC;
+    // Whether the bound exceeds the range of int, in which case INT_MAX is used as the bound
+    int tooLarge;
+    char boundStr[15];
+    char *output;
+    // The attribute values whose reachability is asked for the REFINE_CEGAR strategy (see getProbeAVs), probed in the
+    // NuSMV file in SMC mode, or NULL if they are not asked
+    int *probeAttrs;
+    int *probeVals;
+    int nProbes;
+} ModelCheckTask;
+
+/**
+ * Prepare the model checking of an instance: compress its domains, estimate the bound and translate it into
+ * a NuSMV file in the log directory
+ *
+ * @param task[out]: The model checking task
+ * @param pInst[in]: The instance
+ * @param fileTag[in]: The tag appended to the names of the NuSMV file and the result file
+ * @param doProbing[in]: Whether to ask the reachability of the attribute values of the instance, which must be sliced
+ * @return 0 if success, -1 otherwise
+ */
+static int prepareModelCheck(ModelCheckTask *task, ACoACInstance *pInst, char *modelCheckerPath, char *logDir, char *fileTag,
+                             int doSlicing, int doCompressing, int doProbing, int useBMC, int tl, long timeout) {
+    task->pInst = pInst;
+    task->modelCheckerPath = modelCheckerPath;
+    task->timeout = timeout;
+    task->useBMC = useBMC;
+    task->tooLarge = 0;
+    task->output = NULL;
+    task->probeAttrs = task->probeVals = NULL;
+    task->nProbes = 0;
+
+    if (doSlicing && doCompressing) {
+        // Replace the values that no rule can tell apart by one representative value
+        compressDomains(pInst);
+    }
+    if (doProbing) {
+        task->nProbes = getProbeAVs(pInst, &task->probeAttrs, &task->probeVals);
+    }
+
+    if (useBMC) {
+        // Bound estimation, if the bound exceeds the range of int, use INT_MAX as the bound
+        BigInteger bound = computeBound(pInst, tl);
+        if (bound.magLen > 1 || (bound.magLen == 1 && (bound.mag[0] >> 31) != 0)) {
+            logACoAC(__func__, __LINE__, 0, WARNING, "bound is too large, use INT_MAX as bound\n");
+            sprintf(task->boundStr, "%d", INT_MAX);
+            task->tooLarge = 1;
+        } else {
+            sprintf(task->boundStr, "%d", bound.signum == 0 ? 0 : bound.mag[0]);
+        }
+        iBigInteger.finalize(bound);
+    }
+
+    // Translate the instance to a NuSMV file
+    task->nusmvFilePath = (char *)malloc(strlen(logDir) + NUSMV_FILE_NAME_LEN + strlen(fileTag) + SMV_SUFFIX_LEN + 2);
+    sprintf(task->nusmvFilePath, "%s/%s%s%s", logDir, NUSMV_FILE_NAME, fileTag, SMV_SUFFIX);
+    task->resultFilePath = (char *)malloc(strlen(logDir) + RESULT_FILE_NAME_LEN + strlen(fileTag) + RESULT_SUFFIX_LEN + 2);
+    sprintf(task->resultFilePath, "%s/%s%s%s", logDir, RESULT_FILE_NAME, fileTag, RESULT_SUFFIX);
+    // The invariants are checked by BDDs in SMC mode only, so the attribute values are probed in SMC mode only
+    if (translateWithProbes(pInst, task->nusmvFilePath, doSlicing, task->probeAttrs, task->probeVals, useBMC ? 0 : task->nProbes) != 0) {
+        free(task->nusmvFilePath);
+        free(task->resultFilePath);
+        free(task->probeAttrs);
+        free(task->probeVals);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * Call the model checker to verify the NuSMV file of a task and save the result in the log directory.
+ * The tasks of the clusters of an instance are run in a thread pool.
+ */
+static void runModelCheck(void *arg) {
+    ModelCheckTask *task = (ModelCheckTask *)arg;
+    task->output = runModelChecker(task->modelCheckerPath, task->nusmvFilePath, task->resultFilePath, task->timeout, task->useBMC ? task->boundStr : NULL);
+}
+
+/**
+ * Analyze the output of the model checker of a task, and release the output and the paths of the task.
+ * If the attribute values of the instance are probed, their reachability is recorded in @{pAbsRef}; in BMC mode, or
+ * if the results of the probes are missing, all of them are recorded as reachable.
+ *
+ * @param task[in]: The model checking task
+ * @param showRules[in]: Whether to find the rules associated with the actions
+ * @param pAbsRef[in]: The AbsRef instance, used only if the attribute values are probed
+ * @return The result of the instance of the task
+ */
+static ACoACResult analyzeModelCheck(ModelCheckTask *task, int showRules, AbsRef *pAbsRef) {
+    char *reachable = NULL;
+    if (task->probeAttrs != NULL && !task->useBMC) {
+        reachable = (char *)malloc(task->nProbes + 1);
+        if (analyzeProbeResults(task->output, task->nProbes, reachable) != 0) {
+            logACoAC(__func__, __LINE__, 0, WARNING, "missing the results of the probes\n");
+            free(reachable);
+            reachable = NULL;
+        }
+    }
+    ACoACResult result = analyzeModelCheckerOutput(task->output, task->pInst, task->useBMC ? task->boundStr : NULL, showRules);
+    free(task->output);
+    if (task->probeAttrs != NULL) {
+        addReachableAVs(pAbsRef, task->pInst, task->probeAttrs, task->probeVals, reachable, task->nProbes);
+        free(reachable);
+        free(task->probeAttrs);
+        free(task->probeVals);
+    }
+
+    if (task->tooLarge && result.code == ACoAC_RESULT_UNREACHABLE) {
+        // The bound exceeds the range of int and the model checker result is "unreachable", need re-verification in SMC mode
+        task->output = runModelChecker(task->modelCheckerPath, task->nusmvFilePath, task->resultFilePath, task->timeout, NULL);
+        result = analyzeModelCheckerOutput(task->output, task->pInst, NULL, showRules);
+        free(task->output);
+    }
+    free(task->nusmvFilePath);
+    free(task->resultFilePath);
+    return result;
+}
+
+/*
+ * The settings of a verification, shared by its rounds of abstraction refinement
+ */
+typedef struct _VerifyContext {
+    char *modelCheckerPath;
+    char *logDir;
+    int doSlicing;
+    int doCompressing;
+    int doClustering;
+    int doProbing;
+    int enableAbstractRefine;
+    int useBMC;
+    int tl;
+    long timeout;
+    // The AbsRef instance, or NULL if abstraction refinement is disabled
+    AbsRef *pAbsRef;
+} VerifyContext;
+
+/*
+ * A round of abstraction refinement prepared for model checking: the sub-policy after local pruning, its clusters
+ * and the model checking tasks of the clusters
+ */
+typedef struct _PreparedRound {
+    // The sub-policy, or NULL if the rule-selection strategies cannot select any new rules
+    ACoACInstance *pInst;
+    int round;
+    // The result of local pruning, ACoAC_RESULT_UNKNOWN if the sub-policy is to be model checked
+    ACoACResult result;
+    // The clusters of the sub-policy, if there are several clusters
+    ACoACInstance **clusters;
+    int nClusters;
+    // The model checking tasks of the clusters, of which nTasks are translated
+    ModelCheckTask *tasks;
+    int nTasks;
+    // Whether the translation of the clusters failed
+    int failed;
+    // The fork of the rules the round is pruned with, if the round is prepared while the global rule list is still
+    // the fork of the previous round (see speculateRound), NULL otherwise
+    Vector *pVecRules;
+} PreparedRound;
+
+/**
+ * Prepare a round of abstraction refinement: save the sub-policy in the log directory, prune it, split it into
+ * clusters and translate the clusters to NuSMV files.
+ *
+ * @param ctx[in]: The settings of the verification
+ * @param pInst[in]: The sub-policy of the round, or the instance if abstraction refinement is disabled
+ * @param prepared[out]: The prepared round
+ */
+static void prepareRound(VerifyContext *ctx, ACoACInstance *pInst, PreparedRound *prepared) {
+    prepared->pInst = pInst;
+    prepared->round = ctx->enableAbstractRefine ? ctx->pAbsRef->round : 0;
+    prepared->result = (ACoACResult){.code = ACoAC_RESULT_UNKNOWN};
+    prepared->clusters = NULL;
+    prepared->nClusters = 0;
+    prepared->tasks = NULL;
+    prepared->nTasks = 0;
+    prepared->failed = 0;
+    prepared->pVecRules = NULL;
+    if (pInst == NULL) {
+        return;
+    }
+
+    char roundStr[10], *writePath;
+    sprintf(roundStr, "%d", prepared->round);
+    if (ctx->enableAbstractRefine) {
+        // Save the abstract sub-policy in the log directory
+        writePath = (char *)malloc(strlen(ctx->logDir) + ABSTRACTION_REFINEMENT_RESULT_FILE_NAME_LEN + strlen(roundStr) + ACoAC_SUFFIX_LEN + 2);
+        sprintf(writePath, "%s/%s%s%s", ctx->logDir, ABSTRACTION_REFINEMENT_RESULT_FILE_NAME, roundStr, ACoAC_SUFFIX);
+        writeACoACInstance(pInst, writePath);
+        free(writePath);
+
+        if (ctx->doSlicing) {
+            // Local pruning
+            prepared->pInst = sliceIncremental(pInst, &prepared->result);
+            if (prepared->result.code != ACoAC_RESULT_UNKNOWN) {
+                return;
+            }
+
+            // Save the pruned sub-policy in the log directory
+            writePath = (char *)malloc(strlen(ctx->logDir) + SLICING_RESULT_FILE_NAME_LEN + strlen(roundStr) + ACoAC_SUFFIX_LEN + 2);
+            sprintf(writePath, "%s/%s%s%s", ctx->logDir, SLICING_RESULT_FILE_NAME, roundStr, ACoAC_SUFFIX);
+            writeACoACInstance(prepared->pInst, writePath);
+            free(writePath);
+        }
+    }
+
+    // Split the instance into the clusters of the query attributes, which are model checked separately
+    ACoACInstance **clusters = &prepared->pInst;
+    int nClusters = 1, c;
+    if (ctx->doSlicing && ctx->doClustering) {
+        nClusters = splitIntoClusters(prepared->pInst, &clusters);
+    }
+    if (nClusters > 1) {
+        prepared->clusters = clusters;
+    }
+    prepared->nClusters = nClusters;
+
+    // Translate the clusters to NuSMV files, named after the round and, if there are several clusters, the cluster
+    prepared->tasks = (ModelCheckTask *)malloc(nClusters * sizeof(ModelCheckTask));
+    char fileTag[24];
+    for (c = 0; c < nClusters; c++) {
+        if (nClusters == 1) {
+            strcpy(fileTag, roundStr);
+        } else {
+            sprintf(fileTag, "%s_%d", roundStr, c + 1);
+        }
+        if (prepareModelCheck(&prepared->tasks[c], clusters[c], ctx->modelCheckerPath, ctx->logDir, fileTag, ctx->doSlicing, ctx->doCompressing,
+                              ctx->doProbing, ctx->useBMC, ctx->tl, ctx->timeout) != 0) {
+            prepared->failed = 1;
+            return;
+        }
+        prepared->nTasks++;
+    }
+}
+
+/*
+ * The next round of abstraction refinement, prepared on a worker thread while the model checker runs
+ */
+typedef struct _RoundSpeculation {
+    VerifyContext *ctx;
+    PreparedRound prepared;
+} RoundSpeculation;
+
+/**
+ * Refine the sub-policy and prepare the next round, assuming the current sub-policy is determined to be "safe".
+ * It is run on a worker thread while the model checker runs on the current sub-policy, so it only touches the AbsRef
+ * instance and the global variables, which are not used by the main thread until the model checker returns.
+ *
+ * The next round is pruned with its own fork of the rules, and the fork of the current round is restored as the global
+ * rule list afterwards, since the output of the model checker is analyzed with the rules of the current round.
+ */
+static void speculateRound(void *arg) {
+    RoundSpeculation *spec = (RoundSpeculation *)arg;
+    AbsRef *pAbsRef = spec->ctx->pAbsRef;
+    Vector *pVecRulesCur = pVecRules;
+    // getInstance keeps the current fork if the global rule list is the original one
+    pVecRules = pAbsRef->pOriVecRules;
+    prepareRound(spec->ctx, refine(pAbsRef), &spec->prepared);
+    if (pVecRules != pAbsRef->pOriVecRules) {
+        spec->prepared.pVecRules = pVecRules;
+    }
+    pVecRules = pVecRulesCur;
+}
+
+/**
+ * Make the fork of the rules of a speculatively prepared round the global rule list, releasing the fork of the
+ * previous round.
+ */
+static void adoptRound(VerifyContext *ctx, PreparedRound *prepared) {
+    if (prepared->pVecRules == NULL) {
+        return;
+    }
+    if (pVecRules != ctx->pAbsRef->pOriVecRules) {
+        releaseRuleList(pVecRules);
+    }
+    pVecRules = prepared->pVecRules;
+    prepared->pVecRules = NULL;
+}
+
+/**
+ * Discard a prepared round that is not verified, releasing it and removing its files from the log directory.
+ */
+static void discardRound(VerifyContext *ctx, PreparedRound *prepared) {
+    if (prepared->pInst == NULL) {
+        return;
+    }
+    logACoAC(__func__, __LINE__, 0, INFO, "[Pipeline] discard the prepared %d-th round\n", prepared->round);
+    int c;
+    for (c = 0; c < prepared->nTasks; c++) {
+        remove(prepared->tasks[c].nusmvFilePath);
+        free(prepared->tasks[c].nusmvFilePath);
+        free(prepared->tasks[c].resultFilePath);
+        free(prepared->tasks[c].probeAttrs);
+        free(prepared->tasks[c].probeVals);
+    }
+    free(prepared->tasks);
+    if (prepared->clusters != NULL) {
+        finalizeClusters(prepared->clusters, prepared->nClusters);
     }
+
+    char roundStr[10];
+    sprintf(roundStr, "%d", prepared->round);
+    char *writePath = (char *)malloc(strlen(ctx->logDir) + ABSTRACTION_REFINEMENT_RESULT_FILE_NAME_LEN + strlen(roundStr) + ACoAC_SUFFIX_LEN + 2);
+    sprintf(writePath, "%s/%s%s%s", ctx->logDir, ABSTRACTION_REFINEMENT_RESULT_FILE_NAME, roundStr, ACoAC_SUFFIX);
+    remove(writePath);
+    sprintf(writePath, "%s/%s%s%s", ctx->logDir, SLICING_RESULT_FILE_NAME, roundStr, ACoAC_SUFFIX);
+    remove(writePath);
+    free(writePath);
+    finalizeSubPolicy(ctx->pAbsRef, prepared->pInst);
+    if (prepared->pVecRules != NULL) {
+        releaseRuleList(prepared->pVecRules);
+    }
+}
+
+/**
+ * Complete the telemetry of a round of abstraction refinement and save the telemetry of all the rounds in the log
+ * directory.
+ *
+ * @param pAbsRef[in]: The AbsRef instance
+ * @param logDir[in]: The log directory
+ * @param round[in]: The round
+ * @param nRulesChecked[in]: The number of rules of the model checked sub-policy, or 0 if it is determined by pruning
+ * @param mcCost[in]: The wall-clock time of the model checker in milliseconds
+ */
+static void reportRefinementRound(AbsRef *pAbsRef, char *logDir, int round, int nRulesChecked, double mcCost) {
+    reportRound(pAbsRef, round, nRulesChecked, mcCost);
+    char *telemetryPath = (char *)malloc(strlen(logDir) + REFINE_TELEMETRY_FILE_NAME_LEN + 2);
+    sprintf(telemetryPath, "%s/%s", logDir, REFINE_TELEMETRY_FILE_NAME);
+    writeRefineTelemetry(pAbsRef, telemetryPath);
+    free(telemetryPath);
+}
+
+static ACoACResult verify(char *modelCheckerPath, char *instFilePath, char *logDir, char *cacheDir, int doPrechecking, int doSlicing,
+                          int doCompressing, int doClustering, int enableAbstractRefine, RefineStrategy refineStrategy, int refineSteps,
+                          int pipeline, int useBMC, int tl, int showRules, long timeout, int nThreads) {
+    // read the instance file
+    ACoACInstance *pInst = readInstanceFile(instFilePath, nThreads);
     if (pInst == NULL) {
         return (ACoACResult){.code = ACoAC_RESULT_ERROR};
     }
 
+    // The result of pre-checking and slicing is cached by the fingerprint of the parsed policy
+    unsigned char fingerprint[FINGERPRINT_LEN];
+    int cached = 0;
+    ACoACResult result = {.code = ACoAC_RESULT_UNKNOWN};
+    if (!doSlicing || cacheDir == NULL || fingerprintPolicy(pInst, doPrechecking, fingerprint) != 0) {
+        cacheDir = NULL;
+    } else if ((cached = loadSlicingCache(cacheDir, fingerprint, &pInst, &result)) && result.code != ACoAC_RESULT_UNKNOWN) {
+        printResult(result, showRules);
+        return result;
+    }
+
     // initialize the instance
-    init(pInst);
+    if (!cached) {
+        init(pInst);
+    }
+    setSlicingThreads(nThreads);
 
     // pre-checking
-    if (doPrechecking) {
+    if (doPrechecking && !cached) {
         logACoAC(__func__, __LINE__, 0, INFO, "[start] pre-checking\n");
         clock_t startPreCheck = clock();
         ACoACResult result = preCheck(pInst);
@@ -75,19 +486,27 @@ static ACoACResult verify(char *modelCheckerPath, char *instFilePath, char *logD
         logACoAC(__func__, __LINE__, 0, INFO, "[end] pre-checking, cost ==> %.2fms\n", time_spent);
         if (result.code != ACoAC_RESULT_UNKNOWN) {
             logACoAC(__func__, __LINE__, 0, INFO, "preCheck success\n");
+            if (cacheDir != NULL) {
+                saveSlicingCache(cacheDir, fingerprint, NULL, result);
+            }
             printResult(result, showRules);
             return result;
         }
         logACoAC(__func__, __LINE__, 0, INFO, "preCheck failed\n");
     }
 
-    pInst = userCleaning(pInst);
     char *writePath;
-
-    ACoACResult result = {.code = ACoAC_RESULT_UNKNOWN};
+    if (!cached) {
+        pInst = userCleaning(pInst);
+    }
     if (doSlicing) {
         // Global pruning
-        pInst = slice(pInst, &result);
+        if (!cached) {
+            pInst = sliceIncremental(pInst, &result);
+            if (cacheDir != NULL) {
+                saveSlicingCache(cacheDir, fingerprint, pInst, result);
+            }
+        }
         if (result.code != ACoAC_RESULT_UNKNOWN) {
             printResult(result, showRules);
             return result;
@@ -99,110 +518,130 @@ static ACoACResult verify(char *modelCheckerPath, char *instFilePath, char *logD
         free(writePath);
     }
 
-    AbsRef *pAbsRef;
+    AbsRef *pAbsRef = NULL;
     ACoACInstance *next;
     char roundStr[10];
-    char boundStr[15];
-    char *nusmvFilePath, *resultFilePath, *nusmvOutput;
+    // The reachable attribute values of the sub-policies are asked for the counterexample-guided refinement
+    int doProbing = enableAbstractRefine && doSlicing && refineStrategy == REFINE_CEGAR;
 
     if (enableAbstractRefine) {
         // Generate an abstract sub-policy
         pAbsRef = createAbsRef(pInst);
+        pAbsRef->strategy = refineStrategy;
+        // refineSteps is 0 if the number of steps of the rule-selection strategies is adapted to the previous rounds
+        pAbsRef->nSteps = refineSteps > 0 ? refineSteps : 1;
+        pAbsRef->adaptiveSteps = refineSteps == 0;
         next = abstract(pAbsRef);
     } else {
         // no abstraction refinement
         next = pInst;
     }
 
-    // Start the loop of abstraction refinement
-    while (next != NULL) {
-        sprintf(roundStr, "%d", enableAbstractRefine ? pAbsRef->round : 0);
+    // The next round can be prepared while the model checker runs only if it does not depend on the results of the
+    // model checker, i.e., the sub-policy is widened by a fixed number of steps
+    if (pipeline && enableAbstractRefine && (refineStrategy != REFINE_WIDEN || refineSteps == 0)) {
+        logACoAC(__func__, __LINE__, 0, WARNING, "pipelining needs the widen strategy with fixed steps, disabled\n");
+        pipeline = 0;
+    }
+    pipeline = pipeline && enableAbstractRefine;
 
-        if (enableAbstractRefine) {
-            // Save the abstract sub-policy in the log directory
-            writePath = (char *)malloc(strlen(logDir) + ABSTRACTION_REFINEMENT_RESULT_FILE_NAME_LEN + strlen(roundStr) + ACoAC_SUFFIX_LEN + 2);
-            sprintf(writePath, "%s/%s%s%s", logDir, ABSTRACTION_REFINEMENT_RESULT_FILE_NAME, roundStr, ACoAC_SUFFIX);
-            writeACoACInstance(next, writePath);
-            free(writePath);
+    VerifyContext ctx = {modelCheckerPath, logDir, doSlicing, doCompressing, doClustering, doProbing, enableAbstractRefine, useBMC, tl, timeout, pAbsRef};
+    PreparedRound prepared;
+    RoundSpeculation spec;
+    spec.ctx = &ctx;
+    prepareRound(&ctx, next, &prepared);
 
-            if (doSlicing) {
-                // Local pruning
-                next = slice(next, &result);
-                if (result.code == ACoAC_RESULT_REACHABLE || (result.code == ACoAC_RESULT_UNREACHABLE && !enableAbstractRefine)) {
-                    // Abstraction refinement is disabled and the safety of the sub-policy is determined, output the result
-                    // Abstraction refinement is enabled and the sub-policy is determined to be "unsafe", also output the result
-                    printResult(result, showRules);
-                    logACoAC(__func__, __LINE__, 0, INFO, "round => %s\n", roundStr);
-                    return result;
-                }
-                if (result.code == ACoAC_RESULT_UNREACHABLE) {
-                    // Abstraction refinement is enabled and the sub-policy is determined to be "safe", need refinement and re-verification
-                    printResult(result, showRules);
-                    next = refine(pAbsRef);
-                    continue;
-                }
+    // Start the loop of abstraction refinement
+    while (prepared.pInst != NULL) {
+        next = prepared.pInst;
+        sprintf(roundStr, "%d", prepared.round);
 
-                // Save the pruned sub-policy in the log directory
-                writePath = (char *)malloc(strlen(logDir) + SLICING_RESULT_FILE_NAME_LEN + strlen(roundStr) + ACoAC_SUFFIX_LEN + 2);
-                sprintf(writePath, "%s/%s%s%s", logDir, SLICING_RESULT_FILE_NAME, roundStr, ACoAC_SUFFIX);
-                writeACoACInstance(next, writePath);
-                free(writePath);
-            }
+        if (prepared.result.code == ACoAC_RESULT_REACHABLE) {
+            // Abstraction refinement is enabled and the sub-policy is determined to be "unsafe" by local pruning, output the result
+            printResult(prepared.result, showRules);
+            reportRefinementRound(pAbsRef, logDir, prepared.round, 0, 0);
+            logACoAC(__func__, __LINE__, 0, INFO, "round => %s\n", roundStr);
+            return prepared.result;
         }
-
-        int tooLarge = 0;
-        if (useBMC) {
-            // Bound estimation, if the bound exceeds the range of int, use INT_MAX as the bound
-            BigInteger bound = computeBound(next, tl);
-            if (bound.magLen > 1 || (bound.magLen == 1 && (bound.mag[0] >> 31) != 0)) {
-                logACoAC(__func__, __LINE__, 0, WARNING, "bound is too large, use INT_MAX as bound\n");
-                sprintf(boundStr, "%d", INT_MAX);
-                tooLarge = 1;
-            } else {
-                sprintf(boundStr, "%d", bound.signum == 0 ? 0 : bound.mag[0]);
-            }
-            iBigInteger.finalize(bound);
+        if (prepared.result.code == ACoAC_RESULT_UNREACHABLE) {
+            // Abstraction refinement is enabled and the sub-policy is determined to be "safe", need refinement and re-verification
+            printResult(prepared.result, showRules);
+            reportRefinementRound(pAbsRef, logDir, prepared.round, 0, 0);
+            finalizeSubPolicy(pAbsRef, next);
+            prepareRound(&ctx, refine(pAbsRef), &prepared);
+            continue;
         }
-
-        // Translate the instance to a NuSMV file
-        nusmvFilePath = (char *)malloc(strlen(logDir) + NUSMV_FILE_NAME_LEN + strlen(roundStr) + SMV_SUFFIX_LEN + 2);
-        sprintf(nusmvFilePath, "%s/%s%s%s", logDir, NUSMV_FILE_NAME, roundStr, SMV_SUFFIX);
-        if (translate(next, nusmvFilePath, doSlicing) != 0) {
+        if (prepared.failed) {
             logACoAC(__func__, __LINE__, 0, ERROR, "failed to translate instance to nusmv file\n");
             result.code = ACoAC_RESULT_ERROR;
             printResult(result, showRules);
             return result;
         }
 
-        // Call the model checker to verify the instance and save the result in the log directory
-        resultFilePath = (char *)malloc(strlen(logDir) + RESULT_FILE_NAME_LEN + strlen(roundStr) + RESULT_SUFFIX_LEN + 2);
-        sprintf(resultFilePath, "%s/%s%s%s", logDir, RESULT_FILE_NAME, roundStr, RESULT_SUFFIX);
-        nusmvOutput = runModelChecker(modelCheckerPath, nusmvFilePath, resultFilePath, timeout, useBMC ? boundStr : NULL);
-
-        // Analyze the result of the model checker
-        result = analyzeModelCheckerOutput(nusmvOutput, next, useBMC ? boundStr : NULL, showRules);
-        free(nusmvOutput);
+        // Prepare the next round on a worker thread, assuming the sub-policy is determined to be "safe"
+        ThreadPool *pSpecPool = NULL;
+        if (pipeline) {
+            pSpecPool = iThreadPool.Create(1);
+            iThreadPool.Submit(pSpecPool, speculateRound, &spec);
+        }
 
-        if (tooLarge && result.code == ACoAC_RESULT_UNREACHABLE) {
-            // The bound exceeds the range of int and the model checker result is "unreachable", need re-verification in SMC mode
-            nusmvOutput = runModelChecker(modelCheckerPath, nusmvFilePath, resultFilePath, timeout, NULL);
-            result = analyzeModelCheckerOutput(nusmvOutput, next, NULL, showRules);
-            free(nusmvOutput);
+        // Call the model checker on the clusters, at most nThreads at a time, and combine the results
+        ModelCheckTask *tasks = prepared.tasks;
+        int nClusters = prepared.nClusters, c;
+        ACoACResult results[nClusters];
+        double startModelChecking = wallClockMs();
+        if (nClusters > 1 && nThreads > 1) {
+            ThreadPool *pool = iThreadPool.Create(nThreads < nClusters ? nThreads : nClusters);
+            for (c = 0; c < nClusters; c++) {
+                iThreadPool.Submit(pool, runModelCheck, &tasks[c]);
+            }
+            iThreadPool.Finalize(pool);
+        } else {
+            for (c = 0; c < nClusters; c++) {
+                runModelCheck(&tasks[c]);
+            }
+        }
+        // The time of waiting for the next round is not counted as model checking
+        double mcCost = wallClockMs() - startModelChecking;
+        if (pSpecPool != NULL) {
+            iThreadPool.Finalize(pSpecPool);
+        }
+        startModelChecking = wallClockMs();
+        for (c = 0; c < nClusters; c++) {
+            results[c] = analyzeModelCheck(&tasks[c], showRules, pAbsRef);
+        }
+        mcCost += wallClockMs() - startModelChecking;
+        if (nClusters == 1) {
+            result = results[0];
+        } else {
+            result = combineClusterResults(results, nClusters);
+            finalizeClusters(prepared.clusters, nClusters);
         }
-        free(nusmvFilePath);
-        free(resultFilePath);
+        free(tasks);
 
         logACoAC(__func__, __LINE__, 0, INFO, "\n");
         printResult(result, showRules);
+        if (enableAbstractRefine) {
+            reportRefinementRound(pAbsRef, logDir, prepared.round, iHashSet.Size(next->pSetRuleIdxes), mcCost);
+        }
 
         // If abstraction refinement is disabled or the sub-policy is not determined to be "unsafe", output the result
         if (!enableAbstractRefine || result.code != ACoAC_RESULT_UNREACHABLE) {
+            if (pSpecPool != NULL) {
+                discardRound(&ctx, &spec.prepared);
+            }
             logACoAC(__func__, __LINE__, 0, INFO, "round => %s\n", roundStr);
             return result;
         }
 
         // Abstraction refinement is enabled and the sub-policy is determined to be "unsafe", need refinement and re-verification
-        next = refine(pAbsRef);
+        finalizeSubPolicy(pAbsRef, next);
+        if (pSpecPool != NULL) {
+            adoptRound(&ctx, &spec.prepared);
+            prepared = spec.prepared;
+        } else {
+            prepareRound(&ctx, refine(pAbsRef), &prepared);
+        }
     }
     logACoAC(__func__, __LINE__, 0, INFO, "round => %s\n", roundStr);
     return result;
@@ -211,21 +650,8 @@ static ACoACResult verify(char *modelCheckerPath, char *instFilePath, char *logD
 #include <unistd.h>
 
 char *computeBoundTightnessForFile(char *instFilePath, char *resultFile, int *scale) {
-    ACoACInstance *pInst = NULL;
-
     // read the instance file
-    int instFilePathLen = strlen(instFilePath);
-    if (instFilePathLen >= ACoAC_SUFFIX_LEN && strcmp(instFilePath + instFilePathLen - ACoAC_SUFFIX_LEN, ACoAC_SUFFIX) == 0) {
-        logACoAC(__func__, __LINE__, 0, INFO, "[start] parsing ACoAC instance file\n");
-        pInst = readACoACInstance(instFilePath);
-    } else if ((instFilePathLen >= ARBAC_SUFFIX_LEN && strcmp(instFilePath + instFilePathLen - ARBAC_SUFFIX_LEN, ARBAC_SUFFIX) == 0) ||
-               (instFilePathLen >= MOHAWK_SUFFIX_LEN && strcmp(instFilePath + instFilePathLen - MOHAWK_SUFFIX_LEN, MOHAWK_SUFFIX) == 0)) {
-        logACoAC(__func__, __LINE__, 0, INFO, "[start] translating arbac instance file\n");
-        pInst = readARBACInstance(instFilePath);
-    } else {
-        logACoAC(__func__, __LINE__, 0, ERROR, "illegal file type\n");
-        exit(1);
-    }
+    ACoACInstance *pInst = readInstanceFile(instFilePath, 1);
     if (pInst == NULL) {
         exit(1);
     }
@@ -423,7 +849,12 @@ int main(int argc, char *argv[]) {
     int help = 0;
     int doPrechecking = 1;
     int doSlicing = 1;
+    int doCompressing = 1;
+    int doClustering = 1;
     int enableAbstractRefine = 1;
+    RefineStrategy refineStrategy = REFINE_WIDEN;
+    int refineSteps = 1;
+    int pipeline = 0;
     int useBMC = 1;
     int showRules = 1;
 
@@ -434,29 +865,51 @@ int main(int argc, char *argv[]) {
     long timeout = 60;
     int computeTightness = 0;
     char *outputPath = NULL;
+    int nThreads = 1;
+    char *cacheDir = NULL;
+    int useCache = 0;
+    int noCache = 0;
 
     int unrecognized = 0;
 
-    char *helpMessage = "Usage: acoac-verifier\
+    char *helpMessage = "Usage: acoac-verifier [compile]\
+        \ncompile                        compile the input (.aabac, .arbac or .mohawk) into a binary policy (.aabin) saved at -output\
         \n-tl|-b <arg>                   tight level, either 1 (loose) or 2 (tight)\
         \n-help|-h                       print the help text\
         \n-input|-i <arg>                acoac file path\
         \n-model_checker|-m <arg>        nusmv file path\
         \n-log_dir|-l <arg>              directory for storing logs\
         \n-no_absref|-a                  no abstraction refinement\
+        \n-refine_strategy|-f <arg>      strategy of abstraction refinement, either widen (default) or cegar, which selects the rules\
+        \n                               leading from the reachable attribute values to the query, as found by the model checker in smc mode\
+        \n-refine_steps|-e <arg>         steps of the rule-selection strategies per refinement, either a positive number (default 1) or\
+        \n                               adaptive, which doubles the steps after fast rounds and halves them after slow rounds\
+        \n-pipeline|-y                   prepare the next round of abstraction refinement while the model checker runs, discarded\
+        \n                               if the refinement stops, only with the widen strategy and fixed steps\
         \n-no_precheck|-p                no precheck\
         \n-no_slicing|-s                 no slicing\
+        \n-no_compress|-d                no compression of the attribute domains after slicing\
+        \n-no_cluster|-g                 no splitting of the query into independent clusters of attributes after slicing\
         \n-no_rules|-r                   do not show the rules associated with the actions in the result\
         \n-smc|-n                        on smc mode\
         \n-timeout|-t <arg>              timeout in seconds\
         \n-compute_tightness|-c          compute the tightness of the bound\
-        \n-output|-o <arg>               output file path for saving the tightness of the bound\n";
+        \n-output|-o <arg>               output file path for saving the tightness of the bound or the compiled policy\
+        \n-threads|-j <arg>              number of worker threads, also the number of clusters model checked at once (default 1)\
+        \n-cache|-u                      reuse and save the results of slicing in $XDG_CACHE_HOME/coachecker or ~/.cache/coachecker\
+        \n-cache_dir|-k <arg>            reuse and save the results of slicing in the given directory\
+        \n-no_cache|-x                   do not reuse or save the cached results of slicing (default), overriding -cache and -cache_dir\n";
 
     static struct option long_options[] = {
         {"help", no_argument, 0, 'h'},
         {"no_precheck", no_argument, 0, 'p'},
         {"no_slicing", no_argument, 0, 's'},
+        {"no_compress", no_argument, 0, 'd'},
+        {"no_cluster", no_argument, 0, 'g'},
         {"no_absref", no_argument, 0, 'a'},
+        {"refine_strategy", required_argument, 0, 'f'},
+        {"refine_steps", required_argument, 0, 'e'},
+        {"pipeline", no_argument, 0, 'y'},
         {"smc", no_argument, 0, 'n'},
         {"tl", required_argument, 0, 'b'},
         {"no_rules", no_argument, 0, 'r'},
@@ -466,13 +919,17 @@ int main(int argc, char *argv[]) {
         {"timeout", required_argument, 0, 't'},
         {"compute_tightness", no_argument, 0, 'c'},
         {"output", required_argument, 0, 'o'},
+        {"threads", required_argument, 0, 'j'},
+        {"cache", no_argument, 0, 'u'},
+        {"cache_dir", required_argument, 0, 'k'},
+        {"no_cache", no_argument, 0, 'x'},
         {0, 0, 0, 0}};
 
     int c;
     while (1) {
         int option_index = 0;
 
-        c = getopt_long_only(argc, argv, "hpsanb:rm:i:l:t:co:", long_options, &option_index);
+        c = getopt_long_only(argc, argv, "hpsdgaf:e:ynb:rm:i:l:t:co:j:uk:x", long_options, &option_index);
 
         if (c == -1)
             break;
@@ -487,9 +944,36 @@ int main(int argc, char *argv[]) {
         case 's':
             doSlicing = 0;
             break;
+        case 'd':
+            doCompressing = 0;
+            break;
+        case 'g':
+            doClustering = 0;
+            break;
         case 'a':
             enableAbstractRefine = 0;
             break;
+        case 'f':
+            if (strcmp(optarg, "widen") == 0) {
+                refineStrategy = REFINE_WIDEN;
+            } else if (strcmp(optarg, "cegar") == 0) {
+                refineStrategy = REFINE_CEGAR;
+            } else {
+                printf("refine strategy should be either widen or cegar\n");
+                return 0;
+            }
+            break;
+        case 'e':
+            if (strcmp(optarg, "adaptive") == 0) {
+                refineSteps = 0;
+            } else if ((refineSteps = atoi(optarg)) <= 0) {
+                printf("refine steps should be either a positive number or adaptive\n");
+                return 0;
+            }
+            break;
+        case 'y':
+            pipeline = 1;
+            break;
         case 'n':
             useBMC = 0;
             break;
@@ -525,18 +1009,43 @@ int main(int argc, char *argv[]) {
             outputPath = (char *)malloc(strlen(optarg) + 1);
             strcpy(outputPath, optarg);
             break;
+        case 'j':
+            nThreads = atoi(optarg);
+            break;
+        case 'u':
+            useCache = 1;
+            break;
+        case 'k':
+            free(cacheDir);
+            cacheDir = (char *)malloc(strlen(optarg) + 1);
+            strcpy(cacheDir, optarg);
+            useCache = 1;
+            break;
+        case 'x':
+            noCache = 1;
+            break;
         default:
             unrecognized = 1;
             break;
         }
     }
 
+    // The only non-option argument is the subcommand
+    int doCompile = optind < argc && strcmp(argv[optind], "compile") == 0;
+    if (optind < argc && !doCompile) {
+        unrecognized = 1;
+    }
+
     if (unrecognized) {
         printf("Found unrecognized option\n%s", helpMessage);
     } else if (help) {
         printf("%s", helpMessage);
     } else if (!inputPath) {
         printf("please input the file path of acoac instance\n%s", helpMessage);
+    } else if (nThreads <= 0) {
+        printf("number of threads must be greater than 0\n%s", helpMessage);
+    } else if (doCompile) {
+        return compile(inputPath, outputPath, nThreads);
     } else if (computeTightness) {
         computeBoundTightness(inputPath, outputPath);
     } else if (!modelCheckerPath) {
@@ -546,8 +1055,15 @@ int main(int argc, char *argv[]) {
     } else if (timeout <= 0) {
         printf("timeout must be greater than 0\n%s", helpMessage);
     } else {
+        // The cache is only used on request, so that no files are written out of the log directory by default
+        if (!useCache || noCache) {
+            free(cacheDir);
+            cacheDir = NULL;
+        } else if (cacheDir == NULL) {
+            cacheDir = getDefaultCacheDir();
+        }
         clock_t start = clock();
-        verify(modelCheckerPath, inputPath, logDir, doPrechecking, doSlicing, enableAbstractRefine, useBMC, tl, showRules, timeout);
+        verify(modelCheckerPath, inputPath, logDir, cacheDir, doPrechecking, doSlicing, doCompressing, doClustering, enableAbstractRefine, refineStrategy, refineSteps, pipeline, useBMC, tl, showRules, timeout, nThreads);
         clock_t end = clock();
         double time_spent = (double)(end - start) / CLOCKS_PER_SEC * 1000;
         logACoAC(__func__, __LINE__, 0, INFO, "end verification, cost => %.2fms\n", time_spent);
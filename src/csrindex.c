@@ -0,0 +1,163 @@
+#include "csrindex.h"
+#include <stdlib.h>
+#include <string.h>
+
+// The columns of a row are sorted by counting when they span at most COUNTING_SORT_SPAN_FACTOR times as many values
+// as the row has entries, and by merging otherwise
+#define COUNTING_SORT_SPAN_FACTOR 4
+
+/**
+ * Stable sort of the entries @{src}[0, n) by column into @{dst}, by merging runs of doubling length.
+ * Both arrays are overwritten.
+ *
+ * @return The array that holds the sorted entries, either @{src} or @{dst}
+ */
+static CSREntry *mergeSortByCol(CSREntry *src, CSREntry *dst, int n) {
+    int width, lo, mid, hi, i, j, k;
+    CSREntry *tmp;
+    for (width = 1; width < n; width <<= 1) {
+        for (lo = 0; lo < n; lo += width << 1) {
+            mid = lo + width < n ? lo + width : n;
+            hi = lo + (width << 1) < n ? lo + (width << 1) : n;
+            for (i = lo, j = mid, k = lo; k < hi; k++) {
+                dst[k] = (j >= hi || (i < mid && src[i].col <= src[j].col)) ? src[i++] : src[j++];
+            }
+        }
+        tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+    return src;
+}
+
+static CSRIndex *Build(Arena *arena, int nRows, CSREntry *entries, int nEntries) {
+    CSRIndex *index = (CSRIndex *)iArena.Alloc(arena, sizeof(CSRIndex));
+    index->nRows = nRows;
+    index->rowStart = (int *)iArena.Alloc(arena, (nRows + 1) * sizeof(int));
+    index->elems = (int *)iArena.Alloc(arena, nEntries * sizeof(int));
+
+    // Bucket the entries by row, keeping their order; rowStart[r] is used as the insertion point of row r
+    CSREntry *sorted = (CSREntry *)iArena.Alloc(arena, nEntries * sizeof(CSREntry));
+    CSREntry *buffer = (CSREntry *)iArena.Alloc(arena, nEntries * sizeof(CSREntry));
+    int *entryStart = (int *)iArena.Alloc(arena, (nRows + 1) * sizeof(int));
+    int i, r, c, n, minCol, maxCol, maxSpan = 0;
+    for (r = 0; r <= nRows; r++) {
+        entryStart[r] = 0;
+    }
+    for (i = 0; i < nEntries; i++) {
+        entryStart[entries[i].row + 1]++;
+    }
+    for (r = 0; r < nRows; r++) {
+        entryStart[r + 1] += entryStart[r];
+        index->rowStart[r] = entryStart[r];
+    }
+    for (i = 0; i < nEntries; i++) {
+        sorted[index->rowStart[entries[i].row]++] = entries[i];
+    }
+    for (r = 0; r < nRows; r++) {
+        n = entryStart[r + 1] - entryStart[r];
+        if (n > 1) {
+            minCol = maxCol = sorted[entryStart[r]].col;
+            for (i = entryStart[r] + 1; i < entryStart[r + 1]; i++) {
+                minCol = sorted[i].col < minCol ? sorted[i].col : minCol;
+                maxCol = sorted[i].col > maxCol ? sorted[i].col : maxCol;
+            }
+            // rowStart[r] holds the span of the columns of row r until the cells are numbered
+            index->rowStart[r] = (long)maxCol - minCol < (long)n * COUNTING_SORT_SPAN_FACTOR ? maxCol - minCol + 1 : 0;
+            maxSpan = index->rowStart[r] > maxSpan ? index->rowStart[r] : maxSpan;
+        }
+    }
+
+    // Sort each row by column, keeping the order of the entries of the same cell, and count the cells
+    int *colCount = (int *)iArena.Alloc(arena, (maxSpan + 1) * sizeof(int));
+    int nCells = 0, span;
+    CSREntry *row;
+    for (r = 0; r < nRows; r++) {
+        n = entryStart[r + 1] - entryStart[r];
+        row = sorted + entryStart[r];
+        if (n > 1) {
+            span = index->rowStart[r];
+            if (span > 0) {
+                minCol = row[0].col;
+                for (i = 1; i < n; i++) {
+                    minCol = row[i].col < minCol ? row[i].col : minCol;
+                }
+                for (c = 0; c <= span; c++) {
+                    colCount[c] = 0;
+                }
+                for (i = 0; i < n; i++) {
+                    colCount[row[i].col - minCol + 1]++;
+                }
+                for (c = 0; c < span; c++) {
+                    colCount[c + 1] += colCount[c];
+                }
+                for (i = 0; i < n; i++) {
+                    buffer[entryStart[r] + colCount[row[i].col - minCol]++] = row[i];
+                }
+                memcpy(row, buffer + entryStart[r], n * sizeof(CSREntry));
+            } else if (mergeSortByCol(row, buffer + entryStart[r], n) != row) {
+                memcpy(row, buffer + entryStart[r], n * sizeof(CSREntry));
+            }
+        }
+        for (i = 0; i < n; i++) {
+            if (i == 0 || row[i].col != row[i - 1].col) {
+                nCells++;
+            }
+        }
+    }
+    index->nCells = nCells;
+    index->cols = (int *)iArena.Alloc(arena, nCells * sizeof(int));
+    index->cellStart = (int *)iArena.Alloc(arena, (nCells + 1) * sizeof(int));
+    for (r = 0, c = 0; r < nRows; r++) {
+        index->rowStart[r] = c;
+        for (i = entryStart[r]; i < entryStart[r + 1]; i++) {
+            if (i == entryStart[r] || sorted[i].col != sorted[i - 1].col) {
+                index->cols[c] = sorted[i].col;
+                index->cellStart[c++] = i;
+            }
+            index->elems[i] = sorted[i].elem;
+        }
+    }
+    index->rowStart[nRows] = nCells;
+    index->cellStart[nCells] = nEntries;
+    return index;
+}
+
+static int Find(CSRIndex *index, int row, int col) {
+    if (row < 0 || row >= index->nRows) {
+        return -1;
+    }
+    int lo = index->rowStart[row], hi = index->rowStart[row + 1] - 1, mid;
+    while (lo <= hi) {
+        mid = (lo + hi) >> 1;
+        if (index->cols[mid] < col) {
+            lo = mid + 1;
+        } else if (index->cols[mid] > col) {
+            hi = mid - 1;
+        } else {
+            return mid;
+        }
+    }
+    return -1;
+}
+
+static int Get(CSRIndex *index, int row, int col, int **ppElems) {
+    int c = Find(index, row, col);
+    if (c < 0) {
+        *ppElems = NULL;
+        return 0;
+    }
+    *ppElems = index->elems + index->cellStart[c];
+    return index->cellStart[c + 1] - index->cellStart[c];
+}
+
+static int CellSize(CSRIndex *index, int cell) {
+    return index->cellStart[cell + 1] - index->cellStart[cell];
+}
+
+CSRIndexInterface iCSRIndex = {
+    .Build = Build,
+    .Find = Find,
+    .Get = Get,
+    .CellSize = CellSize,
+};
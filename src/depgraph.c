@@ -0,0 +1,275 @@
+#include "depgraph.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Number the nodes of the graph: the cells of the target index keep their numbers, and the cells of the precondition
+ * index whose pair is not a target get new numbers. The rows of both indices are merged, since their columns are sorted.
+ */
+static void numberNodes(Arena *arena, DepGraph *g) {
+    CSRIndex *pT = g->pIndexTarget, *pP = g->pIndexPrecond;
+    int nNodes = pT->nCells, r, c, t;
+    g->precondNode = (int *)iArena.Alloc(arena, (pP->nCells + 1) * sizeof(int));
+    for (r = 0; r < pP->nRows; r++) {
+        t = r < pT->nRows ? pT->rowStart[r] : 0;
+        for (c = pP->rowStart[r]; c < pP->rowStart[r + 1]; c++) {
+            while (r < pT->nRows && t < pT->rowStart[r + 1] && pT->cols[t] < pP->cols[c]) {
+                t++;
+            }
+            g->precondNode[c] = r < pT->nRows && t < pT->rowStart[r + 1] && pT->cols[t] == pP->cols[c] ? t : nNodes++;
+        }
+    }
+
+    g->nNodes = nNodes;
+    g->nTargets = pT->nCells;
+    g->nodeAttr = (int *)iArena.Alloc(arena, (nNodes + 1) * sizeof(int));
+    g->nodeVal = (int *)iArena.Alloc(arena, (nNodes + 1) * sizeof(int));
+    for (r = 0; r < pT->nRows; r++) {
+        for (c = pT->rowStart[r]; c < pT->rowStart[r + 1]; c++) {
+            g->nodeAttr[c] = r;
+            g->nodeVal[c] = pT->cols[c];
+        }
+    }
+    for (r = 0; r < pP->nRows; r++) {
+        for (c = pP->rowStart[r]; c < pP->rowStart[r + 1]; c++) {
+            g->nodeAttr[g->precondNode[c]] = r;
+            g->nodeVal[g->precondNode[c]] = pP->cols[c];
+        }
+    }
+}
+
+/**
+ * Build the edges in both directions: every entry (pair, rule) of the precondition index is an edge from the node
+ * of the pair to the node of the target of the rule. The edges of a node are bucketed by counting.
+ */
+static void buildEdges(Arena *arena, DepGraph *g) {
+    CSRIndex *pT = g->pIndexTarget, *pP = g->pIndexPrecond;
+    int nNodes = g->nNodes, maxRule = -1, c, i, u, v, e;
+    for (i = 0; i < pT->cellStart[pT->nCells]; i++) {
+        maxRule = pT->elems[i] > maxRule ? pT->elems[i] : maxRule;
+    }
+    int *ruleTarget = (int *)iArena.Alloc(arena, (maxRule + 2) * sizeof(int));
+    for (i = 0; i <= maxRule; i++) {
+        ruleTarget[i] = -1;
+    }
+    for (c = 0; c < pT->nCells; c++) {
+        for (i = pT->cellStart[c]; i < pT->cellStart[c + 1]; i++) {
+            ruleTarget[pT->elems[i]] = c;
+        }
+    }
+
+    g->outStart = (int *)iArena.Alloc(arena, (nNodes + 1) * sizeof(int));
+    g->inStart = (int *)iArena.Alloc(arena, (nNodes + 1) * sizeof(int));
+    memset(g->outStart, 0, (nNodes + 1) * sizeof(int));
+    memset(g->inStart, 0, (nNodes + 1) * sizeof(int));
+    int nEdges = 0;
+    for (c = 0; c < pP->nCells; c++) {
+        for (i = pP->cellStart[c]; i < pP->cellStart[c + 1]; i++) {
+            if (pP->elems[i] <= maxRule && ruleTarget[pP->elems[i]] >= 0) {
+                g->outStart[g->precondNode[c] + 1]++;
+                g->inStart[ruleTarget[pP->elems[i]] + 1]++;
+                nEdges++;
+            }
+        }
+    }
+    for (u = 0; u < nNodes; u++) {
+        g->outStart[u + 1] += g->outStart[u];
+        g->inStart[u + 1] += g->inStart[u];
+    }
+
+    g->nEdges = nEdges;
+    g->outAdj = (int *)iArena.Alloc(arena, (nEdges + 1) * sizeof(int));
+    g->outEdge = (int *)iArena.Alloc(arena, (nEdges + 1) * sizeof(int));
+    g->inAdj = (int *)iArena.Alloc(arena, (nEdges + 1) * sizeof(int));
+    g->inEdge = (int *)iArena.Alloc(arena, (nEdges + 1) * sizeof(int));
+    int *outNext = (int *)iArena.Alloc(arena, (nNodes + 1) * sizeof(int));
+    int *inNext = (int *)iArena.Alloc(arena, (nNodes + 1) * sizeof(int));
+    memcpy(outNext, g->outStart, (nNodes + 1) * sizeof(int));
+    memcpy(inNext, g->inStart, (nNodes + 1) * sizeof(int));
+    for (c = 0; c < pP->nCells; c++) {
+        u = g->precondNode[c];
+        for (i = pP->cellStart[c]; i < pP->cellStart[c + 1]; i++) {
+            if (pP->elems[i] > maxRule || (v = ruleTarget[pP->elems[i]]) < 0) {
+                continue;
+            }
+            e = outNext[u]++;
+            g->outAdj[e] = v;
+            g->outEdge[e] = i;
+            e = inNext[v]++;
+            g->inAdj[e] = u;
+            g->inEdge[e] = i;
+        }
+    }
+}
+
+/**
+ * Compute the SCCs with Tarjan's algorithm, where the recursion is replaced by an explicit call stack holding the
+ * node and the next out-edge to visit. Tarjan's algorithm completes an SCC after all the SCCs reachable from it,
+ * so the SCCs are numbered in reverse order of completion to get a topological order.
+ */
+static void computeSCCs(Arena *arena, DepGraph *g) {
+    int nNodes = g->nNodes, counter = 0, top = 0, callTop = 0, nSCCs = 0, s, u, v, w;
+    int *order = (int *)iArena.Alloc(arena, (nNodes + 1) * sizeof(int));
+    int *low = (int *)iArena.Alloc(arena, (nNodes + 1) * sizeof(int));
+    int *stack = (int *)iArena.Alloc(arena, (nNodes + 1) * sizeof(int));
+    int *callStack = (int *)iArena.Alloc(arena, (nNodes + 1) * sizeof(int));
+    int *nextEdge = (int *)iArena.Alloc(arena, (nNodes + 1) * sizeof(int));
+    char *onStack = (char *)iArena.Alloc(arena, nNodes + 1);
+    g->sccOf = (int *)iArena.Alloc(arena, (nNodes + 1) * sizeof(int));
+    memset(onStack, 0, nNodes + 1);
+    for (u = 0; u < nNodes; u++) {
+        order[u] = -1;
+    }
+
+    for (s = 0; s < nNodes; s++) {
+        if (order[s] != -1) {
+            continue;
+        }
+        order[s] = low[s] = counter++;
+        stack[top++] = s;
+        onStack[s] = 1;
+        nextEdge[s] = g->outStart[s];
+        callStack[callTop++] = s;
+        while (callTop > 0) {
+            u = callStack[callTop - 1];
+            if (nextEdge[u] < g->outStart[u + 1]) {
+                v = g->outAdj[nextEdge[u]++];
+                if (order[v] == -1) {
+                    order[v] = low[v] = counter++;
+                    stack[top++] = v;
+                    onStack[v] = 1;
+                    nextEdge[v] = g->outStart[v];
+                    callStack[callTop++] = v;
+                } else if (onStack[v] && order[v] < low[u]) {
+                    low[u] = order[v];
+                }
+                continue;
+            }
+            // All the out-edges of u are visited, return to its caller
+            callTop--;
+            if (callTop > 0 && low[u] < low[callStack[callTop - 1]]) {
+                low[callStack[callTop - 1]] = low[u];
+            }
+            if (low[u] == order[u]) {
+                do {
+                    w = stack[--top];
+                    onStack[w] = 0;
+                    g->sccOf[w] = nSCCs;
+                } while (w != u);
+                nSCCs++;
+            }
+        }
+    }
+
+    g->nSCCs = nSCCs;
+    g->sccStart = (int *)iArena.Alloc(arena, (nSCCs + 1) * sizeof(int));
+    g->sccNodes = (int *)iArena.Alloc(arena, (nNodes + 1) * sizeof(int));
+    memset(g->sccStart, 0, (nSCCs + 1) * sizeof(int));
+    for (u = 0; u < nNodes; u++) {
+        g->sccOf[u] = nSCCs - 1 - g->sccOf[u];
+        g->sccStart[g->sccOf[u] + 1]++;
+    }
+    for (s = 0; s < nSCCs; s++) {
+        g->sccStart[s + 1] += g->sccStart[s];
+        // low is reused as the insertion point of each SCC
+        low[s] = g->sccStart[s];
+    }
+    for (u = 0; u < nNodes; u++) {
+        g->sccNodes[low[g->sccOf[u]]++] = u;
+    }
+}
+
+static DepGraph *Build(Arena *arena, CSRIndex *pIndexTarget, CSRIndex *pIndexPrecond) {
+    DepGraph *g = (DepGraph *)iArena.Alloc(arena, sizeof(DepGraph));
+    g->pIndexTarget = pIndexTarget;
+    g->pIndexPrecond = pIndexPrecond;
+    numberNodes(arena, g);
+    buildEdges(arena, g);
+    computeSCCs(arena, g);
+    return g;
+}
+
+static int Find(DepGraph *g, int attrIdx, int valIdx) {
+    int c = iCSRIndex.Find(g->pIndexTarget, attrIdx, valIdx);
+    if (c >= 0) {
+        return c;
+    }
+    c = iCSRIndex.Find(g->pIndexPrecond, attrIdx, valIdx);
+    return c < 0 ? -1 : g->precondNode[c];
+}
+
+static int InCycle(DepGraph *g, int node) {
+    int scc = g->sccOf[node], e;
+    if (g->sccStart[scc + 1] - g->sccStart[scc] > 1) {
+        return 1;
+    }
+    for (e = g->outStart[node]; e < g->outStart[node + 1]; e++) {
+        if (g->outAdj[e] == node) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Mark the nodes reachable from the seeds along the edges of one direction, skipping the dead edges.
+ * Only the nodes whose SCC is at most @{maxSCC} are visited.
+ */
+static int traverse(DepGraph *g, int *start, int *adj, int *edgeIds, int *seeds, int nSeeds, const char *edgeLive, char *visited,
+                    int maxSCC) {
+    int *stack = (int *)malloc((g->nNodes + 1) * sizeof(int));
+    int top = 0, nVisited = 0, i, u, v, e;
+    for (i = 0; i < nSeeds; i++) {
+        if (seeds[i] >= 0 && !visited[seeds[i]]) {
+            visited[seeds[i]] = 1;
+            stack[top++] = seeds[i];
+            nVisited++;
+        }
+    }
+    while (top > 0) {
+        u = stack[--top];
+        for (e = start[u]; e < start[u + 1]; e++) {
+            v = adj[e];
+            if (visited[v] || g->sccOf[v] > maxSCC || (edgeLive != NULL && !edgeLive[edgeIds[e]])) {
+                continue;
+            }
+            visited[v] = 1;
+            stack[top++] = v;
+            nVisited++;
+        }
+    }
+    free(stack);
+    return nVisited;
+}
+
+static int IsReachable(DepGraph *g, int from, int to) {
+    if (from < 0 || to < 0 || g->sccOf[from] > g->sccOf[to]) {
+        return 0;
+    }
+    if (g->sccOf[from] == g->sccOf[to]) {
+        return 1;
+    }
+    // The SCCs on a path from @{from} to @{to} are between theirs in the topological order
+    char *visited = (char *)calloc(g->nNodes + 1, 1);
+    traverse(g, g->outStart, g->outAdj, g->outEdge, &from, 1, NULL, visited, g->sccOf[to]);
+    int reachable = visited[to];
+    free(visited);
+    return reachable;
+}
+
+static int Forward(DepGraph *g, int *seeds, int nSeeds, const char *edgeLive, char *visited) {
+    return traverse(g, g->outStart, g->outAdj, g->outEdge, seeds, nSeeds, edgeLive, visited, g->nSCCs);
+}
+
+static int Backward(DepGraph *g, int *seeds, int nSeeds, const char *edgeLive, char *visited) {
+    return traverse(g, g->inStart, g->inAdj, g->inEdge, seeds, nSeeds, edgeLive, visited, g->nSCCs);
+}
+
+DepGraphInterface iDepGraph = {
+    .Build = Build,
+    .Find = Find,
+    .InCycle = InCycle,
+    .IsReachable = IsReachable,
+    .Forward = Forward,
+    .Backward = Backward,
+};
@@ -48,7 +48,7 @@ static void computePR(char *instFile, char *resultFile) {
     // 进行global pruning
     pInst = userCleaning(pInst);
     ACoACResult result = {.code = ACoAC_RESULT_UNKNOWN};
-    pInst = slice(pInst, &result);
+    pInst = sliceIncremental(pInst, &result);
 
     if (result.code == ACoAC_RESULT_REACHABLE || result.code == ACoAC_RESULT_UNREACHABLE) {
         // 如果global pruning后即可判断实例的可达性，说明所有规则均为冗余，剪枝后规则数为0，并且不需要进行local pruning
@@ -82,7 +82,7 @@ static void computePR(char *instFile, char *resultFile) {
         }
         nRulesBeforeLP[cnt] = iHashSet.Size(next->pSetRuleIdxes);
         result = (ACoACResult){.code = ACoAC_RESULT_UNKNOWN};
-        next = slice(next, &result);
+        next = sliceIncremental(next, &result);
 
         if (result.code == ACoAC_RESULT_REACHABLE) {
             nRulesAfterLP[cnt] = 0;
@@ -100,6 +100,7 @@ static void computePR(char *instFile, char *resultFile) {
             nRulesAfterLP[cnt] = 0;
         }
         cnt++;
+        finalizeSubPolicy(pAbsRef, next);
         next = refine(pAbsRef);
     }
 
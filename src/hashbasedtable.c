@@ -3,10 +3,11 @@
 
 #include "hashbasedtable.h"
 
-static HashBasedTable *Create(int rowKeySize, int colKeySize, int valueSize, Hashcode rowHashCode, KeyEqual rowKeyEqual, Hashcode colHashCode, KeyEqual colKeyEqual) {
-    HashBasedTable *hashTable = (HashBasedTable *)malloc(sizeof(HashBasedTable));
-    hashTable->pRowMap = iHashMap.Create(rowKeySize, sizeof(HashMap *), rowHashCode, rowKeyEqual);
+static HashBasedTable *CreateInArena(Arena *arena, int rowKeySize, int colKeySize, int valueSize, Hashcode rowHashCode, KeyEqual rowKeyEqual, Hashcode colHashCode, KeyEqual colKeyEqual) {
+    HashBasedTable *hashTable = (HashBasedTable *)(arena != NULL ? iArena.Alloc(arena, sizeof(HashBasedTable)) : malloc(sizeof(HashBasedTable)));
+    hashTable->pRowMap = iHashMap.CreateInArena(arena, rowKeySize, sizeof(HashMap *), rowHashCode, rowKeyEqual);
     iHashMap.SetDestructValue(hashTable->pRowMap, iHashMap.DestructPointer);
+    hashTable->arena = arena;
 
     hashTable->colKeySize = colKeySize;
     hashTable->valueSize = valueSize;
@@ -17,10 +18,14 @@ static HashBasedTable *Create(int rowKeySize, int colKeySize, int valueSize, Has
     return hashTable;
 }
 
+static HashBasedTable *Create(int rowKeySize, int colKeySize, int valueSize, Hashcode rowHashCode, KeyEqual rowKeyEqual, Hashcode colHashCode, KeyEqual colKeyEqual) {
+    return CreateInArena(NULL, rowKeySize, colKeySize, valueSize, rowHashCode, rowKeyEqual, colHashCode, colKeyEqual);
+}
+
 static int Put(HashBasedTable *hashTable, void *rowKey, void *colKey, void *value) {
     HashMap *pColMap, **ppColMap = iHashMap.Get(hashTable->pRowMap, rowKey);
     if (ppColMap == NULL) {
-        pColMap = iHashMap.Create(hashTable->colKeySize, hashTable->valueSize, hashTable->colHashCode, hashTable->colKeyEqual);
+        pColMap = iHashMap.CreateInArena(hashTable->arena, hashTable->colKeySize, hashTable->valueSize, hashTable->colHashCode, hashTable->colKeyEqual);
         if (hashTable->destructValue != NULL) {
             iHashMap.SetDestructValue(pColMap, hashTable->destructValue);
         }
@@ -65,12 +70,20 @@ static void Clear(HashBasedTable *hashTable) {
 }
 
 static void Finalize(HashBasedTable *hashTable) {
+    if (hashTable->arena != NULL) {
+        // The maps are released with the arena, they only need to be visited to run the destructors
+        if (hashTable->pRowMap->destructKey != NULL || hashTable->destructValue != NULL) {
+            iHashMap.Finalize(hashTable->pRowMap);
+        }
+        return;
+    }
     iHashMap.Finalize(hashTable->pRowMap);
     free(hashTable);
 }
 
 HashBasedTableInterface iHashBasedTable = {
     .Create = Create,
+    .CreateInArena = CreateInArena,
     .Put = Put,
     .Get = Get,
     .GetRow = GetRow,
@@ -92,7 +92,23 @@ int Size(HashMap *hashMap) {
     return hashMap->size;
 }
 
-static HashNode *newNode(unsigned int hash, void *key, int keySize, void *value, int valueSize, HashNode *next) {
+/**
+ * Allocate a node holding copies of the key and the value. In an arena, the node and the two copies are
+ * allocated as one block.
+ */
+static HashNode *newNode(Arena *arena, unsigned int hash, void *key, int keySize, void *value, int valueSize, HashNode *next) {
+    if (arena != NULL) {
+        size_t keyOffset = (sizeof(HashNode) + 7) & ~(size_t)7;
+        size_t valueOffset = keyOffset + (((size_t)keySize + 7) & ~(size_t)7);
+        HashNode *node = (HashNode *)iArena.Alloc(arena, valueOffset + valueSize);
+        node->hash = hash;
+        node->key = (char *)node + keyOffset;
+        memcpy(node->key, key, keySize);
+        node->value = (char *)node + valueOffset;
+        memcpy(node->value, value, valueSize);
+        node->next = next;
+        return node;
+    }
     HashNode *node = (HashNode *)malloc(sizeof(HashNode));
     node->hash = hash;
     char *keyCopy = (char *)malloc(keySize);
@@ -143,7 +159,12 @@ static HashNode **resize(HashMap *hashMap) {
         newThr = (newCap < MAXIMUM_CAPACITY && ft < (float)MAXIMUM_CAPACITY ? (int)ft : MAX_INTEGER);
     }
     hashMap->threshold = newThr;
-    HashNode **newTab = (HashNode **)malloc(newCap * sizeof(HashNode *));
+    HashNode **newTab;
+    if (hashMap->arena != NULL) {
+        newTab = (HashNode **)iArena.Alloc(hashMap->arena, newCap * sizeof(HashNode *));
+    } else {
+        newTab = (HashNode **)malloc(newCap * sizeof(HashNode *));
+    }
     memset(newTab, 0, newCap * sizeof(HashNode *));
     hashMap->table = newTab;
     hashMap->tableLen = newCap;
@@ -186,7 +207,9 @@ static HashNode **resize(HashMap *hashMap) {
                 }
             }
         }
-        free(oldTab);
+        if (hashMap->arena == NULL) {
+            free(oldTab);
+        }
     }
     return newTab;
 }
@@ -200,7 +223,7 @@ static int putVal(HashMap *hashMap, unsigned int hash, void *key, void *value, i
         n = hashMap->tableLen;
     }
     if ((p = tab[i = (n - 1) & hash]) == NULL)
-        tab[i] = newNode(hash, key, hashMap->keySize, value, hashMap->valueSize, NULL);
+        tab[i] = newNode(hashMap->arena, hash, key, hashMap->keySize, value, hashMap->valueSize, NULL);
     else {
         HashNode *e;
         void *k;
@@ -211,7 +234,7 @@ static int putVal(HashMap *hashMap, unsigned int hash, void *key, void *value, i
             int binCount;
             for (binCount = 0;; ++binCount) {
                 if ((e = p->next) == NULL) {
-                    p->next = newNode(hash, key, hashMap->keySize, value, hashMap->valueSize, NULL);
+                    p->next = newNode(hashMap->arena, hash, key, hashMap->keySize, value, hashMap->valueSize, NULL);
                     /*if (binCount >= TREEIFY_THRESHOLD - 1)
                         //change the link list to a red-black tree
                         treeifyBin(tab, hash);*/
@@ -309,20 +332,22 @@ static int removeNode(HashMap *hashMap, unsigned int hash, void *key, void *valu
             if (hashMap->destructKey != NULL) {
                 hashMap->destructKey(node->key);
             }
-            free(node->key);
             if (hashMap->destructValue != NULL) {
                 hashMap->destructValue(node->value);
             }
-            free(node->value);
-            free(node);
+            if (hashMap->arena == NULL) {
+                free(node->key);
+                free(node->value);
+                free(node);
+            }
             return 1;
         }
     }
     return 0;
 }
 
-static HashMap *Create(int keySize, int valueSize, Hashcode hashcode, KeyEqual keyEqual) {
-    HashMap *hashMap = (HashMap *)malloc(sizeof(HashMap));
+static HashMap *CreateInArena(Arena *arena, int keySize, int valueSize, Hashcode hashcode, KeyEqual keyEqual) {
+    HashMap *hashMap = (HashMap *)(arena != NULL ? iArena.Alloc(arena, sizeof(HashMap)) : malloc(sizeof(HashMap)));
     hashMap->size = 0;
     hashMap->keySize = keySize;
     hashMap->valueSize = valueSize;
@@ -335,13 +360,32 @@ static HashMap *Create(int keySize, int valueSize, Hashcode hashcode, KeyEqual k
     hashMap->valueToString = DefaultElementToString;
     hashMap->destructKey = NULL;
     hashMap->destructValue = NULL;
+    hashMap->arena = arena;
     return hashMap;
 }
 
+static HashMap *Create(int keySize, int valueSize, Hashcode hashcode, KeyEqual keyEqual) {
+    return CreateInArena(NULL, keySize, valueSize, hashcode, keyEqual);
+}
+
 static int Put(HashMap *hashMap, void *key, void *value) {
     return putVal(hashMap, hashMap->hashcode(key), key, value, 0, 0);
 }
 
+static int PutAll(HashMap *hashMap, HashMap *hashMap2) {
+    int i, size = hashMap->size;
+    HashNode *e;
+    if (hashMap2->table == NULL) {
+        return 0;
+    }
+    for (i = 0; i < hashMap2->tableLen; ++i) {
+        for (e = hashMap2->table[i]; e != NULL; e = e->next) {
+            putVal(hashMap, e->hash, e->key, e->value, 0, 0);
+        }
+    }
+    return hashMap->size > size;
+}
+
 static int ContainsKey(HashMap *hashMap, void *key) {
     return getNode(hashMap, key) != NULL;
 }
@@ -373,12 +417,14 @@ static void Clear(HashMap *hashMap) {
                     if (hashMap->destructKey != NULL) {
                         hashMap->destructKey(e->key);
                     }
-                    free(e->key);
                     if (hashMap->destructValue != NULL) {
                         hashMap->destructValue(e->value);
                     }
-                    free(e->value);
-                    free(e);
+                    if (hashMap->arena == NULL) {
+                        free(e->key);
+                        free(e->value);
+                        free(e);
+                    }
                     e = next;
                 } while (e != NULL);
                 tab[i] = NULL;
@@ -391,6 +437,13 @@ static void Finalize(HashMap *hashMap) {
     if (hashMap == NULL) {
         return;
     }
+    if (hashMap->arena != NULL) {
+        // The memory is released with the arena, only the destructors need to be run
+        if (hashMap->destructKey != NULL || hashMap->destructValue != NULL) {
+            Clear(hashMap);
+        }
+        return;
+    }
     Clear(hashMap);
     free(hashMap->table);
     hashMap->table = NULL;
@@ -427,9 +480,8 @@ static void RemoveCurrent(HashNodeIterator *it) {
     removeNode(it->hashMap, p->hash, p->key, NULL, 0, 0);
 }
 
-static HashNodeIterator *NewIterator(HashMap *hashMap) {
+static void InitIterator(HashMap *hashMap, HashNodeIterator *it) {
     HashNode **t = hashMap->table;
-    HashNodeIterator *it = (HashNodeIterator *)malloc(sizeof(HashNodeIterator));
     it->hashMap = hashMap;
     it->current = NULL;
     it->next = NULL;
@@ -441,6 +493,11 @@ static HashNodeIterator *NewIterator(HashMap *hashMap) {
     it->HasNext = HasNext;
     it->GetNext = GetNext;
     it->Remove = RemoveCurrent;
+}
+
+static HashNodeIterator *NewIterator(HashMap *hashMap) {
+    HashNodeIterator *it = (HashNodeIterator *)malloc(sizeof(HashNodeIterator));
+    InitIterator(hashMap, it);
     return it;
 }
 
@@ -503,7 +560,9 @@ static int HashMapEqual(HashMap *hashMap, HashMap *hashMap2) {
 
 HashMapInterface iHashMap = {
     .Create = Create,
+    .CreateInArena = CreateInArena,
     .Put = Put,
+    .PutAll = PutAll,
     .ContainsKey = ContainsKey,
     .Get = Get,
     .GetOrDefault = GetOrDefault,
@@ -519,4 +578,5 @@ HashMapInterface iHashMap = {
     .SetDestructValue = SetDestructValue,
     .DestructPointer = DestructHashMapPointer,
     .NewIterator = NewIterator,
-    .DeleteIterator = DeleteIterator};
\ No newline at end of file
+    .DeleteIterator = DeleteIterator,
+    .InitIterator = InitIterator};
\ No newline at end of file
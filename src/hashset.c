@@ -9,10 +9,18 @@ static HashSet *Create(int valueSize, Hashcode hashCode, KeyEqual keyEqual) {
     return iHashMap.Create(valueSize, sizeof(char), hashCode, keyEqual);
 }
 
+static HashSet *CreateInArena(Arena *arena, int valueSize, Hashcode hashCode, KeyEqual keyEqual) {
+    return iHashMap.CreateInArena(arena, valueSize, sizeof(char), hashCode, keyEqual);
+}
+
 static int Add(HashSet *hashSet, void *newval) {
     return !iHashMap.Put(hashSet, newval, defaultValue);
 }
 
+static int AddAll(HashSet *hashSet1, HashSet *hashSet2) {
+    return iHashMap.PutAll(hashSet1, hashSet2);
+}
+
 static int Size(HashSet *hashSet) {
     return iHashMap.Size(hashSet);
 }
@@ -33,6 +41,11 @@ static void *GetNext(HashNodeIterator *it) {
     return e->key;
 }
 
+static void InitIterator(HashSet *hashSet, HashSetIterator *it) {
+    iHashMap.InitIterator(hashSet, it);
+    it->GetNext = GetNext;
+}
+
 static HashSetIterator *NewIterator(HashSet *hashSet) {
     HashSetIterator *it = iHashMap.NewIterator(hashSet);
     it->GetNext = GetNext;
@@ -60,14 +73,14 @@ static int Contains(HashSet *hashSet, void *element) {
  */
 static int RetainAll(HashSet *hashSet1, HashSet *hashSet2) {
     int modified = 0;
-    HashSetIterator *it = NewIterator(hashSet1);
-    while (it->HasNext(it)) {
-        if (!Contains(hashSet2, it->GetNext(it))) {
-            it->Remove(it);
+    HashSetIterator it;
+    InitIterator(hashSet1, &it);
+    while (it.HasNext(&it)) {
+        if (!Contains(hashSet2, it.GetNext(&it))) {
+            it.Remove(&it);
             modified = 1;
         }
     }
-    DeleteIterator(it);
     return modified;
 }
 
@@ -81,25 +94,25 @@ static void Clear(HashSet *hashSet) {
 
 static int containsAll(HashSet *hashSet1, HashSet *hashSet2) {
     int ret = 1;
-    HashSetIterator *it = NewIterator(hashSet2);
-    while (it->HasNext(it)) {
-        if (!Contains(hashSet1, it->GetNext(it))) {
+    HashSetIterator it;
+    InitIterator(hashSet2, &it);
+    while (it.HasNext(&it)) {
+        if (!Contains(hashSet1, it.GetNext(&it))) {
             ret = 0;
             break;
         }
     }
-    iHashMap.DeleteIterator(it);
     return ret;
 }
 
 static unsigned int HashSetHashCode(void *hashSet) {
     HashSet *hs = *(HashSet **)hashSet;
     int hash = 1;
-    HashSetIterator *it = NewIterator(hs);
-    while (it->HasNext(it)) {
-        hash = 31 * hash + hs->hashcode(it->GetNext(it));
+    HashSetIterator it;
+    InitIterator(hs, &it);
+    while (it.HasNext(&it)) {
+        hash = 31 * hash + hs->hashcode(it.GetNext(&it));
     }
-    iHashMap.DeleteIterator(it);
     return hash;
 }
 
@@ -126,15 +139,16 @@ static void Finalize(HashSet *hashSet) {
 
 static char *ToString(void *pHashSet) {
     HashSet *hashSet = *(HashSet **)pHashSet;
-    HashSetIterator *it = iHashSet.NewIterator(hashSet);
+    HashSetIterator it;
+    InitIterator(hashSet, &it);
     char *e;
     char *ret = (char *)malloc(3);
     int cur = 0;
     ret[cur++] = '[';
     int first = 1;
     int elementLen;
-    while (it->HasNext(it)) {
-        e = hashSet->keyToString(it->GetNext(it));
+    while (it.HasNext(&it)) {
+        e = hashSet->keyToString(it.GetNext(&it));
         elementLen = strlen(e);
         ret = (char *)realloc(ret, cur + elementLen + 4);
         if (first) {
@@ -149,7 +163,6 @@ static char *ToString(void *pHashSet) {
     }
     ret[cur++] = ']';
     ret[cur++] = '\0';
-    iHashSet.DeleteIterator(it);
     return ret;
 }
 
@@ -167,7 +180,9 @@ static void DestructHashSetPointer(void *pHashSet) {
 
 HashSetInterface iHashSet = {
     .Create = Create,
+    .CreateInArena = CreateInArena,
     .Add = Add,
+    .AddAll = AddAll,
     .Contains = Contains,
     .containsAll = containsAll,
     .HashCode = HashSetHashCode,
@@ -184,4 +199,5 @@ HashSetInterface iHashSet = {
     .DestructPointer = DestructHashSetPointer,
     .NewIterator = NewIterator,
     .DeleteIterator = DeleteIterator,
+    .InitIterator = InitIterator,
 };
\ No newline at end of file
@@ -0,0 +1,98 @@
+#include "initstate.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#define WORD_BITS 64
+
+static InitState *Create(HashBasedTable *pTableInitState, int nUsers, int nAttrs, IntMap *pmapAttr2DefVal) {
+    InitState *state = (InitState *)malloc(sizeof(InitState));
+    if (state == NULL) {
+        printf("[Error] InitState Create: failed to allocate memory\n");
+        abort();
+    }
+    state->nUsers = nUsers;
+    state->nAttrs = nAttrs;
+    // The columns are slices of one block
+    state->values = (int *)malloc(((size_t)nAttrs * (nUsers + 1) + 1) * sizeof(int));
+    state->columns = (int **)malloc((nAttrs + 1) * sizeof(int *));
+    state->nListed = (int *)malloc((nAttrs + 1) * sizeof(int));
+    if (state->values == NULL || state->columns == NULL || state->nListed == NULL) {
+        printf("[Error] InitState Create: failed to allocate memory\n");
+        abort();
+    }
+    state->nRows = iHashMap.Size(pTableInitState->pRowMap);
+
+    int attrIdx, userIdx, defValIdx, *pDefValIdx, *column;
+    for (attrIdx = 0; attrIdx < nAttrs; attrIdx++) {
+        column = state->values + (size_t)attrIdx * (nUsers + 1);
+        pDefValIdx = (int *)iIntMap.Get(pmapAttr2DefVal, attrIdx);
+        defValIdx = pDefValIdx == NULL ? -1 : *pDefValIdx;
+        for (userIdx = 0; userIdx <= nUsers; userIdx++) {
+            column[userIdx] = defValIdx;
+        }
+        state->columns[attrIdx] = column;
+        state->nListed[attrIdx] = 0;
+    }
+
+    HashNodeIterator itRows, itAVs;
+    HashNode *nodeRow, *nodeAV;
+    iHashMap.InitIterator(pTableInitState->pRowMap, &itRows);
+    while (itRows.HasNext(&itRows)) {
+        nodeRow = (HashNode *)itRows.GetNext(&itRows);
+        userIdx = *(int *)nodeRow->key;
+        iHashMap.InitIterator(*(HashMap **)nodeRow->value, &itAVs);
+        while (itAVs.HasNext(&itAVs)) {
+            nodeAV = (HashNode *)itAVs.GetNext(&itAVs);
+            attrIdx = *(int *)nodeAV->key;
+            state->columns[attrIdx][userIdx] = *(int *)nodeAV->value;
+            state->nListed[attrIdx]++;
+        }
+    }
+    return state;
+}
+
+static int Get(InitState *state, int userIdx, int attrIdx) {
+    return state->columns[attrIdx][userIdx];
+}
+
+static void EvalAtom(InitState *state, IntervalTest *test, int from, int n, uint64_t *bits) {
+    const int *column = state->columns[test->attribute] + from;
+    int i = 0;
+    memset(bits, 0, (n + WORD_BITS - 1) / WORD_BITS * sizeof(uint64_t));
+#if defined(__AVX2__)
+    // A user is out of [lo, hi] if lo > v or v > hi, which is tested for 8 users per instruction and gathered into
+    // 8 bits by the sign bits of the lanes
+    __m256i lo = _mm256_set1_epi32(test->lo), hi = _mm256_set1_epi32(test->hi);
+    __m256i in = _mm256_set1_epi32(test->negated ? 0 : -1), v, out;
+    for (; i + 8 <= n; i += 8) {
+        v = _mm256_loadu_si256((const __m256i *)(column + i));
+        out = _mm256_or_si256(_mm256_cmpgt_epi32(lo, v), _mm256_cmpgt_epi32(v, hi));
+        bits[i / WORD_BITS] |= (uint64_t)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_xor_si256(out, in))) << (i % WORD_BITS);
+    }
+#endif
+    for (; i < n; i++) {
+        bits[i / WORD_BITS] |= (uint64_t)INTERVAL_TEST(test, column[i]) << (i % WORD_BITS);
+    }
+}
+
+static void Finalize(InitState *state) {
+    if (state == NULL) {
+        return;
+    }
+    free(state->values);
+    free(state->columns);
+    free(state->nListed);
+    free(state);
+}
+
+InitStateInterface iInitState = {
+    .Create = Create,
+    .Get = Get,
+    .EvalAtom = EvalAtom,
+    .Finalize = Finalize,
+};
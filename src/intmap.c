@@ -0,0 +1,221 @@
+#include "intmap.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DEFAULT_INITIAL_CAPACITY 16
+// The table is resized when (size + nDeleted) > capacity * 3 / 4
+#define LOAD_FACTOR_NUM 3
+#define LOAD_FACTOR_DEN 4
+
+static IntMap *Create(int valueSize) {
+    IntMap *map = (IntMap *)malloc(sizeof(IntMap));
+    if (map == NULL) {
+        printf("[Error] IntMap Create: failed to allocate memory\n");
+        abort();
+    }
+    map->keys = NULL;
+    map->values = NULL;
+    map->capacity = 0;
+    map->size = 0;
+    map->nDeleted = 0;
+    map->valueSize = valueSize;
+    map->destructValue = NULL;
+    return map;
+}
+
+/**
+ * Allocate a table with @{capacity} slots and re-insert the entries of the old table, dropping the tombstones.
+ */
+static void rehash(IntMap *map, int capacity) {
+    int *oldKeys = map->keys;
+    char *oldValues = map->values;
+    int oldCapacity = map->capacity;
+    map->keys = (int *)malloc(capacity * sizeof(int));
+    map->values = map->valueSize > 0 ? (char *)malloc((size_t)capacity * map->valueSize) : NULL;
+    if (map->keys == NULL || (map->valueSize > 0 && map->values == NULL)) {
+        printf("[Error] IntMap rehash: failed to allocate memory\n");
+        abort();
+    }
+    int i, j, mask = capacity - 1;
+    for (i = 0; i < capacity; i++) {
+        map->keys[i] = INTMAP_EMPTY_KEY;
+    }
+    map->capacity = capacity;
+    map->nDeleted = 0;
+    for (i = 0; i < oldCapacity; i++) {
+        if (oldKeys[i] == INTMAP_EMPTY_KEY || oldKeys[i] == INTMAP_DELETED_KEY) {
+            continue;
+        }
+        for (j = (unsigned int)oldKeys[i] & mask; map->keys[j] != INTMAP_EMPTY_KEY; j = (j + 1) & mask) {
+        }
+        map->keys[j] = oldKeys[i];
+        if (map->valueSize > 0) {
+            memcpy(map->values + (size_t)j * map->valueSize, oldValues + (size_t)i * map->valueSize, map->valueSize);
+        }
+    }
+    free(oldKeys);
+    free(oldValues);
+}
+
+/**
+ * Find the slot of a key.
+ *
+ * @return The slot of the key, or -1 if the key does not exist
+ */
+static int findSlot(IntMap *map, int key) {
+    if (map->size == 0) {
+        return -1;
+    }
+    int mask = map->capacity - 1, i, k;
+    for (i = (unsigned int)key & mask; (k = map->keys[i]) != INTMAP_EMPTY_KEY; i = (i + 1) & mask) {
+        if (k == key) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static int Put(IntMap *map, int key, void *value) {
+    if (key == INTMAP_EMPTY_KEY || key == INTMAP_DELETED_KEY) {
+        printf("[Error] IntMap Put: the key %d is reserved\n", key);
+        abort();
+    }
+    if (map->capacity == 0) {
+        rehash(map, DEFAULT_INITIAL_CAPACITY);
+    }
+    int mask = map->capacity - 1, i, k, tombstone = -1;
+    for (i = (unsigned int)key & mask; (k = map->keys[i]) != INTMAP_EMPTY_KEY; i = (i + 1) & mask) {
+        if (k == key) {
+            if (map->valueSize > 0) {
+                memcpy(map->values + (size_t)i * map->valueSize, value, map->valueSize);
+            }
+            return 1;
+        }
+        if (k == INTMAP_DELETED_KEY && tombstone < 0) {
+            tombstone = i;
+        }
+    }
+    if (tombstone >= 0) {
+        // Reuse the first tombstone on the probe sequence
+        i = tombstone;
+        map->nDeleted--;
+    }
+    map->keys[i] = key;
+    if (map->valueSize > 0) {
+        memcpy(map->values + (size_t)i * map->valueSize, value, map->valueSize);
+    }
+    map->size++;
+    if ((long)(map->size + map->nDeleted) * LOAD_FACTOR_DEN > (long)map->capacity * LOAD_FACTOR_NUM) {
+        // Grow only if the live entries need it, otherwise just drop the tombstones
+        rehash(map, (long)map->size * LOAD_FACTOR_DEN > (long)map->capacity * LOAD_FACTOR_NUM / 2 ? map->capacity * 2 : map->capacity);
+    }
+    return 0;
+}
+
+static void *Get(IntMap *map, int key) {
+    int i = findSlot(map, key);
+    if (i < 0) {
+        return NULL;
+    }
+    return map->valueSize > 0 ? map->values + (size_t)i * map->valueSize : (void *)&map->keys[i];
+}
+
+static int ContainsKey(IntMap *map, int key) {
+    return findSlot(map, key) >= 0;
+}
+
+static void removeSlot(IntMap *map, int i) {
+    if (map->destructValue != NULL) {
+        map->destructValue(map->values + (size_t)i * map->valueSize);
+    }
+    map->keys[i] = INTMAP_DELETED_KEY;
+    map->size--;
+    map->nDeleted++;
+}
+
+static int Remove(IntMap *map, int key) {
+    int i = findSlot(map, key);
+    if (i < 0) {
+        return 0;
+    }
+    removeSlot(map, i);
+    return 1;
+}
+
+static void Clear(IntMap *map) {
+    int i;
+    for (i = 0; i < map->capacity; i++) {
+        if (map->destructValue != NULL && map->keys[i] != INTMAP_EMPTY_KEY && map->keys[i] != INTMAP_DELETED_KEY) {
+            map->destructValue(map->values + (size_t)i * map->valueSize);
+        }
+        map->keys[i] = INTMAP_EMPTY_KEY;
+    }
+    map->size = 0;
+    map->nDeleted = 0;
+}
+
+static int Size(IntMap *map) {
+    return map->size;
+}
+
+static void Finalize(IntMap *map) {
+    if (map == NULL) {
+        return;
+    }
+    Clear(map);
+    free(map->keys);
+    free(map->values);
+    free(map);
+}
+
+static DestructFn SetDestructValue(IntMap *map, DestructFn destructValue) {
+    DestructFn old = map->destructValue;
+    map->destructValue = destructValue;
+    return old;
+}
+
+static void InitIterator(IntMap *map, IntMapIterator *it) {
+    it->map = map;
+    it->index = -1;
+    it->key = INTMAP_EMPTY_KEY;
+    it->value = NULL;
+}
+
+static int Next(IntMapIterator *it) {
+    IntMap *map = it->map;
+    int k;
+    while (++it->index < map->capacity) {
+        k = map->keys[it->index];
+        if (k != INTMAP_EMPTY_KEY && k != INTMAP_DELETED_KEY) {
+            it->key = k;
+            it->value = map->valueSize > 0 ? map->values + (size_t)it->index * map->valueSize : (void *)&map->keys[it->index];
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void RemoveCurrent(IntMapIterator *it) {
+    if (it->index < 0 || it->index >= it->map->capacity || it->map->keys[it->index] != it->key) {
+        printf("[Error] IntMap RemoveCurrent: no current entry\n");
+        abort();
+    }
+    // A tombstone keeps the probe sequences of the remaining entries, so the iteration can go on
+    removeSlot(it->map, it->index);
+}
+
+IntMapInterface iIntMap = {
+    .Create = Create,
+    .Put = Put,
+    .Get = Get,
+    .ContainsKey = ContainsKey,
+    .Remove = Remove,
+    .Clear = Clear,
+    .Size = Size,
+    .Finalize = Finalize,
+    .SetDestructValue = SetDestructValue,
+    .InitIterator = InitIterator,
+    .Next = Next,
+    .RemoveCurrent = RemoveCurrent,
+};
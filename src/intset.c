@@ -0,0 +1,50 @@
+#include "intset.h"
+#include <stddef.h>
+
+static IntSet *Create() {
+    return iIntMap.Create(0);
+}
+
+static int Add(IntSet *set, int element) {
+    return !iIntMap.Put(set, element, NULL);
+}
+
+static int Contains(IntSet *set, int element) {
+    return iIntMap.ContainsKey(set, element);
+}
+
+static int Remove(IntSet *set, int element) {
+    return iIntMap.Remove(set, element);
+}
+
+static void Clear(IntSet *set) {
+    iIntMap.Clear(set);
+}
+
+static int Size(IntSet *set) {
+    return iIntMap.Size(set);
+}
+
+static void Finalize(IntSet *set) {
+    iIntMap.Finalize(set);
+}
+
+static void InitIterator(IntSet *set, IntSetIterator *it) {
+    iIntMap.InitIterator(set, it);
+}
+
+static int Next(IntSetIterator *it) {
+    return iIntMap.Next(it);
+}
+
+IntSetInterface iIntSet = {
+    .Create = Create,
+    .Add = Add,
+    .Contains = Contains,
+    .Remove = Remove,
+    .Clear = Clear,
+    .Size = Size,
+    .Finalize = Finalize,
+    .InitIterator = InitIterator,
+    .Next = Next,
+};
@@ -1,7 +1,11 @@
 // #define _POSIX_C_SOURCE 199309L
+// For pipe2
+#define _GNU_SOURCE
 
 #include "mc_runner.h"
 #include "acoac_utils.h"
+#include <ctype.h>
+#include <fcntl.h>
 #include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -38,7 +42,9 @@ static char *run(char *cmdPath, char *args[], char *resultFilePath, long timeout
     free(cmd);
 
     int pipefd[2];
-    if (pipe(pipefd) == -1) {
+    // Keep the pipe from leaking into the model checkers started concurrently by other threads. The pipe is created
+    // close-on-exec, since another thread may fork between creating it and setting the flag with fcntl
+    if (pipe2(pipefd, O_CLOEXEC) == -1) {
         logACoAC(__func__, __LINE__, 0, ERROR, "Failed to create pipe\n");
         return NULL;
     }
@@ -189,30 +195,61 @@ char *runModelChecker(char *modelCheckerPath, char *nusmvFilePath, char *resultF
     return result;
 }
 
+#include "acoac_domcomp.h"
 #include "acoac_translator.h"
 #include <regex.h>
 
 #define PATTERN_SMC_UNREACHABLE "-- specification .* is true"
 #define PATTERN_BMC_UNREACHABLE "-- no counterexample found with bound"
 #define PATTERN_BMC_UNREACHABLE_LEN 37
+#define PATTERN_SPECIFICATION "-- specification"
+#define PATTERN_SPECIFICATION_LEN 16
+#define PATTERN_INVARIANT "-- invariant"
+#define PATTERN_INVARIANT_LEN 12
 
-int findRule(HashMap *state, HashBasedTable *pTableTargetAV2Rule, AdminstrativeAction action) {
-    int attrIdx = getAttrIndex(action.attr);
+/**
+ * Find a rule that authorizes an administrative action in a state of the query user.
+ * If the domain of the attribute is compressed, the value of the action is the representative of a class, and the
+ * rules setting the attribute to any value of the class are candidates. The value of the action is then replaced by
+ * the target value of the rule found, so that the action is concrete.
+ *
+ * @param state[in]: The state of the query user, in which the values of the compressed attributes are representatives.
+ * It is updated by the action if a rule is found
+ * @param pInst[in]: The ACoAC instance
+ * @param action[in]: The administrative action
+ * @return The index of the rule, -1 if no rule is found, -2 if the value of the action is invalid
+ */
+int findRule(HashMap *state, ACoACInstance *pInst, AdminstrativeAction *action) {
+    int attrIdx = getAttrIndex(action->attr);
+    AttrType attrType = getAttrType(action->attr);
     int valIdx;
-    if(getValueIndex(getAttrType(action.attr), action.val, &valIdx) != 0) {
+    if(getValueIndex(attrType, action->val, &valIdx) != 0) {
         return -2;
     }
-    HashSet **ppSetCandidateRules = (HashSet **)iHashBasedTable.Get(pTableTargetAV2Rule, &attrIdx, &valIdx);
-    if (ppSetCandidateRules != NULL) {
-        int ruleIdx;
-        Rule *pRule;
-        HashSetIterator *itSet = iHashSet.NewIterator(*ppSetCandidateRules);
-        while (itSet->HasNext(itSet)) {
-            ruleIdx = *(int *)itSet->GetNext(itSet);
-            pRule = (Rule *)iVector.GetElement(pVecRules, ruleIdx);
+    CSRIndex *pIndexTargetAV2Rule = getTargetAV2RuleIndex(pInst);
+    int cFirst = 0, cLast = -1, c, i;
+    int *pCandidateRules, nCandidateRules;
+    Rule *pRule;
+    if (pInst->pMapAttr2Classes != NULL && iIntMap.ContainsKey(pInst->pMapAttr2Classes, attrIdx) && attrIdx < pIndexTargetAV2Rule->nRows) {
+        cFirst = pIndexTargetAV2Rule->rowStart[attrIdx];
+        cLast = pIndexTargetAV2Rule->rowStart[attrIdx + 1] - 1;
+    } else if ((c = iCSRIndex.Find(pIndexTargetAV2Rule, attrIdx, valIdx)) >= 0) {
+        cFirst = cLast = c;
+    }
+    for (c = cFirst; c <= cLast; c++) {
+        if (getRepresentative(pInst, attrIdx, pIndexTargetAV2Rule->cols[c]) != valIdx) {
+            continue;
+        }
+        nCandidateRules = iCSRIndex.CellSize(pIndexTargetAV2Rule, c);
+        pCandidateRules = pIndexTargetAV2Rule->elems + pIndexTargetAV2Rule->cellStart[c];
+        for (i = 0; i < nCandidateRules; i++) {
+            pRule = (Rule *)iVector.GetElement(pVecRules, pCandidateRules[i]);
             if (iRule.CanBeManaged(pRule, state)) {
                 iHashMap.Put(state, &attrIdx, &valIdx);
-                return ruleIdx;
+                if (pIndexTargetAV2Rule->cols[c] != valIdx) {
+                    action->val = getValueByIndex(attrType, pIndexTargetAV2Rule->cols[c]);
+                }
+                return pCandidateRules[i];
             }
         }
     }
@@ -224,6 +261,8 @@ ACoACResult analyzeModelCheckerOutput(char *output, ACoACInstance *pInst, char *
 
     int waitAction = 0;
     int reachable = 0;
+    // Whether the lines belong to the result of a probe (see translateWithProbes), whose trace is skipped
+    int inProbe = 0;
     char *attr, *val;
 
     if (output == NULL) {
@@ -260,6 +299,14 @@ ACoACResult analyzeModelCheckerOutput(char *output, ACoACInstance *pInst, char *
             return (ACoACResult){ACoAC_RESULT_UNREACHABLE, NULL, NULL};
         }
 
+        if (strncmp(line, PATTERN_INVARIANT, PATTERN_INVARIANT_LEN) == 0 || strncmp(line, PATTERN_SPECIFICATION, PATTERN_SPECIFICATION_LEN) == 0) {
+            inProbe = line[3] == 'i';
+        }
+        if (inProbe) {
+            line = strtok(NULL, "\n");
+            continue;
+        }
+
         if (strstr(line, "State:")) {
             // 如果line中包含“State:”，意味者是目标状态是可达的，需要将解析出的管理操作记录下来
             if (reachable) {
@@ -300,27 +347,54 @@ ACoACResult analyzeModelCheckerOutput(char *output, ACoACInstance *pInst, char *
     if (!reachable) {
         return (ACoACResult){ACoAC_RESULT_ERROR, NULL, NULL};
     }
-    if (showRules) {
+    // 属性值域被压缩时，反例中的值是等价类的代表值，需要通过寻找规则将其还原为具体的值
+    if (showRules || pInst->pMapAttr2Classes != NULL) {
         HashMap *pMapState = iHashMap.Create(sizeof(int), sizeof(int), IntHashCode, IntEqual);
         HashNode *node;
+        int repIdx;
         HashNodeIterator *itMap = iHashMap.NewIterator(iHashBasedTable.GetRow(pInst->pTableInitState, &pInst->queryUserIdx));
         while (itMap->HasNext(itMap)) {
             node = itMap->GetNext(itMap);
-            iHashMap.Put(pMapState, node->key, node->value);
+            repIdx = getRepresentative(pInst, *(int *)node->key, *(int *)node->value);
+            iHashMap.Put(pMapState, node->key, &repIdx);
         }
         iHashMap.DeleteIterator(itMap);
 
-        Vector *pVecRules = iVector.Create(sizeof(Rule), iVector.Size(pVecActions));
+        Vector *pVecRules = iVector.Create(sizeof(int), iVector.Size(pVecActions));
         int i;
         for (i = 0; i < iVector.Size(pVecActions); i++) {
-            AdminstrativeAction action = *(AdminstrativeAction *)iVector.GetElement(pVecActions, i);
-            int ruleIdx = findRule(pMapState, pInst->pTableTargetAV2Rule, action);
+            int ruleIdx = findRule(pMapState, pInst, (AdminstrativeAction *)iVector.GetElement(pVecActions, i));
             if (ruleIdx < 0) {
                 logACoAC(__func__, __LINE__, 0, ERROR, "find no corresponding rule!\n");
             }
             iVector.Add(pVecRules, &ruleIdx);
         }
-        return (ACoACResult){ACoAC_RESULT_REACHABLE, pVecActions, pVecRules};
+        iHashMap.Finalize(pMapState);
+        if (showRules) {
+            return (ACoACResult){ACoAC_RESULT_REACHABLE, pVecActions, pVecRules};
+        }
+        iVector.Finalize(pVecRules);
     }
     return (ACoACResult){ACoAC_RESULT_REACHABLE, pVecActions, NULL};
-}
\ No newline at end of file
+}
+int analyzeProbeResults(char *output, int nProbes, char *reachable) {
+    if (output == NULL) {
+        return -1;
+    }
+    int i = 0;
+    char *line = output, *end, *tail;
+    while (i < nProbes && *line != '\0') {
+        end = strchr(line, '\n');
+        if (end == NULL) {
+            end = line + strlen(line);
+        }
+        if (strncmp(line, PATTERN_INVARIANT, PATTERN_INVARIANT_LEN) == 0) {
+            // Only a proved invariant tells that the attribute value is unreachable
+            for (tail = end; tail > line && isspace((unsigned char)tail[-1]); tail--) {
+            }
+            reachable[i++] = !(tail - line >= 7 && strncmp(tail - 7, "is true", 7) == 0);
+        }
+        line = *end == '\0' ? end : end + 1;
+    }
+    return i == nProbes ? 0 : -1;
+}
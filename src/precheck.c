@@ -14,7 +14,7 @@ static ACoACResult getReachableResultFromRules(ACoACInstance *pInst, Vector *rul
         action.adminIdx = pInst->queryUserIdx;
         action.userIdx = pInst->queryUserIdx;
         action.attr = istrCollection.GetElement(pscAttrs, pRule->targetAttrIdx);
-        attrType = *(AttrType *)iHashMap.Get(pmapAttr2Type, &pRule->targetAttrIdx);
+        attrType = *(AttrType *)iIntMap.Get(pmapAttr2Type, pRule->targetAttrIdx);
         action.val = getValueByIndex(attrType, pRule->targetValueIdx);
 
         iVector.Add(actions, &action);
@@ -26,36 +26,32 @@ static ACoACResult getReachableResultFromRules(ACoACInstance *pInst, Vector *rul
 }
 
 ACoACResult preCheck(ACoACInstance *pInst) {
-    HashMap *pmapQueryAVs = pInst->pmapQueryAVs;
-    HashBasedTable *pTableTargetAV2Rule = pInst->pTableTargetAV2Rule;
+    IntMap *pmapQueryAVs = pInst->pmapQueryAVs;
+    CSRIndex *pIndexTargetAV2Rule = getTargetAV2RuleIndex(pInst);
     Vector *pVecSelectedRuleIdxes = iVector.Create(sizeof(int), 0);
 
     // 第一阶段，对于a1=v1,...,an=vn形式的查询，依次检查是否存在目标为ai=vi且条件为true的规则，如果都存在，则说明查询属性组是可达的
     int success = 1, found;
-    HashNodeIterator *itQueryAVs = iHashMap.NewIterator(pmapQueryAVs);
+    IntMapIterator itQueryAVs;
     HashNode *node;
-    int queryAttrIdx, queryValueIdx, ruleIdx;
-    HashSet **ppSetRuleIdxes;
-    HashSetIterator *itRuleIdxes;
+    int queryAttrIdx, queryValueIdx, ruleIdx, *pRuleIdxes, nRuleIdxes, i;
     Rule *pRule;
-    while (itQueryAVs->HasNext(itQueryAVs)) {
-        node = (HashNode *)itQueryAVs->GetNext(itQueryAVs);
-        queryAttrIdx = *(int *)node->key;
-        queryValueIdx = *(int *)node->value;
+    iIntMap.InitIterator(pmapQueryAVs, &itQueryAVs);
+    while (iIntMap.Next(&itQueryAVs)) {
+        queryAttrIdx = itQueryAVs.key;
+        queryValueIdx = *(int *)itQueryAVs.value;
 
         if (queryValueIdx == getInitValue(pInst, pInst->queryUserIdx, queryAttrIdx)) {
             continue;
         }
-        ppSetRuleIdxes = (HashSet **)iHashBasedTable.Get(pTableTargetAV2Rule, &queryAttrIdx, &queryValueIdx);
-        if (ppSetRuleIdxes == NULL) {
+        nRuleIdxes = iCSRIndex.Get(pIndexTargetAV2Rule, queryAttrIdx, queryValueIdx, &pRuleIdxes);
+        if (nRuleIdxes == 0) {
             // 一定不可达
-            iHashMap.DeleteIterator(itQueryAVs);
             return (ACoACResult){.code = ACoAC_RESULT_UNREACHABLE};
         }
         found = 0;
-        itRuleIdxes = iHashSet.NewIterator(*ppSetRuleIdxes);
-        while (itRuleIdxes->HasNext(itRuleIdxes)) {
-            ruleIdx = *(int *)itRuleIdxes->GetNext(itRuleIdxes);
+        for (i = 0; i < nRuleIdxes; i++) {
+            ruleIdx = pRuleIdxes[i];
             pRule = (Rule *)iVector.GetElement(pVecRules, ruleIdx);
             if (iHashMap.Size(pRule->pmapUserCondValue) == 0) {
                 found = 1;
@@ -63,37 +59,33 @@ ACoACResult preCheck(ACoACInstance *pInst) {
                 break;
             }
         }
-        iHashSet.DeleteIterator(itRuleIdxes);
         if (!found) {
             success = 0;
             break;
         }
     }
-    iHashMap.DeleteIterator(itQueryAVs);
     if (success) {
         return getReachableResultFromRules(pInst, pVecSelectedRuleIdxes);
     }
 
     iVector.Clear(pVecSelectedRuleIdxes);
     // 如果目标属性值只有一对，遍历以其为目标的规则，判断这些规则的条件是否均可无条件满足
-    if (iHashMap.Size(pmapQueryAVs) == 1) {
-        itQueryAVs = iHashMap.NewIterator(pmapQueryAVs);
-        node = (HashNode *)itQueryAVs->GetNext(itQueryAVs);
-        queryAttrIdx = *(int *)node->key;
-        queryValueIdx = *(int *)node->value;
-        ppSetRuleIdxes = (HashSet **)iHashBasedTable.Get(pTableTargetAV2Rule, &queryAttrIdx, &queryValueIdx);
-        itRuleIdxes = iHashSet.NewIterator(*ppSetRuleIdxes);
+    if (iIntMap.Size(pmapQueryAVs) == 1) {
+        iIntMap.InitIterator(pmapQueryAVs, &itQueryAVs);
+        iIntMap.Next(&itQueryAVs);
+        queryAttrIdx = itQueryAVs.key;
+        queryValueIdx = *(int *)itQueryAVs.value;
+        nRuleIdxes = iCSRIndex.Get(pIndexTargetAV2Rule, queryAttrIdx, queryValueIdx, &pRuleIdxes);
 
         HashNodeIterator *itUserCondValue;
         int condAttrIdx, condValueIdx;
-        HashSet *psetCondValueIdxes;
-        HashSetIterator *itCondValueIdxes;
-        HashSet **ppSetRuleIdxes2;
-        HashSetIterator *itRuleIdxes2;
+        ValueSet *psetCondValueIdxes;
+        ValueSetIterator itCondValueIdxes;
+        int *pRuleIdxes2, nRuleIdxes2, j;
         int ruleIdx2;
         Rule *pRule2;
-        while (itRuleIdxes->HasNext(itRuleIdxes)) {
-            ruleIdx = *(int *)itRuleIdxes->GetNext(itRuleIdxes);
+        for (i = 0; i < nRuleIdxes; i++) {
+            ruleIdx = pRuleIdxes[i];
             iVector.Add(pVecSelectedRuleIdxes, &ruleIdx);
             success = 1;
             pRule = (Rule *)iVector.GetElement(pVecRules, ruleIdx);
@@ -101,20 +93,16 @@ ACoACResult preCheck(ACoACInstance *pInst) {
             while (itUserCondValue->HasNext(itUserCondValue)) {
                 node = (HashNode *)itUserCondValue->GetNext(itUserCondValue);
                 condAttrIdx = *(int *)node->key;
-                psetCondValueIdxes = *(HashSet **)node->value;
+                psetCondValueIdxes = *(ValueSet **)node->value;
                 condValueIdx = getInitValue(pInst, pInst->queryUserIdx, condAttrIdx);
-                if (!iHashSet.Contains(psetCondValueIdxes, &condValueIdx)) {
+                if (!iValueSet.Contains(psetCondValueIdxes, condValueIdx)) {
                     found = 0;
-                    itCondValueIdxes = iHashSet.NewIterator(psetCondValueIdxes);
-                    while (itCondValueIdxes->HasNext(itCondValueIdxes)) {
-                        condValueIdx = *(int *)itCondValueIdxes->GetNext(itCondValueIdxes);
-                        ppSetRuleIdxes2 = (HashSet **)iHashBasedTable.Get(pTableTargetAV2Rule, &condAttrIdx, &condValueIdx);
-                        if (ppSetRuleIdxes2 == NULL) {
-                            continue;
-                        }
-                        itRuleIdxes2 = iHashSet.NewIterator(*ppSetRuleIdxes2);
-                        while (itRuleIdxes2->HasNext(itRuleIdxes2)) {
-                            ruleIdx2 = *(int *)itRuleIdxes2->GetNext(itRuleIdxes2);
+                    iValueSet.InitIterator(psetCondValueIdxes, &itCondValueIdxes);
+                    while (iValueSet.Next(&itCondValueIdxes)) {
+                        condValueIdx = itCondValueIdxes.value;
+                        nRuleIdxes2 = iCSRIndex.Get(pIndexTargetAV2Rule, condAttrIdx, condValueIdx, &pRuleIdxes2);
+                        for (j = 0; j < nRuleIdxes2; j++) {
+                            ruleIdx2 = pRuleIdxes2[j];
                             pRule2 = (Rule *)iVector.GetElement(pVecRules, ruleIdx2);
                             if (iHashMap.Size(pRule2->pmapUserCondValue) == 0) {
                                 iVector.Insert(pVecSelectedRuleIdxes, &ruleIdx2);
@@ -122,12 +110,10 @@ ACoACResult preCheck(ACoACInstance *pInst) {
                                 break;
                             }
                         }
-                        iHashSet.DeleteIterator(itRuleIdxes2);
                         if (found) {
                             break;
                         }
                     }
-                    iHashSet.DeleteIterator(itCondValueIdxes);
                     if (!found) {
                         success = 0;
                         break;
@@ -0,0 +1,124 @@
+#include "thread_pool.h"
+#include "acoac_utils.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+
+static void *workerLoop(void *arg) {
+    ThreadPool *pool = (ThreadPool *)arg;
+    Task *task;
+    while (1) {
+        pthread_mutex_lock(&pool->lock);
+        while (pool->head == NULL && !pool->shutdown) {
+            pthread_cond_wait(&pool->taskAvailable, &pool->lock);
+        }
+        if (pool->head == NULL) {
+            // shutdown and no task left
+            pthread_mutex_unlock(&pool->lock);
+            return NULL;
+        }
+        task = pool->head;
+        pool->head = task->next;
+        if (pool->head == NULL) {
+            pool->tail = NULL;
+        }
+        pthread_mutex_unlock(&pool->lock);
+
+        task->fn(task->arg);
+        free(task);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->nUnfinished == 0) {
+            pthread_cond_broadcast(&pool->allFinished);
+        }
+        pthread_mutex_unlock(&pool->lock);
+    }
+}
+
+static ThreadPool *Create(int nThreads) {
+    if (nThreads < 1) {
+        nThreads = 1;
+    }
+    ThreadPool *pool = (ThreadPool *)malloc(sizeof(ThreadPool));
+    pool->threads = (pthread_t *)malloc(nThreads * sizeof(pthread_t));
+    pool->nThreads = 0;
+    pool->head = pool->tail = NULL;
+    pool->nUnfinished = 0;
+    pool->shutdown = 0;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->taskAvailable, NULL);
+    pthread_cond_init(&pool->allFinished, NULL);
+    for (int i = 0; i < nThreads; i++) {
+        if (pthread_create(&pool->threads[i], NULL, workerLoop, pool) != 0) {
+            logACoAC(__func__, __LINE__, 0, WARNING, "failed to create thread %d, continue with %d threads\n", i, pool->nThreads);
+            break;
+        }
+        pool->nThreads++;
+    }
+    if (pool->nThreads == 0) {
+        logACoAC(__func__, __LINE__, 0, ERROR, "failed to create any thread\n");
+        exit(-1);
+    }
+    return pool;
+}
+
+static int Submit(ThreadPool *pool, TaskFn fn, void *arg) {
+    Task *task = (Task *)malloc(sizeof(Task));
+    if (task == NULL) {
+        logACoAC(__func__, __LINE__, 0, ERROR, "Failed to allocate memory for task\n");
+        return -1;
+    }
+    task->fn = fn;
+    task->arg = arg;
+    task->next = NULL;
+    pthread_mutex_lock(&pool->lock);
+    if (pool->tail == NULL) {
+        pool->head = pool->tail = task;
+    } else {
+        pool->tail->next = task;
+        pool->tail = task;
+    }
+    pool->nUnfinished++;
+    pthread_cond_signal(&pool->taskAvailable);
+    pthread_mutex_unlock(&pool->lock);
+    return 0;
+}
+
+static void Wait(ThreadPool *pool) {
+    pthread_mutex_lock(&pool->lock);
+    while (pool->nUnfinished > 0) {
+        pthread_cond_wait(&pool->allFinished, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+static void Finalize(ThreadPool *pool) {
+    if (pool == NULL) {
+        return;
+    }
+    pthread_mutex_lock(&pool->lock);
+    pool->shutdown = 1;
+    pthread_cond_broadcast(&pool->taskAvailable);
+    pthread_mutex_unlock(&pool->lock);
+    for (int i = 0; i < pool->nThreads; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->taskAvailable);
+    pthread_cond_destroy(&pool->allFinished);
+    free(pool->threads);
+    free(pool);
+}
+
+static int NumCores() {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+}
+
+ThreadPoolInterface iThreadPool = {
+    .Create = Create,
+    .Submit = Submit,
+    .Wait = Wait,
+    .Finalize = Finalize,
+    .NumCores = NumCores,
+};
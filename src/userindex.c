@@ -0,0 +1,128 @@
+#include "userindex.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define WORD_BITS 64
+// An atomic condition satisfied by more values than this is evaluated on the column instead of by a union of bitmaps
+#define MAX_UNION_BITMAPS 4
+
+static UserIndex *Create(InitState *state) {
+    UserIndex *index = (UserIndex *)malloc(sizeof(UserIndex));
+    index->arena = iArena.Acquire();
+    index->state = state;
+    index->nUsers = state->nUsers + 1;
+    index->nWords = (index->nUsers + WORD_BITS - 1) / WORD_BITS;
+    index->nAttrs = state->nAttrs;
+    index->attrBitmaps = (IntMap **)calloc(index->nAttrs + 1, sizeof(IntMap *));
+    return index;
+}
+
+static uint64_t *getBitmap(UserIndex *index, IntMap *pmapBitmaps, int valIdx) {
+    uint64_t **ppBitmap = (uint64_t **)iIntMap.Get(pmapBitmaps, valIdx), *bitmap;
+    if (ppBitmap != NULL) {
+        return *ppBitmap;
+    }
+    bitmap = (uint64_t *)iArena.Alloc(index->arena, index->nWords * sizeof(uint64_t));
+    memset(bitmap, 0, index->nWords * sizeof(uint64_t));
+    iIntMap.Put(pmapBitmaps, valIdx, &bitmap);
+    return bitmap;
+}
+
+/**
+ * Build the bitmaps of the values of the attribute @{attrIdx} from its column, runs of users with the same value
+ * sharing the lookup of the bitmap.
+ */
+static IntMap *getAttrBitmaps(UserIndex *index, int attrIdx) {
+    if (index->attrBitmaps[attrIdx] != NULL) {
+        return index->attrBitmaps[attrIdx];
+    }
+    IntMap *pmapBitmaps = iIntMap.Create(sizeof(uint64_t *));
+    int *column = index->state->columns[attrIdx], u;
+    uint64_t *bitmap = NULL;
+    for (u = 0; u < index->nUsers; u++) {
+        if (u == 0 || column[u] != column[u - 1]) {
+            bitmap = getBitmap(index, pmapBitmaps, column[u]);
+        }
+        bitmap[u / WORD_BITS] |= (uint64_t)1 << (u % WORD_BITS);
+    }
+    index->attrBitmaps[attrIdx] = pmapBitmaps;
+    return pmapBitmaps;
+}
+
+static int IsSatisfiable(UserIndex *index, IntervalTest *tests, int nTests) {
+    // The bitmaps of the values satisfying the i-th test are bitmaps[atomStart[i]], ..., bitmaps[atomStart[i + 1] - 1],
+    // or atoms[i] is evaluated on its column if there are more than MAX_UNION_BITMAPS of them
+    int nAtoms = nTests, nBitmaps = 0, i;
+    for (i = 0; i < nAtoms; i++) {
+        nBitmaps += iIntMap.Size(getAttrBitmaps(index, tests[i].attribute));
+    }
+    uint64_t **bitmaps = (uint64_t **)malloc((nBitmaps + 1) * sizeof(uint64_t *));
+    int *atomStart = (int *)malloc((nAtoms + 1) * sizeof(int));
+    IntervalTest **atoms = (IntervalTest **)malloc((nAtoms + 1) * sizeof(IntervalTest *));
+    IntMapIterator itBitmaps;
+    nBitmaps = 0;
+    for (i = 0; i < nAtoms; i++) {
+        atoms[i] = &tests[i];
+        atomStart[i] = nBitmaps;
+        iIntMap.InitIterator(index->attrBitmaps[tests[i].attribute], &itBitmaps);
+        while (iIntMap.Next(&itBitmaps)) {
+            if (INTERVAL_TEST(&tests[i], itBitmaps.key)) {
+                bitmaps[nBitmaps++] = *(uint64_t **)itBitmaps.value;
+            }
+        }
+        if (nBitmaps == atomStart[i]) {
+            // No user has a value satisfying the atomic condition
+            free(bitmaps);
+            free(atomStart);
+            free(atoms);
+            return 0;
+        }
+        if (nBitmaps - atomStart[i] <= MAX_UNION_BITMAPS) {
+            atoms[i] = NULL;
+        }
+    }
+    atomStart[nAtoms] = nBitmaps;
+
+    int w, b, n, satisfiable = 0;
+    uint64_t word, atomWord;
+    for (w = 0; w < index->nWords && !satisfiable; w++) {
+        word = ~(uint64_t)0;
+        for (i = 0; i < nAtoms && word != 0; i++) {
+            if (atoms[i] != NULL) {
+                n = index->nUsers - w * WORD_BITS;
+                iInitState.EvalAtom(index->state, atoms[i], w * WORD_BITS, n < WORD_BITS ? n : WORD_BITS, &atomWord);
+            } else {
+                atomWord = 0;
+                for (b = atomStart[i]; b < atomStart[i + 1]; b++) {
+                    atomWord |= bitmaps[b][w];
+                }
+            }
+            word &= atomWord;
+        }
+        // The bits beyond the last user are never set, unless the condition has no atomic condition
+        satisfiable = nAtoms == 0 || word != 0;
+    }
+    free(bitmaps);
+    free(atomStart);
+    free(atoms);
+    return satisfiable;
+}
+
+static void Finalize(UserIndex *index) {
+    if (index == NULL) {
+        return;
+    }
+    int attrIdx;
+    for (attrIdx = 0; attrIdx < index->nAttrs; attrIdx++) {
+        iIntMap.Finalize(index->attrBitmaps[attrIdx]);
+    }
+    free(index->attrBitmaps);
+    iArena.Release(index->arena);
+    free(index);
+}
+
+UserIndexInterface iUserIndex = {
+    .Create = Create,
+    .IsSatisfiable = IsSatisfiable,
+    .Finalize = Finalize,
+};
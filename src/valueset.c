@@ -0,0 +1,797 @@
+#include "valueset.h"
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#define WORD_BITS 64
+
+/**
+ * The base of the word containing a value, i.e., the value rounded down to a multiple of 64
+ */
+static int wordBase(int value) {
+    return value & ~(WORD_BITS - 1);
+}
+
+/**
+ * The absolute index of the first word of a set, so that the words of two sets can be aligned
+ */
+static long firstWord(ValueSet *set) {
+    return (long)set->base / WORD_BITS;
+}
+
+/* Word-parallel kernels over @{n} aligned words */
+
+static void orWords(uint64_t *dst, const uint64_t *src, int n) {
+    int i = 0;
+#if defined(__AVX2__)
+    for (; i + 4 <= n; i += 4) {
+        __m256i d = _mm256_loadu_si256((const __m256i *)(dst + i));
+        __m256i s = _mm256_loadu_si256((const __m256i *)(src + i));
+        _mm256_storeu_si256((__m256i *)(dst + i), _mm256_or_si256(d, s));
+    }
+#endif
+    for (; i < n; i++) {
+        dst[i] |= src[i];
+    }
+}
+
+static void andWords(uint64_t *dst, const uint64_t *src, int n) {
+    int i = 0;
+#if defined(__AVX2__)
+    for (; i + 4 <= n; i += 4) {
+        __m256i d = _mm256_loadu_si256((const __m256i *)(dst + i));
+        __m256i s = _mm256_loadu_si256((const __m256i *)(src + i));
+        _mm256_storeu_si256((__m256i *)(dst + i), _mm256_and_si256(d, s));
+    }
+#endif
+    for (; i < n; i++) {
+        dst[i] &= src[i];
+    }
+}
+
+/**
+ * @return 1 if every bit of @{sub} is also set in @{super}, 0 otherwise
+ */
+static int subsetWords(const uint64_t *sub, const uint64_t *super, int n) {
+    int i = 0;
+#if defined(__AVX2__)
+    for (; i + 4 <= n; i += 4) {
+        __m256i a = _mm256_loadu_si256((const __m256i *)(sub + i));
+        __m256i b = _mm256_loadu_si256((const __m256i *)(super + i));
+        if (!_mm256_testc_si256(b, a)) {
+            return 0;
+        }
+    }
+#endif
+    for (; i < n; i++) {
+        if (sub[i] & ~super[i]) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @return 1 if some bit is set in both @{a} and @{b}, 0 otherwise
+ */
+static int intersectWords(const uint64_t *a, const uint64_t *b, int n) {
+    int i = 0;
+#if defined(__AVX2__)
+    for (; i + 4 <= n; i += 4) {
+        __m256i x = _mm256_loadu_si256((const __m256i *)(a + i));
+        __m256i y = _mm256_loadu_si256((const __m256i *)(b + i));
+        if (!_mm256_testz_si256(x, y)) {
+            return 1;
+        }
+    }
+#endif
+    for (; i < n; i++) {
+        if (a[i] & b[i]) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int countWords(const uint64_t *words, int n) {
+    int i, count = 0;
+    for (i = 0; i < n; i++) {
+        count += __builtin_popcountll(words[i]);
+    }
+    return count;
+}
+
+static ValueSet *Create() {
+    ValueSet *set = (ValueSet *)malloc(sizeof(ValueSet));
+    if (set == NULL) {
+        printf("[Error] ValueSet Create: failed to allocate memory\n");
+        abort();
+    }
+    set->words = NULL;
+    set->base = 0;
+    set->nWords = 0;
+    set->values = NULL;
+    set->capacity = 0;
+    set->size = 0;
+    set->elementToString = NULL;
+    return set;
+}
+
+static ValueSet *Clone(ValueSet *set) {
+    ValueSet *clone = Create();
+    if (set->values != NULL) {
+        clone->capacity = set->size > 0 ? set->size : 1;
+        clone->values = (int *)malloc(clone->capacity * sizeof(int));
+        memcpy(clone->values, set->values, set->size * sizeof(int));
+    } else if (set->nWords > 0) {
+        clone->words = (uint64_t *)malloc(set->nWords * sizeof(uint64_t));
+        memcpy(clone->words, set->words, set->nWords * sizeof(uint64_t));
+    }
+    clone->base = set->base;
+    clone->nWords = set->nWords;
+    clone->size = set->size;
+    clone->elementToString = set->elementToString;
+    return clone;
+}
+
+/**
+ * Check if a bitset of @{nWords} words holding @{nValues} values would take too much memory, in which case the values
+ * are stored as a sorted array instead.
+ */
+static int tooSparse(long nWords, long nValues) {
+    return nWords > VALUESET_MAX_WORDS || (nWords > VALUESET_MIN_SPARSE_WORDS && nWords > VALUESET_MAX_WORDS_PER_VALUE * nValues);
+}
+
+/**
+ * The number of words of a bitset covering the values @{lo} to @{hi}
+ */
+static long wordsOfRange(int lo, int hi) {
+    return (long)wordBase(hi) / WORD_BITS - (long)wordBase(lo) / WORD_BITS + 1;
+}
+
+/**
+ * Convert a bitset into the sorted array of its values.
+ */
+static void toSparse(ValueSet *set) {
+    int *values = (int *)malloc((set->size + 1) * sizeof(int)), n = 0, k;
+    uint64_t bits;
+    for (k = 0; k < set->nWords; k++) {
+        for (bits = set->words[k]; bits != 0; bits &= bits - 1) {
+            values[n++] = set->base + k * WORD_BITS + __builtin_ctzll(bits);
+        }
+    }
+    free(set->words);
+    set->words = NULL;
+    set->nWords = 0;
+    set->base = 0;
+    set->values = values;
+    set->capacity = set->size + 1;
+}
+
+/**
+ * Convert a sorted array back into a bitset once the values are dense enough, i.e., the bitset would stay a bitset
+ * even with twice as many words, so that a set growing around the threshold is not converted back and forth.
+ */
+static void densify(ValueSet *set) {
+    if (set->size == 0 || tooSparse(2 * wordsOfRange(set->values[0], set->values[set->size - 1]), set->size)) {
+        return;
+    }
+    int i;
+    long k;
+    set->base = wordBase(set->values[0]);
+    set->nWords = (int)wordsOfRange(set->values[0], set->values[set->size - 1]);
+    set->words = (uint64_t *)calloc(set->nWords, sizeof(uint64_t));
+    for (i = 0; i < set->size; i++) {
+        k = (long)wordBase(set->values[i]) / WORD_BITS - firstWord(set);
+        set->words[k] |= (uint64_t)1 << (set->values[i] - wordBase(set->values[i]));
+    }
+    free(set->values);
+    set->values = NULL;
+    set->capacity = 0;
+}
+
+/**
+ * Find a value in a sorted array by binary search.
+ *
+ * @return The index of the value, or -(i + 1) if it is not in the set, where i is the index it would be inserted at
+ */
+static int searchValue(ValueSet *set, int value) {
+    int lo = 0, hi = set->size - 1, mid;
+    while (lo <= hi) {
+        mid = lo + (hi - lo) / 2;
+        if (set->values[mid] < value) {
+            lo = mid + 1;
+        } else if (set->values[mid] > value) {
+            hi = mid - 1;
+        } else {
+            return mid;
+        }
+    }
+    return -(lo + 1);
+}
+
+/**
+ * Extend the words of a bitset so that they cover the words with the bases @{lo} to @{hi}.
+ * When the set has to grow, it grows by at least its current length, so that adding values in order costs amortized constant time.
+ * If the words would be too many for the values (see tooSparse), the set is converted into a sorted array instead.
+ *
+ * @param nValues[in]: The number of values of the set after the values of the range are added, at most
+ * @return 1 if the set is a bitset covering the range, 0 if it is a sorted array
+ */
+static int ensureRange(ValueSet *set, int lo, int hi, long nValues) {
+    if (set->values != NULL) {
+        return 0;
+    }
+    long newFirst = (long)lo / WORD_BITS, newLast = (long)hi / WORD_BITS;
+    if (set->nWords == 0) {
+        if (tooSparse(newLast - newFirst + 1, nValues)) {
+            toSparse(set);
+            return 0;
+        }
+        set->nWords = (int)(newLast - newFirst + 1);
+        set->words = (uint64_t *)calloc(set->nWords, sizeof(uint64_t));
+        set->base = lo;
+        return 1;
+    }
+    long first = firstWord(set), last = first + set->nWords - 1;
+    if (newFirst >= first && newLast <= last) {
+        return 1;
+    }
+    if (newFirst > first) {
+        newFirst = first;
+    }
+    if (newLast < last) {
+        newLast = last;
+    }
+    if (tooSparse(newLast - newFirst + 1, nValues)) {
+        toSparse(set);
+        return 0;
+    }
+    // The amortized growth is dropped if it would take the set over VALUESET_MAX_WORDS
+    long grownFirst = newFirst, grownLast = newLast;
+    if (newFirst < first && first - newFirst < set->nWords) {
+        grownFirst = first - set->nWords;
+    }
+    if (newLast > last && newLast - last < set->nWords) {
+        grownLast = last + set->nWords;
+    }
+    if (grownLast - grownFirst + 1 <= VALUESET_MAX_WORDS) {
+        newFirst = grownFirst;
+        newLast = grownLast;
+    }
+    int n = (int)(newLast - newFirst + 1);
+    uint64_t *words = (uint64_t *)calloc(n, sizeof(uint64_t));
+    if (words == NULL) {
+        printf("[Error] ValueSet ensureRange: failed to allocate memory\n");
+        abort();
+    }
+    memcpy(words + (first - newFirst), set->words, set->nWords * sizeof(uint64_t));
+    free(set->words);
+    set->words = words;
+    set->nWords = n;
+    set->base = (int)(newFirst * WORD_BITS);
+    return 1;
+}
+
+/**
+ * Add sorted values to a set, merging them into the sorted array if the set is sparse.
+ *
+ * @return The number of values added
+ */
+static int addValues(ValueSet *set, const int *values, int n) {
+    int i, j, k, added = 0;
+    long w;
+    uint64_t bit;
+    if (n == 0) {
+        return 0;
+    }
+    if (ensureRange(set, wordBase(values[0]), wordBase(values[n - 1]), (long)set->size + n)) {
+        for (i = 0; i < n; i++) {
+            w = (long)wordBase(values[i]) / WORD_BITS - firstWord(set);
+            bit = (uint64_t)1 << (values[i] - wordBase(values[i]));
+            added += !(set->words[w] & bit);
+            set->words[w] |= bit;
+        }
+        set->size += added;
+        return added;
+    }
+
+    int *merged = (int *)malloc((set->size + n) * sizeof(int));
+    for (i = j = k = 0; i < set->size || j < n;) {
+        if (j == n || (i < set->size && set->values[i] < values[j])) {
+            merged[k++] = set->values[i++];
+        } else {
+            if (i < set->size && set->values[i] == values[j]) {
+                i++;
+            } else {
+                added++;
+            }
+            merged[k++] = values[j++];
+        }
+    }
+    free(set->values);
+    set->values = merged;
+    set->capacity = set->size + n;
+    set->size = k;
+    densify(set);
+    return added;
+}
+
+static int Add(ValueSet *set, int value) {
+    if (ensureRange(set, wordBase(value), wordBase(value), (long)set->size + 1)) {
+        long k = (long)wordBase(value) / WORD_BITS - firstWord(set);
+        uint64_t bit = (uint64_t)1 << (value - wordBase(value));
+        if (set->words[k] & bit) {
+            return 0;
+        }
+        set->words[k] |= bit;
+        set->size++;
+        return 1;
+    }
+
+    int i = searchValue(set, value);
+    if (i >= 0) {
+        return 0;
+    }
+    i = -i - 1;
+    if (set->size == set->capacity) {
+        set->capacity = set->capacity * 2 + 1;
+        set->values = (int *)realloc(set->values, set->capacity * sizeof(int));
+        if (set->values == NULL) {
+            printf("[Error] ValueSet Add: failed to allocate memory\n");
+            abort();
+        }
+    }
+    memmove(set->values + i + 1, set->values + i, (set->size - i) * sizeof(int));
+    set->values[i] = value;
+    set->size++;
+    densify(set);
+    return 1;
+}
+
+/**
+ * Get the index of the word containing a value in a set.
+ *
+ * @return The index of the word, or -1 if the value is out of the range of the set
+ */
+static long findWord(ValueSet *set, int value) {
+    long k = (long)wordBase(value) / WORD_BITS - firstWord(set);
+    return k >= 0 && k < set->nWords ? k : -1;
+}
+
+static int Contains(ValueSet *set, int value) {
+    if (set->values != NULL) {
+        return searchValue(set, value) >= 0;
+    }
+    long k = findWord(set, value);
+    return k >= 0 && (set->words[k] >> (value - wordBase(value)) & 1);
+}
+
+static int Remove(ValueSet *set, int value) {
+    if (set->values != NULL) {
+        int i = searchValue(set, value);
+        if (i < 0) {
+            return 0;
+        }
+        memmove(set->values + i, set->values + i + 1, (set->size - i - 1) * sizeof(int));
+        set->size--;
+        return 1;
+    }
+    long k = findWord(set, value);
+    uint64_t bit = (uint64_t)1 << (value - wordBase(value));
+    if (k < 0 || !(set->words[k] & bit)) {
+        return 0;
+    }
+    set->words[k] &= ~bit;
+    set->size--;
+    return 1;
+}
+
+static int Size(ValueSet *set) {
+    return set->size;
+}
+
+static void Clear(ValueSet *set) {
+    if (set->nWords > 0) {
+        memset(set->words, 0, set->nWords * sizeof(uint64_t));
+    }
+    set->size = 0;
+}
+
+static void InitIterator(ValueSet *set, ValueSetIterator *it) {
+    it->set = set;
+    it->wordIdx = 0;
+    it->bits = set->values == NULL && set->nWords > 0 ? set->words[0] : 0;
+    it->value = 0;
+}
+
+static int Next(ValueSetIterator *it) {
+    ValueSet *set = it->set;
+    if (set->values != NULL) {
+        if (it->wordIdx >= set->size) {
+            return 0;
+        }
+        it->value = set->values[it->wordIdx++];
+        return 1;
+    }
+    while (it->bits == 0) {
+        if (++it->wordIdx >= set->nWords) {
+            return 0;
+        }
+        it->bits = set->words[it->wordIdx];
+    }
+    it->value = set->base + it->wordIdx * WORD_BITS + __builtin_ctzll(it->bits);
+    it->bits &= it->bits - 1;
+    return 1;
+}
+
+static int inRange(int value, int lo, int hi, int negated) {
+    return negated ? value < lo || value > hi : value >= lo && value <= hi;
+}
+
+/**
+ * Collect the values of a set in [lo, hi], or out of it if @{negated}, in ascending order.
+ *
+ * @param pn[out]: The number of values
+ * @return The values, which should be freed by the caller
+ */
+static int *collectValues(ValueSet *set, int lo, int hi, int negated, int *pn) {
+    int *values = (int *)malloc((set->size + 1) * sizeof(int));
+    ValueSetIterator it;
+    *pn = 0;
+    InitIterator(set, &it);
+    while (Next(&it)) {
+        if (inRange(it.value, lo, hi, negated)) {
+            values[(*pn)++] = it.value;
+        }
+    }
+    return values;
+}
+
+/**
+ * Compute the words shared by the ranges of two sets.
+ *
+ * @param off1[out]: The index of the first shared word in @{set1}
+ * @param off2[out]: The index of the first shared word in @{set2}
+ * @return The number of shared words
+ */
+static int overlap(ValueSet *set1, ValueSet *set2, int *off1, int *off2) {
+    long first1 = firstWord(set1), first2 = firstWord(set2);
+    long first = first1 > first2 ? first1 : first2;
+    long end1 = first1 + set1->nWords, end2 = first2 + set2->nWords;
+    long end = end1 < end2 ? end1 : end2;
+    *off1 = (int)(first - first1);
+    *off2 = (int)(first - first2);
+    return end > first ? (int)(end - first) : 0;
+}
+
+static int AddAll(ValueSet *set1, ValueSet *set2) {
+    if (set2->size == 0) {
+        return 0;
+    }
+    if (set2->values == NULL) {
+        // Skip the empty words of set2, so that set1 only grows as much as needed
+        int lo = 0, hi = set2->nWords - 1;
+        while (set2->words[lo] == 0) {
+            lo++;
+        }
+        while (set2->words[hi] == 0) {
+            hi--;
+        }
+        if (ensureRange(set1, set2->base + lo * WORD_BITS, set2->base + hi * WORD_BITS, (long)set1->size + set2->size)) {
+            int n = hi - lo + 1;
+            uint64_t *dst = set1->words + (firstWord(set2) + lo - firstWord(set1));
+            int before = countWords(dst, n);
+            orWords(dst, set2->words + lo, n);
+            int after = countWords(dst, n);
+            set1->size += after - before;
+            return after != before;
+        }
+    }
+    int n, *values = collectValues(set2, INT_MIN, INT_MAX, 0, &n);
+    int added = addValues(set1, values, n);
+    free(values);
+    return added != 0;
+}
+
+static int RetainAll(ValueSet *set1, ValueSet *set2) {
+    int before = set1->size, i, k;
+    if (set1->values != NULL) {
+        for (i = k = 0; i < set1->size; i++) {
+            if (Contains(set2, set1->values[i])) {
+                set1->values[k++] = set1->values[i];
+            }
+        }
+        set1->size = k;
+        return set1->size != before;
+    }
+    if (set2->values != NULL) {
+        uint64_t bits;
+        for (k = 0; k < set1->nWords; k++) {
+            for (bits = set1->words[k]; bits != 0; bits &= bits - 1) {
+                if (!Contains(set2, set1->base + k * WORD_BITS + __builtin_ctzll(bits))) {
+                    set1->words[k] &= ~(bits & -bits);
+                    set1->size--;
+                }
+            }
+        }
+        return set1->size != before;
+    }
+    int off1, off2, n = overlap(set1, set2, &off1, &off2);
+    if (n == 0) {
+        Clear(set1);
+        return before != 0;
+    }
+    memset(set1->words, 0, off1 * sizeof(uint64_t));
+    andWords(set1->words + off1, set2->words + off2, n);
+    memset(set1->words + off1 + n, 0, (set1->nWords - off1 - n) * sizeof(uint64_t));
+    set1->size = countWords(set1->words + off1, n);
+    return set1->size != before;
+}
+
+/**
+ * The mask of the values in [lo, hi], or out of it if @{negated}, among the 64 values of the word with the base @{base}.
+ * Only the words holding a bound of the interval are partially masked, the others are masked as a whole.
+ */
+static uint64_t rangeMask(long base, long lo, long hi, int negated) {
+    uint64_t mask;
+    if (lo < base) {
+        lo = base;
+    }
+    if (hi > base + WORD_BITS - 1) {
+        hi = base + WORD_BITS - 1;
+    }
+    mask = lo > hi ? 0 : (~(uint64_t)0 >> (WORD_BITS - 1 - (hi - lo))) << (lo - base);
+    return negated ? ~mask : mask;
+}
+
+static int AddAllInRange(ValueSet *set1, ValueSet *set2, int lo, int hi, int negated) {
+    if (set2->size == 0) {
+        return 0;
+    }
+    if (set2->values == NULL) {
+        // Skip the words of set2 with no value in the range, so that set1 only grows as much as needed
+        int first = 0, last = set2->nWords - 1, k;
+        while (first <= last && (set2->words[first] & rangeMask(set2->base + (long)first * WORD_BITS, lo, hi, negated)) == 0) {
+            first++;
+        }
+        while (last >= first && (set2->words[last] & rangeMask(set2->base + (long)last * WORD_BITS, lo, hi, negated)) == 0) {
+            last--;
+        }
+        if (first > last) {
+            return 0;
+        }
+        if (ensureRange(set1, set2->base + first * WORD_BITS, set2->base + last * WORD_BITS, (long)set1->size + set2->size)) {
+            uint64_t *dst = set1->words + (firstWord(set2) + first - firstWord(set1)), word;
+            int added = 0;
+            for (k = first; k <= last; k++, dst++) {
+                word = set2->words[k] & rangeMask(set2->base + (long)k * WORD_BITS, lo, hi, negated);
+                added += __builtin_popcountll(word & ~*dst);
+                *dst |= word;
+            }
+            set1->size += added;
+            return added != 0;
+        }
+    }
+    int n, *values = collectValues(set2, lo, hi, negated, &n);
+    int added = addValues(set1, values, n);
+    free(values);
+    return added != 0;
+}
+
+static int RetainRange(ValueSet *set, int lo, int hi, int negated) {
+    int before = set->size, i, k;
+    if (set->values != NULL) {
+        for (i = k = 0; i < set->size; i++) {
+            if (inRange(set->values[i], lo, hi, negated)) {
+                set->values[k++] = set->values[i];
+            }
+        }
+        set->size = k;
+        return set->size != before;
+    }
+    for (k = 0; k < set->nWords; k++) {
+        set->words[k] &= rangeMask(set->base + (long)k * WORD_BITS, lo, hi, negated);
+    }
+    set->size = countWords(set->words, set->nWords);
+    return set->size != before;
+}
+
+static int ContainsAll(ValueSet *set1, ValueSet *set2) {
+    if (set2->size > set1->size) {
+        return 0;
+    }
+    if (set2->size == 0) {
+        return 1;
+    }
+    if (set1->values != NULL || set2->values != NULL) {
+        ValueSetIterator it;
+        InitIterator(set2, &it);
+        while (Next(&it)) {
+            if (!Contains(set1, it.value)) {
+                return 0;
+            }
+        }
+        return 1;
+    }
+    int off1, off2, n = overlap(set1, set2, &off1, &off2);
+    // Every value of set2 must be in the shared words
+    if (n == 0 || countWords(set2->words + off2, n) != set2->size) {
+        return 0;
+    }
+    return subsetWords(set2->words + off2, set1->words + off1, n);
+}
+
+static int Intersects(ValueSet *set1, ValueSet *set2) {
+    if (set1->values != NULL || set2->values != NULL) {
+        // Look up the values of the smaller set in the other one
+        ValueSet *smaller = set1->size < set2->size ? set1 : set2, *larger = smaller == set1 ? set2 : set1;
+        ValueSetIterator it;
+        InitIterator(smaller, &it);
+        while (Next(&it)) {
+            if (Contains(larger, it.value)) {
+                return 1;
+            }
+        }
+        return 0;
+    }
+    int off1, off2, n = overlap(set1, set2, &off1, &off2);
+    return n > 0 && intersectWords(set1->words + off1, set2->words + off2, n);
+}
+
+static int Equal(ValueSet *set1, ValueSet *set2) {
+    if (set1 == set2) {
+        return 1;
+    }
+    return set1->size == set2->size && ContainsAll(set1, set2);
+}
+
+static unsigned int HashCode(ValueSet *set) {
+    // Only the non-empty words are hashed, since two equal sets may cover different ranges
+    unsigned int hash = 1;
+    if (set->values != NULL) {
+        // The values are grouped into the words they would have in a bitset, so that equal sets have the same hash
+        // code whether they are bitsets or sorted arrays
+        int i = 0, base;
+        uint64_t word;
+        while (i < set->size) {
+            base = wordBase(set->values[i]);
+            for (word = 0; i < set->size && wordBase(set->values[i]) == base; i++) {
+                word |= (uint64_t)1 << (set->values[i] - base);
+            }
+            hash = 31 * hash + (unsigned int)((long)base / WORD_BITS);
+            hash = 31 * hash + (unsigned int)(word ^ (word >> 32));
+        }
+        return hash;
+    }
+    long first = firstWord(set);
+    int k;
+    for (k = 0; k < set->nWords; k++) {
+        if (set->words[k] != 0) {
+            hash = 31 * hash + (unsigned int)(first + k);
+            hash = 31 * hash + (unsigned int)(set->words[k] ^ (set->words[k] >> 32));
+        }
+    }
+    return hash;
+}
+
+static int NextRange(ValueSetIterator *it, int *lo, int *hi) {
+    ValueSet *set = it->set;
+    if (!Next(it)) {
+        return 0;
+    }
+    *lo = it->value;
+    if (set->values != NULL) {
+        while (it->wordIdx < set->size && set->values[it->wordIdx] - 1 == it->value) {
+            it->value = set->values[it->wordIdx++];
+        }
+        *hi = it->value;
+        return 1;
+    }
+    // Find the first bit after the value that is not set, skipping the words with all bits set
+    long end = (long)it->value - set->base + 1, k;
+    uint64_t unset;
+    while ((k = end / WORD_BITS) < set->nWords) {
+        unset = ~set->words[k] >> (end % WORD_BITS);
+        if (unset != 0) {
+            end += __builtin_ctzll(unset);
+            break;
+        }
+        end = (k + 1) * WORD_BITS;
+    }
+    *hi = (int)(set->base + end - 1);
+    // Resume the iteration after the run
+    if (k < set->nWords) {
+        it->wordIdx = (int)k;
+        it->bits = set->words[k] & (~(uint64_t)0 << (end % WORD_BITS));
+    } else {
+        it->wordIdx = set->nWords - 1;
+        it->bits = 0;
+    }
+    return 1;
+}
+
+static char *defaultElementToString(void *pValue) {
+    char *buffer = (char *)malloc(16);
+    sprintf(buffer, "%d", *(int *)pValue);
+    return buffer;
+}
+
+static char *ToString(void *pSet) {
+    ValueSet *set = *(ValueSet **)pSet;
+    KeyToString elementToString = set->elementToString != NULL ? set->elementToString : defaultElementToString;
+    ValueSetIterator it;
+    char *e;
+    char *ret = (char *)malloc(3);
+    int cur = 0;
+    ret[cur++] = '[';
+    int first = 1;
+    int elementLen;
+    InitIterator(set, &it);
+    while (Next(&it)) {
+        e = elementToString(&it.value);
+        elementLen = strlen(e);
+        ret = (char *)realloc(ret, cur + elementLen + 4);
+        if (first) {
+            first = 0;
+        } else {
+            ret[cur++] = ',';
+            ret[cur++] = ' ';
+        }
+        memcpy(ret + cur, e, elementLen);
+        free(e);
+        cur += elementLen;
+    }
+    ret[cur++] = ']';
+    ret[cur++] = '\0';
+    return ret;
+}
+
+static KeyToString SetElementToString(ValueSet *set, KeyToString elementToString) {
+    KeyToString old = set->elementToString;
+    set->elementToString = elementToString;
+    return old;
+}
+
+static void Finalize(ValueSet *set) {
+    if (set == NULL) {
+        return;
+    }
+    free(set->words);
+    free(set->values);
+    free(set);
+}
+
+static void DestructPointer(void *pSet) {
+    Finalize(*(ValueSet **)pSet);
+}
+
+ValueSetInterface iValueSet = {
+    .Create = Create,
+    .Clone = Clone,
+    .Add = Add,
+    .Contains = Contains,
+    .Remove = Remove,
+    .Size = Size,
+    .Clear = Clear,
+    .AddAll = AddAll,
+    .RetainAll = RetainAll,
+    .AddAllInRange = AddAllInRange,
+    .RetainRange = RetainRange,
+    .ContainsAll = ContainsAll,
+    .Intersects = Intersects,
+    .Equal = Equal,
+    .HashCode = HashCode,
+    .ToString = ToString,
+    .SetElementToString = SetElementToString,
+    .Finalize = Finalize,
+    .DestructPointer = DestructPointer,
+    .InitIterator = InitIterator,
+    .Next = Next,
+    .NextRange = NextRange,
+};
@@ -0,0 +1,10 @@
+#!/bin/sh
+# A stand-in for the model checker in the tests: print the recorded output of nuXmv for the NuSMV file, which is the
+# last argument, looked up in the data directory by the MD5 sum of the file.
+for smvFile in "$@"; do :; done
+output="$(dirname "$0")/data/$(md5sum "$smvFile" | cut -d ' ' -f 1).out"
+if [ ! -f "$output" ]; then
+    echo "no recorded output for $smvFile" >&2
+    exit 1
+fi
+cat "$output"
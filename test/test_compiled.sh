@@ -0,0 +1,66 @@
+#!/bin/sh
+# A corrupted compiled policy must be rejected by the loader, not crash it: each case overwrites one field of the
+# compiled demo1 and loads it again with the compile subcommand.
+# usage: test_compiled.sh <coachecker>
+coachecker="$1"
+testDir="$(cd "$(dirname "$0")" && pwd)"
+workDir="$(mktemp -d)"
+trap 'rm -rf "$workDir"' EXIT
+cp "$testDir/../demo/demo1.acoac" "$workDir/demo1.aabac"
+
+# The offsets of the fields in the header (see CompiledHeader in src/acoac_binary.c)
+N_ATOM_CONDS=40
+OFF_USERS=56
+OFF_UAVS=104
+OFF_CONDS=112
+OFF_RULES=128
+
+# putInt <file> <offset> <bytes> <value>: write a little-endian integer
+putInt() {
+    bytes=""
+    i=0
+    while [ $i -lt "$3" ]; do
+        bytes="$bytes$(printf '\\%03o' $((($4 >> (8 * i)) & 255)))"
+        i=$((i + 1))
+    done
+    printf "$bytes" | dd of="$1" bs=1 seek="$2" conv=notrunc 2>/dev/null
+}
+
+# getInt64 <file> <offset>
+getInt64() {
+    od -An -t d8 -j "$2" -N 8 "$1" | tr -d ' '
+}
+
+if ! "$coachecker" compile -input "$workDir/demo1.aabac" -output "$workDir/demo1.aabin" > "$workDir/output" 2>&1 ||
+    ! "$coachecker" compile -input "$workDir/demo1.aabin" -output "$workDir/reloaded.aabin" > "$workDir/output" 2>&1 ||
+    ! cmp -s "$workDir/demo1.aabin" "$workDir/reloaded.aabin"; then
+    cat "$workDir/output"
+    echo "failed to compile and reload demo1"
+    exit 1
+fi
+
+offUsers=$(getInt64 "$workDir/demo1.aabin" $OFF_USERS)
+offUAVs=$(getInt64 "$workDir/demo1.aabin" $OFF_UAVS)
+offConds=$(getInt64 "$workDir/demo1.aabin" $OFF_CONDS)
+offRules=$(getInt64 "$workDir/demo1.aabin" $OFF_RULES)
+
+status=0
+# corrupt <name> <offset> <bytes> <value>
+corrupt() {
+    cp "$workDir/demo1.aabin" "$workDir/corrupted.aabin"
+    putInt "$workDir/corrupted.aabin" "$2" "$3" "$4"
+    "$coachecker" compile -input "$workDir/corrupted.aabin" -output "$workDir/reloaded.aabin" > "$workDir/output" 2>&1
+    rc=$?
+    if [ $rc -ne 1 ] || ! grep -q "corrupted" "$workDir/output"; then
+        echo "corrupted $1 is not rejected (exit code $rc)"
+        status=1
+    fi
+}
+
+corrupt "section offset" $OFF_USERS 8 1000000000
+corrupt "count" $N_ATOM_CONDS 4 -1
+corrupt "string offset" $((offUsers + 4)) 4 2147483647
+corrupt "user of a UAV" $offUAVs 4 1000000
+corrupt "atomic conditions of a condition" $((offConds + 4)) 4 1000000
+corrupt "target attribute of a rule" $offRules 4 -2
+exit $status
@@ -0,0 +1,24 @@
+#!/bin/sh
+# When the domain of x is compressed, the counterexample sets x to 4, the representative of the class {4, 5}, while
+# only the rule setting x to 5 is applicable: the action must be reported with the value 5 and that rule, as without
+# compression. The comments of the rules are not compared, since they show the compressed value sets.
+# usage: test_compression.sh <coachecker>
+coachecker="$1"
+testDir="$(cd "$(dirname "$0")" && pwd)"
+workDir="$(mktemp -d)"
+trap 'rm -rf "$workDir"' EXIT
+cp "$testDir/data/compression.aabac" "$workDir/compression.aabac"
+
+status=0
+for options in "" "-no_compress"; do
+    mkdir -p "$workDir/log"
+    "$coachecker" -smc -no_cache -no_absref $options -input "$workDir/compression.aabac" \
+        -model_checker "$testDir/replay_mc.sh" -log_dir "$workDir/log" > "$workDir/output" 2>&1
+    grep -a -E '^(reachable|unreachable|Step[0-9]+:)' "$workDir/output" | sed 's/\t\/\*.*\*\/$//' > "$workDir/result"
+    if ! diff "$testDir/data/compression.expected" "$workDir/result"; then
+        echo "unexpected result with options [$options]"
+        status=1
+    fi
+    rm -rf "$workDir/log"
+done
+exit $status
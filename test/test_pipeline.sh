@@ -0,0 +1,23 @@
+#!/bin/sh
+# The sub-policy of the first round of demo3 is "unsafe" while the next round is prepared by -pipeline: the actions of
+# the counterexample must be found with the rules of the first round, as without -pipeline.
+# usage: test_pipeline.sh <coachecker>
+coachecker="$1"
+testDir="$(cd "$(dirname "$0")" && pwd)"
+workDir="$(mktemp -d)"
+trap 'rm -rf "$workDir"' EXIT
+cp "$testDir/../demo/demo3.acoac" "$workDir/demo3.aabac"
+
+status=0
+for options in "" "-pipeline"; do
+    mkdir -p "$workDir/log"
+    "$coachecker" -smc -no_cache $options -input "$workDir/demo3.aabac" -model_checker "$testDir/replay_mc.sh" \
+        -log_dir "$workDir/log" > "$workDir/output" 2>&1
+    grep -a -E '^(reachable|unreachable|Step[0-9]+:)' "$workDir/output" > "$workDir/result"
+    if ! diff "$testDir/data/demo3_pipeline.expected" "$workDir/result"; then
+        echo "unexpected result with options [$options]"
+        status=1
+    fi
+    rm -rf "$workDir/log"
+done
+exit $status
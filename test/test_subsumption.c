@@ -0,0 +1,66 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "acoac_inst.h"
+#include "acoac_io.h"
+#include "acoac_pruning.h"
+
+static int failures = 0;
+
+#define CHECK(cond)                                                   \
+    do {                                                              \
+        if (!(cond)) {                                                \
+            printf("[Error] %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            failures++;                                               \
+        }                                                             \
+    } while (0)
+
+/**
+ * Check the rules of test/data/subsumption.aabac that are left after the subsumed rules are removed, see the comments
+ * of the rules in the policy
+ */
+static void testSubsumption(const char *path) {
+    ACoACInstance *pInst = readACoACInstance((char *)path);
+    CHECK(pInst != NULL);
+    if (pInst == NULL) {
+        return;
+    }
+    // Rules 4 and 5 are merged into rule 3 by the discretization, and rule 0 is subsumed by rule 1
+    init(pInst);
+    CHECK(iHashSet.Size(pInst->pSetRuleIdxes) == 8);
+    CHECK(removeSubsumedRules(pInst) == 1);
+
+    // The rule set compares rules by content, so the kept indices are read by iterating over it
+    int kept[10] = {0}, expected[10] = {0, 1, 1, 1, 0, 0, 1, 1, 1, 1}, i;
+    HashSetIterator itRuleIdxes;
+    iHashSet.InitIterator(pInst->pSetRuleIdxes, &itRuleIdxes);
+    while (itRuleIdxes.HasNext(&itRuleIdxes)) {
+        int ruleIdx = *(int *)itRuleIdxes.GetNext(&itRuleIdxes);
+        CHECK(ruleIdx >= 0 && ruleIdx < 10);
+        if (ruleIdx >= 0 && ruleIdx < 10) {
+            kept[ruleIdx] = 1;
+        }
+    }
+    for (i = 0; i < 10; i++) {
+        if (kept[i] != expected[i]) {
+            printf("[Error] rule %d is %s\n", i, kept[i] ? "kept" : "removed");
+            failures++;
+        }
+    }
+    finalizeACoACInstance(pInst);
+}
+
+int main(int argc, char *argv[]) {
+    if (argc != 2) {
+        printf("usage: %s <subsumption.aabac>\n", argv[0]);
+        return 1;
+    }
+    testSubsumption(argv[1]);
+    finalizeGlobalVars();
+    if (failures > 0) {
+        printf("%d checks failed\n", failures);
+        return 1;
+    }
+    printf("All checks passed\n");
+    return 0;
+}
@@ -0,0 +1,148 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "valueset.h"
+
+static int failures = 0;
+
+#define CHECK(cond)                                                   \
+    do {                                                              \
+        if (!(cond)) {                                                \
+            printf("[Error] %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            failures++;                                               \
+        }                                                             \
+    } while (0)
+
+static ValueSet *createSet(const int *values, int n) {
+    ValueSet *set = iValueSet.Create();
+    int i;
+    for (i = 0; i < n; i++) {
+        iValueSet.Add(set, values[i]);
+    }
+    return set;
+}
+
+/**
+ * Check that a set holds exactly the given values, in ascending order
+ */
+static void checkValues(ValueSet *set, const int *values, int n) {
+    ValueSetIterator it;
+    int i = 0;
+    CHECK(iValueSet.Size(set) == n);
+    iValueSet.InitIterator(set, &it);
+    while (iValueSet.Next(&it)) {
+        CHECK(i < n && it.value == values[i]);
+        i++;
+    }
+    CHECK(i == n);
+}
+
+static void testSparse() {
+    int values[] = {-2000000000, -5, 3, 2000000000};
+    ValueSet *set = createSet((int[]){2000000000, 3, -2000000000, -5, 3}, 5);
+    // A bitset over the range would take about 500MB
+    CHECK(set->values != NULL && set->words == NULL);
+    checkValues(set, values, 4);
+    CHECK(iValueSet.Contains(set, -2000000000));
+    CHECK(!iValueSet.Contains(set, -4));
+    CHECK(!iValueSet.Contains(set, 2000000001));
+    CHECK(iValueSet.Remove(set, -5));
+    CHECK(!iValueSet.Remove(set, -5));
+    checkValues(set, (int[]){-2000000000, 3, 2000000000}, 3);
+    iValueSet.Finalize(set);
+
+    set = createSet((int[]){0, 2000000000}, 2);
+    CHECK(set->values != NULL && set->capacity <= 2);
+    iValueSet.Finalize(set);
+}
+
+static void testDensify() {
+    int i;
+    ValueSet *set = createSet((int[]){0, 100000}, 2);
+    CHECK(set->values != NULL);
+    for (i = 1; i < 100000; i++) {
+        iValueSet.Add(set, i);
+    }
+    // The values fill their range, so the set is a bitset again
+    CHECK(set->values == NULL);
+    CHECK(iValueSet.Size(set) == 100001);
+    CHECK(iValueSet.Contains(set, 0) && iValueSet.Contains(set, 54321) && iValueSet.Contains(set, 100000));
+    iValueSet.Finalize(set);
+}
+
+static void testMixed() {
+    ValueSet *dense = createSet((int[]){-3, -2, -1, 5, 6, 100}, 6);
+    ValueSet *sparse = createSet((int[]){2000000000, -3, -2, -1, 5, 6, 100}, 7);
+    ValueSet *set, *other;
+    CHECK(dense->values == NULL && sparse->values != NULL);
+
+    CHECK(!iValueSet.Equal(dense, sparse));
+    CHECK(iValueSet.ContainsAll(sparse, dense));
+    CHECK(!iValueSet.ContainsAll(dense, sparse));
+    CHECK(iValueSet.Intersects(dense, sparse));
+    iValueSet.Remove(sparse, 2000000000);
+    // Equal sets have the same hash code whether they are bitsets or sorted arrays
+    CHECK(sparse->values != NULL);
+    CHECK(iValueSet.Equal(dense, sparse) && iValueSet.Equal(sparse, dense));
+    CHECK(iValueSet.HashCode(dense) == iValueSet.HashCode(sparse));
+
+    set = iValueSet.Clone(dense);
+    other = createSet((int[]){-2000000000, 5}, 2);
+    CHECK(iValueSet.AddAll(set, other) == 1);
+    iValueSet.Finalize(other);
+    CHECK(set->values != NULL);
+    checkValues(set, (int[]){-2000000000, -3, -2, -1, 5, 6, 100}, 7);
+    CHECK(iValueSet.RetainAll(set, dense) == 1);
+    checkValues(set, (int[]){-3, -2, -1, 5, 6, 100}, 6);
+    CHECK(iValueSet.HashCode(set) == iValueSet.HashCode(dense));
+    iValueSet.Finalize(set);
+
+    set = iValueSet.Clone(dense);
+    other = createSet((int[]){6, -1, 1000000000}, 3);
+    CHECK(iValueSet.RetainAll(set, other) == 1);
+    iValueSet.Finalize(other);
+    checkValues(set, (int[]){-1, 6}, 2);
+    iValueSet.Finalize(set);
+
+    set = createSet((int[]){1000000000}, 1);
+    CHECK(iValueSet.AddAllInRange(set, sparse, -2, 6, 0) == 1);
+    checkValues(set, (int[]){-2, -1, 5, 6, 1000000000}, 5);
+    CHECK(iValueSet.AddAllInRange(set, dense, -2, 6, 1) == 1);
+    checkValues(set, (int[]){-3, -2, -1, 5, 6, 100, 1000000000}, 7);
+    CHECK(iValueSet.RetainRange(set, 0, 100, 1) == 1);
+    checkValues(set, (int[]){-3, -2, -1, 1000000000}, 4);
+    other = createSet((int[]){-4, 0, 2000000000}, 3);
+    CHECK(!iValueSet.Intersects(set, other));
+    iValueSet.Finalize(other);
+    iValueSet.Finalize(set);
+
+    iValueSet.Finalize(dense);
+    iValueSet.Finalize(sparse);
+}
+
+static void testRanges() {
+    int lo, hi, n = 0;
+    int runs[][2] = {{-2000000000, -2000000000}, {-3, -1}, {5, 6}, {2147483646, 2147483647}};
+    ValueSetIterator it;
+    ValueSet *set = createSet((int[]){2147483647, -1, 5, -3, 6, -2000000000, -2, 2147483646}, 8);
+    iValueSet.InitIterator(set, &it);
+    while (iValueSet.NextRange(&it, &lo, &hi)) {
+        CHECK(n < 4 && lo == runs[n][0] && hi == runs[n][1]);
+        n++;
+    }
+    CHECK(n == 4);
+    iValueSet.Finalize(set);
+}
+
+int main() {
+    testSparse();
+    testDensify();
+    testMixed();
+    testRanges();
+    if (failures > 0) {
+        printf("%d checks failed\n", failures);
+        return 1;
+    }
+    printf("All checks passed\n");
+    return 0;
+}